@@ -0,0 +1,58 @@
+#include "AcousticEq.h"
+#include <math.h>
+
+float eqGainAt(const AcousticEqData& eq, float freqHz) {
+  uint8_t n = eq.count > EQ_MAX_POINTS ? EQ_MAX_POINTS : eq.count;
+  if (n == 0) return 1.0f;
+  if (n == 1 || freqHz <= eq.freqHz[0]) return eq.gain[0] / (float)EQ_GAIN_UNITY;
+  if (freqHz >= eq.freqHz[n - 1]) return eq.gain[n - 1] / (float)EQ_GAIN_UNITY;
+
+  uint8_t i = 1;
+  while (freqHz > eq.freqHz[i]) ++i;
+  float f0 = eq.freqHz[i - 1], f1 = eq.freqHz[i];
+  float g0 = eq.gain[i - 1], g1 = eq.gain[i];
+  float t = f1 > f0 ? (freqHz - f0) / (f1 - f0) : 0.0f;
+  return (g0 + t * (g1 - g0)) / (float)EQ_GAIN_UNITY;
+}
+
+bool AcousticEqBuilder::addMeasurement(float freqHz, float levelDb) {
+  if (!(freqHz >= 1.0f && freqHz <= 65535.0f) || !isfinite(levelDb)) return false;
+
+  for (uint8_t i = 0; i < count; ++i) {
+    if (fabsf(points[i].freqHz - freqHz) < EQ_MERGE_HZ) {
+      points[i].sumDb += levelDb;
+      points[i].samples++;
+      return true;
+    }
+  }
+  if (count >= EQ_MAX_POINTS) return false;
+
+  // Inserción ordenada: la tabla sale ya ascendente
+  uint8_t at = count;
+  while (at > 0 && points[at - 1].freqHz > freqHz) {
+    points[at] = points[at - 1];
+    --at;
+  }
+  points[at] = {freqHz, levelDb, 1};
+  count++;
+  return true;
+}
+
+bool AcousticEqBuilder::build(AcousticEqData& out) const {
+  if (count < 2) return false;
+
+  float meanDb = 0.0f;
+  for (uint8_t i = 0; i < count; ++i) meanDb += levelDbAt(i);
+  meanDb /= count;
+
+  out = AcousticEqData();
+  for (uint8_t i = 0; i < count; ++i) {
+    float gain = powf(10.0f, (meanDb - levelDbAt(i)) / 20.0f);
+    if (gain < EQ_GAIN_MIN) gain = EQ_GAIN_MIN;
+    if (gain > EQ_GAIN_MAX) gain = EQ_GAIN_MAX;
+    out.freqHz[i] = (uint16_t)lroundf(points[i].freqHz);
+    out.gain[i] = (uint16_t)lroundf(gain * EQ_GAIN_UNITY);
+  }
+  out.count = count;
+  return true;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <stdint.h>
+#include "ConfigSchema.h"
+
+/*
+ * Ecualización del inyector acústico: la respuesta del tweeter y la cavidad
+ * no es plana entre 4.2 y 6.4 kHz, así que a igual nivel la potencia
+ * inyectada cambia con la carga MAP. La tabla (AcousticEqData, persistida en
+ * ConfigStore) da una ganancia por frecuencia que la compensa; se aplica
+ * donde nivel y frecuencia pasan al inyector (ActuatorManager), precalculada
+ * por bin de carga en SynthTuningTable.
+ */
+
+constexpr float EQ_GAIN_MIN = 0.25f;   ///< -12 dB
+constexpr float EQ_GAIN_MAX = 4.0f;    ///< +12 dB; por encima de nivel 1 el DAC satura
+constexpr float EQ_MERGE_HZ = 25.0f;   ///< Medidas más cercanas se promedian en un punto
+
+/**
+ * Ganancia a una frecuencia: interpolación lineal entre los puntos vecinos y
+ * el valor del extremo fuera del rango medido. 1 sin tabla.
+ */
+float eqGainAt(const AcousticEqData& eq, float freqHz);
+
+/**
+ * @class AcousticEqBuilder
+ * Acumula las medidas del barrido de calibración (nivel del tono a cada
+ * frecuencia, en dB de cualquier referencia) y calcula la tabla. Repetir una
+ * frecuencia promedia las medidas, así que un segundo barrido refina el
+ * primero.
+ */
+class AcousticEqBuilder {
+public:
+  /// Vuelve a empezar sin medidas
+  void reset() { count = 0; }
+
+  /**
+   * Añade una medida.
+   * @return false si la frecuencia no es válida o ya hay EQ_MAX_POINTS.
+   */
+  bool addMeasurement(float freqHz, float levelDb);
+
+  uint8_t size() const { return count; }
+  float frequencyAt(uint8_t i) const { return points[i].freqHz; }
+  float levelDbAt(uint8_t i) const { return points[i].sumDb / points[i].samples; }
+
+  /**
+   * Ganancias que llevan cada punto a la media de todos (en dB), limitadas
+   * a EQ_GAIN_MIN..EQ_GAIN_MAX. La media deja el nivel medio de la banda
+   * como estaba.
+   * @return false con menos de dos puntos.
+   */
+  bool build(AcousticEqData& out) const;
+
+private:
+  struct Point {
+    float    freqHz;
+    float    sumDb;
+    uint16_t samples;
+  };
+
+  Point   points[EQ_MAX_POINTS];
+  uint8_t count = 0;
+};
@@ -1,55 +1,142 @@
 #include "AcousticInjector.h"
 #include "driver/dac.h"
+#include "soc/rtc.h"
+#include "soc/rtc_cntl_reg.h"
+#include "soc/rtc_io_reg.h"
+#include "soc/sens_reg.h"
+#include "TuningProfile.h"
 #include <math.h>
+#include <string.h>
 
-AcousticInjector* AcousticInjector::_instance = nullptr;
+// Estado de la ISR en DRAM: sigue accesible con la caché de flash apagada
+static DRAM_ATTR SynthIsrState s_synth;
+static DRAM_ATTR AdditiveState<AcousticInjector::OSCILLATORS> s_additive;
+static DRAM_ATTR volatile bool s_additiveOn = false;
 
-const uint8_t AcousticInjector::_sineTable[AcousticInjector::TABLE_SIZE] = {
-  128, 176, 218, 245, 255, 245, 218, 176,
-  128, 80, 38, 11, 1, 11, 38, 80
-};
+static volatile uint32_t* dacRegister(dac_channel_t channel) {
+  return (volatile uint32_t*)(uintptr_t)(channel == DAC_CHANNEL_1 ? RTC_IO_PAD_DAC1_REG : RTC_IO_PAD_DAC2_REG);
+}
 
-void AcousticInjector::begin(uint8_t dacPin, uint8_t relayPin) {
-  _instance = this;
+// Una muestra en uno o los dos DAC; en estéreo ambos registros se escriben seguidos
+static inline __attribute__((always_inline)) void synthTick() {
+  if (s_additiveOn) {
+    uint8_t out = additiveStep(s_additive);
+    synthDacWrite(s_synth.dacReg, out);
+    s_synth.lastDAC = out;
+    s_synth.ticks = s_synth.ticks + 1;
+    return;
+  }
+  // Una sola lectura: la comprobación y la escritura usan el mismo registro
+  volatile uint32_t* dac2Reg = s_synth.dac2Reg;
+  if (dac2Reg) {
+    SynthFrame f = synthStereoStep(s_synth);
+    synthDacWrite(s_synth.dacReg, f.dac1);
+    synthDacWrite(dac2Reg, f.dac2);
+  } else {
+    synthDacWrite(s_synth.dacReg, synthIsrStep(s_synth));
+  }
+}
+
+// Contador de ciclos de la CPU (registro especial CCOUNT del Xtensa)
+static inline __attribute__((always_inline)) uint32_t cycleCount() {
+  uint32_t c;
+  asm volatile("rsr %0, ccount" : "=a"(c));
+  return c;
+}
 
+void AcousticInjector::begin(uint8_t dacPin, uint8_t relayPin) {
   _dacPin = dacPin;
   _relayPin = relayPin;
   pinMode(_relayPin, OUTPUT);
   digitalWrite(_relayPin, LOW);
 
   _dacChannel = (_dacPin == 25) ? DAC_CHANNEL_1 : DAC_CHANNEL_2;
+  _dacChannel2 = (_dacChannel == DAC_CHANNEL_1) ? DAC_CHANNEL_2 : DAC_CHANNEL_1;
   dac_output_enable(_dacChannel);
 
+  memcpy(s_synth.table, SYNTH_SINE_TABLE, sizeof(s_synth.table));
+  s_synth.dacReg = dacRegister(_dacChannel);
+  s_synth.index = 0;
+  s_synth.levelInt = 0;
+
+  // Aditiva por defecto: la portadora más la resonancia de la cavidad a media amplitud
+  additiveFillTable(s_additive.table);
+  setOscillator(0, 0.0f, 1.0f);
+  if (OSCILLATORS > 1) setOscillator(1, HELMHOLTZ_HZ, 0.5f);
+
   _level = 0.0f;
   _targetLevel = 0.0f;
-  _index = 0;
-  _levelInt = 0;
 
   _timer = timerBegin(2, 80, true); // Timer 2, 1 MHz
   timerAttachInterrupt(_timer, &AcousticInjector::onTimer, true);
-  timerAlarmWrite(_timer, 1000000 / SAMPLE_RATE, true); // 64kHz
+  _periodUs = 1000000 / SAMPLE_RATE;
+  timerAlarmWrite(_timer, _periodUs, true); // 64kHz
   timerAlarmDisable(_timer);
+  setModulation(_modulation);  // Moduladores a la frecuencia de muestreo inicial
+
+  // RTC8M varía entre chips: medirlo para que el generador de coseno acierte
+  rtc_clk_8m_enable(true, true);
+  uint32_t cal = rtc_clk_cal(RTC_CAL_8MD256, 100);  // µs por ciclo de RTC8M/256, en Q13.19
+  if (cal) _rtc8mHz = (float)(256.0 * 1e6 * (1 << 19) / cal);
 }
 
 void AcousticInjector::start(float level) {
   _targetLevel = constrain(level, 0.0f, 1.0f);
   _level = 0.0f;
-  _levelInt = 0;
-  _index = 0;
+  s_synth.levelInt = 0;
+  s_synth.index = 0;
+  s_synth.resetMax = true;  // Máximo de ciclos por arranque
+  synthModRestart(s_synth.mod);
+  synthModRestart(s_additive.mod);
 
   digitalWrite(_relayPin, HIGH);
   delay(10);
 
-  timerAlarmEnable(_timer);
+  _starts->inc();
+  _running = true;
+  if (_mode == OutputMode::STEREO) {
+    // El segundo DAC solo se toma mientras suena en estéreo (GPIO 25/26)
+    dac_output_enable(_dacChannel2);
+    s_synth.levelInt2 = 0;
+    s_synth.shapeErr2 = 0;
+    s_synth.dac2Reg = dacRegister(_dacChannel2);
+  }
+  if (_mode == OutputMode::ADDITIVE) {
+    for (uint8_t i = 0; i < OSCILLATORS; i++) {
+      s_additive.osc[i].phase = additivePhase(_oscPhase[i]);
+      s_additive.osc[i].increment = additiveIncrement(i == 0 ? _currentFrequency : _oscFreq[i]);
+    }
+    s_additive.gain = 0;
+    s_additive.clipped = 0;
+    s_additiveOn = true;
+  }
+  if (_mode == OutputMode::COSINE) {
+    // Arranca apagado; la rampa de update() lo enciende por escalas
+    _cwScale = CW_SCALE_OFF;
+    if (_currentFrequency > 0.0f) cwSetFrequency(_currentFrequency);
+  } else {
+    // La aditiva muestrea a ritmo fijo; la tabla, al de la frecuencia pedida
+    timerAlarmWrite(_timer, _mode == OutputMode::ADDITIVE ? SYNTH_TIMER_HZ / ADDITIVE_SAMPLE_HZ : _periodUs, true);
+    timerAlarmEnable(_timer);
+  }
 }
 
 void AcousticInjector::stop() {
   timerAlarmDisable(_timer);
+  waitIsrQuiescent();
+  cwDisable();
+  s_additiveOn = false;
   dac_output_voltage(_dacChannel, 128);
+  if (s_synth.dac2Reg) {
+    // Ya no hay ISR en curso ni pendiente: nadie más lee el registro
+    s_synth.dac2Reg = nullptr;
+    dac_output_voltage(_dacChannel2, 128);
+  }
+  _running = false;
   digitalWrite(_relayPin, LOW);
   _level = 0.0f;
   _targetLevel = 0.0f;
-  _levelInt = 0;
+  s_synth.levelInt = 0;
 }
 
 void AcousticInjector::setLevel(float level) {
@@ -57,40 +144,62 @@ void AcousticInjector::setLevel(float level) {
 }
 
 void AcousticInjector::update() {
-  const float alpha = 0.9f; // factor de suavizado, ajustable
-  _level = alpha * _level + (1.0f - alpha) * _targetLevel;
-
-  _levelInt = (uint8_t)(_level * 255.0f);
+  _level = synthRampLevel(_level, _targetLevel, SYNTH_RAMP_ALPHA);
+  s_synth.levelInt = synthLevelInt(_level);
+  s_synth.levelInt2 = synthLevelInt(_level * _gain2);
+  if (_mode == OutputMode::ADDITIVE) s_additive.gain = additiveGain(_oscLevel, OSCILLATORS, s_synth.levelInt);
+  if (_running && _mode == OutputMode::COSINE) cwApplyLevel();
+  publishIsrStats();
 }
 
+/*
+ * Con la alarma ya apagada no se dispara otra ISR. Una ya disparada entra en
+ * pocos µs y la que esté en curso acaba antes de la muestra siguiente: tras
+ * una muestra de espera solo queda ver bajar inIsr (stop() puede correr en el
+ * otro núcleo).
+ */
+void AcousticInjector::waitIsrQuiescent() {
+  delayMicroseconds(max(_periodUs, SYNTH_TIMER_HZ / ADDITIVE_SAMPLE_HZ));
+  while (s_synth.inIsr) {
+  }
+}
 
+// Solo registros, DRAM y código inline: nada de flash ni del driver del DAC
 void IRAM_ATTR AcousticInjector::onTimer() {
-  if (!_instance) return;
-
-  uint8_t raw = _instance->_sineTable[_instance->_index];
-  int16_t delta = (int16_t)raw - 128;
-  int16_t modulated = 128 + ((delta * _instance->_levelInt) >> 8);
-  uint8_t output = constrain(modulated, 0, 255);
-
-  dac_output_voltage(_instance->_dacChannel, output);
-  _instance->_lastDACValue = output;
-
-  _instance->_index = (_instance->_index + 1) % TABLE_SIZE;
+  s_synth.inIsr = true;
+  uint32_t t0 = cycleCount();
+  synthTick();
+  uint32_t cycles = cycleCount() - t0;
+
+  s_synth.cycleSum = s_synth.cycleSum + cycles;
+  if (s_synth.resetMax) {
+    s_synth.cycleMax = 0;
+    s_synth.resetMax = false;
+  }
+  if (cycles > s_synth.cycleMax) s_synth.cycleMax = cycles;
+  s_synth.inIsr = false;
 }
 
 void IRAM_ATTR AcousticInjector::applyPendingDAC() {
-  uint8_t raw = _sineTable[_index];
-  int16_t delta = (int16_t)raw - 128;
-  int16_t modulated = 128 + ((delta * _levelInt) >> 8);
-  uint8_t output = constrain(modulated, 0, 255);
-  dac_output_voltage(_dacChannel, output);
-  _lastDACValue = output;
+  synthTick();
+}
 
-  _index = (_index + 1) % TABLE_SIZE;
+// La ISR solo acumula; las métricas se actualizan aquí, fuera de la interrupción
+void AcousticInjector::publishIsrStats() {
+  uint32_t ticks = s_synth.ticks;
+  uint32_t cycleSum = s_synth.cycleSum;
+  uint32_t samples = ticks - _statTicks;
+  if (samples > 0) {
+    _isrTicks->inc(samples);
+    _isrCycles->set((int32_t)((cycleSum - _statCycleSum) / samples));
+  }
+  _isrCyclesMax->set((int32_t)s_synth.cycleMax);
+  _statTicks = ticks;
+  _statCycleSum = cycleSum;
 }
 
 uint8_t AcousticInjector::getCurrentDAC() const {
-  return _lastDACValue;
+  return s_synth.lastDAC;
 }
 
 bool AcousticInjector::isActive() const {
@@ -165,15 +274,139 @@ void AcousticInjector::testSimple() {
 }
 
 float AcousticInjector::mapLoadToWaveFrequency(float percent) {
-  constexpr float FREQ_MIN = 4200.0f;   // Baja carga
-  constexpr float FREQ_MAX = 6400.0f;   // Alta carga
-  percent = constrain(percent, 0.0f, 100.0f);
-  return FREQ_MIN + (percent / 100.0f) * (FREQ_MAX - FREQ_MIN);
+  return synthFrequencyForLoad(percent, DEFAULT_FREQ_MIN_HZ, DEFAULT_FREQ_MAX_HZ);
 }
 
 void AcousticInjector::updateWaveFrequency(float freqHz) {
+  setSamplePeriod(synthTimerPeriodUs(freqHz, TABLE_SIZE), freqHz);
+}
+
+void AcousticInjector::setSamplePeriod(uint32_t periodUs, float freqHz) {
   if (!_timer) return;
   _currentFrequency = freqHz;
-  float periodPerSample = 1e6 / (freqHz * TABLE_SIZE);  // μs por muestra
-  timerAlarmWrite(_timer, static_cast<uint32_t>(periodPerSample), true);
+  if (_mode == OutputMode::COSINE) cwSetFrequency(freqHz);
+  // Durante un chirp el oscilador 0 es del barrido
+  if (_mode == OutputMode::ADDITIVE && !isChirp(_modulation)) s_additive.osc[0].increment = additiveIncrement(freqHz);
+  // Varios bins de carga comparten periodo entero: no tocar el timer en vano
+  if (periodUs == _periodUs) return;
+  _periodUs = periodUs;
+  // Los moduladores de la tabla cuentan muestras: se rehacen con el nuevo periodo
+  synthModConfigure(s_synth.mod, _modulation, (float)SYNTH_TIMER_HZ / periodUs);
+  if (_mode != OutputMode::ADDITIVE) timerAlarmWrite(_timer, periodUs, true);  // μs por muestra
+}
+
+void AcousticInjector::setNoiseShaping(bool on) {
+  s_synth.shapeMask = on ? 0xFF : 0;  // Un byte: la ISR ve uno u otro, nunca a medias
+}
+
+bool AcousticInjector::getNoiseShaping() const {
+  return s_synth.shapeMask != 0;
+}
+
+void AcousticInjector::setStereoPhase(float degrees) {
+  s_synth.phaseOffset = synthPhaseFromDegrees(degrees);
+}
+
+float AcousticInjector::getStereoPhase() const {
+  return s_synth.phaseOffset * (360.0f / 256.0f);
+}
+
+void AcousticInjector::setSecondGain(float gain) {
+  _gain2 = constrain(gain, 0.0f, 1.0f);
+}
+
+bool AcousticInjector::setOscillator(uint8_t index, float freqHz, float level, float phaseDeg) {
+  if (index >= OSCILLATORS) return false;
+  uint32_t increment = index == 0 ? additiveIncrement(_currentFrequency) : additiveIncrement(freqHz);
+  if (index > 0 && increment == 0) return false;
+
+  _oscFreq[index] = index == 0 ? 0.0f : freqHz;
+  _oscPhase[index] = phaseDeg;
+  _oscLevel[index] = synthLevelInt(constrain(level, 0.0f, 1.0f));
+  if (index > 0) s_additive.osc[index].increment = increment;
+  s_additive.osc[index].level = _oscLevel[index];
+  return true;
+}
+
+bool AcousticInjector::getOscillator(uint8_t index, float& freqHz, float& level, float& phaseDeg) const {
+  if (index >= OSCILLATORS) return false;
+  freqHz = index == 0 ? _currentFrequency : _oscFreq[index];
+  level = _oscLevel[index] / 255.0f;
+  phaseDeg = _oscPhase[index];
+  return true;
+}
+
+uint32_t AcousticInjector::getClippedSamples() const {
+  return s_additive.clipped;
+}
+
+bool AcousticInjector::isChirp(const AcousticModulation& mod) {
+  return mod.mode == ModulationMode::CHIRP_LINEAR || mod.mode == ModulationMode::CHIRP_EXP;
+}
+
+bool AcousticInjector::setModulation(const AcousticModulation& mod) {
+  _modulation = mod;
+  synthModConfigure(s_synth.mod, mod, (float)SYNTH_TIMER_HZ / (_periodUs ? _periodUs : 1));
+  synthModConfigure(s_additive.mod, mod, ADDITIVE_SAMPLE_HZ);
+  // Fuera del chirp, el oscilador 0 vuelve a la portadora con la fase donde esté
+  if (!isChirp(mod)) s_additive.osc[0].increment = additiveIncrement(_currentFrequency);
+  return supportsModulation(mod);
+}
+
+bool AcousticInjector::supportsModulation(const AcousticModulation& mod) const {
+  if (mod.mode == ModulationMode::NONE) return true;
+  if (isChirp(mod)) return _mode == OutputMode::ADDITIVE;
+  return _mode != OutputMode::COSINE;  // Sin ISR no hay envolvente
+}
+
+bool AcousticInjector::setOutputMode(OutputMode mode) {
+  if (_running) return mode == _mode;
+  _mode = mode;
+  return true;
+}
+
+float AcousticInjector::getOutputFrequency() const {
+  if (_mode == OutputMode::COSINE) return _cw.realHz;
+  if (_mode == OutputMode::ADDITIVE) return additiveFrequency(additiveIncrement(_currentFrequency));
+  return _periodUs ? (float)SYNTH_TIMER_HZ / ((float)_periodUs * TABLE_SIZE) : 0.0f;
+}
+
+void AcousticInjector::cwSetFrequency(float freqHz) {
+  CwToneSettings s = cwToneForFrequency(freqHz, _rtc8mHz, CW_CLK_DIV_LIMIT);
+  bool changed = s.freqStep != _cw.freqStep || s.clkDiv != _cw.clkDiv;
+  _cw = s;
+  if (!changed) return;
+  if (CW_CLK_DIV_LIMIT > 0) REG_SET_FIELD(RTC_CNTL_CLK_CONF_REG, RTC_CNTL_CK8M_DIV_SEL, s.clkDiv);
+  SET_PERI_REG_BITS(SENS_SAR_DAC_CTRL1_REG, SENS_SW_FSTEP, s.freqStep, SENS_SW_FSTEP_S);
+}
+
+void AcousticInjector::cwApplyLevel() {
+  uint8_t scale = cwScaleForLevel(_level);
+  if (scale == _cwScale) return;
+  if (scale == CW_SCALE_OFF || _cw.freqStep == 0) {
+    cwDisable();
+    return;
+  }
+
+  // INV = 2 invierte el MSB: coseno centrado en 128 con DC = 0
+  if (_dacChannel == DAC_CHANNEL_1) {
+    SET_PERI_REG_BITS(SENS_SAR_DAC_CTRL2_REG, SENS_DAC_SCALE1, scale, SENS_DAC_SCALE1_S);
+    SET_PERI_REG_BITS(SENS_SAR_DAC_CTRL2_REG, SENS_DAC_INV1, 2, SENS_DAC_INV1_S);
+    SET_PERI_REG_BITS(SENS_SAR_DAC_CTRL2_REG, SENS_DAC_DC1, 0, SENS_DAC_DC1_S);
+  } else {
+    SET_PERI_REG_BITS(SENS_SAR_DAC_CTRL2_REG, SENS_DAC_SCALE2, scale, SENS_DAC_SCALE2_S);
+    SET_PERI_REG_BITS(SENS_SAR_DAC_CTRL2_REG, SENS_DAC_INV2, 2, SENS_DAC_INV2_S);
+    SET_PERI_REG_BITS(SENS_SAR_DAC_CTRL2_REG, SENS_DAC_DC2, 0, SENS_DAC_DC2_S);
+  }
+  if (_cwScale == CW_SCALE_OFF) {
+    SET_PERI_REG_MASK(SENS_SAR_DAC_CTRL1_REG, SENS_SW_TONE_EN);
+    SET_PERI_REG_MASK(SENS_SAR_DAC_CTRL2_REG, _dacChannel == DAC_CHANNEL_1 ? SENS_DAC_CW_EN1_M : SENS_DAC_CW_EN2_M);
+  }
+  _cwScale = scale;
+}
+
+void AcousticInjector::cwDisable() {
+  if (_cwScale == CW_SCALE_OFF) return;
+  CLEAR_PERI_REG_MASK(SENS_SAR_DAC_CTRL2_REG, _dacChannel == DAC_CHANNEL_1 ? SENS_DAC_CW_EN1_M : SENS_DAC_CW_EN2_M);
+  _cwScale = CW_SCALE_OFF;
 }
@@ -2,10 +2,24 @@
 
 #include <Arduino.h>
 #include "driver/dac.h"
+#include "Metrics.h"
+#include "SynthKernel.h"
+#include "DacCosine.h"
+#include "AdditiveSynth.h"
 
 class AcousticInjector {
 public:
-  static constexpr uint8_t TABLE_SIZE = 16;
+  /// Cómo se genera la onda en el DAC
+  enum class OutputMode : uint8_t {
+    SINE_TABLE,  ///< Tabla de seno desde la ISR del timer 2
+    COSINE,      ///< Generador de coseno del DAC: tono puro sin ISR, nivel en 4 escalas
+    STEREO,      ///< Tabla en los dos DAC desde la misma ISR, el segundo desfasado
+    ADDITIVE,    ///< Suma de OSCILLATORS osciladores DDS a ADDITIVE_SAMPLE_HZ
+  };
+
+  static constexpr uint8_t OSCILLATORS = VORTEX_SYNTH_OSCILLATORS;
+
+  static constexpr uint8_t TABLE_SIZE = SYNTH_TABLE_SIZE;
   static constexpr uint32_t SAMPLE_RATE = 64000;  // 64 kHz para alta fidelidad
   // Paso de rampa para suavizar cambios en el nivel (_level).
   // Modificar este valor para hacer la transición más lenta (valor menor) o más rápida (valor mayor).
@@ -16,7 +30,7 @@ public:
   void stop();
   void setLevel(float level);
   void update();               // Rampa de nivel
-  void IRAM_ATTR applyPendingDAC(); // ✅ Safe para llamar desde interrupción
+  void IRAM_ATTR applyPendingDAC(); // ✅ Safe para llamar desde interrupción (y con la caché de flash apagada)
   uint8_t getCurrentDAC() const;
   bool isActive() const;
   static void IRAM_ATTR onTimer();
@@ -26,26 +40,99 @@ public:
   void emitResonant(float level); // Señal por fase acumulada
   void testSimple();
   void updateWaveFrequency(float freqHz);  // Cambiar nombre para aclarar que es por onda completa
+  /**
+   * Alarma del timer ya calculada (ver SynthTuningTable). No reescribe el
+   * timer si el periodo no cambia.
+   * @param periodUs µs por muestra.
+   * @param freqHz   Frecuencia pedida, para getFrequency().
+   */
+  void setSamplePeriod(uint32_t periodUs, float freqHz);
+  /**
+   * Cambia la salida. Solo con el inyector parado.
+   * @return false si está activo.
+   */
+  bool setOutputMode(OutputMode mode);
+  OutputMode getOutputMode() const { return _mode; }
+  /// Conformado de ruido en la ISR de la tabla (synthSampleShaped); se puede cambiar en marcha
+  void setNoiseShaping(bool on);
+  bool getNoiseShaping() const;
+  /**
+   * Desfase del segundo DAC en modo STEREO (resolución 360/256°); se puede
+   * cambiar en marcha.
+   * @param degrees 180 = contrafase.
+   */
+  void setStereoPhase(float degrees);
+  float getStereoPhase() const;
+  /// Nivel del segundo DAC relativo al principal, 0–1
+  void setSecondGain(float gain);
+  float getSecondGain() const { return _gain2; }
+  /**
+   * Oscilador del modo ADDITIVE. El 0 es la portadora: su frecuencia sale de
+   * la carga MAP (setSamplePeriod) y freqHz se ignora. Nivel y frecuencia
+   * valen al momento; la fase se aplica en start().
+   * @param level 0–1, antes del margen y del nivel general.
+   * @return false si el índice no existe o la frecuencia no cabe bajo Nyquist.
+   */
+  bool setOscillator(uint8_t index, float freqHz, float level, float phaseDeg = 0.0f);
+  bool getOscillator(uint8_t index, float& freqHz, float& level, float& phaseDeg) const;
+  /// Muestras recortadas por el modo ADDITIVE desde el arranque
+  uint32_t getClippedSamples() const;
+  /**
+   * Modulación calculada en la ISR (SynthModulator.h); se puede cambiar en
+   * marcha sin clics. Ráfagas y AM valen en las salidas con ISR; el chirp
+   * necesita el DDS de ADDITIVE y barre el oscilador 0.
+   * @return false si la salida actual no la aplica (se guarda igual).
+   */
+  bool setModulation(const AcousticModulation& mod);
+  /// Si la salida actual aplica esa modulación
+  bool supportsModulation(const AcousticModulation& mod) const;
+  const AcousticModulation& getModulation() const { return _modulation; }
   static float mapLoadToWaveFrequency(float mapLoadPercent);
   float getLevel() const { return _level; }
   float getFrequency() const { return _currentFrequency; }
+  /// Lo que sale de verdad, tras cuantizar periodo (tabla) o paso (coseno)
+  float getOutputFrequency() const;
+  float getFrequencyError() const { return getOutputFrequency() - _currentFrequency; }
+  float getRtc8mHz() const { return _rtc8mHz; }
 
 
-  static AcousticInjector* _instance;
-
 private:
+  // El divisor de RTC8M también frena el reloj rápido del RTC: no se toca
+  static constexpr uint8_t CW_CLK_DIV_LIMIT = 0;
+
+  void cwSetFrequency(float freqHz);
+  void cwApplyLevel();
+  void cwDisable();
+  void waitIsrQuiescent();  ///< Tras timerAlarmDisable(): vuelve cuando la ISR ya no corre
+  void publishIsrStats();
+  static bool isChirp(const AcousticModulation& mod);
+
   uint8_t  _dacPin = 0;
   uint8_t  _relayPin = 0;
-  uint8_t  _index = 0;      // índice para tabla seno (solo para modo tabla)
   float    _level = 0.0f;
   float    _targetLevel = 0.0f;
-  uint8_t  _lastDACValue = 128;
   dac_channel_t _dacChannel;
+  dac_channel_t _dacChannel2;      // el otro DAC, para STEREO
+  float    _gain2 = 1.0f;
+  float    _oscFreq[OSCILLATORS] = {};
+  float    _oscPhase[OSCILLATORS] = {};
+  uint8_t  _oscLevel[OSCILLATORS] = {};
+  AcousticModulation _modulation;
   hw_timer_t* _timer = nullptr;
-  volatile uint8_t _levelInt = 0;  // nivel escalado 0-255 para ISR
   float _currentFrequency = 0.0f;
+  uint32_t _periodUs = 0;          // alarma actual del timer
+  OutputMode _mode = OutputMode::SINE_TABLE;
+  float    _rtc8mHz = CW_RTC8M_NOMINAL_HZ;
+  CwToneSettings _cw;
+  uint8_t  _cwScale = CW_SCALE_OFF;  // escala escrita; OFF = generador apagado
+  bool     _running = false;          // entre start() y stop()
+
+  uint32_t _statTicks = 0;         // última lectura de la ISR publicada
+  uint32_t _statCycleSum = 0;
 
+  Counter* _isrTicks = &MetricsRegistry::getInstance().counter("acoustic.isr_ticks");
+  Gauge*   _isrCycles    = &MetricsRegistry::getInstance().gauge("acoustic.isr_cycles");      // ciclos por muestra
+  Gauge*   _isrCyclesMax = &MetricsRegistry::getInstance().gauge("acoustic.isr_cycles_max");  // desde start()
+  Counter* _starts   = &MetricsRegistry::getInstance().counter("acoustic.starts");
 
-  // Tabla seno 16 muestras para ISR rápido (0-255)
-  static const uint8_t _sineTable[TABLE_SIZE];
 };
@@ -0,0 +1,230 @@
+#include "AcousticMonitor.h"
+#include "driver/i2s.h"
+#include "esp_timer.h"
+#include "ADCUtils.h"
+#include "Logger.h"
+#include <math.h>
+
+static constexpr i2s_port_t FEEDBACK_I2S = I2S_NUM_0;  // El DAC del inyector va por registros, no por I2S
+static constexpr uint16_t FEEDBACK_DMA_CHUNK = 128;     // Muestras por lectura del DMA
+
+bool AcousticMonitor::begin(uint8_t micPin, const AcousticInjector* injector) {
+  _injector = injector;
+  _available = false;
+  if (micPin < 32 || micPin > 39) {
+    LOG_E("Error: GPIO inválido para el micrófono de retorno (ADC1).");
+    return false;
+  }
+  _channel = pinToADCChannel(micPin);
+
+  i2s_config_t cfg = {};
+  cfg.mode = (i2s_mode_t)(I2S_MODE_MASTER | I2S_MODE_RX | I2S_MODE_ADC_BUILT_IN);
+  cfg.sample_rate = FEEDBACK_SAMPLE_HZ;
+  cfg.bits_per_sample = I2S_BITS_PER_SAMPLE_16BIT;
+  cfg.channel_format = I2S_CHANNEL_FMT_ONLY_LEFT;
+  cfg.communication_format = I2S_COMM_FORMAT_I2S_MSB;
+  cfg.intr_alloc_flags = 0;
+  cfg.dma_buf_count = 4;
+  cfg.dma_buf_len = FEEDBACK_DMA_CHUNK;
+  cfg.use_apll = false;
+
+  std::lock_guard<std::mutex> lock(adc1Mutex());
+  adc1_config_channel_atten(_channel, ADC_ATTEN_DB_11);
+  if (i2s_driver_install(FEEDBACK_I2S, &cfg, 0, nullptr) != ESP_OK ||
+      i2s_set_adc_mode(ADC_UNIT_1, _channel) != ESP_OK) {
+    LOG_E("Error: no arranca el I2S del micrófono de retorno.");
+    return false;
+  }
+
+  // El reloj del I2S en modo ADC no da exactamente lo pedido: medirlo, como RTC8M
+  uint16_t buf[FEEDBACK_DMA_CHUNK];
+  size_t bytes = 0;
+  i2s_adc_enable(FEEDBACK_I2S);
+  i2s_read(FEEDBACK_I2S, buf, sizeof(buf), &bytes, pdMS_TO_TICKS(100));  // El primero llega a medias
+  int64_t t0 = esp_timer_get_time();
+  uint32_t samples = 0;
+  for (uint8_t i = 0; i < 16; i++) {
+    if (i2s_read(FEEDBACK_I2S, buf, sizeof(buf), &bytes, pdMS_TO_TICKS(100)) != ESP_OK || bytes == 0) break;
+    samples += bytes / sizeof(buf[0]);
+  }
+  int64_t elapsed = esp_timer_get_time() - t0;
+  i2s_adc_disable(FEEDBACK_I2S);
+  adc1_get_raw(_channel);  // Devuelve ADC1 al controlador RTC que usa analogRead
+
+  if (samples == 0 || elapsed <= 0) {
+    LOG_E("Error: el I2S del micrófono de retorno no entrega muestras.");
+    return false;
+  }
+  _sampleHz = samples * 1e6f / elapsed;
+  _available = true;
+  return true;
+}
+
+void AcousticMonitor::service() {
+  if (!_available) return;
+  serviceSpectrum();
+  if (!_injector || !_injector->isActive()) return;
+  // Un chirp no tiene una frecuencia que sintonizar
+  const AcousticModulation& mod = _injector->getModulation();
+  if (mod.mode == ModulationMode::CHIRP_LINEAR || mod.mode == ModulationMode::CHIRP_EXP) return;
+
+  float freq = _injector->getOutputFrequency();
+  float level = _injector->getLevel();
+  if (!capture(freq)) return;
+
+  _lastHz = freq;
+  judge(_detector.result(), level, mod.mode == ModulationMode::NONE);
+}
+
+// Lee el ADC por I2S con ADC1 tomado hasta que sink() devuelve true o se
+// pasa de maxSamples. El DMA entrega las muestras de 16 bits por parejas
+// intercambiadas (canal en los 4 bits altos): se deshace
+template <typename Sink>
+static bool readAdc1(adc1_channel_t channel, uint32_t maxSamples, Sink sink) {
+  uint16_t buf[FEEDBACK_DMA_CHUNK];
+  size_t bytes = 0;
+  bool done = false;
+  std::lock_guard<std::mutex> lock(adc1Mutex());
+  i2s_adc_enable(FEEDBACK_I2S);
+  i2s_read(FEEDBACK_I2S, buf, sizeof(buf), &bytes, pdMS_TO_TICKS(20));  // Arranque del SAR
+  for (uint32_t got = 0; !done && got < maxSamples;) {
+    if (i2s_read(FEEDBACK_I2S, buf, sizeof(buf), &bytes, pdMS_TO_TICKS(100)) != ESP_OK || bytes == 0) break;
+    size_t n = bytes / sizeof(buf[0]);
+    for (size_t i = 0; i + 1 < n && !done; i += 2) {
+      done = sink(buf[i + 1] & 0x0FFF) || sink(buf[i] & 0x0FFF);
+    }
+    got += n;
+  }
+  i2s_adc_disable(FEEDBACK_I2S);
+  adc1_get_raw(channel);  // Devuelve ADC1 al controlador RTC que usa analogRead
+  return done;
+}
+
+// Hasta dos ventanas: la primera desde begin() solo mide la continua
+bool AcousticMonitor::capture(float freqHz) {
+  if (freqHz != _detector.frequency() && !_detector.tune(freqHz, _sampleHz, FEEDBACK_WINDOW_SAMPLES)) return false;
+  _detector.restart();
+  return readAdc1(_channel, 2u * GOERTZEL_MAX_SAMPLES, [this](uint16_t raw) { return _detector.push(raw); });
+}
+
+// Un bloque seguido: ADC1 queda tomado size / fs (53 ms con 2048)
+void AcousticMonitor::serviceSpectrum() {
+  std::lock_guard<std::mutex> lock(_spectrumMtx);
+  if (!_spectrum.isConfigured()) return;
+  int16_t* dst = _spectrum.input();
+  uint16_t size = _spectrum.getSize(), filled = 0;
+  bool ok = readAdc1(_channel, 2u * size, [&](uint16_t raw) {
+    dst[filled++] = (int16_t)(((int32_t)raw - 2048) << 4);  // 12 bits a Q15
+    return filled == size;
+  });
+  if (ok) _spectrum.process();
+}
+
+bool AcousticMonitor::startSpectrum(uint16_t size, uint8_t averages) {
+  if (!_available) return false;
+  std::lock_guard<std::mutex> lock(_spectrumMtx);
+  return _spectrum.configure(size, _sampleHz, averages);
+}
+
+void AcousticMonitor::stopSpectrum() {
+  std::lock_guard<std::mutex> lock(_spectrumMtx);
+  _spectrum.release();
+}
+
+bool AcousticMonitor::isSpectrumOn() const {
+  std::lock_guard<std::mutex> lock(_spectrumMtx);
+  return _spectrum.isConfigured();
+}
+
+uint8_t AcousticMonitor::readSpectrum(uint8_t* bands, uint8_t count, SpectrumInfo& info) const {
+  std::lock_guard<std::mutex> lock(_spectrumMtx);
+  info.sequence = _spectrum.getSequence();
+  info.size = _spectrum.getSize();
+  info.averages = _spectrum.getAverages();
+  info.sampleHz = _spectrum.getSampleHz();
+  uint8_t n = info.sequence ? _spectrum.encode(bands, count) : 0;
+  info.bandHz = n ? _spectrum.binHz() * (info.size / 2) / n : 0.0f;
+  return n;
+}
+
+void AcousticMonitor::judge(const GoertzelResult& r, float level, bool learn) {
+  _last = r;
+  _windows++;
+  float mv = r.amplitude * 3300.0f / 4095.0f;  // Cuentas de 12 bits a mV
+  _toneMv->set(static_cast<int32_t>(mv));
+  _snrDb->set(static_cast<int32_t>(r.snrDb));
+
+  if (r.rms < FEEDBACK_MIN_RMS || r.mean < 32.0f || r.mean > 4063.0f) {
+    setStatus(FeedbackStatus::NO_INPUT);
+    return;
+  }
+  if (level < FEEDBACK_MIN_LEVEL) return;
+  if (r.snrDb < FEEDBACK_MIN_SNR_DB) {
+    setStatus(FeedbackStatus::SILENT);
+    return;
+  }
+
+  _lastDb = 20.0f * log10f(mv / level);
+  uint8_t bin = _loadBin;
+  if (bin >= SYNTH_LOAD_BINS) {
+    setStatus(FeedbackStatus::OK);
+    return;
+  }
+  float learned;
+  if (getBinResponse(bin, learned) && _lastDb < learned - FEEDBACK_WEAK_DB) {
+    setStatus(FeedbackStatus::WEAK);
+    return;
+  }
+  setStatus(FeedbackStatus::OK);
+
+  // Media móvil por bin; solo tono continuo, las ráfagas bajan el pico medio
+  if (!learn) return;
+  uint16_t n = _binWindows[bin];
+  if (n < FEEDBACK_LEARN_WINDOWS) {
+    _binDb[bin] = (_binDb[bin] * n + _lastDb) / (n + 1);
+    _binWindows[bin] = n + 1;
+    if (n + 1 == FEEDBACK_LEARN_WINDOWS) LOG_I(">> Retorno bin %u: %.1f dB", bin, _binDb[bin]);
+  } else {
+    _binDb[bin] += (_lastDb - _binDb[bin]) / FEEDBACK_LEARN_WINDOWS;
+    if (_binWindows[bin] < 0xFFFF) _binWindows[bin]++;
+  }
+}
+
+// Un estado nuevo necesita FEEDBACK_CONFIRM ventanas seguidas que lo digan
+void AcousticMonitor::setStatus(FeedbackStatus candidate) {
+  if (candidate != _candidate) {
+    _candidate = candidate;
+    _candidateCount = 0;
+  }
+  if (_candidateCount < FEEDBACK_CONFIRM) _candidateCount++;
+  if (_candidateCount < FEEDBACK_CONFIRM || candidate == _status) return;
+
+  _status = candidate;
+  if (candidate != FeedbackStatus::OK) {
+    _faults->inc();
+    LOG_W(">> Retorno acústico: %s (%.1f Hz, SNR %.1f dB)", statusName(candidate), _lastHz, _last.snrDb);
+  }
+}
+
+bool AcousticMonitor::getBinResponse(uint8_t bin, float& db) const {
+  if (bin >= SYNTH_LOAD_BINS || _binWindows[bin] < FEEDBACK_LEARN_WINDOWS) return false;
+  db = _binDb[bin];
+  return true;
+}
+
+void AcousticMonitor::clearResponse() {
+  for (uint8_t i = 0; i < SYNTH_LOAD_BINS; i++) {
+    _binDb[i] = 0.0f;
+    _binWindows[i] = 0;
+  }
+}
+
+const char* AcousticMonitor::statusName(FeedbackStatus status) {
+  switch (status) {
+    case FeedbackStatus::OK:       return "OK";
+    case FeedbackStatus::WEAK:     return "débil";
+    case FeedbackStatus::SILENT:   return "sin tono (tweeter o relé)";
+    case FeedbackStatus::NO_INPUT: return "sin entrada (micrófono)";
+    default:                       return "sin datos";
+  }
+}
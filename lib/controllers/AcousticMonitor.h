@@ -0,0 +1,137 @@
+#pragma once
+
+#include <Arduino.h>
+#include "driver/adc.h"
+#include "AcousticInjector.h"
+#include "GoertzelDetector.h"
+#include "SpectrumAnalyzer.h"
+#include "SynthTuningTable.h"
+#include "Metrics.h"
+#include <mutex>
+
+/*
+ * Retorno acústico: un micrófono o sensor de presión en el conducto, en un
+ * pin libre de ADC1, muestreado por I2S (DMA) mientras la ISR sintetiza. Un
+ * GoertzelDetector sintonizado a la frecuencia real del inyector confirma
+ * que sale tono, detecta tweeter muerto o relé abierto y guarda la
+ * respuesta del conducto por bin de carga.
+ *
+ * La captura va por ventanas cortas: mientras el I2S tiene ADC1, MAP y TPS
+ * no se pueden leer (adc1Mutex()), así que cada FEEDBACK_PERIOD_MS se toma
+ * ADC1 solo FEEDBACK_WINDOW_SAMPLES muestras (~10 ms).
+ *
+ * Con el espectro en marcha, la misma tarea captura además un bloque seguido
+ * por vuelta para SpectrumAnalyzer, suene o no el inyector: Helmholtz,
+ * armónicos de la tabla y silbido del turbo. Ese bloque retiene ADC1 más
+ * (53 ms con 2048 muestras): es una herramienta de ajuste, no de marcha.
+ */
+
+constexpr uint32_t FEEDBACK_SAMPLE_HZ      = 40000;  ///< Nominal; begin() mide la real
+constexpr uint16_t FEEDBACK_WINDOW_SAMPLES = 400;    ///< Se ajusta a periodos enteros del tono
+constexpr uint32_t FEEDBACK_PERIOD_MS      = 100;    ///< Una ventana cada tanto mientras suena
+constexpr float    FEEDBACK_MIN_LEVEL      = 0.1f;   ///< Por debajo no se juzga
+constexpr float    FEEDBACK_MIN_SNR_DB     = 6.0f;   ///< Menos: no hay tono en el conducto
+constexpr float    FEEDBACK_WEAK_DB        = 10.0f;  ///< Caída frente a lo aprendido en el bin
+constexpr float    FEEDBACK_MIN_RMS        = 0.5f;   ///< Cuentas: entrada muerta (ni ruido)
+constexpr uint8_t  FEEDBACK_CONFIRM        = 3;      ///< Ventanas seguidas para cambiar de estado
+constexpr uint16_t FEEDBACK_LEARN_WINDOWS  = 8;      ///< Ventanas para dar un bin por aprendido
+
+/// Cabecera del último espectro publicado
+struct SpectrumInfo {
+  uint32_t sequence = 0;  ///< Espectros publicados; 0 = aún ninguno
+  uint16_t size = 0;
+  uint8_t  averages = 0;
+  float    sampleHz = 0.0f;
+  float    bandHz = 0.0f;  ///< Ancho de cada banda del resumen
+};
+
+/// Veredicto de las últimas ventanas con el inyector sonando
+enum class FeedbackStatus : uint8_t {
+  UNKNOWN,    ///< Aún sin ventanas que juzgar
+  OK,         ///< Tono presente
+  WEAK,       ///< Tono, pero FEEDBACK_WEAK_DB por debajo de lo aprendido en ese bin
+  SILENT,     ///< Sin tono: tweeter muerto, relé abierto o DAC parado
+  NO_INPUT,   ///< Entrada plana o saturada: micrófono desconectado
+};
+
+class AcousticMonitor {
+public:
+  /**
+   * Configura el I2S en modo ADC sobre el pin y mide la frecuencia de
+   * muestreo real.
+   * @param micPin Pin de ADC1 (32–39) libre.
+   * @return false si el pin no es de ADC1 o el I2S no arranca.
+   */
+  bool begin(uint8_t micPin, const AcousticInjector* injector);
+  bool isAvailable() const { return _available; }
+
+  /// Desde una tarea de baja prioridad cada FEEDBACK_PERIOD_MS: una ventana si suena
+  void service();
+
+  /// Bin de carga vigente (ActuatorManager), para la respuesta por bin
+  void noteLoadBin(uint8_t bin) { _loadBin = bin; }
+
+  FeedbackStatus getStatus() const { return _status; }
+  static const char* statusName(FeedbackStatus status);
+  const GoertzelResult& getLast() const { return _last; }
+  float getLastFrequency() const { return _lastHz; }
+  /// Respuesta de la última ventana: dB de mV de tono por unidad de nivel
+  float getLastResponseDb() const { return _lastDb; }
+  float getSampleHz() const { return _sampleHz; }
+  /// Ventanas juzgadas desde begin()
+  uint32_t getWindows() const { return _windows; }
+
+  /**
+   * Respuesta media del conducto en un bin.
+   * @return false si el bin aún no tiene FEEDBACK_LEARN_WINDOWS ventanas.
+   */
+  bool getBinResponse(uint8_t bin, float& db) const;
+  uint16_t getBinWindows(uint8_t bin) const { return bin < SYNTH_LOAD_BINS ? _binWindows[bin] : 0; }
+  void clearResponse();
+
+  /**
+   * Espectro por bloques de size muestras, promediando averages bloques.
+   * @return false sin micrófono o con un tamaño que no vale (fftValidSize).
+   */
+  bool startSpectrum(uint16_t size, uint8_t averages);
+  /// Para el espectro y libera sus buffers
+  void stopSpectrum();
+  bool isSpectrumOn() const;
+  /**
+   * Último espectro en bandas de un byte (SpectrumAnalyzer::encode).
+   * @return Bandas escritas; 0 si aún no hay espectro.
+   */
+  uint8_t readSpectrum(uint8_t* bands, uint8_t count, SpectrumInfo& info) const;
+
+private:
+  static constexpr uint8_t NO_BIN = 0xFF;
+
+  bool capture(float freqHz);
+  void serviceSpectrum();
+  void judge(const GoertzelResult& r, float level, bool learn);
+  void setStatus(FeedbackStatus candidate);
+
+  const AcousticInjector* _injector = nullptr;
+  adc1_channel_t _channel = ADC1_CHANNEL_0;
+  bool  _available = false;
+  float _sampleHz = FEEDBACK_SAMPLE_HZ;
+  GoertzelDetector _detector;
+  SpectrumAnalyzer _spectrum;
+  mutable std::mutex _spectrumMtx;  ///< La tarea publica, la consola lee
+
+  volatile uint8_t _loadBin = NO_BIN;
+  FeedbackStatus _status = FeedbackStatus::UNKNOWN;
+  FeedbackStatus _candidate = FeedbackStatus::UNKNOWN;
+  uint8_t  _candidateCount = 0;
+  GoertzelResult _last;
+  float    _lastHz = 0.0f;
+  float    _lastDb = 0.0f;
+  uint32_t _windows = 0;
+
+  float    _binDb[SYNTH_LOAD_BINS] = {};
+  uint16_t _binWindows[SYNTH_LOAD_BINS] = {};
+
+  Gauge*   _toneMv = &MetricsRegistry::getInstance().gauge("acoustic.feedback_mv");    // pico del tono
+  Gauge*   _snrDb  = &MetricsRegistry::getInstance().gauge("acoustic.feedback_snr");   // dB
+  Counter* _faults = &MetricsRegistry::getInstance().counter("acoustic.feedback_faults");  // pasos a WEAK/SILENT/NO_INPUT
+};
@@ -1,8 +1,9 @@
 #include "ActuatorManager.h"
 
-void ActuatorManager::begin(uint8_t turboRelayPin, uint8_t acousticDacPin, uint8_t acousticRelayPin) {
+void ActuatorManager::begin(uint8_t turboRelayPin, uint8_t acousticDacPin, uint8_t acousticRelayPin, uint8_t feedbackPin) {
   vortex.begin(turboRelayPin);
   injector.begin(acousticDacPin, acousticRelayPin);
+  if (feedbackPin != 0xFF) monitor.begin(feedbackPin, &injector);
 
   // Apagar ambos al inicio
   vortex.stop();
@@ -22,6 +23,7 @@ void ActuatorManager::startVortex() {
 void ActuatorManager::stopAll() {
   vortex.stop();
   injector.stop();
+  thermal.off(millis());
 }
 
 void ActuatorManager::stopVortex() {
@@ -37,20 +39,50 @@ bool ActuatorManager::isTurboOn() const {
 }
 
 void ActuatorManager::startAcoustic(float level) {
-  injector.start(level);
+  injector.start(thermal.apply(millis(), level, modulationDuty(modulation)));
 }
 
 void ActuatorManager::stopAcoustic() {
   injector.stop();
+  thermal.off(millis());
 }
 
-void ActuatorManager::setAcousticParameters(float level, float mapLoadPercent) {
-  float freq = AcousticInjector::mapLoadToWaveFrequency(mapLoadPercent);
-  injector.updateWaveFrequency(freq);
-  injector.setLevel(level);
-  
+// Cada 20 ms en INYECCION_ACUSTICA: solo se toca el timer si cambia el bin de
+// carga, y los moduladores si cambia la modulación. El nivel pasa por la
+// ecualización y después por el límite térmico
+void ActuatorManager::setAcousticParameters(float level, float mapLoadPercent, const AcousticModulation& mod) {
+  if (mod != modulation) {
+    modulation = mod;
+    injector.setModulation(mod);
+  }
+  uint8_t bin = SynthTuningTable::binForLoad(mapLoadPercent);
+  if (bin != loadBin) {
+    loadBin = bin;
+    injector.setSamplePeriod(tuning.periodUs(bin), tuning.frequencyHz(bin));
+    monitor.noteLoadBin(bin);
+  }
+  float allowed = thermal.apply(millis(), level * tuning.gain(bin), modulationDuty(modulation));
+  injector.setLevel(allowed);
+
+  coilRise->set(static_cast<int32_t>(thermal.getRise() * 10.0f));
+  thermalLimit->set(static_cast<int32_t>(thermal.maxLevel(modulationDuty(modulation)) * 1000.0f));
+  if (thermal.isLimiting()) thermalCycles->inc();
+}
+
+void ActuatorManager::setActuationMap(const ActuationMap& map) {
+  tuning.build(map, AcousticInjector::TABLE_SIZE);
+  tuning.applyEq(eq);
+  loadBin = NO_BIN;  // El mismo bin puede ir ahora a otra frecuencia
+}
+
+void ActuatorManager::setEqualization(const AcousticEqData& table) {
+  eq = table;
+  tuning.applyEq(eq);
 }
 
+bool ActuatorManager::setOscillator(uint8_t index, float freqHz, float level, float phaseDeg) {
+  return injector.setOscillator(index, freqHz, level, phaseDeg);
+}
 
 bool ActuatorManager::isAcousticOn() const {
   return injector.isActive();
@@ -63,3 +95,17 @@ VortexController& ActuatorManager::getVortexController() {
 AcousticInjector& ActuatorManager::getAcousticInjector() {
   return injector;
 }
+
+// La tarea del monitor mide mientras test() suena; aquí solo se lee el veredicto
+AcousticSelfTest ActuatorManager::selfTest() {
+  AcousticSelfTest t;
+  uint32_t before = monitor.getWindows();
+  injector.test();
+  t.verified = monitor.isAvailable();
+  if (!t.verified) return t;
+  t.measured = monitor.getWindows() - before >= FEEDBACK_CONFIRM;
+  t.status = monitor.getStatus();
+  t.last = monitor.getLast();
+  t.freqHz = monitor.getLastFrequency();
+  return t;
+}
@@ -2,34 +2,81 @@
 
 #include "VortexController.h"
 #include "AcousticInjector.h"
+#include "AcousticMonitor.h"
+#include "ActuatorControl.h"
+#include "SynthTuningTable.h"
+#include "TweeterThermal.h"
+#include "Metrics.h"
 
-class ActuatorManager {
+/// Resultado de ActuatorManager::selfTest(); lo imprime quien lo pidió
+struct AcousticSelfTest {
+  bool verified = false;  ///< Había micrófono de retorno
+  bool measured = false;  ///< El monitor juzgó ventanas mientras sonaba
+  FeedbackStatus status = FeedbackStatus::UNKNOWN;
+  GoertzelResult last;    ///< Última ventana juzgada
+  float freqHz = 0.0f;    ///< Frecuencia a la que se midió
+
+  /// false si el monitor no oyó el tono; true sin monitor
+  bool passed() const { return !verified || (measured && status == FeedbackStatus::OK); }
+};
+
+class ActuatorManager : public ActuatorControl {
 public:
   ActuatorManager() = default;
 
-  // Inicializa ambos actuadores con sus pines respectivos
-  void begin(uint8_t turboRelayPin, uint8_t acousticDacPin, uint8_t acousticRelayPin);
+  // Inicializa ambos actuadores con sus pines respectivos; sin micrófono de
+  // retorno (0xFF) no hay monitor acústico
+  void begin(uint8_t turboRelayPin, uint8_t acousticDacPin, uint8_t acousticRelayPin, uint8_t feedbackPin = 0xFF);
 
   // Actualiza lógica interna (por ejemplo, rampas, timers)
-  void update();
+  void update() override;
 
   void stopAll();
   // Control Vortex
-  void startVortex();
-  void stopVortex();
+  void startVortex() override;
+  void stopVortex() override;
   bool isTurboOn() const;
   void setVortexLevel(float level);
 
   // Control Acoustic Injector
-  void startAcoustic(float level);
-  void stopAcoustic();
-  void setAcousticParameters(float level, float mapLoadPercent);
-  bool isAcousticOn() const;
+  void startAcoustic(float level) override;
+  void stopAcoustic() override;
+  void setAcousticParameters(float level, float mapLoadPercent, const AcousticModulation& modulation) override;
+  bool isAcousticOn() const override;
+  void setActuationMap(const ActuationMap& map) override;
+  // Ecualización del tweeter (ConfigStore); se aplica al nivel según la frecuencia
+  void setEqualization(const AcousticEqData& eq);
+  const AcousticEqData& getEqualization() const { return eq; }
+
+  // Temperatura estimada de la bobina; limita el nivel que llega al inyector
+  const TweeterThermal& getThermal() const { return thermal; }
+
+  // Micrófono de retorno: tono presente y respuesta del conducto por bin de carga
+  AcousticMonitor& getMonitor() { return monitor; }
+  float getLoadBinFrequency(uint8_t bin) const { return tuning.frequencyHz(bin); }
+  /// Prueba del inyector (AcousticInjector::test) juzgada por el monitor
+  AcousticSelfTest selfTest();
+
+  // Osciladores de la salida aditiva (el 0 sigue a la carga MAP)
+  bool setOscillator(uint8_t index, float freqHz, float level, float phaseDeg = 0.0f);
+  uint8_t getOscillatorCount() const { return AcousticInjector::OSCILLATORS; }
 
   VortexController& getVortexController();
   AcousticInjector& getAcousticInjector();
 
 private:
+  static constexpr uint8_t NO_BIN = 0xFF;
+
   VortexController vortex;
   AcousticInjector injector;
+  SynthTuningTable tuning;
+  uint8_t loadBin = NO_BIN;  ///< Último bin aplicado al inyector
+  AcousticModulation modulation;  ///< Última modulación aplicada al inyector
+  AcousticEqData eq;
+  TweeterThermal thermal;
+  AcousticMonitor monitor;
+
+  Gauge*   coilRise      = &MetricsRegistry::getInstance().gauge("acoustic.coil_rise");   // décimas de °C sobre ambiente
+  Gauge*   thermalLimit  = &MetricsRegistry::getInstance().gauge("acoustic.thermal_limit");  // nivel máximo, ‰
+  Counter* thermalCycles = &MetricsRegistry::getInstance().counter("acoustic.thermal_limited");  // ciclos recortados
 };
@@ -0,0 +1,31 @@
+#include "AdditiveSynth.h"
+#include <math.h>
+
+void additiveFillTable(int8_t* table) {
+  for (uint16_t i = 0; i < ADDITIVE_TABLE_SIZE; ++i) {
+    table[i] = (int8_t)lroundf(127.0f * sinf(2.0f * (float)M_PI * i / ADDITIVE_TABLE_SIZE));
+  }
+}
+
+uint32_t additiveIncrement(float freqHz, uint32_t sampleHz) {
+  if (!(freqHz > 0.0f) || freqHz >= sampleHz / 2.0f) return 0;
+  return (uint32_t)((double)freqHz / sampleHz * 4294967296.0 + 0.5);
+}
+
+float additiveFrequency(uint32_t increment, uint32_t sampleHz) {
+  return (float)(increment * (double)sampleHz / 4294967296.0);
+}
+
+uint32_t additivePhase(float degrees) {
+  double turns = degrees / 360.0;
+  turns -= floor(turns);
+  return (uint32_t)(turns * 4294967296.0);
+}
+
+uint16_t additiveGain(const uint8_t* levels, uint8_t count, uint8_t masterInt) {
+  uint32_t sum = 0;
+  for (uint8_t i = 0; i < count; ++i) sum += levels[i];
+  // 256 × 255 / sum: la suma de picos queda en ±127
+  uint32_t headroom = sum > 255 ? (256u * 255u) / sum : 256u;
+  return (uint16_t)((headroom * masterInt + 127) / 255);
+}
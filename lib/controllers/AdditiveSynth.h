@@ -0,0 +1,96 @@
+#pragma once
+
+#include <stdint.h>
+#include "SynthModulator.h"
+
+/*
+ * Síntesis aditiva para el inyector acústico: N osciladores DDS (acumulador
+ * de fase de 32 bits) sumados en punto fijo a una frecuencia de muestreo
+ * fija. Permite mezclar, por ejemplo, la resonancia de Helmholtz de la
+ * cavidad (~484 Hz) con la portadora forzada (4.2–6.4 kHz), cosa que la ISR
+ * de la tabla, cuya frecuencia de muestreo es 16 × la del tono, no puede.
+ *
+ * Igual que SynthKernel.h, todo lo que corre por muestra es inline para que
+ * quede en IRAM junto a la ISR, y el estado es un único objeto para DRAM.
+ */
+
+/// Osciladores compilados en el firmware (la ISR los recorre todos)
+#ifndef VORTEX_SYNTH_OSCILLATORS
+#define VORTEX_SYNTH_OSCILLATORS 4
+#endif
+
+constexpr uint32_t ADDITIVE_SAMPLE_HZ  = 50000;  ///< Alarma de 20 µs del timer 2
+constexpr uint16_t ADDITIVE_TABLE_SIZE = 256;    ///< Índice: los 8 bits altos de la fase
+constexpr float    HELMHOLTZ_HZ        = 484.0f; ///< Resonancia de la cavidad (informe técnico)
+
+/**
+ * @struct AdditiveOscillator
+ * Un oscilador. increment y level los escribe la tarea; phase solo la ISR
+ * (o la tarea con la ISR parada).
+ */
+struct AdditiveOscillator {
+  uint32_t phase = 0;               ///< 2^32 = un periodo
+  volatile uint32_t increment = 0;  ///< additiveIncrement()
+  volatile uint8_t  level = 0;      ///< 0–255
+};
+
+/**
+ * @struct AdditiveState
+ * Estado completo del motor aditivo.
+ * @tparam N Número de osciladores, fijo al compilar.
+ */
+template <uint8_t N>
+struct AdditiveState {
+  int8_t  table[ADDITIVE_TABLE_SIZE] = {};  ///< additiveFillTable()
+  AdditiveOscillator osc[N];
+  volatile uint16_t gain = 0;      ///< Q8 (256 = 1): nivel general × margen, additiveGain()
+  volatile uint32_t clipped = 0;   ///< Muestras saturadas
+  SynthModState mod;               ///< Ráfagas y AM sobre la mezcla; chirp sobre el oscilador 0
+};
+
+/// Un periodo de seno con signo (±127)
+void additiveFillTable(int8_t* table);
+
+/// Incremento de fase para freqHz a sampleHz; 0 si no cabe bajo Nyquist
+uint32_t additiveIncrement(float freqHz, uint32_t sampleHz = ADDITIVE_SAMPLE_HZ);
+
+/// Frecuencia que sale de verdad con un incremento
+float additiveFrequency(uint32_t increment, uint32_t sampleHz = ADDITIVE_SAMPLE_HZ);
+
+/// Grados (cualquier signo) a fase del acumulador
+uint32_t additivePhase(float degrees);
+
+/**
+ * Ganancia general en Q8. Si los niveles suman más de 255, los picos
+ * alineados de todos los osciladores podrían salirse del DAC: la mezcla se
+ * atenúa para que el peor caso quepa, y el nivel general escala encima.
+ * @param levels    Nivel de cada oscilador, 0–255.
+ * @param masterInt Nivel general 0–255 (synthLevelInt()).
+ */
+uint16_t additiveGain(const uint8_t* levels, uint8_t count, uint8_t masterInt);
+
+/**
+ * Una muestra de la mezcla para el DAC de 8 bits. Con la ganancia de
+ * additiveGain() no satura; si se fuerza otra, recorta y cuenta en clipped.
+ */
+template <uint8_t N>
+static inline __attribute__((always_inline)) uint8_t additiveStep(AdditiveState<N>& s) {
+  synthModChirp(s.mod, s.osc[0].increment);
+  int32_t gain = (int32_t)((s.gain * synthModStep(s.mod)) >> 16);
+  int32_t acc = 0;
+  for (uint8_t i = 0; i < N; ++i) {
+    AdditiveOscillator& o = s.osc[i];
+    acc += s.table[o.phase >> 24] * (int32_t)o.level;
+    o.phase += o.increment;
+  }
+  // |acc| <= 127 × 255 × N; por 2^16 de ganancia cabe en 32 bits hasta N = 16
+  int32_t out = (acc * gain) >> 16;
+  if (out > 127 || out < -128) {
+    out = out > 127 ? 127 : -128;
+    s.clipped = s.clipped + 1;
+  }
+  return (uint8_t)(128 + out);
+}
+
+static_assert(VORTEX_SYNTH_OSCILLATORS >= 1 && VORTEX_SYNTH_OSCILLATORS <= 16,
+              "VORTEX_SYNTH_OSCILLATORS entre 1 y 16");
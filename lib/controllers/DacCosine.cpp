@@ -0,0 +1,38 @@
+#include "DacCosine.h"
+#include <math.h>
+
+float cwToneFrequency(uint16_t freqStep, uint8_t clkDiv, float rtc8mHz) {
+  return rtc8mHz / (1.0f + clkDiv) * freqStep / 65536.0f;
+}
+
+CwToneSettings cwToneForFrequency(float freqHz, float rtc8mHz, uint8_t maxClkDiv) {
+  if (maxClkDiv > CW_MAX_CLK_DIV) maxClkDiv = CW_MAX_CLK_DIV;
+  CwToneSettings best;
+  for (uint8_t div = 0; div <= maxClkDiv; ++div) {
+    float stepHz = cwToneFrequency(1, div, rtc8mHz);
+    float step = roundf(freqHz / stepHz);
+    if (step < 1.0f) step = 1.0f;
+    if (step > 65535.0f) step = 65535.0f;
+
+    CwToneSettings s;
+    s.freqStep = static_cast<uint16_t>(step);
+    s.clkDiv = div;
+    s.realHz = cwToneFrequency(s.freqStep, div, rtc8mHz);
+    s.errorHz = s.realHz - freqHz;
+    if (best.freqStep == 0 || fabsf(s.errorHz) < fabsf(best.errorHz)) best = s;
+  }
+  return best;
+}
+
+uint8_t cwScaleForLevel(float level) {
+  // Cortes en la media geométrica de escalas vecinas; el último, a media 1/8
+  if (level >= 0.7071f) return 0;
+  if (level >= 0.3536f) return 1;
+  if (level >= 0.1768f) return 2;
+  if (level >= 0.0625f) return 3;
+  return CW_SCALE_OFF;
+}
+
+float cwScaleAmplitude(uint8_t scale) {
+  return scale < CW_SCALE_COUNT ? 1.0f / static_cast<float>(1u << scale) : 0.0f;
+}
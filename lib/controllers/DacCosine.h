@@ -0,0 +1,51 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Cálculo de registros del generador de coseno del DAC del ESP32, separado
+ * del driver para poder revisarlo en el host (vortex_sweep --coseno).
+ *
+ * El generador no usa CPU: una vez programado, el DAC saca un coseno de
+ *
+ *   f = RTC8M / (1 + CK8M_DIV_SEL) * SW_FSTEP / 65536
+ *
+ * con amplitud fija a escala completa, 1/2, 1/4 o 1/8 (DAC_SCALE). RTC8M
+ * ronda los 8.5 MHz pero varía entre chips; conviene medirlo (rtc_clk_cal).
+ */
+
+constexpr float   CW_RTC8M_NOMINAL_HZ = 8500000.0f;
+constexpr uint8_t CW_MAX_CLK_DIV      = 7;     ///< RTC_CNTL_CK8M_DIV_SEL es de 3 bits
+constexpr uint8_t CW_SCALE_COUNT      = 4;     ///< DAC_SCALE: 1, 1/2, 1/4, 1/8
+constexpr uint8_t CW_SCALE_OFF        = 0xFF;  ///< Nivel demasiado bajo: generador apagado
+
+/**
+ * @struct CwToneSettings
+ * Valores de registro para una frecuencia y lo que sale con ellos.
+ */
+struct CwToneSettings {
+  uint16_t freqStep = 0;  ///< SENS_SW_FSTEP; 0 = sin calcular
+  uint8_t  clkDiv = 0;    ///< RTC_CNTL_CK8M_DIV_SEL
+  float    realHz = 0.0f;
+  float    errorHz = 0.0f;  ///< realHz - pedida
+};
+
+/// Frecuencia que produce un par paso/divisor
+float cwToneFrequency(uint16_t freqStep, uint8_t clkDiv, float rtc8mHz);
+
+/**
+ * Paso y divisor más cercanos a la frecuencia pedida. A igual error gana el
+ * divisor menor, que deja el reloj del RTC como estaba.
+ * @param rtc8mHz   Reloj RTC8M medido (o CW_RTC8M_NOMINAL_HZ).
+ * @param maxClkDiv Divisor más alto que se puede tocar (0 = no tocarlo).
+ */
+CwToneSettings cwToneForFrequency(float freqHz, float rtc8mHz, uint8_t maxClkDiv);
+
+/**
+ * Escala más cercana (en dB) a un nivel 0–1.
+ * @return 0–3, o CW_SCALE_OFF por debajo de la mitad de 1/8.
+ */
+uint8_t cwScaleForLevel(float level);
+
+/// Amplitud relativa de una escala (0 para CW_SCALE_OFF)
+float cwScaleAmplitude(uint8_t scale);
@@ -0,0 +1,217 @@
+#pragma once
+
+#include <stdint.h>
+#include "SynthModulator.h"
+
+/*
+ * Aritmética por muestra del inyector acústico, separada del driver para
+ * poder medirla en el host. Todo es inline: dentro de una ISR IRAM_ATTR
+ * el código queda en IRAM junto con ella.
+ */
+
+constexpr uint8_t SYNTH_TABLE_SIZE = 16;
+constexpr float   SYNTH_RAMP_ALPHA = 0.9f;     ///< Suavizado del nivel por llamada a update()
+constexpr uint32_t SYNTH_TIMER_HZ  = 1000000;  ///< Timer 2 con prescaler 80: tick de 1 µs
+
+/// Un periodo de seno, centrado en 128 (0–255)
+static const uint8_t SYNTH_SINE_TABLE[SYNTH_TABLE_SIZE] = {
+  128, 176, 218, 245, 255, 245, 218, 176,
+  128, 80, 38, 11, 1, 11, 38, 80
+};
+
+/**
+ * Escala una muestra de la tabla (centrada en 128) por el nivel.
+ * @param raw      Muestra 0–255 de la tabla.
+ * @param levelInt Nivel 0–255.
+ * @return Valor para el DAC de 8 bits.
+ */
+static inline __attribute__((always_inline)) uint8_t synthSample(uint8_t raw, uint8_t levelInt) {
+  // |delta| <= 128 y levelInt <= 255: el resultado queda en 0–254, sin saturar
+  int16_t delta = (int16_t)raw - 128;
+  return (uint8_t)(128 + ((delta * levelInt) >> 8));
+}
+
+/**
+ * Como synthSample(), pero arrastra el resto del escalado a la muestra
+ * siguiente (realimentación del error, primer orden). El ruido de
+ * cuantización se desplaza hacia Nyquist, lejos de la portadora, y a niveles
+ * bajos deja de ser distorsión de la forma de onda. Con errMask = 0 el
+ * resultado es el de synthSample().
+ * @param err     Resto de la muestra anterior, en 1/256 de LSB; se actualiza.
+ * @param errMask 0xFF con el conformado de ruido, 0 sin él.
+ */
+static inline __attribute__((always_inline)) uint8_t synthSampleShaped(uint8_t raw, uint8_t levelInt,
+                                                                      uint8_t& err, uint8_t errMask) {
+  // Entre -32640 y 32640: cabe en 16 bits y el resultado sigue en 0–255
+  int16_t acc = (int16_t)(((int16_t)raw - 128) * levelInt + err);
+  err = (uint8_t)(acc & errMask);
+  return (uint8_t)(128 + (acc >> 8));
+}
+
+/// Siguiente índice de una tabla de tableSize muestras
+static inline __attribute__((always_inline)) uint8_t synthNextIndex(uint8_t index, uint8_t tableSize) {
+  return (uint8_t)((index + 1) % tableSize);
+}
+
+static_assert((SYNTH_TABLE_SIZE & (SYNTH_TABLE_SIZE - 1)) == 0, "La ISR avanza el índice con máscara");
+constexpr uint8_t SYNTH_INDEX_MASK = SYNTH_TABLE_SIZE - 1;
+
+/// Fase en 1/256 de periodo: cada paso de la tabla son SYNTH_PHASE_SUBSTEPS
+constexpr uint8_t SYNTH_PHASE_SUBSTEPS = 256 / SYNTH_TABLE_SIZE;
+
+/**
+ * Muestra de una tabla de N muestras en cualquier fase (1/256 de periodo,
+ * 1.4°), interpolando entre las dos muestras vecinas.
+ */
+template <uint8_t N>
+static inline __attribute__((always_inline)) uint8_t synthTableAt(const uint8_t (&table)[N], uint8_t phase) {
+  constexpr uint8_t substeps = 256 / N;
+  uint8_t i = phase / substeps;
+  int16_t frac = phase % substeps;
+  int16_t a = table[i];
+  int16_t b = table[(i + 1) & (N - 1)];
+  return (uint8_t)(a + (b - a) * frac / substeps);
+}
+
+/// Desfase en grados (cualquier signo) a la escala de synthTableAt()
+static inline uint8_t synthPhaseFromDegrees(float degrees) {
+  float turns = degrees / 360.0f;
+  turns -= (float)(int32_t)turns;
+  if (turns < 0.0f) turns += 1.0f;
+  return (uint8_t)((int32_t)(turns * 256.0f + 0.5f) & 0xFF);
+}
+
+/**
+ * @struct SynthIsrStateT
+ * Todo lo que lee y escribe la ISR de la tabla, junto. En el firmware es un
+ * único objeto DRAM_ATTR: con la caché de flash apagada (escrituras en NVS)
+ * la ISR no toca nada fuera de IRAM/DRAM y sigue sonando.
+ *
+ * N es el tamaño de la tabla; el firmware usa SynthIsrState (N =
+ * SYNTH_TABLE_SIZE) y vortex_sweep instancia otros para compararlos.
+ */
+template <uint8_t N>
+struct SynthIsrStateT {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "La ISR avanza el índice con máscara");
+  static constexpr uint8_t TABLE_SIZE = N;
+
+  uint8_t  table[N] = {};                 ///< Copia de SYNTH_SINE_TABLE, que vive en flash
+  volatile uint32_t* dacReg = nullptr;    ///< RTC_IO_PAD_DACn_REG del canal
+  volatile uint8_t levelInt = 0;          ///< Lo escribe update()
+  volatile uint8_t shapeMask = 0;         ///< 0xFF: conformado de ruido activo (synthSampleShaped)
+  uint8_t  shapeErr = 0;
+  uint8_t  index = 0;
+  volatile uint8_t lastDAC = 128;
+
+  // Segundo canal (estéreo): misma fase que el primero más phaseOffset
+  volatile uint32_t* volatile dac2Reg = nullptr;  ///< nullptr = solo un canal; lo cambia la tarea
+  volatile uint8_t levelInt2 = 0;
+  volatile uint8_t phaseOffset = 0;       ///< 1/256 de periodo (synthPhaseFromDegrees)
+  uint8_t  shapeErr2 = 0;
+  volatile uint8_t lastDAC2 = 128;
+
+  SynthModState mod;                      ///< Ráfagas y AM sobre los dos canales
+
+  volatile bool resetMax = false;         ///< Lo pide la tarea; lo atiende la ISR
+  volatile bool inIsr = false;            ///< true mientras corre la ISR (stop() espera a que baje)
+  volatile uint32_t ticks = 0;            ///< Muestras emitidas
+  volatile uint32_t cycleSum = 0;         ///< Ciclos de CPU acumulados; usar diferencias
+  volatile uint32_t cycleMax = 0;
+};
+
+using SynthIsrState = SynthIsrStateT<SYNTH_TABLE_SIZE>;
+
+/// Campo de 8 bits del DAC en RTC_IO_PAD_DAC1_REG y RTC_IO_PAD_DAC2_REG (RTC_IO_PDACn_DAC_S)
+constexpr uint32_t SYNTH_DAC_SHIFT = 19;
+
+/// Una muestra de la tabla a un nivel ya modulado; avanza el índice
+template <uint8_t N>
+static inline __attribute__((always_inline)) uint8_t synthIsrEmit(SynthIsrStateT<N>& s, uint8_t levelInt) {
+  uint8_t out = synthSampleShaped(s.table[s.index], levelInt, s.shapeErr, s.shapeMask);
+  s.index = (uint8_t)((s.index + 1) & (N - 1));
+  s.lastDAC = out;
+  s.ticks = s.ticks + 1;
+  return out;
+}
+
+/// Una muestra de la tabla con máscara en el índice; devuelve el valor del DAC
+template <uint8_t N>
+static inline __attribute__((always_inline)) uint8_t synthIsrStep(SynthIsrStateT<N>& s) {
+  return synthIsrEmit(s, synthModScale(s.levelInt, synthModStep(s.mod)));
+}
+
+/**
+ * @struct SynthFrame
+ * Los dos canales de una misma muestra.
+ */
+struct SynthFrame {
+  uint8_t dac1;  ///< Canal principal
+  uint8_t dac2;  ///< Canal desfasado
+};
+
+/// Una muestra de los dos canales desde el mismo índice; avanza como synthIsrStep()
+template <uint8_t N>
+static inline __attribute__((always_inline)) SynthFrame synthStereoStep(SynthIsrStateT<N>& s) {
+  uint32_t env = synthModStep(s.mod);
+  uint8_t phase = (uint8_t)(s.index * (256 / N) + s.phaseOffset);
+  uint8_t second = synthSampleShaped(synthTableAt(s.table, phase), synthModScale(s.levelInt2, env),
+                                     s.shapeErr2, s.shapeMask);
+  s.lastDAC2 = second;
+  SynthFrame f;
+  f.dac1 = synthIsrEmit(s, synthModScale(s.levelInt, env));
+  f.dac2 = second;
+  return f;
+}
+
+/**
+ * Render intercalado [dac1, dac2, dac1, dac2, ...] de frames muestras, con
+ * la misma aritmética que la ISR. Para análisis en el host o un búfer DMA.
+ * @param out 2 × frames bytes.
+ */
+template <uint8_t N>
+static inline void synthStereoRender(SynthIsrStateT<N>& s, uint8_t* out, uint32_t frames) {
+  for (uint32_t i = 0; i < frames; ++i) {
+    SynthFrame f = synthStereoStep(s);
+    out[2 * i] = f.dac1;
+    out[2 * i + 1] = f.dac2;
+  }
+}
+
+/// Escritura directa del DAC, sin pasar por dac_output_voltage()
+static inline __attribute__((always_inline)) void synthDacWrite(volatile uint32_t* reg, uint8_t value) {
+  *reg = (*reg & ~(0xFFu << SYNTH_DAC_SHIFT)) | ((uint32_t)value << SYNTH_DAC_SHIFT);
+}
+
+/**
+ * Alarma del timer para que la tabla completa dure un periodo de freqHz.
+ * El timer cuenta µs enteros: la frecuencia real es
+ * SYNTH_TIMER_HZ / (periodo * tableSize), algo por encima de la pedida.
+ */
+static inline uint32_t synthTimerPeriodUs(float freqHz, uint8_t tableSize) {
+  return static_cast<uint32_t>(1e6 / (freqHz * tableSize));
+}
+
+/**
+ * Un paso de la rampa de nivel (filtro de primer orden hacia el objetivo).
+ * @param alpha Peso del nivel anterior; más alto es más lento.
+ */
+static inline float synthRampLevel(float level, float targetLevel, float alpha) {
+  return alpha * level + (1.0f - alpha) * targetLevel;
+}
+
+/// Nivel 0–1 en la escala entera que usa la ISR
+static inline uint8_t synthLevelInt(float level) {
+  return (uint8_t)(level * 255.0f);
+}
+
+/**
+ * Frecuencia de la onda completa según la carga MAP.
+ * @param mapLoadPercent Carga 0–100 %; fuera de rango se satura.
+ * @param freqMinHz Frecuencia a carga 0 %.
+ * @param freqMaxHz Frecuencia a carga 100 %.
+ */
+static inline float synthFrequencyForLoad(float mapLoadPercent, float freqMinHz, float freqMaxHz) {
+  if (mapLoadPercent < 0.0f) mapLoadPercent = 0.0f;
+  if (mapLoadPercent > 100.0f) mapLoadPercent = 100.0f;
+  return freqMinHz + (mapLoadPercent / 100.0f) * (freqMaxHz - freqMinHz);
+}
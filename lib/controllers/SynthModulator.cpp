@@ -0,0 +1,57 @@
+#include "SynthModulator.h"
+#include "SynthKernel.h"
+#include <math.h>
+#include <string.h>
+
+static_assert(SYNTH_MOD_TABLE_SIZE == SYNTH_TABLE_SIZE, "El AM interpola la tabla de 16");
+
+static uint32_t samplesFor(float ms, float sampleHz) {
+  float n = ms * sampleHz / 1000.0f + 0.5f;
+  return n < 1.0f ? 1 : (uint32_t)n;
+}
+
+static uint32_t ddsIncrement(float freqHz, float sampleHz) {
+  return (uint32_t)((double)freqHz / sampleHz * 4294967296.0 + 0.5);
+}
+
+void synthModConfigure(SynthModState& m, const AcousticModulation& cfg, float sampleHz) {
+  memcpy(m.table, SYNTH_SINE_TABLE, sizeof(m.table));
+  m.slew = SYNTH_MOD_UNITY / samplesFor(SYNTH_MOD_RAMP_MS, sampleHz);
+
+  // Las ráfagas cuentan desde el flanco: encender cuesta la rampa de subida
+  uint32_t on = samplesFor(cfg.burstOnMs, sampleHz);
+  uint32_t period = on + samplesFor(cfg.burstOffMs, sampleHz);
+  m.burstOn = on;
+  m.burstPeriod = period;
+  if (m.burstPos >= period) m.burstPos = 0;
+
+  float rate = cfg.amRateHz < 0.1f ? 0.1f : (cfg.amRateHz > 50.0f ? 50.0f : cfg.amRateHz);
+  float depth = cfg.amDepth < 0.0f ? 0.0f : (cfg.amDepth > 1.0f ? 1.0f : cfg.amDepth);
+  m.amIncrement = ddsIncrement(rate, sampleHz);
+  m.amDepth = (uint16_t)(depth * 256.0f + 0.5f);
+
+  uint32_t n = samplesFor(cfg.chirpMs, sampleHz);
+  uint32_t start = ddsIncrement(cfg.chirpStartHz, sampleHz);
+  uint32_t end = ddsIncrement(cfg.chirpEndHz, sampleHz);
+  if (cfg.mode == ModulationMode::CHIRP_EXP && start > 0 && end > 0) {
+    // (end / start)^(1 / n) - 1 en Q32; por muestra es del orden de 1e-4
+    m.chirpStep = (int32_t)llround(expm1(log((double)end / start) / n) * 4294967296.0);
+  } else {
+    m.chirpStep = (int32_t)(((int64_t)end - (int64_t)start) / (int64_t)n);
+  }
+  m.chirpStart = start;
+  m.chirpSamples = n;
+
+  bool chirp = cfg.mode == ModulationMode::CHIRP_LINEAR || cfg.mode == ModulationMode::CHIRP_EXP;
+  bool wasChirp = m.mode == (uint8_t)ModulationMode::CHIRP_LINEAR || m.mode == (uint8_t)ModulationMode::CHIRP_EXP;
+  if (chirp && !wasChirp) m.chirpPos = n - 1;
+  else if (m.chirpPos >= n) m.chirpPos = 0;
+  m.mode = (uint8_t)cfg.mode;
+}
+
+void synthModRestart(SynthModState& m) {
+  m.env = SYNTH_MOD_UNITY;
+  m.burstPos = 0;
+  m.amPhase = 0;
+  m.chirpPos = m.chirpSamples - 1;
+}
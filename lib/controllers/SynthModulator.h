@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include "AcousticModulation.h"
+
+/*
+ * Moduladores del inyector acústico en punto fijo, dentro del paso por
+ * muestra de las ISR (SynthKernel.h y AdditiveSynth.h).
+ *
+ * Ráfagas y AM dan una envolvente Q16 que escala el nivel. La envolvente no
+ * salta nunca: se acerca a su objetivo con una pendiente máxima de fondo de
+ * escala por SYNTH_MOD_RAMP_MS, así los flancos de las ráfagas y cualquier
+ * cambio de modo o de parámetros quedan sin clics.
+ *
+ * El chirp mueve el incremento de un oscilador DDS: la fase sigue continua
+ * al volver al principio del barrido. Solo lo usa la salida aditiva; la
+ * tabla va a frecuencia de muestreo variable y no tiene DDS.
+ */
+
+constexpr uint32_t SYNTH_MOD_UNITY   = 65536;  ///< Envolvente Q16 a nivel completo
+constexpr float    SYNTH_MOD_RAMP_MS = 1.0f;   ///< Flanco de 0 a fondo de escala
+constexpr uint8_t  SYNTH_MOD_TABLE_SIZE = 16;  ///< Copia de SYNTH_SINE_TABLE para el AM
+
+/**
+ * @struct SynthModState
+ * Estado de un modulador. Lo configura la tarea con synthModConfigure();
+ * cada campo se escribe de una vez y una mezcla momentánea de parámetros
+ * viejos y nuevos la absorbe la pendiente de la envolvente.
+ */
+struct SynthModState {
+  volatile uint8_t mode = 0;         ///< ModulationMode
+  uint8_t  table[SYNTH_MOD_TABLE_SIZE] = {};  ///< Seno del AM (SYNTH_SINE_TABLE)
+  volatile uint32_t slew = SYNTH_MOD_UNITY;  ///< Paso máximo por muestra
+  uint32_t env = SYNTH_MOD_UNITY;
+
+  volatile uint32_t burstOn = 0;     ///< Muestras encendida
+  volatile uint32_t burstPeriod = 1; ///< Muestras de encendido + apagado
+  uint32_t burstPos = 0;
+
+  volatile uint32_t amIncrement = 0; ///< 2^32 = un periodo del AM
+  volatile uint16_t amDepth = 0;     ///< 0–256
+  uint32_t amPhase = 0;
+
+  volatile uint32_t chirpStart = 0;  ///< Incremento DDS al inicio del barrido
+  volatile int32_t  chirpStep = 0;   ///< Lineal: suma por muestra. Exponencial: factor - 1 en Q32
+  volatile uint32_t chirpSamples = 1;
+  uint32_t chirpPos = 0;
+};
+
+/**
+ * Pasa los parámetros a punto fijo para una frecuencia de muestreo. No
+ * toca envolvente ni fases: se puede llamar con la ISR en marcha, y cada vez
+ * que cambia la frecuencia de muestreo. Al entrar en un chirp, la muestra
+ * siguiente ya empieza el barrido.
+ */
+void synthModConfigure(SynthModState& m, const AcousticModulation& cfg, float sampleHz);
+
+/// Vuelve al principio: envolvente a 1, ráfaga encendida, AM en el pico, chirp desde el inicio
+void synthModRestart(SynthModState& m);
+
+/// Nivel 0–255 por la envolvente Q16
+static inline __attribute__((always_inline)) uint8_t synthModScale(uint8_t levelInt, uint32_t env) {
+  return (uint8_t)((levelInt * env) >> 16);
+}
+
+/// Avanza la envolvente una muestra y la devuelve (Q16, 0–SYNTH_MOD_UNITY)
+static inline __attribute__((always_inline)) uint32_t synthModStep(SynthModState& m) {
+  uint8_t mode = m.mode;
+  uint32_t target = SYNTH_MOD_UNITY;
+  if (mode == (uint8_t)ModulationMode::BURST) {
+    if (m.burstPos >= m.burstOn) target = 0;
+    if (++m.burstPos >= m.burstPeriod) m.burstPos = 0;
+  } else if (mode == (uint8_t)ModulationMode::AM) {
+    // Fase 0 en el pico (un cuarto de tabla adelantada): entrar en AM no salta
+    m.amPhase += m.amIncrement;
+    uint8_t phase = (uint8_t)((m.amPhase >> 24) + 64);
+    uint8_t i = phase >> 4;
+    int16_t a = m.table[i];
+    int16_t s = a + (int16_t)(m.table[(i + 1) & (SYNTH_MOD_TABLE_SIZE - 1)] - a) * (phase & 15) / 16;
+    target = SYNTH_MOD_UNITY - (uint32_t)m.amDepth * (uint32_t)(255 - s);
+  } else if (m.env == SYNTH_MOD_UNITY) {
+    return SYNTH_MOD_UNITY;
+  }
+  int32_t delta = (int32_t)target - (int32_t)m.env;
+  int32_t slew = (int32_t)m.slew;
+  if (delta > slew) delta = slew;
+  else if (delta < -slew) delta = -slew;
+  m.env = (uint32_t)((int32_t)m.env + delta);
+  return m.env;
+}
+
+/// Avanza el barrido una muestra sobre el incremento de un oscilador DDS
+static inline __attribute__((always_inline)) void synthModChirp(SynthModState& m, volatile uint32_t& increment) {
+  uint8_t mode = m.mode;
+  if (mode != (uint8_t)ModulationMode::CHIRP_LINEAR && mode != (uint8_t)ModulationMode::CHIRP_EXP) return;
+  if (++m.chirpPos >= m.chirpSamples) {
+    m.chirpPos = 0;
+    increment = m.chirpStart;
+  } else if (mode == (uint8_t)ModulationMode::CHIRP_LINEAR) {
+    increment = increment + m.chirpStep;
+  } else {
+    uint32_t inc = increment;
+    increment = inc + (int32_t)(((int64_t)inc * m.chirpStep) >> 32);
+  }
+}
@@ -0,0 +1,20 @@
+#include "SynthTuningTable.h"
+
+void SynthTuningTable::build(const ActuationMap& map, uint8_t tableSize) {
+  this->tableSize = tableSize;
+  for (uint8_t bin = 0; bin < SYNTH_LOAD_BINS; ++bin) {
+    float freq = synthFrequencyForLoad(static_cast<float>(bin), map.freqMinHz, map.freqMaxHz);
+    frequencies[bin] = freq;
+    periods[bin] = synthTimerPeriodUs(freq, tableSize);
+    gains[bin] = 1.0f;
+  }
+}
+
+void SynthTuningTable::applyEq(const AcousticEqData& eq) {
+  for (uint8_t bin = 0; bin < SYNTH_LOAD_BINS; ++bin) gains[bin] = eqGainAt(eq, frequencies[bin]);
+}
+
+float SynthTuningTable::realFrequencyHz(uint8_t bin) const {
+  uint32_t period = periods[bin] ? periods[bin] : 1;
+  return static_cast<float>(SYNTH_TIMER_HZ) / (static_cast<float>(period) * tableSize);
+}
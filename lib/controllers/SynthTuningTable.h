@@ -0,0 +1,55 @@
+#pragma once
+
+#include <stdint.h>
+#include "AcousticEq.h"
+#include "SynthKernel.h"
+#include "TuningProfile.h"
+
+constexpr uint8_t SYNTH_LOAD_BINS = 101;  ///< Un bin por cada 1 % de carga MAP
+
+/**
+ * @class SynthTuningTable
+ * Carga MAP → alarma del timer del inyector, precalculada una vez por mapa
+ * de actuación (cambio de perfil). En el lazo queda un redondeo y una
+ * lectura de tabla en lugar del mapeo y la división en float.
+ *
+ * La calibración no la invalida: cambia cómo se obtiene la carga, no cómo
+ * se traduce la carga en frecuencia. La ecualización sí: cada bin lleva
+ * también la ganancia de su frecuencia (applyEq()).
+ */
+class SynthTuningTable {
+public:
+  SynthTuningTable() { build(ActuationMap()); }
+
+  /**
+   * Recalcula la tabla.
+   * @param map       Frecuencias a carga 0 % y 100 %.
+   * @param tableSize Muestras por periodo de la onda.
+   */
+  void build(const ActuationMap& map, uint8_t tableSize = SYNTH_TABLE_SIZE);
+
+  /// Ganancia de ecualización de cada bin; tras build() hay que volver a aplicarla
+  void applyEq(const AcousticEqData& eq);
+
+  /// Bin de una carga 0–100 %; fuera de rango se satura
+  static inline uint8_t binForLoad(float mapLoadPercent) {
+    if (!(mapLoadPercent > 0.0f)) return 0;  // También NaN
+    if (mapLoadPercent >= 100.0f) return SYNTH_LOAD_BINS - 1;
+    return static_cast<uint8_t>(mapLoadPercent + 0.5f);
+  }
+
+  /// Alarma del timer (µs por muestra) del bin
+  uint32_t periodUs(uint8_t bin) const { return periods[bin]; }
+  /// Frecuencia pedida en el centro del bin
+  float frequencyHz(uint8_t bin) const { return frequencies[bin]; }
+  /// Frecuencia que sale de verdad con la alarma entera del bin
+  float realFrequencyHz(uint8_t bin) const;
+  /// Multiplicador del nivel en el bin (1 sin ecualización)
+  float gain(uint8_t bin) const { return gains[bin]; }
+
+private:
+  uint32_t periods[SYNTH_LOAD_BINS];
+  float    frequencies[SYNTH_LOAD_BINS];
+  float    gains[SYNTH_LOAD_BINS];
+  uint8_t  tableSize = SYNTH_TABLE_SIZE;
+};
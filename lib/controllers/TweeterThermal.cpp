@@ -0,0 +1,80 @@
+#include "TweeterThermal.h"
+#include <math.h>
+
+void TweeterThermal::configure(const ThermalParams& p) {
+  params = p;
+  if (params.tauS < 0.1f) params.tauS = 0.1f;
+  if (params.kneeC > params.ceilingC) params.kneeC = params.ceilingC;
+  powerCont = params.riseFullC > params.ceilingC ? params.ceilingC / params.riseFullC : 1.0f;
+  cachedDtMs = 0;
+}
+
+void TweeterThermal::advance(uint32_t nowMs) {
+  if (!started) {
+    started = true;
+    lastMs = nowMs;
+    return;
+  }
+  uint32_t dt = nowMs - lastMs;
+  lastMs = nowMs;
+  if (dt == 0) return;
+  if (dt != cachedDtMs) {
+    cachedDtMs = dt;
+    cachedDecay = expf(-(dt / 1000.0f) / params.tauS);
+  }
+  // Solución exacta del RC con potencia constante en el tramo
+  float target = params.riseFullC * power;
+  rise = target + (rise - target) * cachedDecay;
+}
+
+float TweeterThermal::maxLevel(float duty) const {
+  float allowed = 1.0f;
+  if (powerCont < 1.0f && rise > params.kneeC) {
+    float span = params.ceilingC - params.kneeC;
+    float t = span > 0.0f ? (params.ceilingC - rise) / span : 0.0f;
+    if (t < 0.0f) t = 0.0f;
+    allowed = powerCont + (1.0f - powerCont) * t;
+  }
+  if (duty <= 0.0f) return 1.0f;
+  float level = sqrtf(allowed / duty);
+  return level < 1.0f ? level : 1.0f;
+}
+
+float TweeterThermal::continuousLevel(float duty) const {
+  if (duty <= 0.0f) return 1.0f;
+  float level = sqrtf(powerCont / duty);
+  return level < 1.0f ? level : 1.0f;
+}
+
+float TweeterThermal::apply(uint32_t nowMs, float level, float duty) {
+  advance(nowMs);
+  if (level < 0.0f) level = 0.0f;
+  if (level > 1.0f) level = 1.0f;  // Más allá satura el DAC, no es potencia
+  float limit = maxLevel(duty);
+  limiting = level > limit;
+  if (limiting) level = limit;
+  power = level * level * duty;
+  return level;
+}
+
+void TweeterThermal::off(uint32_t nowMs) {
+  advance(nowMs);
+  power = 0.0f;
+  limiting = false;
+}
+
+float modulationDuty(const AcousticModulation& mod) {
+  switch (mod.mode) {
+    case ModulationMode::BURST: {
+      uint32_t period = (uint32_t)mod.burstOnMs + mod.burstOffMs;
+      return period ? (float)mod.burstOnMs / period : 1.0f;
+    }
+    case ModulationMode::AM: {
+      // Envolvente 1 - d(1 - cos)/2: media de su cuadrado
+      float d = mod.amDepth < 0.0f ? 0.0f : (mod.amDepth > 1.0f ? 1.0f : mod.amDepth);
+      return (1.0f - d / 2.0f) * (1.0f - d / 2.0f) + d * d / 8.0f;
+    }
+    default:
+      return 1.0f;
+  }
+}
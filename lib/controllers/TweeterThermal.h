@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+#include "AcousticModulation.h"
+
+/**
+ * @struct ThermalParams
+ * Modelo térmico de primer orden de la bobina del tweeter. La potencia es
+ * proporcional a nivel² (informe técnico), normalizada a 1 con nivel 1
+ * continuo; la bobina tiende a riseFullC × potencia sobre el ambiente con
+ * constante de tiempo tauS.
+ */
+struct ThermalParams {
+  float tauS      = 8.0f;    ///< Constante de tiempo de la bobina
+  float riseFullC = 140.0f;  ///< Subida en régimen a nivel 1 continuo
+  float ceilingC  = 100.0f;  ///< Subida máxima permitida
+  float kneeC     = 85.0f;   ///< Desde aquí se recorta hacia la potencia continua
+};
+
+/**
+ * @class TweeterThermal
+ * Estimación de la temperatura de la bobina y límite de nivel para no pasar
+ * del techo. En frío deja salir nivel completo aunque en continuo se
+ * pasaría (ráfagas cortas); desde la rodilla, la potencia permitida baja
+ * linealmente hasta la que en régimen queda justo en el techo, así la
+ * temperatura se acerca al techo sin cruzarlo.
+ *
+ * Cada llamada integra de forma exacta la potencia vigente desde la
+ * anterior (potencia constante a tramos): coste constante, sea cual sea el
+ * intervalo, incluidos los ratos con el inyector apagado.
+ */
+class TweeterThermal {
+public:
+  TweeterThermal() { configure(ThermalParams()); }
+
+  void configure(const ThermalParams& params);
+  const ThermalParams& getParams() const { return params; }
+
+  /**
+   * Avanza hasta nowMs y fija el nivel de aquí en adelante.
+   * @param level Nivel pedido 0–1.
+   * @param duty  Potencia media relativa de la modulación (modulationDuty()).
+   * @return Nivel permitido, <= level.
+   */
+  float apply(uint32_t nowMs, float level, float duty = 1.0f);
+
+  /// Avanza hasta nowMs y deja la potencia a 0 (inyector parado)
+  void off(uint32_t nowMs);
+
+  float getRise() const { return rise; }
+  /// Nivel máximo que se permitiría ahora mismo con esa modulación
+  float maxLevel(float duty = 1.0f) const;
+  /// Nivel que se puede mantener indefinidamente sin pasar del techo
+  float continuousLevel(float duty = 1.0f) const;
+  bool isLimiting() const { return limiting; }
+
+private:
+  void advance(uint32_t nowMs);
+
+  ThermalParams params;
+  float rise = 0.0f;     ///< °C sobre el ambiente
+  float power = 0.0f;    ///< Vigente desde lastMs
+  float powerCont = 1.0f;  ///< Potencia que en régimen deja la bobina en el techo
+  uint32_t lastMs = 0;
+  bool started = false;
+  bool limiting = false;
+
+  uint32_t cachedDtMs = 0;  ///< El lazo va casi siempre a paso fijo: una exp por cambio de paso
+  float cachedDecay = 1.0f;
+};
+
+/**
+ * Potencia media de una modulación respecto del tono continuo al mismo
+ * nivel: ciclo de trabajo en las ráfagas, media de la envolvente² en AM.
+ */
+float modulationDuty(const AcousticModulation& mod);
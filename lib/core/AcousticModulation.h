@@ -0,0 +1,39 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @enum ModulationMode
+ * Modulación del tono del inyector acústico.
+ */
+enum class ModulationMode : uint8_t {
+  NONE,          ///< Tono continuo
+  BURST,         ///< Ráfagas: burstOnMs encendido, burstOffMs apagado
+  AM,            ///< Amplitud modulada por un seno lento
+  CHIRP_LINEAR,  ///< Barrido lineal de frecuencia, en diente de sierra
+  CHIRP_EXP,     ///< Barrido exponencial (misma fracción de octava por ms)
+};
+
+/**
+ * @struct AcousticModulation
+ * Parámetros de la modulación que la FSM pasa en setAcousticParameters().
+ * Las ráfagas permiten picos por encima del límite térmico continuo del
+ * tweeter con la misma potencia media.
+ */
+struct AcousticModulation {
+  ModulationMode mode = ModulationMode::NONE;
+  uint16_t burstOnMs    = 50;
+  uint16_t burstOffMs   = 50;
+  float    amRateHz     = 8.0f;     ///< 0.1–50 Hz
+  float    amDepth      = 0.5f;     ///< 0–1: en el valle el nivel es 1 - amDepth
+  float    chirpStartHz = 4200.0f;
+  float    chirpEndHz   = 6400.0f;
+  uint16_t chirpMs      = 200;      ///< Duración de cada barrido
+
+  bool operator==(const AcousticModulation& o) const {
+    return mode == o.mode && burstOnMs == o.burstOnMs && burstOffMs == o.burstOffMs &&
+           amRateHz == o.amRateHz && amDepth == o.amDepth && chirpStartHz == o.chirpStartHz &&
+           chirpEndHz == o.chirpEndHz && chirpMs == o.chirpMs;
+  }
+  bool operator!=(const AcousticModulation& o) const { return !(*this == o); }
+};
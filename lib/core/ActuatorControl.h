@@ -0,0 +1,32 @@
+#pragma once
+
+#include "AcousticModulation.h"
+#include "TuningProfile.h"
+
+/**
+ * @class ActuatorControl
+ * Lo que la FSM necesita de los actuadores. ActuatorManager lo implementa en
+ * el ESP32; las herramientas de host (benchmarks, replay) usan sus propios dobles.
+ */
+class ActuatorControl {
+public:
+  virtual ~ActuatorControl() = default;
+
+  virtual void update() = 0;
+
+  virtual void startVortex() = 0;
+  virtual void stopVortex() = 0;
+
+  virtual void startAcoustic(float level) = 0;
+  virtual void stopAcoustic() = 0;
+  /**
+   * @param level Nivel acústico normalizado [0–1].
+   * @param mapLoadPercent Carga MAP [0–100] que fija la frecuencia.
+   * @param modulation Ráfagas, AM o chirp sobre el tono.
+   */
+  virtual void setAcousticParameters(float level, float mapLoadPercent, const AcousticModulation& modulation) = 0;
+  virtual bool isAcousticOn() const = 0;
+
+  /// Mapa carga → señal del perfil activo; la FSM lo fija al cambiar de perfil
+  virtual void setActuationMap(const ActuationMap& map) = 0;
+};
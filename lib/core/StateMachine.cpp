@@ -1,7 +1,9 @@
 #include "StateMachine.h"
-#include <Arduino.h>  // Para Serial
+#include "Logger.h"
 
-void StateMachine::begin(bool hasCalibration, ActuatorManager* actuatorsPtr, ThresholdManager* thresholdManagerPtr) {
+const TuningProfile StateMachine::defaultProfile = ThresholdManager::factoryProfile();
+
+void StateMachine::begin(bool hasCalibration, ActuatorControl* actuatorsPtr, ThresholdManager* thresholdManagerPtr) {
   current = hasCalibration
               ? SystemState::OFF
               : SystemState::SIN_CALIBRAR;
@@ -9,11 +11,12 @@ void StateMachine::begin(bool hasCalibration, ActuatorManager* actuatorsPtr, Thr
   actuators = actuatorsPtr;
   thresholdManager = thresholdManagerPtr;
   if (thresholdManager) {
-    thresholds = thresholdManager->getThresholds();
+    thresholdManager->applyPending();
+    profile = &thresholdManager->active();
   }
+  actuators->setActuationMap(profile->actuation);
 
-  Serial.print(">> StateMachine iniciado en estado: ");
-  Serial.println(static_cast<int>(current));
+  LOG_I(">> StateMachine iniciado en estado: %d", static_cast<int>(current));
 }
 
 SystemState StateMachine::getState() const {
@@ -28,14 +31,21 @@ void StateMachine::update(float mapLoadPercent,
                           const DebugManager &dbg) {
   
   lastMapLoadPercent = mapLoadPercent;
+  updateCount->inc();
   if (current == SystemState::DEBUG) {
     return;
   }
-
-  // Actualizar umbrales dinámicamente
-  if (thresholdManager) {
-    thresholds = thresholdManager->getThresholds();
+  const SystemState previous = current;
+
+  // Cambio de perfil solo donde no hay actuadores encendidos: el loop
+  // adopta la copia ya preparada, sin copiar ni esperar a la consola
+  if (thresholdManager && isSafeState(current) && thresholdManager->applyPending()) {
+    profile = &thresholdManager->active();
+    actuators->setActuationMap(profile->actuation);
+    LOG_I(">> Perfil %u activo (rev %u)", (unsigned)thresholdManager->getActiveIndex(),
+          (unsigned)profile->revision);
   }
+  const Thresholds& thresholds = profile->thresholds;
 
   currentLevel = tpsLoadPercent / 100.0f;
 
@@ -45,17 +55,17 @@ void StateMachine::update(float mapLoadPercent,
       if (mapLoadPercent < thresholds.MAP_WAKEUP_PERCENT) {
 
         current = SystemState::IDLE;
-        Serial.println("→ Transición: OFF → IDLE");
+        LOG_I("→ Transición: OFF → IDLE");
       }
       break;
 
     case SystemState::SIN_CALIBRAR:
       if (serialCalibReq || bleCalibReq) {
         current = SystemState::CALIBRATION;
-        Serial.println("→ Transición: SIN_CALIBRAR → CALIBRATION");
+        LOG_I("→ Transición: SIN_CALIBRAR → CALIBRATION");
       } else if (calibLoaded) {
         current = SystemState::OFF;
-        Serial.println("→ Transición: SIN_CALIBRAR → OFF (calibración detectada)");
+        LOG_I("→ Transición: SIN_CALIBRAR → OFF (calibración detectada)");
       }
       break;
 
@@ -64,7 +74,7 @@ void StateMachine::update(float mapLoadPercent,
 
       if (calibLoaded) {
         current = SystemState::OFF;
-        Serial.println("→ Transición: CALIBRATION → OFF");
+        LOG_I("→ Transición: CALIBRATION → OFF");
       }
       break;
 
@@ -74,7 +84,7 @@ void StateMachine::update(float mapLoadPercent,
         if (!actuators->isAcousticOn()) {
           actuators->startAcoustic(currentLevel);
         }
-        Serial.println("→ Transición: IDLE → INYECCION_ACUSTICA");
+        LOG_I("→ Transición: IDLE → INYECCION_ACUSTICA");
       }
       break;
 
@@ -82,12 +92,12 @@ void StateMachine::update(float mapLoadPercent,
       if (tpsLoadPercent >= thresholds.VORTEX_TPS_ON && mapLoadPercent >= thresholds.VORTEX_MAP_ON) {
         current = SystemState::VORTEX;
         actuators->startVortex();
-        Serial.println("→ Transición: INYECCION_ACUSTICA → VORTEX");
+        LOG_I("→ Transición: INYECCION_ACUSTICA → VORTEX");
       }
       else if (tpsLoadPercent <= thresholds.INJ_TPS_OFF) {
         current = SystemState::IDLE;
         actuators->stopAcoustic();
-        Serial.println("→ Transición: INYECCION_ACUSTICA → IDLE");
+        LOG_I("→ Transición: INYECCION_ACUSTICA → IDLE");
       }
       break;
 
@@ -96,7 +106,7 @@ void StateMachine::update(float mapLoadPercent,
         current = SystemState::DESCAYENDO;
         actuators->stopAcoustic();
         actuators->stopVortex();
-        Serial.println("→ Transición: VORTEX → DESCAYENDO");
+        LOG_I("→ Transición: VORTEX → DESCAYENDO");
       }
       break;
 
@@ -106,43 +116,46 @@ void StateMachine::update(float mapLoadPercent,
         if (!actuators->isAcousticOn()) {
           actuators->startAcoustic(currentLevel);
         }
-        Serial.println("→ Transición: DESCAYENDO → INYECCION_ACUSTICA");
+        LOG_I("→ Transición: DESCAYENDO → INYECCION_ACUSTICA");
       }
       else if (tpsLoadPercent <= thresholds.INJ_TPS_OFF || mapLoadPercent <= thresholds.INJ_MAP_OFF) {
         current = SystemState::IDLE;
         actuators->stopAcoustic();
-        Serial.println("→ Transición: DESCAYENDO → IDLE");
+        LOG_I("→ Transición: DESCAYENDO → IDLE");
       }
       break;
 
     case SystemState::DEBUG:
       break;
     case SystemState::UNKNOWN:
-      Serial.println(">> Estado UNKNOWN detectado, reseteando a OFF");
+      LOG_W(">> Estado UNKNOWN detectado, reseteando a OFF");
       current = SystemState::OFF;
       break;
 
   }
+
+  if (current != previous) transitionCount->inc();
 }
 
 void StateMachine::handleActions() {
   if (current == SystemState::INYECCION_ACUSTICA) {
-    actuators->setAcousticParameters(currentLevel, lastMapLoadPercent);
+    actuators->setAcousticParameters(currentLevel, lastMapLoadPercent, modulation);
     actuators->update();
   }
 
-  static uint32_t lastPrint = 0;
-  if (millis() - lastPrint > 500) {
-    lastPrint = millis();
-    //Serial.printf("TPS: %.1f%% → Level: %.2f\n", currentLevel * 100.0f, getLevel());
+#if VORTEX_LOG_LEVEL >= VORTEX_LOG_DEBUG
+  static uint8_t ciclos = 0;
+  if (++ciclos >= 25) {  // ~500 ms con el loop de 20 ms
+    ciclos = 0;
+    LOG_D("TPS: %.1f%% → Level: %.2f", currentLevel * 100.0f, getLevel());
   }
+#endif
 }
 
 void StateMachine::debugForceState(SystemState nuevoEstado) {
   if (current == SystemState::DEBUG) {
     current = nuevoEstado;
-    Serial.print(">> Estado forzado a: ");
-    Serial.println(static_cast<int>(nuevoEstado));
+    LOG_I(">> Estado forzado a: %d", static_cast<int>(nuevoEstado));
   }
 }
 
@@ -151,5 +164,10 @@ float StateMachine::getLevel() const {
 }
 
 bool StateMachine::readyForInjection(float tps, float mapLoad) {
-  return tps >= thresholds.INJ_TPS_ON && mapLoad >= thresholds.INJ_MAP_ON;
+  return tps >= profile->thresholds.INJ_TPS_ON && mapLoad >= profile->thresholds.INJ_MAP_ON;
+}
+
+bool StateMachine::isSafeState(SystemState state) {
+  return state == SystemState::OFF || state == SystemState::SIN_CALIBRAR ||
+         state == SystemState::CALIBRATION || state == SystemState::IDLE;
 }
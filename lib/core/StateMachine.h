@@ -1,9 +1,9 @@
 #pragma once
 
-#include "ActuatorManager.h"
+#include "ActuatorControl.h"
 #include "DebugManager.h"
 #include "ThresholdManager.h"
-#include "CalibrationManager.h"
+#include "Metrics.h"
 
 
 /**
@@ -35,10 +35,10 @@ public:
   /**
    * Inicializa la máquina de estados.
    * @param hasCalibration true si ya hay datos de calibración válidos.
-   * @param turboRef Puntero al controlador de turbo.
-   * @param injectorRef Puntero al inyector acústico.
+   * @param actuators Actuadores que comanda la FSM (ActuatorManager en el ESP32).
+   * @param thresholdManagerPtr Origen de los umbrales.
    */
-  void begin(bool hasCalibration, ActuatorManager* actuators, ThresholdManager* thresholdManagerPtr);
+  void begin(bool hasCalibration, ActuatorControl* actuators, ThresholdManager* thresholdManagerPtr);
 
   /**
    * Obtiene el estado actual.
@@ -76,22 +76,30 @@ public:
   float getLevel() const;
   bool readyForInjection(float, float);
 
-  CalibStep currentCalibStep = CalibStep::TPS_MIN;
-  unsigned long lastStepTime = 0;
+  /// Modulación que se pasa a los actuadores en INYECCION_ACUSTICA
+  void setAcousticModulation(const AcousticModulation& mod) { modulation = mod; }
+  const AcousticModulation& getAcousticModulation() const { return modulation; }
+
 
 
 
 private:
-  Thresholds thresholds;                         ///< Copia local de los umbrales actuales
+  static bool isSafeState(SystemState state);     ///< Estados sin actuadores encendidos
+
+  const TuningProfile* profile = &defaultProfile;  ///< Perfil vigente (doble buffer del ThresholdManager)
+  static const TuningProfile defaultProfile;
   ThresholdManager* thresholdManager = nullptr;  ///< Puntero al gestor de umbrales
   SystemState        current{SystemState::OFF};   ///< Estado actual
-  ActuatorManager* actuators = nullptr;
-  CalibrationManager* calibMgr= nullptr;
+  ActuatorControl* actuators = nullptr;
   float              lastMapLoadPercent = 0.0f; ///< Guardar el último mapLoadPercent
 
 
   
   float currentLevel{0.0f};  ///< Nivel actual de inyección acústica calculado internamente
+  AcousticModulation modulation;  ///< Fijada por consola; NONE = tono continuo
+
+  Counter* updateCount     = &MetricsRegistry::getInstance().counter("fsm.updates");
+  Counter* transitionCount = &MetricsRegistry::getInstance().counter("fsm.transitions");
 
 
 };
@@ -1,120 +1,339 @@
 #include "ThresholdManager.h"
-#include <Preferences.h>
-#include <Arduino.h>
+#include "ConfigStore.h"
+#include <string.h>
 
-static constexpr const char* NVS_NAMESPACE = "thresholds";
+// Claves que acepta setThreshold(), en el orden en que se listan
+static const struct {
+    const char* name;
+    float Thresholds::*field;
+} THRESHOLD_KEYS[] = {
+    { "MAP_WAKEUP_PERCENT", &Thresholds::MAP_WAKEUP_PERCENT },
+    { "INJ_TPS_ON",         &Thresholds::INJ_TPS_ON },
+    { "INJ_MAP_ON",         &Thresholds::INJ_MAP_ON },
+    { "INJ_TPS_OFF",        &Thresholds::INJ_TPS_OFF },
+    { "INJ_MAP_OFF",        &Thresholds::INJ_MAP_OFF },
+    { "VORTEX_TPS_ON",      &Thresholds::VORTEX_TPS_ON },
+    { "VORTEX_MAP_ON",      &Thresholds::VORTEX_MAP_ON },
+    { "VORTEX_TPS_OFF",     &Thresholds::VORTEX_TPS_OFF },
+};
+
+static const struct {
+    const char* name;
+    float ActuationMap::*field;
+} ACTUATION_KEYS[] = {
+    { "FREQ_MIN_HZ", &ActuationMap::freqMinHz },
+    { "FREQ_MAX_HZ", &ActuationMap::freqMaxHz },
+};
+
+ThresholdManager::ThresholdManager() {
+    profiles[0] = factoryProfile();
+    live[0] = live[1] = profiles[0];
+}
+
+TuningProfile ThresholdManager::factoryProfile() {
+    TuningProfile p;
+    strncpy(p.name, "base", sizeof(p.name) - 1);
+    p.valid = 1;
+
+    Thresholds& t = p.thresholds;
+
+    // Umbral mínimo de presión (MAP) para pasar de OFF a IDLE
+    t.MAP_WAKEUP_PERCENT = 5.0f;
+
+    // Umbrales para activar la inyección acústica
+    t.INJ_TPS_ON         = 10.0f;   // % TPS mínimo para iniciar
+    t.INJ_MAP_ON         = 40.0f;   // % MAP mínimo para iniciar
+
+    // Umbrales para detener la inyección acústica
+    t.INJ_TPS_OFF        = 8.0f;    // % TPS para apagar
+    t.INJ_MAP_OFF        = 30.0f;   // % MAP para apagar
+
+    // Umbrales para activar el vortex
+    t.VORTEX_TPS_ON      = 45.0f;   // % TPS para activar
+    t.VORTEX_MAP_ON      = 75.0f;   // % MAP para activar (presión alta)
+
+    // Umbral para apagar el vortex
+    t.VORTEX_TPS_OFF     = 30.0f;   // % TPS para apagar vortex
+
+    // p.actuation queda con el barrido de fábrica (DEFAULT_FREQ_*)
+    return p;
+}
 
 bool ThresholdManager::begin() {
-    loadDefaults();  // Cargar llaves y valores por defecto primero
+    ConfigStore& store = ConfigStore::getInstance();
+    bool stored = false;
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        for (uint8_t i = 0; i < MAX_PROFILES; i++) {
+            TuningProfile p;
+            if (store.getProfile(i, p)) {
+                p.name[PROFILE_NAME_LEN - 1] = '\0';
+                profiles[i] = p;
+                stored = true;
+            }
+        }
 
-    if (!loadFromNVS()) {
-        // Si falló la carga, mantenemos los defaults y los guardamos
-        return saveToNVS();
+        uint8_t wanted = store.getActiveProfile();
+        selected = profiles[wanted].valid ? wanted : 0;
+        publish();
     }
 
+    if (!stored) {
+        // Si no había perfiles guardados, mantenemos el de fábrica y lo guardamos
+        dirty[0] = true;
+        return saveToStore();
+    }
     return true;
 }
 
 Thresholds ThresholdManager::getThresholds() const {
-    Thresholds t;
-    t.MAP_WAKEUP_PERCENT = thresholds.at("MAP_WAKEUP_PERCENT");
-    t.INJ_TPS_ON        = thresholds.at("INJ_TPS_ON");
-    t.INJ_MAP_ON        = thresholds.at("INJ_MAP_ON");
-    t.INJ_TPS_OFF       = thresholds.at("INJ_TPS_OFF");
-    t.INJ_MAP_OFF       = thresholds.at("INJ_MAP_OFF");
-    t.VORTEX_TPS_ON      = thresholds.at("VORTEX_TPS_ON");
-    t.VORTEX_MAP_ON      = thresholds.at("VORTEX_MAP_ON");
-    t.VORTEX_TPS_OFF     = thresholds.at("VORTEX_TPS_OFF");
-    return t;
+    std::lock_guard<std::mutex> lock(writer);
+    return profiles[selected].thresholds;
+}
+
+float* ThresholdManager::field(TuningProfile& profile, const std::string& key) const {
+    for (const auto& k : THRESHOLD_KEYS) {
+        if (key == k.name) return &(profile.thresholds.*k.field);
+    }
+    for (const auto& k : ACTUATION_KEYS) {
+        if (key == k.name) return &(profile.actuation.*k.field);
+    }
+    return nullptr;
 }
 
 bool ThresholdManager::setThreshold(const std::string& key, float value) {
-    auto it = thresholds.find(key);
-    if (it != thresholds.end()) {
-        it->second = value;
-        return true;
+    std::lock_guard<std::mutex> lock(writer);
+    if (!drafting) {
+        draft = profiles[selected];
+        draftIndex = selected;
+        drafting = true;
     }
-    return false;
+    float* f = field(draft, key);
+    if (!f) return false;
+
+    *f = value;
+    return true;
 }
 
-bool ThresholdManager::save() {
-    return saveToNVS();
+bool ThresholdManager::editProfile(uint8_t index) {
+    std::lock_guard<std::mutex> lock(writer);
+    if (index != NO_SLOT && (index >= MAX_PROFILES || !profiles[index].valid)) return false;
+    draft = profiles[index == NO_SLOT ? selected : index];
+    draftIndex = index;
+    drafting = true;
+    return true;
 }
 
-bool ThresholdManager::reset() {
-    loadDefaults();
-    return saveToNVS();
+ThresholdManager::EditResult ThresholdManager::applyEdits(const char** reason) {
+    std::lock_guard<std::mutex> lock(writer);
+    return applyLocked(reason);
 }
 
-std::vector<std::string> ThresholdManager::listKeys() const {
-    std::vector<std::string> keys;
-    for (const auto& pair : thresholds) {
-        keys.push_back(pair.first);
+// Con writer tomado
+ThresholdManager::EditResult ThresholdManager::applyLocked(const char** reason) {
+    if (!drafting) return EditResult::NO_EDITS;
+    if (draftIndex == NO_SLOT) return EditResult::NO_SLOT;
+    const char* problem = checkProfile(draft);
+    if (problem) {
+        if (reason) *reason = problem;
+        return EditResult::INVALID;
     }
-    return keys;
+
+    // Nombre y revisión son de la ranura; el borrador solo aporta valores
+    TuningProfile& p = profiles[draftIndex];
+    p.thresholds = draft.thresholds;
+    p.actuation = draft.actuation;
+    dirty[draftIndex] = true;
+    drafting = false;
+    if (draftIndex == selected) publish();
+    draftIndex = NO_SLOT;
+    return EditResult::OK;
 }
 
-void ThresholdManager::loadDefaults() {
-    thresholds.clear();
+void ThresholdManager::discardEdits() {
+    std::lock_guard<std::mutex> lock(writer);
+    drafting = false;
+    draftIndex = NO_SLOT;
+}
 
-    // Umbral mínimo de presión (MAP) para pasar de OFF a IDLE
-    thresholds["MAP_WAKEUP_PERCENT"] = 5.0f;
+bool ThresholdManager::getEdits(TuningProfile& out) const {
+    std::lock_guard<std::mutex> lock(writer);
+    if (!drafting) return false;
+    out = draft;
+    return true;
+}
 
-    // Umbrales para activar la inyección acústica
-    thresholds["INJ_TPS_ON"]         = 10.0f;   // % TPS mínimo para iniciar
-    thresholds["INJ_MAP_ON"]         = 40.0f;   // % MAP mínimo para iniciar
+int ThresholdManager::getEditIndex() const {
+    std::lock_guard<std::mutex> lock(writer);
+    return drafting ? draftIndex : -1;
+}
 
-    // Umbrales para detener la inyección acústica
-    thresholds["INJ_TPS_OFF"]        = 8.0f;    // % TPS para apagar
-    thresholds["INJ_MAP_OFF"]        = 30.0f;   // % MAP para apagar
+ThresholdManager::EditResult ThresholdManager::save(const char** reason) {
+    EditResult result;
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        result = applyLocked(reason);
+    }
+    if (result == EditResult::NO_EDITS) result = EditResult::OK;  // Solo persistir lo ya aplicado
+    if (result == EditResult::OK) saveToStore();
+    return result;
+}
 
-    // Umbrales para activar el vortex
-    thresholds["VORTEX_TPS_ON"]       = 45.0f;   // % TPS para activar
-    thresholds["VORTEX_MAP_ON"]       = 75.0f;   // % MAP para activar (presión alta)
+bool ThresholdManager::reset() {
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        TuningProfile& p = profiles[selected];
+        TuningProfile factory = factoryProfile();
+        p.thresholds = factory.thresholds;
+        p.actuation = factory.actuation;
+        dirty[selected] = true;
+        drafting = false;
+        draftIndex = NO_SLOT;
+        publish();
+    }
+    return saveToStore();
+}
 
-    // Umbral para apagar el vortex
-    thresholds["VORTEX_TPS_OFF"]      = 30.0f;   // % TPS para apagar vortex
+const char* ThresholdManager::checkProfile(const TuningProfile& profile) {
+    const Thresholds& t = profile.thresholds;
+    for (const auto& k : THRESHOLD_KEYS) {
+        float v = t.*k.field;
+        if (!(v >= 0.0f && v <= 100.0f)) return "umbral fuera de 0-100 %";
+    }
+    // La misma histéresis que impone tools/tune: sin ella la FSM oscila o no apaga
+    if (t.INJ_TPS_ON - t.INJ_TPS_OFF < MIN_HYSTERESIS) return "INJ_TPS_OFF debe quedar 1 % por debajo de INJ_TPS_ON";
+    if (t.INJ_MAP_ON - t.INJ_MAP_OFF < MIN_HYSTERESIS) return "INJ_MAP_OFF debe quedar 1 % por debajo de INJ_MAP_ON";
+    if (t.VORTEX_TPS_ON - t.VORTEX_TPS_OFF < MIN_HYSTERESIS) return "VORTEX_TPS_OFF debe quedar 1 % por debajo de VORTEX_TPS_ON";
+    if (t.VORTEX_TPS_ON - t.INJ_TPS_ON < MIN_HYSTERESIS) return "VORTEX_TPS_ON debe quedar 1 % por encima de INJ_TPS_ON";
+
+    const ActuationMap& a = profile.actuation;
+    if (!(a.freqMinHz > 0.0f && a.freqMaxHz >= a.freqMinHz)) return "se necesita 0 < FREQ_MIN_HZ <= FREQ_MAX_HZ";
+    return nullptr;
 }
 
+std::vector<std::string> ThresholdManager::listKeys() const {
+    std::vector<std::string> keys;
+    for (const auto& k : THRESHOLD_KEYS) keys.push_back(k.name);
+    for (const auto& k : ACTUATION_KEYS) keys.push_back(k.name);
+    return keys;
+}
 
-bool ThresholdManager::loadFromNVS() {
-    Preferences prefs;
-    if (!prefs.begin(NVS_NAMESPACE, true)) {
-        Serial.println("ERROR: No se pudo abrir NVS para lectura");
-        return false;
+bool ThresholdManager::getProfile(uint8_t index, TuningProfile& out) const {
+    std::lock_guard<std::mutex> lock(writer);
+    if (index >= MAX_PROFILES || !profiles[index].valid) return false;
+    out = profiles[index];
+    return true;
+}
+
+int ThresholdManager::findProfile(const char* name) const {
+    std::lock_guard<std::mutex> lock(writer);
+    for (uint8_t i = 0; i < MAX_PROFILES; i++) {
+        if (profiles[i].valid && strncmp(profiles[i].name, name, PROFILE_NAME_LEN) == 0) return i;
     }
+    return -1;
+}
 
-    // Si alguna clave falta, no cargamos (datos incompletos)
-    for (const auto& key : listKeys()) {
-        if (!prefs.isKey(key.c_str())) {
-            prefs.end();
-            return false;
-        }
+bool ThresholdManager::selectProfile(uint8_t index) {
+    {
+        std::lock_guard<std::mutex> lock(writer);
+        if (index >= MAX_PROFILES || !profiles[index].valid) return false;
+        selected = index;
+        publish();
     }
+    ConfigStore::getInstance().setActiveProfile(index);
+    return true;
+}
+
+int ThresholdManager::createProfile(const char* name) {
+    std::lock_guard<std::mutex> lock(writer);
+    return createLocked(name);
+}
+
+// Con writer tomado
+int ThresholdManager::createLocked(const char* name) {
+    if (!name || !name[0] || strlen(name) >= PROFILE_NAME_LEN) return -1;
 
-    for (auto& pair : thresholds) {
-        pair.second = prefs.getFloat(pair.first.c_str(), -1.0f);
-        if (pair.second < 0.0f) {
-            prefs.end();
-            return false;
+    int freeSlot = -1;
+    for (uint8_t i = 0; i < MAX_PROFILES; i++) {
+        if (!profiles[i].valid) {
+            if (freeSlot < 0) freeSlot = i;
+        } else if (strncmp(profiles[i].name, name, PROFILE_NAME_LEN) == 0) {
+            return -1;
         }
     }
+    if (freeSlot < 0) return -1;
 
-    prefs.end();
-    return true;
+    TuningProfile& p = profiles[freeSlot];
+    p = profiles[selected];
+    memset(p.name, 0, sizeof(p.name));
+    strncpy(p.name, name, sizeof(p.name) - 1);
+    p.revision = 0;
+    dirty[freeSlot] = true;
+    return freeSlot;
 }
 
-bool ThresholdManager::saveToNVS() {
-    Preferences prefs;
-    if (!prefs.begin(NVS_NAMESPACE, false)) {
-        Serial.println("ERROR: No se pudo abrir NVS para escritura");
-        return false;
+int ThresholdManager::createAndEdit(const char* name) {
+    std::lock_guard<std::mutex> lock(writer);
+    int index = -1;
+    for (uint8_t i = 0; name && i < MAX_PROFILES; i++) {
+        if (profiles[i].valid && strncmp(profiles[i].name, name, PROFILE_NAME_LEN) == 0) index = i;
     }
+    if (index < 0) index = createLocked(name);
+
+    draft = profiles[index < 0 ? selected : index];
+    draftIndex = index < 0 ? NO_SLOT : static_cast<uint8_t>(index);
+    drafting = true;
+    return index;
+}
+
+uint8_t ThresholdManager::getSelectedIndex() const {
+    std::lock_guard<std::mutex> lock(writer);
+    return selected;
+}
 
-    for (const auto& pair : thresholds) {
-        prefs.putFloat(pair.first.c_str(), pair.second);
+// Con writer tomado. Escribe el perfil seleccionado en la copia que el loop
+// no está leyendo y la marca pendiente.
+void ThresholdManager::publish() {
+    uint8_t s = liveState.load(std::memory_order_acquire);
+    // Retirar una publicación anterior que el loop aún no adoptó: a partir de
+    // aquí la copia libre no cambia de dueño mientras se escribe.
+    while ((s & LIVE_PENDING) &&
+           !liveState.compare_exchange_weak(s, s & ~LIVE_PENDING, std::memory_order_acquire)) {
     }
+    s &= LIVE_SLOT;
+
+    uint8_t spare = s ^ LIVE_SLOT;
+    live[spare] = profiles[selected];
+    liveIndex[spare] = selected;
+    liveState.store(s | LIVE_PENDING, std::memory_order_release);
+}
+
+bool ThresholdManager::applyPending() {
+    uint8_t s = liveState.load(std::memory_order_relaxed);
+    if (!(s & LIVE_PENDING)) return false;
+
+    uint8_t next = (s & LIVE_SLOT) ^ LIVE_SLOT;
+    // Falla solo si la consola retiró la publicación entre medias
+    if (!liveState.compare_exchange_strong(s, next, std::memory_order_acq_rel)) return false;
 
-    prefs.end();
+    activeIndex.store(liveIndex[next], std::memory_order_relaxed);
+    return true;
+}
+
+bool ThresholdManager::saveToStore() {
+    // Solo se actualiza la copia en RAM; ConfigStore agrupa y escribe una vez
+    ConfigStore& store = ConfigStore::getInstance();
+    std::lock_guard<std::mutex> lock(writer);
+    bool republish = false;
+    for (uint8_t i = 0; i < MAX_PROFILES; i++) {
+        if (!profiles[i].valid || !dirty[i]) continue;
+        profiles[i].revision++;
+        dirty[i] = false;
+        store.setProfile(i, profiles[i]);
+        if (i == selected) republish = true;
+    }
+    store.setActiveProfile(selected);
+    // El loop ve la revisión nueva en el próximo estado seguro
+    if (republish) publish();
     return true;
 }
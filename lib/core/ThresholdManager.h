@@ -1,35 +1,143 @@
 #pragma once
 
-#include <map>
+#include <atomic>
+#include <mutex>
 #include <string>
 #include <vector>
+#include "TuningProfile.h"
 
-struct Thresholds {
-    float MAP_WAKEUP_PERCENT;
-    float INJ_TPS_ON;
-    float INJ_MAP_ON;
-    float INJ_TPS_OFF;
-    float INJ_MAP_OFF;
-    float VORTEX_TPS_ON;
-    float VORTEX_MAP_ON;
-    float VORTEX_TPS_OFF;
-};
-
+/**
+ * @class ThresholdManager
+ * Almacén de perfiles de ajuste con nombre ("base", "calle", "pista"...).
+ *
+ * La consola edita y selecciona perfiles; el loop de control solo lee el
+ * perfil vigente. Entre ambos hay un doble buffer: cada cambio se escribe en
+ * la copia libre y se marca como pendiente, y el loop la adopta con
+ * applyPending() cuando la FSM está en un estado seguro. Así el loop nunca
+ * copia, parsea ni espera un mutex.
+ *
+ * Las ediciones clave a clave se acumulan en un borrador y solo llegan al
+ * perfil (y al loop) de una vez con applyEdits() o save(), tras comprobar
+ * checkProfile(): un juego a medio editar nunca se publica.
+ */
 class ThresholdManager {
 public:
+    static constexpr float MIN_HYSTERESIS = 1.0f;  ///< % mínimo entre un umbral ON y su OFF
+    static constexpr uint8_t NO_SLOT = 0xFF;        ///< Borrador sin perfil destino
+
+    enum class EditResult : uint8_t {
+        OK,        ///< Aplicado (o nada pendiente en save())
+        NO_EDITS,  ///< No había borrador
+        NO_SLOT,   ///< El borrador no tiene perfil destino
+        INVALID,   ///< No cumple checkProfile(); el borrador se conserva
+    };
+
+    ThresholdManager();
+    ThresholdManager(const ThresholdManager&) = delete;
+    ThresholdManager& operator=(const ThresholdManager&) = delete;
+
+    /// Carga los perfiles guardados (o guarda el de fábrica si no hay ninguno)
     bool begin();
 
+    /// Umbrales confirmados del perfil seleccionado (sin el borrador)
     Thresholds getThresholds() const;
+
+    /**
+     * Ajusta un valor en el borrador, que se abre sobre el perfil seleccionado
+     * si no había uno. No se publica nada hasta applyEdits() o save().
+     * @param key Nombre de un umbral o FREQ_MIN_HZ / FREQ_MAX_HZ.
+     * @return false si la clave no existe.
+     */
     bool setThreshold(const std::string& key, float value);
-    bool save();
+    /**
+     * Abre un borrador nuevo sobre la ranura index (descarta el anterior).
+     * Con NO_SLOT las ediciones se aceptan pero nunca se aplican: así un
+     * bloque importado cuyo perfil no se pudo crear no cae en otro.
+     */
+    bool editProfile(uint8_t index);
+    /**
+     * Valida el borrador y lo copia a su perfil; si es el seleccionado, lo
+     * publica al loop en un solo paso.
+     * @param reason Si no es nullptr, recibe el motivo de un INVALID.
+     */
+    EditResult applyEdits(const char** reason = nullptr);
+    void discardEdits();
+    /// Copia del borrador; false si no hay ninguno
+    bool getEdits(TuningProfile& out) const;
+    /// Ranura del borrador, NO_SLOT si no tiene destino, -1 si no hay borrador
+    int getEditIndex() const;
+
+    /// applyEdits() si hay borrador y, si sale bien, persiste vía ConfigStore
+    EditResult save(const char** reason = nullptr);
     bool reset();
 
+    /**
+     * Invariantes de un perfil publicable: umbrales entre 0 y 100 %, cada ON
+     * al menos MIN_HYSTERESIS por encima de su OFF, vortex por encima de la
+     * inyección y barrido de frecuencia creciente.
+     * @return nullptr si es válido; si no, el motivo.
+     */
+    static const char* checkProfile(const TuningProfile& profile);
+
     std::vector<std::string> listKeys() const;
 
+    // --- Perfiles ---
+
+    /// Copia de la ranura index; false si está vacía
+    bool getProfile(uint8_t index, TuningProfile& out) const;
+    /// Índice del perfil con ese nombre o -1
+    int findProfile(const char* name) const;
+    /// Selecciona un perfil; el loop lo adopta en el próximo estado seguro
+    bool selectProfile(uint8_t index);
+    /**
+     * Crea un perfil copiando el seleccionado (no lo selecciona).
+     * @return Índice nuevo o -1 si no hay ranuras o el nombre ya existe.
+     */
+    int createProfile(const char* name);
+    /**
+     * "perfil nuevo": crea el perfil (o reutiliza el que ya tiene ese nombre)
+     * y abre el borrador sobre él. Si no se puede, el borrador queda sin
+     * destino (NO_SLOT).
+     * @return Índice del perfil en edición o -1.
+     */
+    int createAndEdit(const char* name);
+    uint8_t getSelectedIndex() const;
+    /// Perfil que usa el loop en este momento
+    uint8_t getActiveIndex() const { return activeIndex.load(std::memory_order_relaxed); }
+
+    // --- Lado del loop de control (un solo consumidor) ---
+
+    /**
+     * Adopta el último perfil publicado, si lo hay.
+     * @return true si cambió el perfil vigente.
+     */
+    bool applyPending();
+    /// Perfil vigente; la referencia es estable hasta el próximo applyPending()
+    const TuningProfile& active() const { return live[liveState.load(std::memory_order_acquire) & LIVE_SLOT]; }
+
+    static TuningProfile factoryProfile();
+
 private:
-    std::map<std::string, float> thresholds;
+    static constexpr uint8_t LIVE_SLOT    = 0x01;  ///< Copia que lee el loop
+    static constexpr uint8_t LIVE_PENDING = 0x02;  ///< La otra copia está lista
+
+    TuningProfile profiles[MAX_PROFILES];
+    bool dirty[MAX_PROFILES] = {};
+    uint8_t selected = 0;
+    mutable std::mutex writer;
+
+    TuningProfile draft;
+    bool drafting = false;
+    uint8_t draftIndex = NO_SLOT;
+
+    TuningProfile live[2];
+    uint8_t liveIndex[2] = {0, 0};
+    std::atomic<uint8_t> liveState{0};
+    std::atomic<uint8_t> activeIndex{0};
 
-    void loadDefaults();
-    bool loadFromNVS();
-    bool saveToNVS();
+    float* field(TuningProfile& profile, const std::string& key) const;
+    int createLocked(const char* name);
+    EditResult applyLocked(const char** reason);
+    void publish();
+    bool saveToStore();
 };
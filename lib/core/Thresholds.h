@@ -0,0 +1,17 @@
+#pragma once
+
+/**
+ * @struct Thresholds
+ * Umbrales (en %) que usa la FSM para decidir las transiciones.
+ * Es un bloque plano de floats para poder copiarse y persistirse tal cual.
+ */
+struct Thresholds {
+    float MAP_WAKEUP_PERCENT;
+    float INJ_TPS_ON;
+    float INJ_MAP_ON;
+    float INJ_TPS_OFF;
+    float INJ_MAP_OFF;
+    float VORTEX_TPS_ON;
+    float VORTEX_MAP_ON;
+    float VORTEX_TPS_OFF;
+};
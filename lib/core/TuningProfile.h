@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+#include "Thresholds.h"
+
+constexpr uint8_t MAX_PROFILES     = 4;   ///< Perfiles guardados en el blob
+constexpr uint8_t PROFILE_NAME_LEN = 12;  ///< Incluye el terminador
+
+constexpr float DEFAULT_FREQ_MIN_HZ = 4200.0f;  ///< Onda a baja carga MAP
+constexpr float DEFAULT_FREQ_MAX_HZ = 6400.0f;  ///< Onda a alta carga MAP
+
+/**
+ * @struct ActuationMap
+ * Cómo se traduce la carga en la señal del inyector acústico.
+ */
+struct ActuationMap {
+  float freqMinHz = DEFAULT_FREQ_MIN_HZ;
+  float freqMaxHz = DEFAULT_FREQ_MAX_HZ;
+};
+
+/**
+ * @struct TuningProfile
+ * Juego completo con nombre (p. ej. "calle", "pista"): umbrales de la FSM y
+ * mapa de actuación. Plano para copiarse y persistirse tal cual.
+ */
+struct TuningProfile {
+  char         name[PROFILE_NAME_LEN] = {};
+  uint16_t     revision = 0;   ///< Sube cada vez que se guarda con cambios
+  uint8_t      valid = 0;      ///< 1 si la ranura está en uso
+  uint8_t      reserved = 0;
+  Thresholds   thresholds{};
+  ActuationMap actuation;
+};
+
+static_assert(sizeof(TuningProfile) == 56, "TuningProfile cambió de layout: subir versión del esquema");
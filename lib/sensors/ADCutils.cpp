@@ -15,3 +15,13 @@ adc1_channel_t pinToADCChannel(uint8_t pin) {
     default: return ADC1_CHANNEL_0; // Fallback
   }
 }
+
+std::mutex& adc1Mutex() {
+  static std::mutex mtx;
+  return mtx;
+}
+
+uint16_t analogReadAdc1(uint8_t pin) {
+  std::lock_guard<std::mutex> lock(adc1Mutex());
+  return analogRead(pin);
+}
@@ -1,6 +1,17 @@
 #pragma once
 #include <Arduino.h>
 #include "driver/adc.h"
+#include <mutex>
 
 
 adc1_channel_t pinToADCChannel(uint8_t pin);
+
+/**
+ * ADC1 lo comparten las lecturas de MAP y TPS (analogRead) con las ventanas
+ * de captura por I2S del micrófono (AcousticMonitor): mientras el I2S lo
+ * tiene, analogRead no lee. Quien use ADC1 lo toma con este mutex.
+ */
+std::mutex& adc1Mutex();
+
+/// analogRead de un pin de ADC1 con el mutex tomado
+uint16_t analogReadAdc1(uint8_t pin);
@@ -0,0 +1,126 @@
+#include "CalibrationEngine.h"
+#include <string.h>
+
+static inline uint16_t median3(uint16_t a, uint16_t b, uint16_t c) {
+  if (a > b) { uint16_t t = a; a = b; b = t; }
+  if (b > c) { b = c; }
+  return a > b ? a : b;
+}
+
+static inline float clamp01(float v) {
+  return v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+}
+
+void ChannelHistogram::reset() {
+  memset(bins, 0, sizeof(bins));
+  samples = spikes = accepted = 0;
+  residualSum = 0.0f;
+  filled = 0;
+}
+
+void ChannelHistogram::add(uint16_t raw) {
+  if (raw > 4095) raw = 4095;
+
+  window[0] = window[1];
+  window[1] = window[2];
+  window[2] = raw;
+  if (filled < 3) {
+    ++filled;
+    if (filled < 3) return;  // hasta tener 3 muestras no hay mediana
+  }
+
+  // La muestra central se sustituye por la mediana: un pico aislado desaparece
+  uint16_t center = window[1];
+  uint16_t med = median3(window[0], window[1], window[2]);
+  uint16_t residual = center > med ? center - med : med - center;
+
+  if (residual > SPIKE_THRESHOLD) {
+    ++spikes;
+  } else {
+    residualSum += residual;
+    ++accepted;
+  }
+
+  uint16_t bin = med >> BIN_SHIFT;
+  if (bins[bin] < UINT16_MAX) ++bins[bin];
+  ++samples;
+}
+
+uint16_t ChannelHistogram::valueAtRank(uint32_t rank) const {
+  uint32_t cumulative = 0;
+  for (uint16_t b = 0; b < BIN_COUNT; ++b) {
+    uint32_t n = bins[b];
+    if (n == 0) continue;
+    if (cumulative + n > rank) {
+      // Interpolar la posición del rank dentro del bin
+      uint32_t width = 1u << BIN_SHIFT;
+      uint32_t offset = ((rank - cumulative) * width + width / 2) / n;
+      return static_cast<uint16_t>((b << BIN_SHIFT) + offset);
+    }
+    cumulative += n;
+  }
+  return 4095;
+}
+
+uint32_t ChannelHistogram::countBetween(uint16_t lo, uint16_t hi) const {
+  uint32_t total = 0;
+  for (uint16_t b = lo >> BIN_SHIFT; b <= (hi >> BIN_SHIFT) && b < BIN_COUNT; ++b) {
+    total += bins[b];
+  }
+  return total;
+}
+
+void CalibrationEngine::reset() {
+  tps.reset();
+  map.reset();
+}
+
+void CalibrationEngine::addSample(uint16_t tpsRaw, uint16_t mapRaw) {
+  tps.add(tpsRaw);
+  map.add(mapRaw);
+}
+
+ChannelReport CalibrationEngine::evaluateChannel(const ChannelHistogram& h) {
+  ChannelReport r;
+  r.samples = h.getSamples();
+  uint32_t observed = r.samples + (r.samples ? 2 : 0);  // las 2 primeras solo llenan la ventana
+  r.spikeRate = observed ? static_cast<float>(h.getSpikes()) / observed : 0.0f;
+  r.noise = h.getNoise();
+  if (r.samples == 0) return r;
+
+  uint32_t tail = static_cast<uint32_t>(r.samples * TAIL_FRACTION);
+  if (tail < MIN_TAIL_SAMPLES) tail = MIN_TAIL_SAMPLES;
+  if (tail * 2 >= r.samples) tail = (r.samples - 1) / 2;
+
+  r.min = h.valueAtRank(tail);
+  r.max = h.valueAtRank(r.samples - 1 - tail);
+
+  uint16_t span = r.max > r.min ? r.max - r.min : 0;
+  r.degenerate = span < MIN_SPAN;
+  if (r.degenerate) return r;
+
+  // Confianza: producto de factores independientes en [0–1]
+  float countScore = clamp01(static_cast<float>(r.samples) / MIN_SAMPLES);
+  float snrScore   = clamp01(span / (20.0f * (r.noise + 1.0f)));   // rango ≥ 20× ruido
+  float spikeScore = clamp01(1.0f - r.spikeRate * 10.0f);          // 10% de picos → 0
+
+  // Ambos extremos deben visitarse de verdad: ≥2% de muestras cerca de cada uno
+  uint16_t band = span / 20;
+  uint32_t nearMin = h.countBetween(r.min, r.min + band);
+  uint32_t nearMax = h.countBetween(r.max > band ? r.max - band : 0, r.max);
+  float supportMin = clamp01(nearMin / (0.02f * r.samples));
+  float supportMax = clamp01(nearMax / (0.02f * r.samples));
+
+  r.quality = countScore * snrScore * spikeScore * supportMin * supportMax;
+  return r;
+}
+
+CalibrationReport CalibrationEngine::evaluate() const {
+  CalibrationReport report;
+  report.tps = evaluateChannel(tps);
+  report.map = evaluateChannel(map);
+  report.quality = report.tps.quality < report.map.quality ? report.tps.quality : report.map.quality;
+  report.accepted = !report.tps.degenerate && !report.map.degenerate
+                 && report.quality >= MIN_QUALITY;
+  return report;
+}
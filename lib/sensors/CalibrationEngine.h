@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * @struct ChannelReport
+ * Resultado estadístico de un canal (TPS o MAP) al final de la calibración.
+ */
+struct ChannelReport {
+  uint16_t min = 0;          ///< Extremo inferior robusto (ADC crudo)
+  uint16_t max = 0;          ///< Extremo superior robusto (ADC crudo)
+  uint32_t samples = 0;      ///< Muestras aceptadas
+  float    noise = 0.0f;     ///< Ruido medio estimado (cuentas ADC)
+  float    spikeRate = 0.0f; ///< Fracción de muestras descartadas como pico
+  float    quality = 0.0f;   ///< Confianza [0–1]
+  bool     degenerate = true;///< Rango demasiado estrecho para usarse
+};
+
+/**
+ * @struct CalibrationReport
+ * Resultado combinado de ambos canales.
+ */
+struct CalibrationReport {
+  ChannelReport tps;
+  ChannelReport map;
+  float quality = 0.0f;      ///< Mínimo de la confianza de ambos canales
+  bool  accepted = false;    ///< true si el rango puede guardarse
+};
+
+/**
+ * @class ChannelHistogram
+ * Acumula un canal ADC de 12 bits en un histograma de memoria fija y
+ * descarta picos aislados con una mediana de 3 muestras.
+ */
+class ChannelHistogram {
+public:
+  static constexpr uint8_t  BIN_SHIFT = 2;                  ///< 4 cuentas ADC por bin
+  static constexpr uint16_t BIN_COUNT = 4096 >> BIN_SHIFT;
+  static constexpr uint16_t SPIKE_THRESHOLD = 64;           ///< Salto respecto a la mediana que se considera pico
+
+  void reset();
+  void add(uint16_t raw);
+
+  /**
+   * Valor crudo por debajo del cual quedan `rank` muestras (rank en [0, samples)).
+   * Interpola linealmente dentro del bin.
+   */
+  uint16_t valueAtRank(uint32_t rank) const;
+
+  uint32_t countBetween(uint16_t lo, uint16_t hi) const;
+
+  uint32_t getSamples() const { return samples; }
+  uint32_t getSpikes() const { return spikes; }
+  float getNoise() const { return accepted ? residualSum / accepted : 0.0f; }
+
+private:
+  uint16_t bins[BIN_COUNT];
+  uint32_t samples = 0;
+  uint32_t spikes = 0;
+  uint32_t accepted = 0;       ///< Muestras que contribuyen a la estimación de ruido
+  float    residualSum = 0.0f;
+  uint16_t window[3] = {0, 0, 0};
+  uint8_t  filled = 0;
+};
+
+/**
+ * @class CalibrationEngine
+ * Calibración estadística: en lugar de min/max crudos usa percentiles robustos
+ * del histograma de cada canal, de modo que un pico del ADC no ensancha el rango.
+ * No depende de Arduino: se puede alimentar con trazas grabadas o sintéticas.
+ */
+class CalibrationEngine {
+public:
+  static constexpr float    TAIL_FRACTION = 0.005f;  ///< Fracción de muestras ignoradas en cada cola
+  static constexpr uint32_t MIN_TAIL_SAMPLES = 5;    ///< Un extremo debe estar respaldado por al menos N muestras
+  static constexpr uint32_t MIN_SAMPLES = 200;       ///< Muestras para confianza plena (4 s a 50 Hz)
+  static constexpr uint16_t MIN_SPAN = 40;           ///< Rango mínimo aceptable (cuentas ADC)
+  static constexpr float    MIN_QUALITY = 0.3f;      ///< Confianza mínima para guardar
+
+  void reset();
+  void addSample(uint16_t tpsRaw, uint16_t mapRaw);
+
+  /**
+   * Calcula extremos robustos, ruido, tasa de picos y confianza de ambos canales.
+   */
+  CalibrationReport evaluate() const;
+
+  uint32_t getSamples() const { return tps.getSamples(); }
+
+private:
+  ChannelHistogram tps;
+  ChannelHistogram map;
+
+  static ChannelReport evaluateChannel(const ChannelHistogram& h);
+};
@@ -1,4 +1,6 @@
 #include "CalibrationManager.h"
+#include "ConfigStore.h"
+#include "Logger.h"
 #include <Arduino.h>
 
 CalibrationManager& CalibrationManager::getInstance() {
@@ -7,36 +9,29 @@ CalibrationManager& CalibrationManager::getInstance() {
 }
 
 void CalibrationManager::begin(SensorManager* _sensors) {
-  prefs.begin("calib", false);
-  prefs.end();
   sensors = _sensors;
   currentStep = CalibStep::TPS_MIN;
 
 }
 
-// Si no existen las 4 claves, pide calibración
+// Si no hay calibración completa guardada, pide calibración
 bool CalibrationManager::loadCalibration() {
-  prefs.begin("calib", false);
-  bool ready = prefs.isKey("map_min")
-            && prefs.isKey("map_max")
-            && prefs.isKey("tps_min")
-            && prefs.isKey("tps_max");
-  if (!ready) {
-    Serial.println(">> No hay datos de calibración. Ejecute calibración.");
-    prefs.end();
+  CalibrationData data = ConfigStore::getInstance().getCalibration();
+  if (!data.valid) {
+    LOG_W(">> No hay datos de calibración. Ejecute calibración.");
     return false;
   }
 
-  mapMin = prefs.getUShort("map_min");
-  mapMax = prefs.getUShort("map_max");
-  tpsMin = prefs.getUShort("tps_min");
-  tpsMax = prefs.getUShort("tps_max");
-  prefs.end();
+  mapMin = data.mapMin;
+  mapMax = data.mapMax;
+  tpsMin = data.tpsMin;
+  tpsMax = data.tpsMax;
+  drift.begin(data);
 
   bool valid = mapMax > mapMin && tpsMax > tpsMin;
-  //Serial.printf(">> Calibración cargada: MAP[%u–%u], TPS[%u–%u] %s\n",
-  //              mapMin, mapMax, tpsMin, tpsMax,
-  //              valid ? "(OK)" : "(inválido)");
+  LOG_D(">> Calibración cargada: MAP[%u–%u], TPS[%u–%u] %s",
+        mapMin, mapMax, tpsMin, tpsMax,
+        valid ? "(OK)" : "(inválido)");
   return valid;
 }
 
@@ -46,46 +41,60 @@ void CalibrationManager::loadDebugCalibration() {
   mapMin = static_cast<uint16_t>((3.05f / 3.3f) * 4095);
   mapMax = static_cast<uint16_t>((3.26f / 3.3f) * 4095);
 
-  Serial.println(">> Calibración DEBUG cargada (valores hardcodeados).");
+  LOG_I(">> Calibración DEBUG cargada (valores hardcodeados).");
 }
 
 
-// Borra NVS y valores en RAM
+// Borra la calibración persistida y los valores en RAM
 void CalibrationManager::clearCalibration() {
-  prefs.begin("calib", false);
-  prefs.clear();
-  prefs.end();
-  
+  ConfigStore::getInstance().clearCalibration();
+
   mapMin = mapMax = tpsMin = tpsMax = 0;
-  Serial.println(">> Umbrales borrados. Requiere calibración.");
+  drift = DriftCompensator();
+  LOG_I(">> Umbrales borrados. Requiere calibración.");
   calibrationDone = false;
   currentStep = CalibStep::TPS_MIN;
 
 }
 
-// Graba los 4 valores actuales
+// No borra nada: saveCalibration() solo se llama si el informe se acepta
+void CalibrationManager::startCalibration() {
+  engine.reset();
+  calibRunning = false;  // runAutoCalibration() vuelve a empezar desde cero
+  calibrationDone = false;
+}
+
+// Entrega los 4 valores actuales a ConfigStore (se escriben en un único commit).
+// Es una calibración manual: pasan a ser también las referencias de la deriva.
 bool CalibrationManager::saveCalibration() {
-  prefs.begin("calib", false);
-  prefs.putUShort("map_min", mapMin);
-  prefs.putUShort("map_max", mapMax);
-  prefs.putUShort("tps_min", tpsMin);
-  prefs.putUShort("tps_max", tpsMax);
-  prefs.end();
-  Serial.println(">> Valores de calibración guardados en NVS.");
+  CalibrationData data;
+  data.mapMin = data.mapMinRef = mapMin;
+  data.mapMax = data.mapMaxRef = mapMax;
+  data.tpsMin = data.tpsMinRef = tpsMin;
+  data.tpsMax = data.tpsMaxRef = tpsMax;
+  data.valid  = 1;
+  ConfigStore::getInstance().setCalibration(data);
+  drift.begin(data);
+  LOG_I(">> Valores de calibración guardados.");
   return true;
 }
 
-// Guarda un solo paso inmediatamente
-void CalibrationManager::saveStep(CalibStep step, uint16_t value) {
-  prefs.begin("calib", false);
-  switch(step) {
-    case CalibStep::MAP_MAX: prefs.putUShort("map_max", value); break;
-    case CalibStep::MAP_MIN: prefs.putUShort("map_min", value); break;
-    case CalibStep::TPS_MIN: prefs.putUShort("tps_min", value); break;
-    case CalibStep::TPS_MAX: prefs.putUShort("tps_max", value); break;
+// Aplica la compensación de deriva y la persiste solo si ya es significativa
+void CalibrationManager::trackDrift() {
+  if (!driftEnabled || simulation || !drift.isActive()) return;
+
+  if (!drift.update(sensors->getLastTPSRaw(), sensors->getLastMAPRaw(), millis())) return;
+
+  CalibrationData data = ConfigStore::getInstance().getCalibration();
+  drift.apply(data);
+  tpsMin = data.tpsMin;
+  tpsMax = data.tpsMax;
+  mapMax = data.mapMax;
+
+  if (drift.shouldPersist()) {
+    ConfigStore::getInstance().setCalibration(data);
+    drift.markPersisted();
   }
-  prefs.end();
-  Serial.printf(">> Paso %d guardado: %u\n", int(step), value);
 }
 
 // Función para esperar ENTER y descartar secuencias de escape o caracteres extraños
@@ -115,71 +124,77 @@ bool waitForEnter() {
 }
 
 bool CalibrationManager::runAutoCalibration(SensorManager& sensors, bool simulacionActiva) {
-  static bool initialized = false;
-  static unsigned long startTime = 0;
-  static uint16_t tpsMinCandidate = UINT16_MAX;
-  static uint16_t tpsMaxCandidate = 0;
-  static uint16_t mapMinCandidate = UINT16_MAX;
-  static uint16_t mapMaxCandidate = 0;
-
-  if (!initialized) {
-    Serial.println(F("\n━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"));
-    Serial.println(F(" CALIBRACIÓN AUTOMÁTICA EN PROGRESO (20s)"));
-    Serial.println(F("  >> No presiones nada. Mueve el acelerador libremente."));
-    Serial.println(F("  >> Motor encendido por MAP_MAX. Motor apagado para MAP_MIN."));
-    Serial.println(F("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━"));
-    startTime = millis();
-    initialized = true;
+  if (!calibRunning) {
+    LOG_I("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
+    LOG_I(" CALIBRACIÓN AUTOMÁTICA EN PROGRESO (%lus)", CALIB_DURATION_MS / 1000);
+    LOG_I("  >> No presiones nada. Mueve el acelerador libremente.");
+    LOG_I("  >> Motor encendido por MAP_MAX. Motor apagado para MAP_MIN.");
+    LOG_I("━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━━");
+    engine.reset();
+    calibStartMs = millis();
+    lastProgressMs = 0;
+    calibRunning = true;
   }
 
-  // Leer sensores
+  // Leer sensores y acumular en los histogramas
   uint16_t tpsRaw = sensors.readTPSRaw();
   uint16_t mapRaw = sensors.readMAPRaw();
+  engine.addSample(tpsRaw, mapRaw);
+
+  // Mostrar en consola los extremos robustos actuales
+  if (millis() - lastProgressMs >= CALIB_PROGRESS_MS) {
+    lastProgressMs = millis();
+    CalibrationReport live = engine.evaluate();
+    LOG_I(
+      "\rTPS=%.2fV [%.2f ⇄ %.2f] | MAP=%.2fV [%.2f ⇄ %.2f] | Q=%3.0f%%   ",
+      sensors.representVoltsFromRaw(tpsRaw),
+      sensors.representVoltsFromRaw(live.tps.min), sensors.representVoltsFromRaw(live.tps.max),
+      sensors.representVoltsFromRaw(mapRaw),
+      sensors.representVoltsFromRaw(live.map.min), sensors.representVoltsFromRaw(live.map.max),
+      live.quality * 100.0f
+    );
+  }
 
-  // Actualizar candidatos
-  tpsMinCandidate = min(tpsMinCandidate, tpsRaw);
-  tpsMaxCandidate = max(tpsMaxCandidate, tpsRaw);
-  mapMinCandidate = min(mapMinCandidate, mapRaw);
-  mapMaxCandidate = max(mapMaxCandidate, mapRaw);
-
-  // Mostrar en consola
-  float tpsVolts = sensors.representVoltsFromRaw(tpsRaw);
-  float tpsMinVolts = sensors.representVoltsFromRaw(tpsMinCandidate);
-  float tpsMaxVolts = sensors.representVoltsFromRaw(tpsMaxCandidate);
-
-  float mapVolts = sensors.representVoltsFromRaw(mapRaw);
-  float mapMinVolts = sensors.representVoltsFromRaw(mapMinCandidate);
-  float mapMaxVolts = sensors.representVoltsFromRaw(mapMaxCandidate);
-
-  Serial.printf(
-    "\rTPS=%.2fV [%.2f ⇄ %.2f] | MAP=%.2fV [%.2f ⇄ %.2f]   ",
-    tpsVolts, tpsMinVolts, tpsMaxVolts,
-    mapVolts, mapMinVolts, mapMaxVolts
-  );
-
-  if (millis() - startTime >= 10000) {
-    Serial.println(F("\n\n>> Tiempo finalizado. Guardando calibración..."));
-
-    // Guardar en miembros internos
-    tpsMin = tpsMinCandidate;
-    tpsMax = tpsMaxCandidate;
-    mapMin = mapMinCandidate;
-    mapMax = mapMaxCandidate;
-
-    // Guardar en NVS
-    saveStep(CalibStep::TPS_MIN, tpsMin);
-    saveStep(CalibStep::TPS_MAX, tpsMax);
-    saveStep(CalibStep::MAP_MIN, mapMin);
-    saveStep(CalibStep::MAP_MAX, mapMax);
-
-    // Reset y marcar como terminado
-    initialized = false;
-    calibrationDone = true;
+  if (millis() - calibStartMs < CALIB_DURATION_MS) {
+    return false;
+  }
+
+  calibRunning = false;
+  calibrationDone = true;
+  lastReport = engine.evaluate();
 
-    Serial.println(F("✔ Calibración completada y almacenada."));
+  LOG_I("\n>> Tiempo finalizado.");
+  printReport(lastReport);
+
+  if (!lastReport.accepted) {
+    // No se toca la calibración anterior: ni en RAM ni en ConfigStore
+    LOG_W("✖ Calibración rechazada: rango degenerado o confianza insuficiente.");
     return true;
   }
-  return false;
+
+  tpsMin = lastReport.tps.min;
+  tpsMax = lastReport.tps.max;
+  mapMin = lastReport.map.min;
+  mapMax = lastReport.map.max;
+
+  // Guardar los 4 valores juntos
+  saveCalibration();
+
+  LOG_I("✔ Calibración completada y almacenada.");
+  return true;
+}
+
+void CalibrationManager::printReport(const CalibrationReport& report) const {
+  const ChannelReport* channels[] = { &report.tps, &report.map };
+  const char* names[] = { "TPS", "MAP" };
+  for (int i = 0; i < 2; ++i) {
+    const ChannelReport& c = *channels[i];
+    LOG_I("  %s: [%u–%u] muestras=%lu ruido=%.1f picos=%.1f%% confianza=%.0f%%%s",
+          names[i], c.min, c.max, (unsigned long)c.samples, c.noise,
+          c.spikeRate * 100.0f, c.quality * 100.0f,
+          c.degenerate ? " (DEGENERADO)" : "");
+  }
+  LOG_I("  Confianza global: %.0f%%", report.quality * 100.0f);
 }
 
 // Getters
@@ -189,15 +204,19 @@ uint16_t CalibrationManager::getTPSMin() const { return tpsMin; }
 uint16_t CalibrationManager::getTPSMax() const { return tpsMax; }
 
 void CalibrationManager::update(bool sim) {
-  if (calibrationDone || sensors == nullptr) {
+  if (sensors == nullptr) {
     return;
   }
   simulation = sim;
 
+  if (calibrationDone) {
+    trackDrift();
+    return;
+  }
+
   // Llamar runAutoCalibration y verificar si terminó
   if (runAutoCalibration(*sensors, sim)) {
     calibrationDone = true;
-    saveCalibration();
     loadCalibration();
   }
 }
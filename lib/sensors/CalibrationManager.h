@@ -1,6 +1,7 @@
 #pragma once
 #include "SensorManager.h"
-#include <Preferences.h>
+#include "CalibrationEngine.h"
+#include "DriftCompensator.h"
 
 
 enum class CalibStep {
@@ -13,6 +14,9 @@ enum class CalibStep {
 
 class CalibrationManager {
 public:
+  static constexpr unsigned long CALIB_DURATION_MS = 20000;  // Duración de la calibración automática
+  static constexpr unsigned long CALIB_PROGRESS_MS = 250;    // Intervalo de refresco del progreso
+
   static CalibrationManager& getInstance();
 
   void begin(SensorManager* sensors);
@@ -26,7 +30,10 @@ public:
 
   void clearCalibration();
 
-  bool saveCalibration();         // guarda mapMin, mapMax, tpsMin, tpsMax
+  /// Arranca una calibración automática; la anterior sigue en uso y guardada hasta que la nueva se acepte
+  void startCalibration();
+
+  bool saveCalibration();         // entrega mapMin, mapMax, tpsMin, tpsMax a ConfigStore
   bool runAutoCalibration(SensorManager& sensors, bool simulacionActiva);
 
 
@@ -35,9 +42,15 @@ public:
   uint16_t getTPSMin() const;
   uint16_t getTPSMax() const;
 
+  // Resultado estadístico de la última calibración automática
+  const CalibrationReport& getLastReport() const { return lastReport; }
+
+  // Recalibración continua en segundo plano
+  void enableDriftCompensation(bool enable) { driftEnabled = enable; }
+  const DriftCompensator& getDrift() const { return drift; }
+
 private:
   CalibrationManager() = default;
-  Preferences prefs;
   bool simulation = false;
   bool calibrationDone = true;
   SensorManager* sensors = nullptr;  // <-- Aquí se guarda el puntero recibido
@@ -50,5 +63,15 @@ private:
 
   bool debugMode = false;  // Modo debug hardcodeado
 
-  void saveStep(CalibStep step, uint16_t value);
+  CalibrationEngine engine;           // Histogramas de la calibración en curso
+  CalibrationReport lastReport;
+  bool calibRunning = false;
+  unsigned long calibStartMs = 0;
+  unsigned long lastProgressMs = 0;
+
+  DriftCompensator drift;
+  bool driftEnabled = true;
+
+  void printReport(const CalibrationReport& report) const;
+  void trackDrift();
 };
@@ -0,0 +1,105 @@
+#include "DriftCompensator.h"
+
+void EndpointTracker::reset(Side endpointSide, uint16_t reference, uint16_t current, uint16_t guardCounts) {
+  status = EndpointStatus();
+  side = endpointSide;
+  status.reference = reference;
+  status.estimate = current;
+  guard = guardCounts;
+  tracking = false;
+}
+
+bool EndpointTracker::update(uint16_t raw, uint32_t nowMs) {
+  uint16_t diff = raw > anchor ? raw - anchor : anchor - raw;
+  if (!tracking || diff > PLATEAU_BAND) {
+    // Empieza una meseta candidata en esta muestra
+    tracking = true;
+    anchor = raw;
+    startMs = nowMs;
+    sum = raw;
+    count = 1;
+    return false;
+  }
+
+  sum += raw;
+  ++count;
+  if (nowMs - startMs < PLATEAU_MS) return false;
+
+  // Meseta completa: una observación cada PLATEAU_MS mientras siga estable
+  float mean = static_cast<float>(sum) / count;
+  anchor = static_cast<uint16_t>(mean + 0.5f);
+  startMs = nowMs;
+  sum = 0;
+  count = 0;
+
+  // Un extremo solo se desplaza despacio: una meseta claramente dentro del rango
+  // es un punto de operación normal (crucero, ralentí con carga), no deriva
+  float fromRef = mean - status.reference;
+  float error = mean - status.estimate;
+  float inward = side == Side::UPPER ? -error : error;
+  if (fromRef > guard || fromRef < -static_cast<float>(guard) || inward > INWARD_CAPTURE) {
+    ++status.rejected;
+    return false;
+  }
+
+  uint16_t before = getValue();
+  status.estimate += GAIN * error;
+  status.lastObservation = mean;
+  status.residual += 0.1f * ((error < 0 ? -error : error) - status.residual);
+  ++status.observations;
+  return getValue() != before;
+}
+
+uint16_t EndpointTracker::getValue() const {
+  return static_cast<uint16_t>(status.estimate + 0.5f);
+}
+
+uint16_t DriftCompensator::guardFor(uint16_t lo, uint16_t hi) {
+  uint16_t guard = hi > lo ? (hi - lo) / 10 : 0;
+  if (guard < GUARD_MIN) guard = GUARD_MIN;
+  if (guard > GUARD_MAX) guard = GUARD_MAX;
+  return guard;
+}
+
+void DriftCompensator::begin(const CalibrationData& calib) {
+  active = calib.valid && calib.tpsMaxRef > calib.tpsMinRef && calib.mapMaxRef > calib.mapMinRef;
+  if (!active) return;
+
+  uint16_t tpsGuard = guardFor(calib.tpsMinRef, calib.tpsMaxRef);
+  uint16_t mapGuard = guardFor(calib.mapMinRef, calib.mapMaxRef);
+  tpsMin.reset(EndpointTracker::Side::LOWER, calib.tpsMinRef, calib.tpsMin, tpsGuard);
+  tpsMax.reset(EndpointTracker::Side::UPPER, calib.tpsMaxRef, calib.tpsMax, tpsGuard);
+  mapMax.reset(EndpointTracker::Side::UPPER, calib.mapMaxRef, calib.mapMax, mapGuard);
+  markPersisted();
+}
+
+bool DriftCompensator::update(uint16_t tpsRaw, uint16_t mapRaw, uint32_t nowMs) {
+  if (!active) return false;
+  bool changed = tpsMin.update(tpsRaw, nowMs);
+  changed |= tpsMax.update(tpsRaw, nowMs);
+  changed |= mapMax.update(mapRaw, nowMs);
+  return changed;
+}
+
+void DriftCompensator::apply(CalibrationData& calib) const {
+  if (!active) return;
+  calib.tpsMin = tpsMin.getValue();
+  calib.tpsMax = tpsMax.getValue();
+  calib.mapMax = mapMax.getValue();
+}
+
+bool DriftCompensator::shouldPersist() const {
+  if (!active) return false;
+  uint16_t now[3] = { tpsMin.getValue(), tpsMax.getValue(), mapMax.getValue() };
+  for (int i = 0; i < 3; ++i) {
+    uint16_t d = now[i] > persisted[i] ? now[i] - persisted[i] : persisted[i] - now[i];
+    if (d >= PERSIST_DELTA) return true;
+  }
+  return false;
+}
+
+void DriftCompensator::markPersisted() {
+  persisted[0] = tpsMin.getValue();
+  persisted[1] = tpsMax.getValue();
+  persisted[2] = mapMax.getValue();
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <stdint.h>
+#include "ConfigSchema.h"
+
+/**
+ * @struct EndpointStatus
+ * Estado de convergencia de un extremo de calibración.
+ */
+struct EndpointStatus {
+  uint16_t reference = 0;     ///< Valor de la calibración manual
+  float    estimate = 0.0f;   ///< Valor adaptado actual
+  float    lastObservation = 0.0f;
+  float    residual = 0.0f;   ///< Media móvil de |observación − estimación|
+  uint32_t observations = 0;  ///< Mesetas aceptadas
+  uint32_t rejected = 0;      ///< Mesetas fuera de la banda de guarda
+};
+
+/**
+ * @class EndpointTracker
+ * Sigue un extremo de calibración (p.ej. acelerador cerrado) a partir de mesetas
+ * estables observadas durante la conducción normal.
+ */
+class EndpointTracker {
+public:
+  static constexpr uint16_t PLATEAU_BAND = 12;   ///< Variación máxima dentro de una meseta (cuentas ADC)
+  static constexpr uint32_t PLATEAU_MS = 2000;   ///< Duración mínima de una meseta
+  static constexpr float    GAIN = 0.05f;        ///< Peso de cada meseta en la estimación
+  static constexpr uint16_t INWARD_CAPTURE = 8;  ///< Cuánto puede caer una meseta hacia dentro del rango
+
+  /// Extremo inferior o superior del rango: decide hacia dónde es "dentro"
+  enum class Side { LOWER, UPPER };
+
+  /**
+   * @param side      Extremo que se sigue.
+   * @param reference Valor de la calibración manual.
+   * @param current   Valor adaptado de partida.
+   * @param guard     Distancia máxima permitida respecto a reference.
+   */
+  void reset(Side side, uint16_t reference, uint16_t current, uint16_t guard);
+
+  /**
+   * Procesa una muestra cruda.
+   * @return true si la estimación cambió.
+   */
+  bool update(uint16_t raw, uint32_t nowMs);
+
+  uint16_t getValue() const;
+  const EndpointStatus& getStatus() const { return status; }
+
+private:
+  EndpointStatus status;
+  Side side = Side::LOWER;
+  uint16_t guard = 0;
+
+  bool     tracking = false;
+  uint16_t anchor = 0;
+  uint32_t startMs = 0;
+  uint32_t sum = 0;
+  uint32_t count = 0;
+};
+
+/**
+ * @class DriftCompensator
+ * Recalibración continua en segundo plano. Ajusta lentamente los extremos con
+ * referencia física (topes del acelerador y presión atmosférica) dentro de una
+ * banda de guarda alrededor de la calibración manual, e indica cuándo la deriva
+ * acumulada justifica persistir.
+ */
+class DriftCompensator {
+public:
+  static constexpr uint16_t GUARD_MIN = 16;       ///< Banda de guarda mínima (cuentas ADC)
+  static constexpr uint16_t GUARD_MAX = 80;       ///< Banda de guarda máxima (≈65 mV)
+  static constexpr uint16_t PERSIST_DELTA = 6;    ///< Deriva que justifica escribir en flash
+
+  /**
+   * Arranca desde la calibración guardada (usa sus referencias manuales).
+   */
+  void begin(const CalibrationData& calib);
+
+  /**
+   * Procesa una muestra de ambos sensores.
+   * @return true si la calibración adaptada cambió.
+   */
+  bool update(uint16_t tpsRaw, uint16_t mapRaw, uint32_t nowMs);
+
+  /**
+   * Escribe los extremos adaptados en calib (mantiene referencias y validez).
+   */
+  void apply(CalibrationData& calib) const;
+
+  /// true si algún extremo se alejó PERSIST_DELTA o más de lo último persistido
+  bool shouldPersist() const;
+  void markPersisted();
+
+  bool isActive() const { return active; }
+  const EndpointStatus& tpsMinStatus() const { return tpsMin.getStatus(); }
+  const EndpointStatus& tpsMaxStatus() const { return tpsMax.getStatus(); }
+  const EndpointStatus& mapMaxStatus() const { return mapMax.getStatus(); }
+
+  /**
+   * Banda de guarda para un canal: 10% del rango, acotada a [GUARD_MIN, GUARD_MAX].
+   */
+  static uint16_t guardFor(uint16_t lo, uint16_t hi);
+
+private:
+  // MAP mínimo (vacío máximo) no tiene referencia física estable: no se adapta
+  EndpointTracker tpsMin;
+  EndpointTracker tpsMax;
+  EndpointTracker mapMax;
+  uint16_t persisted[3] = {0, 0, 0};
+  bool active = false;
+};
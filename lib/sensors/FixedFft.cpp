@@ -0,0 +1,120 @@
+#include "FixedFft.h"
+#include <math.h>
+
+// Cuarto de onda del seno para FFT_MAX_SIZE: cos/sen de 2πm/FFT_MAX_SIZE por simetría
+static constexpr uint16_t QUARTER = FFT_MAX_SIZE / 4;
+static int16_t s_sine[QUARTER + 1];
+static bool s_sineReady = false;
+
+static void fftInitTables() {
+  if (s_sineReady) return;
+  for (uint16_t i = 0; i <= QUARTER; ++i) {
+    long v = lround(sin(2.0 * M_PI * i / FFT_MAX_SIZE) * 32767.0);
+    s_sine[i] = (int16_t)v;
+  }
+  s_sineReady = true;
+}
+
+// sen(2πm/FFT_MAX_SIZE), m en 0..FFT_MAX_SIZE-1
+static inline int16_t sineAt(uint16_t m) {
+  if (m < QUARTER) return s_sine[m];
+  if (m < 2 * QUARTER) return s_sine[2 * QUARTER - m];
+  if (m < 3 * QUARTER) return (int16_t)-s_sine[m - 2 * QUARTER];
+  return (int16_t)-s_sine[4 * QUARTER - m];
+}
+
+static inline int16_t cosineAt(uint16_t m) {
+  return sineAt((uint16_t)((m + QUARTER) & (FFT_MAX_SIZE - 1)));
+}
+
+static inline int16_t mulQ15(int16_t a, int16_t b) {
+  return (int16_t)(((int32_t)a * b + 0x4000) >> 15);
+}
+
+// Producto complejo por un giro Q15, sin redondear a 16 bits todavía
+static inline void rotate(int16_t xr, int16_t xi, int16_t wr, int16_t wi, int32_t& outR, int32_t& outI) {
+  outR = ((int32_t)xr * wr - (int32_t)xi * wi + 0x4000) >> 15;
+  outI = ((int32_t)xr * wi + (int32_t)xi * wr + 0x4000) >> 15;
+}
+
+// (a ± b) / 2 redondeado
+static inline int16_t halfSum(int32_t a, int32_t b) { return (int16_t)((a + b + 1) >> 1); }
+static inline int16_t halfDiff(int32_t a, int32_t b) { return (int16_t)((a - b + 1) >> 1); }
+
+bool fftValidSize(uint16_t n) {
+  return n >= FFT_MIN_SIZE && n <= FFT_MAX_SIZE && (n & (n - 1)) == 0;
+}
+
+void fftHannWindow(int16_t* x, uint16_t n) {
+  if (!fftValidSize(n)) return;
+  fftInitTables();
+  uint16_t step = FFT_MAX_SIZE / n;
+  // w = (1 - cos)/2 en Q15
+  for (uint16_t i = 0; i < n; ++i) {
+    int16_t w = (int16_t)((32767 - cosineAt((uint16_t)(i * step))) >> 1);
+    x[i] = mulQ15(x[i], w);
+  }
+}
+
+bool fftQ15(int16_t* re, int16_t* im, uint16_t n) {
+  if (!fftValidSize(n)) return false;
+  fftInitTables();
+
+  uint8_t bits = 0;
+  while ((1u << bits) < n) ++bits;
+
+  // Orden de bits invertidos
+  for (uint16_t i = 1, j = 0; i < n; ++i) {
+    uint16_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      int16_t t = re[i]; re[i] = re[j]; re[j] = t;
+      t = im[i]; im[i] = im[j]; im[j] = t;
+    }
+  }
+
+  uint16_t half = 1;  // Distancia de la próxima etapa radix-2
+  if (bits & 1) {
+    for (uint16_t k = 0; k < n; k += 2) {
+      int16_t ar = re[k], ai = im[k];
+      re[k] = halfSum(ar, re[k + 1]);  im[k] = halfSum(ai, im[k + 1]);
+      re[k + 1] = halfDiff(ar, re[k + 1]); im[k + 1] = halfDiff(ai, im[k + 1]);
+    }
+    half = 2;
+  }
+
+  // Dos etapas por pasada: tamaños 2·half y 4·half
+  for (; half < n; half <<= 2) {
+    uint16_t span = half << 2;
+    uint16_t step1 = FFT_MAX_SIZE / (half << 1);  // Giro de la primera etapa
+    uint16_t step2 = FFT_MAX_SIZE / span;         // y de la segunda
+    for (uint16_t j = 0; j < half; ++j) {
+      // e^{-iθ}: (cos, -sen)
+      int16_t w1r = cosineAt(j * step1), w1i = (int16_t)-sineAt(j * step1);
+      int16_t w2r = cosineAt(j * step2), w2i = (int16_t)-sineAt(j * step2);
+      for (uint16_t k = j; k < n; k += span) {
+        uint16_t k1 = k + half, k2 = k1 + half, k3 = k2 + half;
+        int32_t tr, ti;
+
+        // Primera etapa: (k, k1) y (k2, k3) con w1
+        rotate(re[k1], im[k1], w1r, w1i, tr, ti);
+        int16_t ar = halfSum(re[k], tr), ai = halfSum(im[k], ti);
+        int16_t br = halfDiff(re[k], tr), bi = halfDiff(im[k], ti);
+        rotate(re[k3], im[k3], w1r, w1i, tr, ti);
+        int16_t cr = halfSum(re[k2], tr), ci = halfSum(im[k2], ti);
+        int16_t dr = halfDiff(re[k2], tr), di = halfDiff(im[k2], ti);
+
+        // Segunda etapa: (a, c) con w2 y (b, d) con w2·(-i)
+        rotate(cr, ci, w2r, w2i, tr, ti);
+        re[k] = halfSum(ar, tr);  im[k] = halfSum(ai, ti);
+        re[k2] = halfDiff(ar, tr); im[k2] = halfDiff(ai, ti);
+        rotate(dr, di, w2r, w2i, tr, ti);
+        // (tr + i·ti)·(-i) = ti - i·tr
+        re[k1] = halfSum(br, ti);  im[k1] = halfDiff(bi, tr);
+        re[k3] = halfDiff(br, ti); im[k3] = halfSum(bi, tr);
+      }
+    }
+  }
+  return true;
+}
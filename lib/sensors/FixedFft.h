@@ -0,0 +1,35 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * FFT compleja en punto fijo Q15, sin dependencias de Arduino: el ESP32 no
+ * trae biblioteca de señal y el host la compara contra una referencia en
+ * doble precisión (tools/test/test_spectrum_analyzer.cpp).
+ *
+ * Radix-2²: entrada en orden de bits invertidos y las etapas de dos en dos,
+ * cada pareja en una sola pasada con mariposas de 4 puntos (3 productos
+ * complejos por 4 puntos, como radix-4, sin tener que reordenar en base 4).
+ * Con log2(n) impar va primero una etapa radix-2 sin productos. Cada etapa
+ * radix-2 divide entre 2: la salida es la DFT / n y, con entradas de
+ * módulo <= 1 (una señal real lo cumple), nunca desborda.
+ */
+
+constexpr uint16_t FFT_MIN_SIZE = 256;
+constexpr uint16_t FFT_MAX_SIZE = 2048;
+
+/// Potencia de dos entre FFT_MIN_SIZE y FFT_MAX_SIZE
+bool fftValidSize(uint16_t n);
+
+/**
+ * Multiplica por la ventana de Hann (Q15) en el sitio.
+ * @param n Tamaño válido (fftValidSize).
+ */
+void fftHannWindow(int16_t* x, uint16_t n);
+
+/**
+ * FFT en el sitio. La salida queda en orden natural, escalada por 1/n.
+ * @param re,im n muestras Q15.
+ * @return false si n no es un tamaño válido.
+ */
+bool fftQ15(int16_t* re, int16_t* im, uint16_t n);
@@ -0,0 +1,62 @@
+#include "GoertzelDetector.h"
+#include <math.h>
+
+bool GoertzelDetector::tune(float freqHz, float sampleHz, uint16_t windowSamples) {
+  length = 0;
+  restart();
+  if (!(sampleHz > 0.0f) || !(freqHz > 0.0f) || freqHz >= sampleHz / 2.0f) return false;
+
+  if (windowSamples > GOERTZEL_MAX_SAMPLES) windowSamples = GOERTZEL_MAX_SAMPLES;
+  float samplesPerCycle = sampleHz / freqHz;
+  float cycles = floorf(windowSamples / samplesPerCycle + 0.5f);
+  if (cycles < 1.0f) cycles = 1.0f;
+  float n = floorf(cycles * samplesPerCycle + 0.5f);
+  if (n < GOERTZEL_MIN_SAMPLES || n > GOERTZEL_MAX_SAMPLES) return false;
+
+  this->freqHz = freqHz;
+  length = (uint16_t)n;
+  coeff = 2.0f * cosf(2.0f * (float)M_PI * freqHz / sampleHz);
+  closed = 0;
+  return true;
+}
+
+void GoertzelDetector::restart() {
+  s1 = s2 = 0.0f;
+  sum = sumSq = 0.0f;
+  count = 0;
+}
+
+bool GoertzelDetector::finish() {
+  if (length == 0) {
+    restart();
+    return false;
+  }
+  float n = count;
+  float mean = sum / n;
+  float power = s1 * s1 + s2 * s2 - coeff * s1 * s2;  // |X(ω)|², vale con ω fraccionaria
+  bool warmup = !offsetValid;
+  offset += mean;
+  offsetValid = true;
+  if (warmup) {
+    restart();
+    return false;
+  }
+
+  // Pico de un seno de amplitud A en N muestras: |X| = A·N/2
+  float amplitude = power > 0.0f ? 2.0f * sqrtf(power) / n : 0.0f;
+  float variance = sumSq / n - mean * mean;
+  if (variance < 0.0f) variance = 0.0f;
+  float tone = amplitude * amplitude / 2.0f;
+  float rest = variance - tone;
+  float floor = variance * 1e-6f + 1e-12f;  // Tono puro: SNR limitada, no infinita
+  if (rest < floor) rest = floor;
+
+  last.amplitude = amplitude;
+  last.rms = sqrtf(variance);
+  last.mean = offset;
+  last.snrDb = tone > 0.0f ? 10.0f * log10f(tone / rest) : -99.0f;
+  last.samples = count;
+  closed++;
+  restart();
+  return true;
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Detector de un tono por ventanas (Goertzel), muestra a muestra y con
+ * memoria constante: da amplitud del tono, RMS de la entrada sin continua y
+ * relación tono/resto de cada ventana. Sin dependencias de Arduino: lo usa
+ * el monitor del micrófono en el ESP32 y el banco de pruebas en el host.
+ */
+
+constexpr uint16_t GOERTZEL_MIN_SAMPLES = 16;
+constexpr uint16_t GOERTZEL_MAX_SAMPLES = 4096;
+
+/**
+ * @struct GoertzelResult
+ * Una ventana cerrada, en las unidades de la entrada (cuentas del ADC).
+ */
+struct GoertzelResult {
+  float    amplitude = 0.0f;  ///< Pico del tono
+  float    rms = 0.0f;        ///< RMS de la ventana sin la continua
+  float    mean = 0.0f;       ///< Continua de la ventana
+  float    snrDb = -99.0f;    ///< Potencia del tono frente a la del resto
+  uint16_t samples = 0;
+};
+
+class GoertzelDetector {
+public:
+  /**
+   * Sintoniza a freqHz. La ventana se ajusta al número entero de periodos
+   * del tono más cercano a windowSamples: la continua y la frecuencia
+   * negativa apenas se cuelan y no hace falta ventana de ponderación.
+   * Vuelve a empezar la ventana; conserva la estimación de continua.
+   * @return false si la frecuencia no cabe bajo Nyquist o no entra un periodo.
+   */
+  bool tune(float freqHz, float sampleHz, uint16_t windowSamples);
+
+  /// Descarta la ventana en curso (por ejemplo, tras un hueco en la captura)
+  void restart();
+
+  /**
+   * Una muestra. La primera ventana tras crear el detector solo mide la
+   * continua y no da resultado.
+   * @return true si cierra una ventana; el resultado queda en result().
+   */
+  inline bool push(float x) {
+    x -= offset;
+    float s0 = x + coeff * s1 - s2;
+    s2 = s1;
+    s1 = s0;
+    sum += x;
+    sumSq += x * x;
+    if (++count < length) return false;
+    return finish();
+  }
+
+  const GoertzelResult& result() const { return last; }
+  /// Ventanas cerradas desde el último tune()
+  uint32_t windows() const { return closed; }
+  float frequency() const { return freqHz; }
+  uint16_t windowLength() const { return length; }
+
+private:
+  bool finish();
+
+  float coeff = 0.0f;   ///< 2·cos(ω)
+  float s1 = 0.0f, s2 = 0.0f;
+  float sum = 0.0f, sumSq = 0.0f;
+  float offset = 0.0f;  ///< Continua de la ventana anterior, restada a la entrada
+  bool  offsetValid = false;
+  uint16_t count = 0;
+  uint16_t length = 0;
+  uint32_t closed = 0;
+  float freqHz = 0.0f;
+  GoertzelResult last;
+};
@@ -2,6 +2,7 @@
 #include "CalibrationManager.h"
 #include "driver/adc.h"
 #include "ADCUtils.h"
+#include "SensorMath.h"
 
 void MAPSensor::begin(uint8_t analogPin) {
   _pin = analogPin;
@@ -26,7 +27,7 @@ uint16_t MAPSensor::readRaw() {
     Serial.println("ERROR: MAPSensor pin no inicializado!");
     return 0;
   }
-  cachedRaw = analogRead(_pin);
+  cachedRaw = analogReadAdc1(_pin);
 
   return cachedRaw;
 }
@@ -50,7 +51,7 @@ float MAPSensor::readVacuum_inHg() {
 
 float MAPSensor::readVolts() const {
   if (modoSimulacion) return (rawSimulado * 3.3f) / 4095.0f;
-  uint16_t raw = analogRead(_pin);
+  uint16_t raw = analogReadAdc1(_pin);
   return (raw * 3.3f) / 4095.0f;
 }
 
@@ -62,24 +63,8 @@ float MAPSensor::convertRawToHg(uint16_t raw) {
 }
 
 float MAPSensor::convertRawToPercent(uint16_t raw) {
-  uint16_t min = CalibrationManager::getInstance().getMAPMin();
-  uint16_t max = CalibrationManager::getInstance().getMAPMax();
-
-  //Serial.print("[DEBUG] MAP Raw: "); Serial.println(raw);
-  //Serial.print("[DEBUG] MAP Min: "); Serial.println(min);
-  //Serial.print("[DEBUG] MAP Max: "); Serial.println(max);
-
-  if (max <= min || raw < min || raw > max) {
-    //Serial.println("[DEBUG] MAP fuera de rango o calibración inválida. Retornando 0.0%");
-    return 0.0f;
-  }
-
-  float norm = (float)(raw - min) / (max - min);
-  float percent = constrain(norm, 0.0f, 1.0f) * 100.0f;
-
-  //Serial.print("[DEBUG] MAP Load %: "); Serial.println(percent, 2);
-
-  return percent;
+  const CalibrationManager& calib = CalibrationManager::getInstance();
+  return rawToPercent(raw, calib.getMAPMin(), calib.getMAPMax());
 }
 
 float MAPSensor::readMAPLoadPercent() {
@@ -52,11 +52,17 @@ float SensorManager::representVoltsFromRaw(uint16_t raw) const {
 
 
 void SensorManager::update() {
+  uint32_t t0 = micros();
   uint16_t rawMAP = mapSensor.readRaw();  // lectura directa
   uint16_t rawTPS = tpsSensor.readRaw();  // lectura directa
+  lastMAPRaw = rawMAP;
+  lastTPSRaw = rawTPS;
 
   mapLoadPercent = mapSensor.convertRawToPercent(rawMAP);
-  tpsLoadPercent = tpsSensor.convertRawToPercent(rawTPS);;
+  tpsLoadPercent = tpsSensor.convertRawToPercent(rawTPS);
+
+  updateCount->inc();
+  updateUs->record(micros() - t0);
 }
 
 
@@ -2,6 +2,7 @@
 #include "MAPSensor.h"
 #include "TPSSensor.h"
 #include <Arduino.h>
+#include "Metrics.h"
 
 class SensorManager {
 public:
@@ -18,6 +19,8 @@ public:
   bool isTPSValid();
   float readMAPLoadPercent();
   float representVoltsFromRaw(uint16_t raw) const;
+  uint16_t getLastMAPRaw() const { return lastMAPRaw; }  // Última lectura de update(), sin tocar el ADC
+  uint16_t getLastTPSRaw() const { return lastTPSRaw; }
   void enableSimulacion();
   void disableSimulacion();
   bool isSimulacionActiva() const { return simulacionActiva; }
@@ -31,10 +34,15 @@ private:
   MAPSensor mapSensor;
   TPSSensor tpsSensor;
   float mapLoadPercent = 0.0f;  //
+  uint16_t lastMAPRaw = 0;
+  uint16_t lastTPSRaw = 0;
   bool simulacionActiva = false;
 
 
 
   float vacuum_inHg = 0;
   float tpsLoadPercent  = 0;
+
+  Counter*   updateCount = &MetricsRegistry::getInstance().counter("sensor.updates");
+  Histogram* updateUs    = &MetricsRegistry::getInstance().histogram("sensor.update_us");
 };
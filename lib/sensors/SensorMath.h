@@ -0,0 +1,26 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Conversiones de sensores sin dependencias de Arduino: las usan los
+ * sensores en el ESP32 y las herramientas de host con el mismo código.
+ */
+
+/**
+ * Posición de una lectura cruda dentro del rango calibrado.
+ * @return 0–100 %; 0 si la calibración es inválida o la lectura cae fuera del rango.
+ */
+inline float rawToPercent(uint16_t raw, uint16_t min, uint16_t max) {
+  if (max <= min || raw < min || raw > max) return 0.0f;
+
+  float norm = (float)(raw - min) / (max - min);
+  if (norm < 0.0f) norm = 0.0f;
+  if (norm > 1.0f) norm = 1.0f;
+  return norm * 100.0f;
+}
+
+/// Lectura ADC de 12 bits a voltios (referencia 3.3 V)
+inline float rawToVolts(uint16_t raw) {
+  return (raw * 3.3f) / 4095.0f;
+}
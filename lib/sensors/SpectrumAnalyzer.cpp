@@ -0,0 +1,87 @@
+#include "SpectrumAnalyzer.h"
+#include <math.h>
+
+// Un seno de amplitud A (fracción del fondo de escala) centrado en un bin
+// sale con |X| = A/4 · 32768: A/2 de la DFT / n y 1/2 de ganancia de Hann
+static constexpr float FULL_SCALE_POWER = (32768.0f / 4.0f) * (32768.0f / 4.0f);
+static constexpr float FLOOR_DB = -140.0f;
+
+bool SpectrumAnalyzer::configure(uint16_t size, float sampleHz, uint8_t averages) {
+  if (!fftValidSize(size) || !(sampleHz > 0.0f)) return false;
+  if (averages < 1) averages = 1;
+  if (averages > SPECTRUM_MAX_AVERAGE) averages = SPECTRUM_MAX_AVERAGE;
+  this->size = size;
+  this->sampleHz = sampleHz;
+  this->averages = averages;
+  accumulated = 0;
+  sequence = 0;
+  re.assign(size, 0);
+  im.assign(size, 0);
+  sum.assign(size / 2 + 1, 0.0f);
+  published.assign(size / 2 + 1, 0.0f);
+  return true;
+}
+
+void SpectrumAnalyzer::release() {
+  size = 0;
+  std::vector<int16_t>().swap(re);
+  std::vector<int16_t>().swap(im);
+  std::vector<float>().swap(sum);
+  std::vector<float>().swap(published);
+}
+
+bool SpectrumAnalyzer::process() {
+  if (!size) return false;
+
+  // La continua del micrófono no es la mitad exacta del ADC
+  int32_t mean = 0;
+  for (uint16_t i = 0; i < size; ++i) mean += re[i];
+  mean /= size;
+  for (uint16_t i = 0; i < size; ++i) {
+    int32_t v = re[i] - mean;
+    re[i] = (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+    im[i] = 0;
+  }
+  fftHannWindow(re.data(), size);
+  fftQ15(re.data(), im.data(), size);
+
+  for (uint16_t k = 0; k <= size / 2; ++k) {
+    sum[k] += (float)((int32_t)re[k] * re[k] + (int32_t)im[k] * im[k]);
+  }
+  if (++accumulated < averages) return false;
+
+  for (uint16_t k = 0; k <= size / 2; ++k) {
+    published[k] = sum[k] / averages;
+    sum[k] = 0.0f;
+  }
+  accumulated = 0;
+  sequence++;
+  return true;
+}
+
+float SpectrumAnalyzer::binDb(uint16_t k) const {
+  if (!size || k > size / 2 || published[k] <= 0.0f) return FLOOR_DB;
+  float db = 10.0f * log10f(published[k] / FULL_SCALE_POWER);
+  return db < FLOOR_DB ? FLOOR_DB : db;
+}
+
+uint8_t SpectrumAnalyzer::encode(uint8_t* out, uint8_t bands) const {
+  uint16_t half = size / 2;
+  if (!size || bands == 0) return 0;
+  if (bands > SPECTRUM_MAX_BANDS) bands = SPECTRUM_MAX_BANDS;
+  if (bands > half) bands = (uint8_t)half;
+
+  for (uint8_t b = 0; b < bands; ++b) {
+    uint16_t from = (uint16_t)((uint32_t)b * half / bands);
+    uint16_t to = (uint16_t)((uint32_t)(b + 1) * half / bands);
+    if (from == 0) from = 1;  // Sin el bin de continua
+    float peak = 0.0f;
+    for (uint16_t k = from; k < to; ++k) {
+      if (published[k] > peak) peak = published[k];
+    }
+    float db = peak > 0.0f ? 10.0f * log10f(peak / FULL_SCALE_POWER) : FLOOR_DB;
+    float code = -db / SPECTRUM_DB_STEP;
+    out[b] = code <= 0.0f ? 0 : (code >= 255.0f ? 255 : (uint8_t)lroundf(code));
+  }
+  return bands;
+}
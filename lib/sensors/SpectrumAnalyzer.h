@@ -0,0 +1,74 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "FixedFft.h"
+
+/*
+ * Espectro promediado de la entrada del micrófono de retorno: ventana de
+ * Hann, FFT Q15 (FixedFft.h) y media de potencias de varios bloques. Sin
+ * dependencias de Arduino; en el ESP32 lo alimenta AcousticMonitor desde su
+ * tarea de baja prioridad.
+ *
+ * Para enviarlo, encode() lo resume en bandas de un byte: el pico de cada
+ * banda en pasos de SPECTRUM_DB_STEP por debajo del fondo de escala.
+ */
+
+constexpr uint8_t SPECTRUM_MAX_BANDS   = 128;
+constexpr float   SPECTRUM_DB_STEP     = 0.5f;  ///< 255 pasos: hasta -127.5 dBFS
+constexpr uint8_t SPECTRUM_MAX_AVERAGE = 64;
+
+class SpectrumAnalyzer {
+public:
+  /**
+   * Reserva los buffers (4·size bytes más la media) y vacía la media.
+   * @param averages Bloques por espectro publicado, 1–SPECTRUM_MAX_AVERAGE.
+   * @return false si el tamaño no vale (fftValidSize).
+   */
+  bool configure(uint16_t size, float sampleHz, uint8_t averages);
+  /// Libera los buffers
+  void release();
+  bool isConfigured() const { return size > 0; }
+
+  uint16_t getSize() const { return size; }
+  float getSampleHz() const { return sampleHz; }
+  uint8_t getAverages() const { return averages; }
+  float binHz() const { return size ? sampleHz / size : 0.0f; }
+
+  /// size muestras Q15 a rellenar antes de process()
+  int16_t* input() { return re.data(); }
+
+  /**
+   * Quita la continua, aplica la ventana, hace la FFT y suma el bloque a la
+   * media.
+   * @return true si con este bloque se publica un espectro nuevo.
+   */
+  bool process();
+
+  /// Espectros publicados desde configure()
+  uint32_t getSequence() const { return sequence; }
+  /**
+   * Nivel del bin k (0..size/2) en el último espectro publicado, en dBFS:
+   * un seno de fondo de escala centrado en un bin da 0 dB.
+   */
+  float binDb(uint16_t k) const;
+
+  /**
+   * Resumen en bandas iguales: pico de cada banda, 0 = 0 dBFS, cada unidad
+   * SPECTRUM_DB_STEP dB más abajo, 255 = por debajo.
+   * @param bands Como mucho SPECTRUM_MAX_BANDS y size/2.
+   * @return Bandas escritas en out.
+   */
+  uint8_t encode(uint8_t* out, uint8_t bands) const;
+
+private:
+  uint16_t size = 0;
+  float sampleHz = 0.0f;
+  uint8_t averages = 1;
+  uint8_t accumulated = 0;
+  uint32_t sequence = 0;
+  std::vector<int16_t> re, im;
+  std::vector<float> sum;        ///< Potencias del promedio en curso
+  std::vector<float> published;  ///< Media del último espectro, por bin
+};
@@ -3,6 +3,7 @@
 #include "CalibrationManager.h"
 #include "driver/adc.h"
 #include "ADCUtils.h"  // si usas utilidades ADC específicas
+#include "SensorMath.h"
 
 void TPSSensor::begin(uint8_t analogPin) {
   _pin = analogPin;
@@ -24,7 +25,8 @@ uint16_t TPSSensor::readRaw() {
     Serial.println("ERROR: TPSSensor pin no inicializado!");
     return 0;
   }
-  // Devuelve lectura cacheada hecha desde ISR
+  cachedRaw = analogReadAdc1(_pin);
+
   return cachedRaw;
 }
 
@@ -50,7 +52,7 @@ float TPSSensor::readVolts() {
     Serial.println("ERROR: TPSSensor pin no inicializado en readVolts!");
     return 0.0f;
   }
-  uint16_t raw = analogRead(_pin);
+  uint16_t raw = analogReadAdc1(_pin);
 
   if (raw <= 5) return 0.0f;
   if (raw >= 4090) return 3.3f;
@@ -64,11 +66,6 @@ bool TPSSensor::isValidReading() {
 
 
 float TPSSensor::convertRawToPercent(uint16_t raw) {
-  uint16_t min = CalibrationManager::getInstance().getTPSMin();
-  uint16_t max = CalibrationManager::getInstance().getTPSMax();
-
-  if (max <= min || raw < min || raw > max) return 0.0f;
-
-  float norm = (float)(raw - min) / (max - min);
-  return constrain(norm, 0.0f, 1.0f) * 100.0f;
+  const CalibrationManager& calib = CalibrationManager::getInstance();
+  return rawToPercent(raw, calib.getTPSMin(), calib.getTPSMax());
 }
@@ -0,0 +1,103 @@
+"""
+Genera ciclos de manejo simulados, sin teclado ni puerto serie, para
+tools/tune y tools/replay.
+
+Usa la misma física y rangos de voltaje que race_sim.py; el conductor sigue
+un guion aleatorio (ralentí, aceleraciones de distinta profundidad, cambios
+de marcha con rebote de MAP y levantadas de pie).
+
+    python drive_cycles.py --ciclos 8 --minutos 5 --salida ciclos/
+"""
+import argparse
+import os
+import random
+
+# --- Parámetros de simulación (race_sim.py) ---
+IDLE_RPM        = 800
+MAX_RPM         = 7000
+SHIFT_RPM       = 6200
+DT              = 0.02   # Mismo periodo que el loop del firmware
+THROTTLE_RATE   = 0.05   # Velocidad con la que el pedal real sigue al objetivo
+THROTTLE_DROP   = 0.2
+MAP_RISE_COEF   = 0.05
+MAP_REBOTE_COEF = 0.2
+RPM_RISE_COEF   = 0.02
+
+TPS_V_OPEN      = 2.25
+TPS_V_CLOSED    = 0.5
+
+MAP_V_IDLE      = 3.05
+MAP_V_MAX       = 3.26
+MAP_V_REBOTE    = 2.95
+
+GEAR_RATIOS     = [3.8, 2.2, 1.5, 1.0, 0.8]
+
+
+def volt_to_adc(volts):
+    return int((volts / 3.3) * 4095)
+
+
+def generar_ciclo(ruta, segundos, rng):
+    throttle = 0.0
+    objetivo = 0.0
+    rpm = IDLE_RPM
+    map_v = MAP_V_IDLE
+    gear = 0
+    rebote = False
+    proximo_cambio = rng.uniform(2.0, 6.0)
+
+    pasos = int(segundos / DT)
+    with open(ruta, "w") as f:
+        f.write(f"# ciclo simulado, {segundos:.0f} s\n")
+        for i in range(pasos):
+            t = i * DT
+
+            # Guion del conductor: cada pocos segundos elige un nuevo pedal objetivo
+            if t >= proximo_cambio:
+                objetivo = rng.choice([0.0, 0.0, 0.15, 0.3, 0.5, 0.8, 1.0])
+                proximo_cambio = t + rng.uniform(1.0, 8.0)
+
+            throttle += (objetivo - throttle) * THROTTLE_RATE
+
+            target_rpm = IDLE_RPM + throttle * (MAX_RPM - IDLE_RPM)
+            rpm += (target_rpm - rpm) * RPM_RISE_COEF
+            if rpm >= SHIFT_RPM and gear < len(GEAR_RATIOS) - 1:
+                rpm *= GEAR_RATIOS[gear + 1] / GEAR_RATIOS[gear]
+                gear += 1
+                throttle *= THROTTLE_DROP
+                rebote = True
+            elif throttle < 0.05 and gear > 0 and rng.random() < 0.002:
+                gear -= 1
+
+            if rebote:
+                map_v += (MAP_V_REBOTE - map_v) * MAP_REBOTE_COEF
+                if abs(map_v - MAP_V_REBOTE) < 0.005:
+                    rebote = False
+            else:
+                target_map = MAP_V_IDLE + throttle * (MAP_V_MAX - MAP_V_IDLE)
+                map_v += (target_map - map_v) * MAP_RISE_COEF
+
+            # El firmware convierte TPS con (raw - min) / (max - min): el voltaje
+            # debe subir con el pedal. race_sim.py envía la polaridad contraria.
+            tps_v = TPS_V_CLOSED + (TPS_V_OPEN - TPS_V_CLOSED) * throttle
+            f.write(f"t_ms:{int(t * 1000)},tps_raw:{volt_to_adc(tps_v)},map_raw:{volt_to_adc(map_v)}\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Ciclos de manejo simulados")
+    parser.add_argument("--ciclos", type=int, default=4)
+    parser.add_argument("--minutos", type=float, default=5.0)
+    parser.add_argument("--semilla", type=int, default=1)
+    parser.add_argument("--salida", default=".")
+    args = parser.parse_args()
+
+    os.makedirs(args.salida, exist_ok=True)
+    rng = random.Random(args.semilla)
+    for n in range(args.ciclos):
+        ruta = os.path.join(args.salida, f"ciclo_{n:02d}.txt")
+        generar_ciclo(ruta, args.minutos * 60.0, rng)
+        print(f">>> {ruta}")
+
+
+if __name__ == "__main__":
+    main()
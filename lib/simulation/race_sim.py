@@ -27,6 +27,10 @@ BAUDRATE       = 115200
 
 DEBUG_MODE     = False
 
+# Si no es None, cada muestra enviada se guarda también aquí con su marca de
+# tiempo, en el formato que lee tools/replay (vortex_replay run <archivo>)
+LOG_PATH       = None
+
 throttle = 0.0
 rpm      = IDLE_RPM
 map_v    = MAP_V_IDLE
@@ -91,6 +95,8 @@ else:
     ser.setRTS(False)
     time.sleep(1)
 
+log_file = open(LOG_PATH, "w") if LOG_PATH else None
+
 try:
     while gear < len(GEAR_RATIOS):
         elapsed = time.time() - idle_start
@@ -186,6 +192,9 @@ try:
         tps_adc = volt_to_adc(tps_v)
         map_adc = volt_to_adc(map_adc_valor)
 
+        if log_file:
+            log_file.write(f"t_ms:{int(elapsed * 1000)},tps_raw:{tps_adc},map_raw:{map_adc}\n")
+
         if not DEBUG_MODE and ser:
             payload = f"tps_raw:{tps_adc},map_raw:{map_adc}\n"
             ser.write(payload.encode('utf-8'))
@@ -209,3 +218,5 @@ try:
 finally:
     if ser:
         ser.close()
+    if log_file:
+        log_file.close()
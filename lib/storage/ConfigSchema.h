@@ -0,0 +1,103 @@
+#pragma once
+
+#include <stdint.h>
+#include "TuningProfile.h"
+
+/**
+ * Esquema del blob de configuración persistido.
+ * Cualquier cambio de layout debe subir CONFIG_SCHEMA_VERSION y añadir el paso
+ * correspondiente en ConfigStore::migrate().
+ */
+constexpr uint32_t CONFIG_MAGIC          = 0x4D434C41;  // "ALCM"
+constexpr uint16_t CONFIG_SCHEMA_VERSION = 4;
+
+/**
+ * @struct CalibrationData
+ * Rango crudo (ADC 12 bits) de los sensores.
+ * Los valores *Ref son los de la última calibración manual; la compensación de
+ * deriva ajusta mapMin..tpsMax pero nunca se aleja de ellos más que su banda de guarda.
+ */
+struct CalibrationData {
+  uint16_t mapMin = 0;
+  uint16_t mapMax = 0;
+  uint16_t tpsMin = 0;
+  uint16_t tpsMax = 0;
+  uint8_t  valid  = 0;          ///< 1 si la calibración está completa
+  uint8_t  reserved[3] = {0, 0, 0};
+  uint16_t mapMinRef = 0;
+  uint16_t mapMaxRef = 0;
+  uint16_t tpsMinRef = 0;
+  uint16_t tpsMaxRef = 0;
+};
+
+constexpr uint8_t  EQ_MAX_POINTS = 12;     ///< Puntos medidos en el barrido de calibración
+constexpr uint16_t EQ_GAIN_UNITY = 4096;   ///< Ganancia Q12
+
+/**
+ * @struct AcousticEqData
+ * Respuesta del tweeter y la cavidad medida por frecuencia, como ganancia
+ * que la compensa. Es del hardware, no de un perfil: una sola tabla.
+ */
+struct AcousticEqData {
+  uint16_t freqHz[EQ_MAX_POINTS] = {};  ///< Ascendentes
+  uint16_t gain[EQ_MAX_POINTS] = {};    ///< Q12: EQ_GAIN_UNITY = sin corrección
+  uint8_t  count = 0;                   ///< Puntos en uso; 0 = sin ecualizar
+  uint8_t  reserved[3] = {0, 0, 0};
+};
+
+/**
+ * @struct ConfigData
+ * Contenido completo del blob. Solo tipos planos: se copia y compara con memcpy/memcmp.
+ */
+struct ConfigData {
+  CalibrationData calib;
+  TuningProfile   profiles[MAX_PROFILES];
+  uint8_t         activeProfile = 0;    ///< Perfil seleccionado al arrancar
+  uint8_t         reserved[3] = {0, 0, 0};
+  AcousticEqData  eq;
+};
+
+/**
+ * @struct ConfigBlobHeader
+ * Cabecera que precede al payload en el almacenamiento.
+ * El CRC32 cubre únicamente el payload.
+ */
+struct ConfigBlobHeader {
+  uint32_t magic;
+  uint16_t version;
+  uint16_t size;
+  uint32_t crc;
+};
+
+static_assert(sizeof(CalibrationData) == 20, "CalibrationData cambió de layout: subir versión");
+static_assert(sizeof(AcousticEqData) == 52, "AcousticEqData cambió de layout: subir versión");
+static_assert(sizeof(ConfigData) == 300, "ConfigData cambió de layout: subir versión");
+
+/**
+ * Layouts de versiones anteriores, solo para ConfigStore::migrate().
+ */
+struct ConfigDataV1 {
+  uint16_t mapMin, mapMax, tpsMin, tpsMax;
+  uint8_t  valid;
+  uint8_t  reserved[3];
+  Thresholds thresholds;
+  uint8_t  thresholdsValid;
+  uint8_t  reserved2[3];
+};
+static_assert(sizeof(ConfigDataV1) == 48, "ConfigDataV1 es histórico: no modificar");
+
+struct ConfigDataV2 {
+  CalibrationData calib;
+  Thresholds      thresholds;
+  uint8_t         thresholdsValid;
+  uint8_t         reserved[3];
+};
+static_assert(sizeof(ConfigDataV2) == 56, "ConfigDataV2 es histórico: no modificar");
+
+struct ConfigDataV3 {
+  CalibrationData calib;
+  TuningProfile   profiles[MAX_PROFILES];
+  uint8_t         activeProfile;
+  uint8_t         reserved[3];
+};
+static_assert(sizeof(ConfigDataV3) == 248, "ConfigDataV3 es histórico: no modificar");
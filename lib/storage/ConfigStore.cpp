@@ -0,0 +1,223 @@
+#include "ConfigStore.h"
+#include <string.h>
+
+ConfigStore& ConfigStore::getInstance() {
+  static ConfigStore inst;
+  return inst;
+}
+
+uint32_t ConfigStore::crc32(const uint8_t* data, size_t len) {
+  uint32_t crc = 0xFFFFFFFFu;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= data[i];
+    for (int b = 0; b < 8; ++b) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+  }
+  return ~crc;
+}
+
+// v2 → v3: el juego único de umbrales pasa a ser el perfil 0
+static void upgradeV2(const ConfigDataV2& v2, ConfigData& out) {
+  out = ConfigData();
+  out.calib = v2.calib;
+  if (v2.thresholdsValid) {
+    TuningProfile& p = out.profiles[0];
+    strncpy(p.name, "base", sizeof(p.name) - 1);
+    p.revision = 1;
+    p.valid = 1;
+    p.thresholds = v2.thresholds;
+  }
+}
+
+bool ConfigStore::migrate(uint16_t fromVersion, const uint8_t* payload, size_t size, ConfigData& out) {
+  // Cada versión antigua se lleva a la actual paso a paso.
+  // Al subir CONFIG_SCHEMA_VERSION añadir aquí el caso de la versión previa.
+  switch (fromVersion) {
+    case 1: {
+      // v1 → v2: aparecen las referencias de calibración manual
+      if (size != sizeof(ConfigDataV1)) return false;
+      ConfigDataV1 v1;
+      memcpy(&v1, payload, sizeof(v1));
+      ConfigDataV2 v2{};
+      v2.calib.mapMin = v2.calib.mapMinRef = v1.mapMin;
+      v2.calib.mapMax = v2.calib.mapMaxRef = v1.mapMax;
+      v2.calib.tpsMin = v2.calib.tpsMinRef = v1.tpsMin;
+      v2.calib.tpsMax = v2.calib.tpsMaxRef = v1.tpsMax;
+      v2.calib.valid = v1.valid;
+      v2.thresholds = v1.thresholds;
+      v2.thresholdsValid = v1.thresholdsValid;
+      upgradeV2(v2, out);
+      return true;
+    }
+    case 2: {
+      if (size != sizeof(ConfigDataV2)) return false;
+      ConfigDataV2 v2;
+      memcpy(&v2, payload, sizeof(v2));
+      upgradeV2(v2, out);
+      return true;
+    }
+    case 3: {
+      // v3 → v4: aparece la ecualización del tweeter, vacía
+      if (size != sizeof(ConfigDataV3)) return false;
+      ConfigDataV3 v3;
+      memcpy(&v3, payload, sizeof(v3));
+      out = ConfigData();
+      out.calib = v3.calib;
+      memcpy(out.profiles, v3.profiles, sizeof(out.profiles));
+      out.activeProfile = v3.activeProfile;
+      return true;
+    }
+    case 4:
+      if (size != sizeof(ConfigData)) return false;
+      memcpy(&out, payload, sizeof(ConfigData));
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool ConfigStore::begin(StorageBackend* backendPtr) {
+  std::lock_guard<std::mutex> lock(mtx);
+  backend = backendPtr;
+  data = ConfigData();
+  changeSeq = writtenSeq = observedSeq = 0;
+  if (!backend) return false;
+
+  uint8_t buf[MAX_BLOB_SIZE];
+  size_t len = backend->read(buf, sizeof(buf));
+
+  if (len >= sizeof(ConfigBlobHeader)) {
+    ConfigBlobHeader hdr;
+    memcpy(&hdr, buf, sizeof(hdr));
+    const uint8_t* payload = buf + sizeof(hdr);
+
+    bool intact = hdr.magic == CONFIG_MAGIC
+               && hdr.size == len - sizeof(hdr)
+               && hdr.crc == crc32(payload, hdr.size);
+
+    if (intact && hdr.version <= CONFIG_SCHEMA_VERSION) {
+      ConfigData loaded;
+      if (migrate(hdr.version, payload, hdr.size, loaded)) {
+        data = loaded;
+        // Un blob migrado se reescribe con el esquema actual en el próximo service()
+        if (hdr.version != CONFIG_SCHEMA_VERSION) ++changeSeq;
+        return true;
+      }
+    }
+  }
+
+  // Sin blob válido: intentar traer los datos del formato anterior
+  ConfigData legacy;
+  if (backend->importLegacy(legacy)) {
+    data = legacy;
+    ++changeSeq;
+    return true;
+  }
+  return false;
+}
+
+CalibrationData ConfigStore::getCalibration() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return data.calib;
+}
+
+void ConfigStore::setCalibration(const CalibrationData& calib) {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (memcmp(&data.calib, &calib, sizeof(calib)) == 0) return;
+  data.calib = calib;
+  markChanged();
+}
+
+void ConfigStore::clearCalibration() {
+  setCalibration(CalibrationData());
+}
+
+bool ConfigStore::getProfile(uint8_t index, TuningProfile& out) const {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (index >= MAX_PROFILES || !data.profiles[index].valid) return false;
+  out = data.profiles[index];
+  return true;
+}
+
+void ConfigStore::setProfile(uint8_t index, const TuningProfile& profile) {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (index >= MAX_PROFILES) return;
+  if (memcmp(&data.profiles[index], &profile, sizeof(profile)) == 0) return;
+  data.profiles[index] = profile;
+  markChanged();
+}
+
+AcousticEqData ConfigStore::getEqualization() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return data.eq;
+}
+
+void ConfigStore::setEqualization(const AcousticEqData& eq) {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (memcmp(&data.eq, &eq, sizeof(eq)) == 0) return;
+  data.eq = eq;
+  markChanged();
+}
+
+uint8_t ConfigStore::getActiveProfile() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return data.activeProfile < MAX_PROFILES ? data.activeProfile : 0;
+}
+
+void ConfigStore::setActiveProfile(uint8_t index) {
+  std::lock_guard<std::mutex> lock(mtx);
+  if (index >= MAX_PROFILES || data.activeProfile == index) return;
+  data.activeProfile = index;
+  markChanged();
+}
+
+void ConfigStore::markChanged() {
+  ++changeSeq;
+}
+
+bool ConfigStore::isDirty() const {
+  std::lock_guard<std::mutex> lock(mtx);
+  return changeSeq != writtenSeq;
+}
+
+bool ConfigStore::service(uint32_t nowMs) {
+  {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (changeSeq == writtenSeq) return false;
+    if (changeSeq != observedSeq) {
+      // Cambio nuevo: reiniciar la ventana de espera
+      observedSeq = changeSeq;
+      quietSinceMs = nowMs;
+      return false;
+    }
+    if (nowMs - quietSinceMs < COALESCE_MS) return false;
+  }
+  return flush();
+}
+
+bool ConfigStore::flush() {
+  uint8_t buf[sizeof(ConfigBlobHeader) + sizeof(ConfigData)];
+  uint32_t seq;
+  {
+    // Solo la copia se hace bajo el candado; la escritura a flash va fuera
+    std::lock_guard<std::mutex> lock(mtx);
+    if (!backend || changeSeq == writtenSeq) return false;
+    seq = changeSeq;
+    memcpy(buf + sizeof(ConfigBlobHeader), &data, sizeof(ConfigData));
+  }
+
+  ConfigBlobHeader hdr;
+  hdr.magic   = CONFIG_MAGIC;
+  hdr.version = CONFIG_SCHEMA_VERSION;
+  hdr.size    = sizeof(ConfigData);
+  hdr.crc     = crc32(buf + sizeof(hdr), sizeof(ConfigData));
+  memcpy(buf, &hdr, sizeof(hdr));
+
+  if (!backend->write(buf, sizeof(buf))) return false;
+
+  std::lock_guard<std::mutex> lock(mtx);
+  writtenSeq = seq;
+  ++commitCount;
+  return true;
+}
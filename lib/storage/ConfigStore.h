@@ -0,0 +1,90 @@
+#pragma once
+
+#include <mutex>
+#include "ConfigSchema.h"
+#include "StorageBackend.h"
+
+/**
+ * @class ConfigStore
+ * Almacén único de configuración persistente.
+ *
+ * Mantiene en RAM una copia del blob versionado y protegido por CRC. Los setters
+ * solo modifican la RAM y marcan cambios; la escritura real la hace service()
+ * desde una tarea de baja prioridad, una sola vez por ráfaga de cambios, para
+ * no detener la caché de flash dentro del lazo de control.
+ */
+class ConfigStore {
+public:
+  /// Tiempo sin cambios nuevos antes de escribir (agrupa ráfagas de setters)
+  static constexpr uint32_t COALESCE_MS = 500;
+  /// Tamaño máximo aceptado para un blob (incluye cabecera)
+  static constexpr size_t MAX_BLOB_SIZE = 512;
+
+  static ConfigStore& getInstance();
+
+  /**
+   * Carga el blob desde el backend, valida CRC y migra versiones antiguas.
+   * Si no hay blob válido intenta importar el formato legado.
+   * @return true si se obtuvieron datos guardados (blob o legado).
+   */
+  bool begin(StorageBackend* backend);
+
+  CalibrationData getCalibration() const;
+  void setCalibration(const CalibrationData& calib);
+  void clearCalibration();
+
+  /**
+   * @param index Ranura 0..MAX_PROFILES-1.
+   * @param out Perfil guardado.
+   * @return false si la ranura está vacía.
+   */
+  bool getProfile(uint8_t index, TuningProfile& out) const;
+  void setProfile(uint8_t index, const TuningProfile& profile);
+
+  /// Ecualización del tweeter (count = 0 si no se ha medido)
+  AcousticEqData getEqualization() const;
+  void setEqualization(const AcousticEqData& eq);
+
+  /// Perfil que se selecciona al arrancar
+  uint8_t getActiveProfile() const;
+  void setActiveProfile(uint8_t index);
+
+  /**
+   * Escribe los cambios pendientes cuando llevan COALESCE_MS sin modificarse.
+   * Llamar periódicamente desde una tarea fuera del lazo de control.
+   * @param nowMs Tiempo actual en ms.
+   * @return true si se realizó una escritura.
+   */
+  bool service(uint32_t nowMs);
+
+  /**
+   * Escribe inmediatamente si hay cambios pendientes.
+   */
+  bool flush();
+
+  bool isDirty() const;
+  uint32_t getCommitCount() const { return commitCount; }
+
+  /**
+   * Convierte un payload de una versión anterior al esquema actual.
+   * @return false si la versión no es migrable.
+   */
+  static bool migrate(uint16_t fromVersion, const uint8_t* payload, size_t size, ConfigData& out);
+
+  static uint32_t crc32(const uint8_t* data, size_t len);
+
+private:
+  ConfigStore() = default;
+
+  void markChanged();
+
+  StorageBackend* backend = nullptr;
+  mutable std::mutex mtx;
+  ConfigData data;
+
+  uint32_t changeSeq = 0;      ///< Se incrementa con cada cambio real
+  uint32_t writtenSeq = 0;     ///< changeSeq del último blob escrito
+  uint32_t observedSeq = 0;    ///< changeSeq visto por service()
+  uint32_t quietSinceMs = 0;   ///< Momento en que service() vio el último cambio
+  uint32_t commitCount = 0;
+};
@@ -0,0 +1,37 @@
+#ifndef ARDUINO
+
+#include "FileStorageBackend.h"
+#include <stdio.h>
+
+size_t FileStorageBackend::read(uint8_t* buf, size_t maxLen) {
+  ++readCount;
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return 0;
+  size_t len = fread(buf, 1, maxLen, f);
+  // Un archivo mayor que maxLen no es un blob válido
+  bool truncated = fgetc(f) != EOF;
+  fclose(f);
+  return truncated ? 0 : len;
+}
+
+bool FileStorageBackend::write(const uint8_t* buf, size_t len) {
+  ++writeCount;
+  // Escribir a un temporal y renombrar: el blob nunca queda a medias
+  std::string tmp = path + ".tmp";
+  FILE* f = fopen(tmp.c_str(), "wb");
+  if (!f) return false;
+  bool ok = fwrite(buf, 1, len, f) == len;
+  ok = (fclose(f) == 0) && ok;
+  if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+    remove(tmp.c_str());
+    return false;
+  }
+  bytesWritten += len;
+  return true;
+}
+
+bool FileStorageBackend::erase() {
+  return remove(path.c_str()) == 0;
+}
+
+#endif // ARDUINO
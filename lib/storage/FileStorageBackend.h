@@ -0,0 +1,33 @@
+#pragma once
+
+#ifndef ARDUINO
+
+#include <string>
+#include "StorageBackend.h"
+
+/**
+ * @class FileStorageBackend
+ * Backend para el host: guarda el blob en un archivo y cuenta las operaciones,
+ * para poder verificar cuántas escrituras provoca cada operación.
+ */
+class FileStorageBackend : public StorageBackend {
+public:
+  explicit FileStorageBackend(const std::string& path) : path(path) {}
+
+  size_t read(uint8_t* buf, size_t maxLen) override;
+  bool write(const uint8_t* buf, size_t len) override;
+  bool erase() override;
+
+  uint32_t getReadCount() const { return readCount; }
+  uint32_t getWriteCount() const { return writeCount; }
+  uint32_t getBytesWritten() const { return bytesWritten; }
+  void resetCounters() { readCount = writeCount = bytesWritten = 0; }
+
+private:
+  std::string path;
+  uint32_t readCount = 0;
+  uint32_t writeCount = 0;
+  uint32_t bytesWritten = 0;
+};
+
+#endif // ARDUINO
@@ -0,0 +1,88 @@
+#ifdef ARDUINO
+
+#include "NvsStorageBackend.h"
+#include <string.h>
+
+static constexpr const char* NVS_NAMESPACE = "config";
+static constexpr const char* NVS_KEY       = "blob";
+
+size_t NvsStorageBackend::read(uint8_t* buf, size_t maxLen) {
+  if (!prefs.begin(NVS_NAMESPACE, true)) return 0;
+  size_t len = prefs.getBytesLength(NVS_KEY);
+  if (len == 0 || len > maxLen) {
+    prefs.end();
+    return 0;
+  }
+  len = prefs.getBytes(NVS_KEY, buf, len);
+  prefs.end();
+  return len;
+}
+
+bool NvsStorageBackend::write(const uint8_t* buf, size_t len) {
+  if (!prefs.begin(NVS_NAMESPACE, false)) return false;
+  size_t written = prefs.putBytes(NVS_KEY, buf, len);
+  prefs.end();  // end() hace el único commit
+  return written == len;
+}
+
+bool NvsStorageBackend::erase() {
+  if (!prefs.begin(NVS_NAMESPACE, false)) return false;
+  bool ok = prefs.clear();
+  prefs.end();
+  return ok;
+}
+
+bool NvsStorageBackend::importLegacy(ConfigData& out) {
+  bool found = false;
+
+  if (prefs.begin("calib", true)) {
+    if (prefs.isKey("map_min") && prefs.isKey("map_max")
+        && prefs.isKey("tps_min") && prefs.isKey("tps_max")) {
+      out.calib.mapMin = prefs.getUShort("map_min");
+      out.calib.mapMax = prefs.getUShort("map_max");
+      out.calib.tpsMin = prefs.getUShort("tps_min");
+      out.calib.tpsMax = prefs.getUShort("tps_max");
+      out.calib.mapMinRef = out.calib.mapMin;
+      out.calib.mapMaxRef = out.calib.mapMax;
+      out.calib.tpsMinRef = out.calib.tpsMin;
+      out.calib.tpsMaxRef = out.calib.tpsMax;
+      out.calib.valid  = 1;
+      found = true;
+    }
+    prefs.end();
+  }
+
+  if (prefs.begin("thresholds", true)) {
+    static const char* const keys[] = {
+      "MAP_WAKEUP_PERCENT", "INJ_TPS_ON", "INJ_MAP_ON", "INJ_TPS_OFF",
+      "INJ_MAP_OFF", "VORTEX_TPS_ON", "VORTEX_MAP_ON", "VORTEX_TPS_OFF"
+    };
+    float values[8];
+    bool complete = true;
+    for (int i = 0; i < 8 && complete; ++i) {
+      values[i] = prefs.getFloat(keys[i], -1.0f);
+      complete = values[i] >= 0.0f;
+    }
+    if (complete) {
+      TuningProfile& p = out.profiles[0];
+      strncpy(p.name, "base", sizeof(p.name) - 1);
+      p.revision = 1;
+      p.valid = 1;
+      Thresholds& t = p.thresholds;
+      t.MAP_WAKEUP_PERCENT = values[0];
+      t.INJ_TPS_ON         = values[1];
+      t.INJ_MAP_ON         = values[2];
+      t.INJ_TPS_OFF        = values[3];
+      t.INJ_MAP_OFF        = values[4];
+      t.VORTEX_TPS_ON      = values[5];
+      t.VORTEX_MAP_ON      = values[6];
+      t.VORTEX_TPS_OFF     = values[7];
+      found = true;
+    }
+    prefs.end();
+  }
+
+  return found;
+}
+
+#endif // ARDUINO
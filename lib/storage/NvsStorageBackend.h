@@ -0,0 +1,26 @@
+#pragma once
+
+#ifdef ARDUINO
+
+#include <Preferences.h>
+#include "StorageBackend.h"
+
+/**
+ * @class NvsStorageBackend
+ * Guarda el blob de configuración como una sola clave binaria en NVS.
+ * Cada write() es un putBytes + un único commit.
+ */
+class NvsStorageBackend : public StorageBackend {
+public:
+  size_t read(uint8_t* buf, size_t maxLen) override;
+  bool write(const uint8_t* buf, size_t len) override;
+  bool erase() override;
+
+  /// Lee los namespaces "calib" y "thresholds" usados antes del blob
+  bool importLegacy(ConfigData& out) override;
+
+private:
+  Preferences prefs;
+};
+
+#endif // ARDUINO
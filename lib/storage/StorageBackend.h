@@ -0,0 +1,37 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "ConfigSchema.h"
+
+/**
+ * @class StorageBackend
+ * Medio físico donde ConfigStore guarda su blob (NVS en el ESP32, archivo en el host).
+ * Cada write() debe ser una única escritura atómica del blob completo.
+ */
+class StorageBackend {
+public:
+  virtual ~StorageBackend() = default;
+
+  /**
+   * Lee el blob guardado.
+   * @return Bytes leídos, 0 si no existe o no cabe en maxLen.
+   */
+  virtual size_t read(uint8_t* buf, size_t maxLen) = 0;
+
+  /**
+   * Reemplaza el blob completo con una sola escritura.
+   */
+  virtual bool write(const uint8_t* buf, size_t len) = 0;
+
+  /**
+   * Borra el blob guardado.
+   */
+  virtual bool erase() = 0;
+
+  /**
+   * Importa datos guardados con el formato anterior al blob (claves sueltas).
+   * @return true si se encontró algo que importar.
+   */
+  virtual bool importLegacy(ConfigData& out) { (void)out; return false; }
+};
@@ -0,0 +1,217 @@
+#include "BleConsoleUI.h"
+#include <Arduino.h>
+#include <string.h>
+
+static constexpr const char* BLE_DEVICE_NAME = "VortexAcusticoV1";
+static constexpr const char* SERVICE_UUID    = "6f9a0001-5a3c-4e8b-9d2f-7654726f7831";
+static constexpr const char* TELEMETRY_UUID  = "6f9a0002-5a3c-4e8b-9d2f-7654726f7831";
+static constexpr const char* CONTROL_UUID    = "6f9a0003-5a3c-4e8b-9d2f-7654726f7831";
+static constexpr const char* CONSOLE_UUID    = "6f9a0004-5a3c-4e8b-9d2f-7654726f7831";
+
+class BleConsoleUI::ServerCallbacks : public BLEServerCallbacks {
+public:
+  explicit ServerCallbacks(BleConsoleUI* owner) : owner(owner) {}
+
+  void onConnect(BLEServer*, esp_ble_gatts_cb_param_t* param) override {
+    owner->connId = param->connect.conn_id;
+    owner->connected = true;
+  }
+
+  void onDisconnect(BLEServer* server) override {
+    owner->connected = false;
+    server->getAdvertising()->start();  // Volver a anunciarse para el próximo cliente
+  }
+
+private:
+  BleConsoleUI* owner;
+};
+
+// Escrituras de control y consola: solo se encolan, se procesan en update()
+class BleConsoleUI::WriteCallbacks : public BLECharacteristicCallbacks {
+public:
+  WriteCallbacks(ByteRing* ring, bool framed) : ring(ring), framed(framed) {}
+
+  void onWrite(BLECharacteristic* chr) override {
+    std::string value = chr->getValue();
+    if (value.empty()) return;
+    if (framed) {
+      // Comandos de control: [longitud][bytes], así la cola nunca los parte
+      if (value.size() > BLE_MAX_CONTROL) return;
+      uint8_t frame[1 + BLE_MAX_CONTROL];
+      frame[0] = static_cast<uint8_t>(value.size());
+      memcpy(frame + 1, value.data(), value.size());
+      ring->write(frame, 1 + value.size());
+    } else {
+      ring->write(reinterpret_cast<const uint8_t*>(value.data()), value.size());
+    }
+  }
+
+private:
+  ByteRing* ring;
+  bool framed;
+};
+
+void BleConsoleUI::begin() {
+  BLEDevice::init(BLE_DEVICE_NAME);
+  BLEDevice::setMTU(BLE_MAX_PAYLOAD + 3);
+
+  server = BLEDevice::createServer();
+  server->setCallbacks(new ServerCallbacks(this));
+
+  BLEService* service = server->createService(SERVICE_UUID);
+
+  telemetryChr = service->createCharacteristic(TELEMETRY_UUID, BLECharacteristic::PROPERTY_NOTIFY);
+  telemetryCccd = new BLE2902();
+  telemetryChr->addDescriptor(telemetryCccd);
+
+  controlChr = service->createCharacteristic(
+      CONTROL_UUID, BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_WRITE_NR);
+  controlChr->setCallbacks(new WriteCallbacks(&control, true));
+
+  consoleChr = service->createCharacteristic(
+      CONSOLE_UUID, BLECharacteristic::PROPERTY_WRITE | BLECharacteristic::PROPERTY_WRITE_NR |
+                    BLECharacteristic::PROPERTY_NOTIFY);
+  consoleCccd = new BLE2902();
+  consoleChr->addDescriptor(consoleCccd);
+  consoleChr->setCallbacks(new WriteCallbacks(&input, false));
+
+  service->start();
+  BLEAdvertising* adv = BLEDevice::getAdvertising();
+  adv->addServiceUUID(SERVICE_UUID);
+  adv->setScanResponse(true);
+  BLEDevice::startAdvertising();
+
+  this->printf("✅ BLE iniciado como \"%s\"\n", BLE_DEVICE_NAME);
+}
+
+void BleConsoleUI::update() {
+  bool clienteActual = connected.load();
+  if (clienteActual && !clientePrevio) {
+    this->println("Cliente BLE conectado");
+  } else if (!clienteActual && clientePrevio) {
+    this->println("Cliente BLE desconectado");
+  }
+  clientePrevio = clienteActual;
+
+  // Comandos binarios, en la misma tarea que la consola de texto
+  uint8_t len;
+  uint8_t frame[BLE_MAX_CONTROL];
+  while (control.read(&len, 1) == 1) {
+    if (len > sizeof(frame) || control.read(frame, len) != len) break;
+    ControlCommand cmd;
+    if (decodeControl(frame, len, cmd)) {
+      procesarControl(cmd);
+    } else {
+      this->printf("⚠️  Comando BLE inválido (%u bytes)\n", (unsigned)len);
+    }
+  }
+
+  ConsoleUI::update();
+}
+
+void BleConsoleUI::procesarControl(const ControlCommand& cmd) {
+  switch (cmd.op) {
+    case BleOp::SET_VALUE: {
+      if (!thresholds) return;
+      std::vector<std::string> keys = thresholds->listKeys();
+      if (cmd.index >= keys.size() || !thresholds->setThreshold(keys[cmd.index], cmd.value)) {
+        this->printf("⚠️  Clave BLE desconocida: %u\n", (unsigned)cmd.index);
+      }
+      break;
+    }
+    case BleOp::SELECT_PROFILE:
+      if (!thresholds || !thresholds->selectProfile(cmd.index)) {
+        this->printf("⚠️  Perfil BLE desconocido: %u\n", (unsigned)cmd.index);
+      }
+      break;
+    case BleOp::SAVE: {
+      // Los SET_VALUE previos se aplican aquí de una vez, si son coherentes
+      const char* reason = "";
+      if (thresholds && thresholds->save(&reason) == ThresholdManager::EditResult::INVALID) {
+        this->printf("⚠️  Umbrales BLE no aplicados: %s\n", reason);
+      }
+      break;
+    }
+    case BleOp::CALIBRATE:
+      consoleCalibRequested = true;
+      break;
+    case BleOp::TELEMETRY_RATE:
+      telemetryIntervalMs = cmd.intervalMs;
+      break;
+  }
+}
+
+int BleConsoleUI::readChar() {
+  uint8_t c;
+  return input.read(&c, 1) == 1 ? c : -1;
+}
+
+size_t BleConsoleUI::payloadLimit() {
+  uint16_t mtu = server ? server->getPeerMTU(connId.load()) : 0;
+  return mtu > 3 ? mtu - 3 : BLE_MIN_PAYLOAD;
+}
+
+size_t BleConsoleUI::writeCapacity() {
+  // Una notificación por drenado; sin suscripción se descarta lo más antiguo
+  if (!connected.load() || !consoleCccd || !consoleCccd->getNotifications()) return 0;
+  return payloadLimit();
+}
+
+void BleConsoleUI::writeOut(const uint8_t* data, size_t len) {
+  consoleChr->setValue(const_cast<uint8_t*>(data), len);
+  consoleChr->notify();
+}
+
+void BleConsoleUI::recordTelemetry(uint32_t nowMs, float mapLoadPercent, float tpsPercent) {
+  uint16_t interval = telemetryIntervalMs.load(std::memory_order_relaxed);
+  if (interval == 0 || !connected.load(std::memory_order_relaxed)) return;
+  if (nowMs - lastSampleMs < interval) return;
+  lastSampleMs = nowMs;
+
+  TelemetrySample s;
+  s.tMs = nowMs;
+  s.tpsCenti = telemetryCenti(tpsPercent);
+  s.mapCenti = telemetryCenti(mapLoadPercent);
+  if (fsm) s.state = static_cast<uint8_t>(fsm->getState());
+  if (actuators) {
+    AcousticInjector& inj = actuators->getAcousticInjector();
+    if (actuators->isAcousticOn()) s.flags |= TELEMETRY_FLAG_ACOUSTIC;
+    if (actuators->isTurboOn()) s.flags |= TELEMETRY_FLAG_VORTEX;
+    s.level = synthLevelInt(inj.getLevel());
+    s.freqHz = static_cast<uint16_t>(inj.getFrequency());
+  }
+  if (fsm && fsm->getState() != SystemState::SIN_CALIBRAR && fsm->getState() != SystemState::CALIBRATION) {
+    s.flags |= TELEMETRY_FLAG_CALIB;
+  }
+  if (thresholds) s.profile = thresholds->getActiveIndex();
+
+  // Muestra entera o nada (DROP_NEWEST): el lazo nunca espera a la radio
+  if (!samples.write(reinterpret_cast<const uint8_t*>(&s), sizeof(s))) samplesLost->inc();
+}
+
+void BleConsoleUI::drainTelemetry(uint32_t nowMs) {
+  if (!connected.load() || !telemetryCccd || !telemetryCccd->getNotifications()) {
+    // Sin suscriptor: descartar lo acumulado para no enviar muestras viejas al suscribirse
+    TelemetrySample s;
+    while (samples.read(reinterpret_cast<uint8_t*>(&s), sizeof(s)) == sizeof(s)) {}
+    if (batcher.count() > 0) batcher.reset();
+    return;
+  }
+
+  batcher.setPayloadLimit(payloadLimit());
+  TelemetrySample s;
+  while (samples.read(reinterpret_cast<uint8_t*>(&s), sizeof(s)) == sizeof(s)) {
+    if (!batcher.fits(s)) notifyTelemetry();
+    batcher.add(s);
+  }
+
+  // Trama incompleta: sale igual cuando su primera muestra envejece
+  if (batcher.count() > 0 && nowMs - batcher.firstMs() >= TELEMETRY_MAX_AGE_MS) notifyTelemetry();
+}
+
+void BleConsoleUI::notifyTelemetry() {
+  telemetryChr->setValue(const_cast<uint8_t*>(batcher.data()), batcher.size());
+  telemetryChr->notify();
+  notifications->inc();
+  batcher.reset();
+}
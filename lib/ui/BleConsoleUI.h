@@ -0,0 +1,86 @@
+#pragma once
+#include "ConsoleUI.h"
+#include "BleProtocol.h"
+#include <BLEDevice.h>
+#include <BLEServer.h>
+#include <BLE2902.h>
+#include <atomic>
+
+/**
+ * @class BleConsoleUI
+ * Servicio GATT que reemplaza la consola SPP (activar con -D VORTEX_BT_BLE=1).
+ *
+ * Características:
+ *  - Telemetría (notify): muestras binarias del lazo de control, varias por
+ *    notificación según el MTU (ver BleProtocol.h).
+ *  - Control (write): comandos binarios de umbrales, perfil, guardado y calibración.
+ *  - Consola (write + notify): la misma consola de texto, para uso manual.
+ *
+ * Los callbacks de BLE solo encolan; todo se procesa en update() (tarea
+ * ConsoleUpdate) y se envía en drainOutput()/drainTelemetry() (ConsoleDrain).
+ */
+class BleConsoleUI : public ConsoleUI {
+public:
+  BleConsoleUI(ConsoleUI** uiPtr) {
+    activeUi = uiPtr;
+    setOutputPolicy(ByteRing::Policy::DROP_OLDEST);  // Al reconectar interesa lo más reciente
+  }
+
+  void begin() override;
+  void update() override;
+  int readChar() override;
+
+  bool isSistemaActivo() const override { return connected.load(); }  // true con un cliente conectado
+
+  /**
+   * Encola una muestra del lazo de control. No bloquea; llamar desde loop().
+   * @param nowMs millis() de la vuelta.
+   */
+  void recordTelemetry(uint32_t nowMs, float mapLoadPercent, float tpsPercent);
+
+  /// Arma y notifica tramas de telemetría; llamar desde la tarea de drenado
+  void drainTelemetry(uint32_t nowMs);
+
+protected:
+  static constexpr uint32_t TELEMETRY_MAX_AGE_MS = 100;  // Latencia máxima de una muestra en la trama
+  static constexpr uint32_t INPUT_CAPACITY  = 256;
+  static constexpr uint32_t CONTROL_CAPACITY = 128;
+  static constexpr uint32_t SAMPLE_CAPACITY = 1024;      // 64 muestras: más de 1 s con el loop de 20 ms
+
+  size_t writeCapacity() override;
+  void writeOut(const uint8_t* data, size_t len) override;
+
+private:
+  class ServerCallbacks;
+  class WriteCallbacks;
+
+  void procesarControl(const ControlCommand& cmd);
+  void notifyTelemetry();
+  size_t payloadLimit();
+
+  BLEServer*         server = nullptr;
+  BLECharacteristic* telemetryChr = nullptr;
+  BLECharacteristic* controlChr = nullptr;
+  BLECharacteristic* consoleChr = nullptr;
+  BLE2902*           telemetryCccd = nullptr;
+  BLE2902*           consoleCccd = nullptr;
+
+  std::atomic<bool>     connected{false};
+  std::atomic<uint16_t> connId{0};
+  bool clientePrevio = false;
+
+  // Productores: callbacks de BLE (entrada y control) y loop() (muestras)
+  uint8_t  inputStorage[INPUT_CAPACITY];
+  ByteRing input{inputStorage, INPUT_CAPACITY};
+  uint8_t  controlStorage[CONTROL_CAPACITY];
+  ByteRing control{controlStorage, CONTROL_CAPACITY};
+  uint8_t  sampleStorage[SAMPLE_CAPACITY];
+  ByteRing samples{sampleStorage, SAMPLE_CAPACITY};
+
+  std::atomic<uint16_t> telemetryIntervalMs{20};
+  uint32_t lastSampleMs = 0;
+  TelemetryBatcher batcher;
+
+  Counter* notifications = &MetricsRegistry::getInstance().counter("ble.notifications");
+  Counter* samplesLost   = &MetricsRegistry::getInstance().counter("ble.samples_lost");
+};
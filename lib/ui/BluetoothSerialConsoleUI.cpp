@@ -1,8 +1,10 @@
 #include "BluetoothSerialConsoleUI.h"
-#include <stdarg.h>
 #include <Arduino.h>
 
-BluetoothSerialConsoleUI::BluetoothSerialConsoleUI() {}
+BluetoothSerialConsoleUI::BluetoothSerialConsoleUI() {
+  activeUi = nullptr;
+  setOutputPolicy(ByteRing::Policy::DROP_OLDEST);
+}
 
 BluetoothSerialConsoleUI::~BluetoothSerialConsoleUI() {
   SerialBT.end();
@@ -13,7 +15,7 @@ void BluetoothSerialConsoleUI::begin() {
     Serial.println("❌ Error al iniciar Bluetooth");
     return;
   }
-  SerialBT.println("✅ Bluetooth iniciado como \"VortexAcusticoV1\"");
+  this->println("✅ Bluetooth iniciado como \"VortexAcusticoV1\"");
   imprimirHelp();  // si tienes ese método en ConsoleUI
 }
 
@@ -22,10 +24,10 @@ void BluetoothSerialConsoleUI::update() {
   bool clienteActual = SerialBT.hasClient();
 
   if (clienteActual && !clientePrevio) {
-    SerialBT.println("Cliente Bluetooth conectado");
-    SerialBT.println("Conexión establecida.");
+    this->println("Cliente Bluetooth conectado");
+    this->println("Conexión establecida.");
   } else if (!clienteActual && clientePrevio) {
-    SerialBT.println("Cliente Bluetooth desconectado");
+    this->println("Cliente Bluetooth desconectado");
   }
   clientePrevio = clienteActual;
 
@@ -34,36 +36,17 @@ void BluetoothSerialConsoleUI::update() {
 }
 
 
-bool BluetoothSerialConsoleUI::inputAvailable() {
-  return SerialBT.available() > 0;
-}
-
-String BluetoothSerialConsoleUI::readLine() {
-  return SerialBT.readStringUntil('\n');
-}
-
-void BluetoothSerialConsoleUI::print(const String& msg) {
-  SerialBT.print(msg);
-    if (mirror && this == *ui) 
-      mirror->print(msg);
+int BluetoothSerialConsoleUI::readChar() {
+  return SerialBT.read();
 }
 
-void BluetoothSerialConsoleUI::println(const String& msg) {
-  SerialBT.println(msg);
-    if (mirror && this == *ui) 
-      mirror->println(msg);
+size_t BluetoothSerialConsoleUI::writeCapacity() {
+  // Sin cliente no se entrega nada: el buffer absorbe y descarta lo más antiguo
+  return SerialBT.hasClient() ? WRITE_CHUNK : 0;
 }
 
-void BluetoothSerialConsoleUI::printf(const char* fmt, ...) {
-  char buf[256];
-  va_list args;
-  va_start(args, fmt);
-  vsnprintf(buf, sizeof(buf), fmt, args);
-  va_end(args);
-  SerialBT.print(buf);
-  if (mirror && this == *ui) 
-    mirror->print(buf);
-  if (mirror) mirror->print(buf);
+void BluetoothSerialConsoleUI::writeOut(const uint8_t* data, size_t len) {
+  SerialBT.write(data, len);
 }
 
 bool BluetoothSerialConsoleUI::isSistemaActivo() {
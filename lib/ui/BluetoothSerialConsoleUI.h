@@ -4,23 +4,27 @@
 
 class BluetoothSerialConsoleUI : public ConsoleUI {
 public:
-  BluetoothSerialConsoleUI(ConsoleUI** uiPtr) : ui(uiPtr) {}//
+  BluetoothSerialConsoleUI(ConsoleUI** uiPtr) {
+    activeUi = uiPtr;
+    setOutputPolicy(ByteRing::Policy::DROP_OLDEST);  // Al reconectar interesa lo más reciente
+  }
 
   BluetoothSerialConsoleUI();
   ~BluetoothSerialConsoleUI();
 
   void begin() override;
   void update() override;
-  bool inputAvailable() override;
-  String readLine() override;
-  void print(const String& msg) override;
-  void println(const String& msg) override;
-  void printf(const char* fmt, ...) override;
+  int readChar() override;
 
   bool isSistemaActivo();  // Retorna true si hay cliente Bluetooth conectado
 
+protected:
+  static constexpr size_t WRITE_CHUNK = 128;  // Bytes entregados al stack SPP por drenado
+
+  size_t writeCapacity() override;
+  void writeOut(const uint8_t* data, size_t len) override;
+
 private:
-  ConsoleUI** ui;  // puntero al puntero global ui
   BluetoothSerial SerialBT;
   bool clientePrevio = false;
 };
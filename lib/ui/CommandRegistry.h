@@ -0,0 +1,56 @@
+#pragma once
+
+#include <string.h>
+#include "CommandParser.h"
+
+/**
+ * @class CommandRegistry
+ * Tabla de comandos registrados (nombre, argumentos, ayuda, manejador, solo-dev).
+ * La tabla es estática y constante; el despacho es una búsqueda lineal sin memoria dinámica.
+ *
+ * @tparam Context Clase que implementa los manejadores (p.ej. ConsoleUI).
+ */
+template <typename Context>
+class CommandRegistry {
+public:
+  using Handler = void (Context::*)(const CommandArgs&);
+
+  struct Command {
+    const char* name;     ///< Primer campo de la línea ("a", "thr", "tps_raw")
+    const char* args;     ///< Descripción de argumentos para la ayuda ("" si no tiene)
+    const char* help;     ///< nullptr = no aparece en la ayuda (feeds del simulador)
+    Handler     handler;
+    bool        devOnly;  ///< Solo disponible en modo desarrollador
+  };
+
+  enum class Result { OK, EMPTY, NOT_FOUND, DEV_ONLY };
+
+  template <size_t N>
+  constexpr explicit CommandRegistry(const Command (&table)[N]) : table(table), count(N) {}
+
+  const Command* find(const char* name) const {
+    for (size_t i = 0; i < count; ++i) {
+      if (strcmp(table[i].name, name) == 0) return &table[i];
+    }
+    return nullptr;
+  }
+
+  /**
+   * Busca el comando por el nombre del primer campo y ejecuta su manejador.
+   */
+  Result dispatch(Context& ctx, const CommandArgs& args, bool developerMode) const {
+    if (args.count == 0) return Result::EMPTY;
+    const Command* cmd = find(args.name());
+    if (!cmd) return Result::NOT_FOUND;
+    if (cmd->devOnly && !developerMode) return Result::DEV_ONLY;
+    (ctx.*(cmd->handler))(args);
+    return Result::OK;
+  }
+
+  size_t size() const { return count; }
+  const Command& operator[](size_t i) const { return table[i]; }
+
+private:
+  const Command* table;
+  size_t count;
+};
@@ -1,5 +1,9 @@
 #include "ConsoleUI.h"
 #include "CalibrationManager.h" 
+#include "ConfigStore.h"
+#include "Logger.h"
+#include <string.h>
+#include <stdarg.h>
 
 void ConsoleUI::begin() {
 }
@@ -33,6 +37,105 @@ bool ConsoleUI::getCalibRequest() {
   return false;
 }
 
+void ConsoleUI::emit(const char* data, size_t len) {
+  // Cualquier otra salida mueve el cursor: el HUD se repinta completo
+  if (!renderingHud) hud.invalidate();
+  output.write(reinterpret_cast<const uint8_t*>(data), len);
+  if (mirror && activeUi && this == *activeUi) {
+    mirror->output.write(reinterpret_cast<const uint8_t*>(data), len);
+    mirror->hud.invalidate();  // Su terminal ya no refleja su propio HUD
+  }
+}
+
+void ConsoleUI::print(const char* msg) {
+  emit(msg, strlen(msg));
+}
+
+void ConsoleUI::print(const String& msg) {
+  emit(msg.c_str(), msg.length());
+}
+
+void ConsoleUI::println(const char* msg) {
+  emit(msg, strlen(msg));
+  emit("\r\n", 2);
+}
+
+void ConsoleUI::println(const String& msg) {
+  emit(msg.c_str(), msg.length());
+  emit("\r\n", 2);
+}
+
+void ConsoleUI::printf(const char* fmt, ...) {
+  char buf[256];
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(buf, sizeof(buf), fmt, args);
+  va_end(args);
+  if (len < 0) return;
+  emit(buf, static_cast<size_t>(len) < sizeof(buf) ? len : sizeof(buf) - 1);
+}
+
+void ConsoleUI::drainOutput() {
+  uint8_t chunk[64];
+  size_t room = writeCapacity();
+  if (room == 0) {
+    // Sumidero cerrado: con DROP_OLDEST se tira lo más antiguo para que quepa
+    // lo que se imprima mientras tanto (p. ej. el aviso de conexión)
+    output.discardOldest(OUTPUT_HEADROOM);
+    return;
+  }
+  while (room > 0) {
+    uint32_t n = output.read(chunk, room < sizeof(chunk) ? room : sizeof(chunk));
+    if (n == 0) break;
+    writeOut(chunk, n);
+    txBytes->inc(n);
+    room -= n;
+  }
+}
+
+void ConsoleUI::attachDebug(DebugManager* debugManagerPtr) {
+  debug = debugManagerPtr;
+}
+
+// Tabla única de comandos, compartida por la consola USB y la Bluetooth
+const ConsoleUI::Command ConsoleUI::COMMANDS[] = {
+  // nombre     args            ayuda                                                    manejador                        dev
+  { "a",        "",             "Activar/Desactivar sistema completo (seguridad/falla)", &ConsoleUI::cmdSistema,          false },
+  { "c",        "",             "Ejecutar rutina de calibración de sensores",            &ConsoleUI::cmdCalibrar,         false },
+  { "m",        "",             "Mostrar menú de comandos",                              &ConsoleUI::cmdAyuda,            false },
+  { "s",        "",             "Activar/Desactivar dashboard del sistema",              &ConsoleUI::cmdDashboard,        false },
+  { "d",        "",             "Activar modo desarrollador",                            &ConsoleUI::cmdDesarrollador,    false },
+  { "n",        "",             "Detener inyección acústica",                            &ConsoleUI::cmdDetenerAcustico,  false },
+  { "b",        "",             "Probar sonido acústico",                                &ConsoleUI::cmdPruebaAcustica,   true  },
+  { "i",        "",             "Activar relé INYECCIÓN_ACÚSTICA",                       &ConsoleUI::cmdReleInyector,     true  },
+  { "t",        "",             "Activar relé TURBO",                                    &ConsoleUI::cmdReleTurbo,        true  },
+  { "u",        "",             "(Comando dev pendiente)",                               &ConsoleUI::cmdPendiente,        true  },
+  { "x",        "",             "Paro manual, volver a IDLE",                            &ConsoleUI::cmdParoManual,       true  },
+  { "v",        "",             "Visualizar curva TPS-MAP (pendiente desarrollo)",       &ConsoleUI::cmdCurva,            true  },
+  { "r",        "",             "Borrar calibración actual",                             &ConsoleUI::cmdBorrarCalibracion,true  },
+  { "z",        "",             "Activar/Desactivar modo simulación",                    &ConsoleUI::cmdSimulacion,       true  },
+  { "k",        "",             "Mostrar lecturas de sensores y deriva",                 &ConsoleUI::cmdSensores,         true  },
+  { "o",        "",             "Estadísticas del buffer de salida de consola",          &ConsoleUI::cmdSalida,           true  },
+  { "perf",     "",             "Contadores de rendimiento (CPU, ISR, pilas, heap)",     &ConsoleUI::cmdPerf,             false },
+  { "thr",      "[CLAVE VALOR|apply|save|descartar]", "Umbrales de la FSM: listar, editar, aplicar o guardar", &ConsoleUI::cmdUmbrales, false },
+  { "perfil",   "[NOMBRE|nuevo NOMBRE]", "Perfiles de ajuste: listar, cambiar o crear y editar", &ConsoleUI::cmdPerfil, false },
+  { "onda",     "[tabla|coseno|ns|estereo [GRADOS [GANANCIA]]|aditiva|osc I HZ NIVEL [GRADOS]]", "Salida del inyector acústico y error de frecuencia", &ConsoleUI::cmdOnda, true },
+  { "mod",      "[no|rafaga ON_MS OFF_MS|am HZ PROF|chirp DESDE HASTA MS [exp]]", "Modulación del inyector acústico", &ConsoleUI::cmdModulacion, true },
+  { "eq",       "[med HZ DB|calcular|borrar]", "Ecualización del tweeter: medidas del barrido y tabla", &ConsoleUI::cmdEcualizacion, true },
+  { "retro",    "[eq|borrar]",  "Micrófono de retorno: tono detectado y respuesta por bin de carga", &ConsoleUI::cmdRetorno, true },
+  { "fft",      "[N [PROMEDIOS [BANDAS]]|no]", "Espectro del micrófono de retorno, una línea por promedio", &ConsoleUI::cmdEspectro, true },
+  { "tlm",      "",             nullptr,                                                 &ConsoleUI::cmdTelemetria,       false },
+  { "rec",      "",             nullptr,                                                 &ConsoleUI::cmdGrabarSensores,   false },
+  // Alimentación del simulador Python y overrides de DebugManager (sin ayuda)
+  { "tps_raw",  "",             nullptr,                                                 &ConsoleUI::cmdSimFeed,          false },
+  { "tps",      "",             nullptr,                                                 &ConsoleUI::cmdOverride,         false },
+  { "map",      "",             nullptr,                                                 &ConsoleUI::cmdOverride,         false },
+  { "vortex",   "",             nullptr,                                                 &ConsoleUI::cmdOverride,         false },
+  { "iny",      "",             nullptr,                                                 &ConsoleUI::cmdOverride,         false },
+};
+
+const ConsoleUI::Registry ConsoleUI::registry(ConsoleUI::COMMANDS);
+
 void ConsoleUI::update() {
   if (!fsm) return;
 
@@ -41,251 +144,680 @@ void ConsoleUI::update() {
     lastState = fsm->getState();
   }
 
-  if (inputAvailable()) {
-    String linea = readLine();
-    //this->println("[DEBUG] Línea recibida cruda: " + linea);
+  // Consumir lo recibido sin bloquear, con un tope de bytes por ciclo
+  for (size_t n = 0; n < INPUT_BUDGET; ++n) {
+    int c = readChar();
+    if (c < 0) break;
+    rxBytes->inc();
+    if (lineBuffer.push(static_cast<char>(c))) {
+      procesarLinea(lineBuffer.data());
+      lineBuffer.reset();
+    }
+  }
 
-    linea.trim();
-    //this->printf("[DEBUG] simulacionActiva = %s\n", simulacionActiva ? "true" : "false");
+  if (recordingSensors && sensors) {
+    grabarMuestra();
+  } else if (streamingSpectrum) {
+    emitirEspectro();
+  } else if (dashboardEnabled && millis() - lastHudTick >= HUD_TICK_MS) {
+    lastHudTick = millis();
+    imprimirDashboard();
+  }
+}
 
-    if (simulationOnPython && linea.startsWith("tps_raw:")) {
-      int idxTPS = linea.indexOf("tps_raw:");
-      int idxMAP = linea.indexOf("map_raw:");
+// Líneas de log del ESP o del simulador que llegan por el mismo puerto
+static bool esLineaDeLog(const char* linea) {
+  static const char* const prefijos[] = {
+    "[", "Gear:", "ets ", "rst:", "load:", "clk_drv:", "entry "
+  };
+  for (const char* p : prefijos) {
+    if (strncmp(linea, p, strlen(p)) == 0) return true;
+  }
+  return strstr(linea, "RPM:") != nullptr;
+}
 
-      if (idxTPS != -1 && idxMAP != -1) {
-        uint16_t tpsRaw = linea.substring(idxTPS + 8, idxMAP - 1).toInt(); // -1 para excluir la coma
-        uint16_t mapRaw = linea.substring(idxMAP + 8).toInt();
+void ConsoleUI::procesarLinea(char* linea) {
+  lineCount->inc();
+  while (*linea == ' ' || *linea == '\t') ++linea;
+  if (*linea == '#') return;  // Comentario (p. ej. en los perfiles de vortex_tune)
+  if (esLineaDeLog(linea)) return;
 
-        sensors->getTPS().setSimulatedRaw(tpsRaw);
-        sensors->getMAP().setSimulatedRaw(mapRaw);
+  CommandArgs args;
+  if (tokenizeCommand(linea, args) == 0) return;
 
-        //this->println("Recibido tps=" + String(tpsRaw) + " map=" + String(mapRaw));
-      }
-    } else if (linea.length() == 1) {
-      interpretarComando(linea.charAt(0));
-    } else if (linea.startsWith("[") || linea.startsWith("Gear:") ||
-         linea.indexOf("RPM:") != -1 || linea.startsWith("ets ") ||
-         linea.startsWith("rst:") || linea.startsWith("load:") ||
-         linea.startsWith("clk_drv:") || linea.startsWith("entry ")) {
-      // Es una línea de log del ESP o del simulador: ignorar
-      } else {
-        this->println("⚠️  Comando no reconocido.");
-      }
+  const Command* cmd = registry.find(args.name());
+  if (cmd && cmd->help) {
+    tiempoProximaImpresionHUD = millis() + 2500;
+  }
 
+  switch (registry.dispatch(*this, args, developerMode)) {
+    case Registry::Result::NOT_FOUND:
+      this->println("⚠️  Comando no reconocido.");
+      break;
+    case Registry::Result::DEV_ONLY:
+      this->println("⚠️  Comando exclusivo del modo desarrollador.");
+      break;
+    default:
+      break;
   }
-  if (dashboardEnabled) {
-    static unsigned long lastPrint = 0;
-    if (millis() - lastPrint > 300) {
-      imprimirDashboard();
-      lastPrint = millis();
-    }
+}
+
+void ConsoleUI::cmdSistema(const CommandArgs&) {
+  toggleSistema();
+}
+
+void ConsoleUI::cmdPruebaAcustica(const CommandArgs&) {
+  actuators->startAcoustic(1.0f);
+  if (!actuators->isAcousticOn()) return;
+
+  AcousticSelfTest t = actuators->selfTest();
+  if (!t.verified) {
+    this->println(">> Sin micrófono de retorno: prueba sin verificar.");
+    return;
+  }
+  if (!t.measured) {
+    this->println("❌ El monitor acústico no llegó a medir.");
+    return;
+  }
+  this->printf(">> Retorno: %.1f Hz, tono %.1f mV, RMS %.1f mV, SNR %.1f dB\n", t.freqHz,
+               t.last.amplitude * 3300.0f / 4095.0f, t.last.rms * 3300.0f / 4095.0f, t.last.snrDb);
+  if (t.passed()) {
+    this->println("✅ Tono confirmado en el conducto.");
+  } else {
+    this->printf("❌ Retorno acústico: %s\n", AcousticMonitor::statusName(t.status));
   }
 }
 
+void ConsoleUI::cmdCalibrar(const CommandArgs&) {
+  consoleCalibRequested = true;
+  this->println(">> Solicitud de calibración registrada.");
+}
 
-void ConsoleUI::interpretarComando(char c) {
-  // Comandos solo en modo desarrollador
-  auto devOnly = [&]() {
-    if (!developerMode) {
-      this->println("⚠️  Comando exclusivo del modo desarrollador.");
-      return false;
+void ConsoleUI::cmdDesarrollador(const CommandArgs&) {
+  developerMode = true;
+  this->println(">> Modo desarrollador ACTIVADO.");
+  imprimirHelp();
+}
+
+void ConsoleUI::cmdReleInyector(const CommandArgs&) {
+  if (actuators->getAcousticInjector().isActive()) {
+    bool estadoActual = actuators->getAcousticInjector().isRelayActive();
+    actuators->getAcousticInjector().testRelay(!estadoActual);
+    this->printf(">> Relé %s.\n", !estadoActual ? "activado" : "desactivado");
+  } else {
+    this->println("⚠️ Inyector no disponible.");
+  }
+}
+
+void ConsoleUI::cmdAyuda(const CommandArgs&) {
+  imprimirHelp();
+}
+
+void ConsoleUI::cmdDetenerAcustico(const CommandArgs&) {
+  if (actuators->isAcousticOn())
+    actuators->stopAcoustic();
+}
+
+void ConsoleUI::cmdBorrarCalibracion(const CommandArgs&) {
+  CalibrationManager::getInstance().clearCalibration();
+  if (fsm) {
+    fsm->debugForceState(SystemState::SIN_CALIBRAR);
+    this->println(">> Se requiere recalibrar de nuevo para poder usar el sistema");
+  } else {
+    this->println("⚠️ No se puede cambiar estado: FSM no está disponible.");
+  }
+}
+
+void ConsoleUI::cmdDashboard(const CommandArgs&) {
+  dashboardEnabled = !dashboardEnabled;
+  this->printf(">> Dashboard en tiempo real %s.\n", dashboardEnabled ? "ACTIVADO" : "DESACTIVADO");
+}
+
+void ConsoleUI::cmdReleTurbo(const CommandArgs&) {
+  if (actuators->getVortexController().isActive()) {
+    if (actuators->getVortexController().isActive()) {
+      actuators->stopVortex();
+      this->println(">> Turbo desactivado.");
+    } else {
+      actuators->startVortex();
+      this->println(">> Turbo activado.");
     }
-    return true;
-  };
-  tiempoProximaImpresionHUD = millis() + 2500;
+  } else {
+    this->println("⚠️ Turbo no disponible.");
+  }
+}
 
-  switch (c) {
-    case 'a':  // Toggle sistema ON/OFF
-      toggleSistema();
-      break;
+void ConsoleUI::cmdPendiente(const CommandArgs&) {
+  // Implementar acción para 'u' si aplica
+}
 
-    case 'b':  // Iniciar inyección acústica (100%)
-      if (!devOnly()) break;
-      actuators->startAcoustic(1.0f);
-      if (actuators->isAcousticOn())
-        actuators->getAcousticInjector().test();
-      break;
+void ConsoleUI::cmdCurva(const CommandArgs&) {
+  this->println(">> [visualización de curva] …");
+}
 
-    case 'c':  // Solicitar calibración por consola
-      consoleCalibRequested = true;
-      this->println(">> Solicitud de calibración registrada.");
-      break;
+void ConsoleUI::cmdParoManual(const CommandArgs&) {
+  if (fsm) {
+    fsm->debugForceState(SystemState::IDLE);
+    this->println(">> Paro manual: regresando a IDLE.");
+  }
+}
 
-    case 'd':  // Activar modo desarrollador
-      developerMode = true;
-      this->println(">> Modo desarrollador ACTIVADO.");
-      imprimirHelp();
-      break;
+void ConsoleUI::cmdSimulacion(const CommandArgs&) {
+  simulationOnPython = !simulationOnPython;
 
-    case 'i':  // Toggle relé inyector acústico (dev mode)
-      if (!devOnly()) break;
-      if (actuators->getAcousticInjector().isActive()) {
-        bool estadoActual = actuators->getAcousticInjector().isRelayActive();
-        actuators->getAcousticInjector().testRelay(!estadoActual);
-        this->printf(">> Relé %s.\n", !estadoActual ? "activado" : "desactivado");
-      } else {
-        this->println("⚠️ Inyector no disponible.");
-      }
-      break;
+  if (simulationOnPython) {
+    //sensors->getTPS().enableSimulation();
+    //sensors->getMAP().enableSimulation();
+  } else {
+    sensors->getTPS().disableSimulation();
+    sensors->getMAP().disableSimulation();
+  }
 
-    case 'm':  // Mostrar ayuda
-      imprimirHelp();
-      break;
+  this->printf(">> Modo simulación %s.\n", simulationOnPython ? "ACTIVADO" : "DESACTIVADO");
+}
 
-    case 'n':  // Detener inyección acústica
-      if (actuators->isAcousticOn())
-        actuators->stopAcoustic();
-      break;
+void ConsoleUI::cmdSensores(const CommandArgs&) {
+  this->printf("== DEBUG Sensores ==\n");
 
-    case 'r':  // Borrar calibración y poner FSM en estado sin calibrar
-      if (!devOnly()) break;
-      CalibrationManager::getInstance().clearCalibration();
-      if (fsm) {
-        fsm->debugForceState(SystemState::SIN_CALIBRAR);
-        this->println(">> Se requiere recalibrar de nuevo para poder usar el sistema");
-      } else {
-        this->println("⚠️ No se puede cambiar estado: FSM no está disponible.");
-      }
-      break;
+  this->printf("TPS: raw=%d, volts=%.2f, %%=%.1f%%\n",
+              sensors->getTPS().readRaw(),
+              sensors->getTPS().readVolts(),
+              sensors->getTPS().readPorcent());
 
-    case 's':  // Toggle dashboard en tiempo real
-      dashboardEnabled = !dashboardEnabled;
-      this->printf(">> Dashboard en tiempo real %s.\n", dashboardEnabled ? "ACTIVADO" : "DESACTIVADO");
-      break;
+  this->printf("MAP: raw=%d, volts=%.2f\n",
+              sensors->getMAP().readRaw(),
+              sensors->getMAP().readVolts());
+  imprimirDeriva();
+}
 
-    case 't':  // Toggle turbo (dev mode)
-      if (!devOnly()) break;
-      if (actuators->getVortexController().isActive()) {
-        if (actuators->getVortexController().isActive()) {
-          actuators->stopVortex();
-          this->println(">> Turbo desactivado.");
-        } else {
-          actuators->startVortex();
-          this->println(">> Turbo activado.");
-        }
-      } else {
-        this->println("⚠️ Turbo no disponible.");
-      }
-      break;
+void ConsoleUI::cmdSalida(const CommandArgs&) {
+  ByteRing::Stats st = output.getStats();
+  this->printf(">> Salida: %lu B escritos, %lu B perdidos en %lu desbordes, pico %lu/%lu B (%s)\n",
+               (unsigned long)st.written, (unsigned long)st.dropped,
+               (unsigned long)st.overflows, (unsigned long)st.highWater,
+               (unsigned long)output.capacity(),
+               output.getPolicy() == ByteRing::Policy::DROP_OLDEST ? "descarta antiguos" : "descarta nuevos");
+  this->printf(">> Log: %lu registros descartados\n", (unsigned long)Logger::getInstance().getDropped());
+}
 
-    case 'u':  // Placeholder para otro comando dev
-      if (!devOnly()) break;
-      // Implementar acción para 'u' si aplica
-      break;
+void ConsoleUI::cmdPerf(const CommandArgs&) {
+  MetricsRegistry& reg = MetricsRegistry::getInstance();
+  uint32_t now = millis();
+  char line[96];
+  this->println(">> Métricas (tasas desde el último 'perf'):");
+  for (uint8_t i = 0; i < reg.size(); ++i) {
+    if (reg.describe(i, now, line, sizeof(line))) {
+      this->print("   ");
+      this->println(line);
+    }
+  }
+  reg.markSnapshot(now);
+}
 
-    case 'v':  // Visualización curva (dev mode)
-      if (!devOnly()) break;
-      this->println(">> [visualización de curva] …");
-      break;
+// Una línea clave:valor para herramientas externas
+void ConsoleUI::cmdTelemetria(const CommandArgs&) {
+  char record[512];
+  if (MetricsRegistry::getInstance().writeTelemetry(millis(), record, sizeof(record))) {
+    this->println(record);
+  }
+}
 
-    case 'x':  // Forzar estado IDLE en FSM
-      if (!devOnly()) break;
-      if (fsm) {
-        fsm->debugForceState(SystemState::IDLE);
-        this->println(">> Paro manual: regresando a IDLE.");
-      }
-      break;
+// "thr" lista, "thr CLAVE VALOR" acumula en el borrador, "thr apply" lo valida
+// y lo publica al loop de una vez, "thr save" además persiste vía ConfigStore y
+// "thr descartar" lo tira. Es el formato que emite tools/tune: un perfil se
+// importa pegando su bloque (perfil nuevo NOMBRE, claves y un solo thr save).
+void ConsoleUI::cmdUmbrales(const CommandArgs& args) {
+  if (!thresholds) return;
+
+  const char* key = args.arg(1);
+  if (!key) {
+    TuningProfile p;
+    bool editing = thresholds->getEdits(p);
+    if (!editing) thresholds->getProfile(thresholds->getSelectedIndex(), p);
+    const Thresholds& t = p.thresholds;
+    if (editing) {
+      this->printf("# perfil %s: borrador sin aplicar (thr apply|save|descartar)\n",
+                   thresholds->getEditIndex() == ThresholdManager::NO_SLOT ? "(ninguno)" : p.name);
+    } else {
+      this->printf("# perfil %s (rev %u)\n", p.name, (unsigned)p.revision);
+    }
+    this->printf("MAP_WAKEUP_PERCENT  %6.2f\n", t.MAP_WAKEUP_PERCENT);
+    this->printf("INJ_TPS_ON          %6.2f\n", t.INJ_TPS_ON);
+    this->printf("INJ_MAP_ON          %6.2f\n", t.INJ_MAP_ON);
+    this->printf("INJ_TPS_OFF         %6.2f\n", t.INJ_TPS_OFF);
+    this->printf("INJ_MAP_OFF         %6.2f\n", t.INJ_MAP_OFF);
+    this->printf("VORTEX_TPS_ON       %6.2f\n", t.VORTEX_TPS_ON);
+    this->printf("VORTEX_MAP_ON       %6.2f\n", t.VORTEX_MAP_ON);
+    this->printf("VORTEX_TPS_OFF      %6.2f\n", t.VORTEX_TPS_OFF);
+    this->printf("FREQ_MIN_HZ         %6.0f\n", p.actuation.freqMinHz);
+    this->printf("FREQ_MAX_HZ         %6.0f\n", p.actuation.freqMaxHz);
+    return;
+  }
 
-    case 'z':  // Toggle modo simulación (dev mode)
-      if (!devOnly()) break;
+  bool save = strcmp(key, "save") == 0;
+  if (save || strcmp(key, "apply") == 0) {
+    const char* reason = "";
+    ThresholdManager::EditResult r = save ? thresholds->save(&reason) : thresholds->applyEdits(&reason);
+    switch (r) {
+      case ThresholdManager::EditResult::OK:
+        this->println(save ? ">> Umbrales guardados." : ">> Umbrales aplicados (thr save para persistir)");
+        break;
+      case ThresholdManager::EditResult::NO_EDITS:
+        this->println(">> Sin cambios pendientes");
+        break;
+      case ThresholdManager::EditResult::NO_SLOT:
+        this->println("⚠️  El borrador no tiene perfil destino: thr descartar");
+        break;
+      case ThresholdManager::EditResult::INVALID:
+        this->printf("⚠️  No se aplica: %s\n", reason);
+        break;
+    }
+    return;
+  }
 
-      simulationOnPython = !simulationOnPython;
+  if (strcmp(key, "descartar") == 0) {
+    thresholds->discardEdits();
+    this->println(">> Borrador descartado");
+    return;
+  }
 
-      if (simulationOnPython) {
-        //sensors->getTPS().enableSimulation();
-        //sensors->getMAP().enableSimulation();
-      } else {
-        sensors->getTPS().disableSimulation();
-        sensors->getMAP().disableSimulation();
-      }
+  float value;
+  if (!args.arg(2) || !CommandArgs::toFloat(args.arg(2), value)) {
+    this->println("⚠️  Uso: thr [CLAVE VALOR|apply|save|descartar]");
+  } else if (!thresholds->setThreshold(key, value)) {
+    this->printf("⚠️  Umbral desconocido: %s\n", key);
+  } else {
+    this->printf(">> %s = %.2f (thr apply o thr save para usarlo)\n", key, value);
+  }
+}
 
-      this->printf(">> Modo simulación %s.\n", simulationOnPython ? "ACTIVADO" : "DESACTIVADO");
-      break;
-    case 'k':  // Verificar valores de sensores
-      if (!devOnly()) break;
+// El cambio se publica al momento; la FSM lo adopta en el próximo estado sin actuadores
+void ConsoleUI::cmdPerfil(const CommandArgs& args) {
+  if (!thresholds) return;
+
+  const char* name = args.arg(1);
+  if (!name) {
+    uint8_t selected = thresholds->getSelectedIndex();
+    uint8_t active = thresholds->getActiveIndex();
+    int editing = thresholds->getEditIndex();
+    for (uint8_t i = 0; i < MAX_PROFILES; i++) {
+      TuningProfile p;
+      if (!thresholds->getProfile(i, p)) continue;
+      const char* note = "";
+      if (selected != active) note = i == selected ? " (pendiente)" : (i == active ? " (en uso)" : "");
+      this->printf("%c %-11s rev %-3u%s%s\n", i == selected ? '*' : ' ', p.name, (unsigned)p.revision, note,
+                   editing == i ? " (en edición)" : "");
+    }
+    return;
+  }
 
-      this->printf("== DEBUG Sensores ==\n");
+  if (strcmp(name, "nuevo") == 0) {
+    // Abre el borrador sobre el perfil: las líneas "thr" que siguen van a él
+    const char* newName = args.arg(2);
+    if (!newName) {
+      this->println("⚠️  Uso: perfil nuevo NOMBRE");
+    } else if (thresholds->createAndEdit(newName) < 0) {
+      this->printf("⚠️  No se pudo crear %s (máx. 11 caracteres, 4 perfiles): el borrador queda sin destino\n", newName);
+    } else {
+      this->printf(">> Perfil %s en edición (thr CLAVE VALOR, luego thr save)\n", newName);
+    }
+    return;
+  }
 
-      this->printf("TPS: raw=%d, volts=%.2f, %%=%.1f%%\n",
-                  sensors->getTPS().readRaw(),
-                  sensors->getTPS().readVolts(),
-                  sensors->getTPS().readPorcent());
+  int index = thresholds->findProfile(name);
+  if (index < 0 || !thresholds->selectProfile(static_cast<uint8_t>(index))) {
+    this->printf("⚠️  Perfil desconocido: %s\n", name);
+  } else {
+    this->printf(">> Perfil %s seleccionado\n", name);
+  }
+}
 
-      this->printf("MAP: raw=%d, volts=%.2f\n",
-                  sensors->getMAP().readRaw(),
-                  sensors->getMAP().readVolts());
+// Tabla por ISR, generador de coseno del DAC o tabla en los dos DAC (el modo
+// solo con el inyector parado); "ns", desfase y ganancia también en marcha
+void ConsoleUI::cmdOnda(const CommandArgs& args) {
+  AcousticInjector& inj = actuators->getAcousticInjector();
+  const char* mode = args.arg(1);
+  if (mode && strcmp(mode, "ns") == 0) {
+    inj.setNoiseShaping(!inj.getNoiseShaping());
+  } else if (mode && strcmp(mode, "osc") == 0) {
+    long index;
+    float freq, level, phase = 0.0f;
+    if (!args.arg(4) || !CommandArgs::toInt(args.arg(2), index) || index < 0 ||
+        !CommandArgs::toFloat(args.arg(3), freq) || !CommandArgs::toFloat(args.arg(4), level) ||
+        (args.arg(5) && !CommandArgs::toFloat(args.arg(5), phase))) {
+      this->println("⚠️  Uso: onda osc I HZ NIVEL [GRADOS]");
+      return;
+    }
+    if (!actuators->setOscillator(static_cast<uint8_t>(index), freq, level, phase)) {
+      this->printf("⚠️  Oscilador 0–%u y frecuencia bajo %lu Hz\n",
+                   actuators->getOscillatorCount() - 1, (unsigned long)(ADDITIVE_SAMPLE_HZ / 2));
+      return;
+    }
+  } else if (mode) {
+    AcousticInjector::OutputMode m;
+    float phase, gain;
+    if (strcmp(mode, "tabla") == 0) m = AcousticInjector::OutputMode::SINE_TABLE;
+    else if (strcmp(mode, "coseno") == 0) m = AcousticInjector::OutputMode::COSINE;
+    else if (strcmp(mode, "estereo") == 0) m = AcousticInjector::OutputMode::STEREO;
+    else if (strcmp(mode, "aditiva") == 0) m = AcousticInjector::OutputMode::ADDITIVE;
+    else {
+      this->println("⚠️  Uso: onda [tabla|coseno|ns|estereo [GRADOS [GANANCIA]]|aditiva|osc I HZ NIVEL [GRADOS]]");
+      return;
+    }
+    if (args.arg(2) && CommandArgs::toFloat(args.arg(2), phase)) inj.setStereoPhase(phase);
+    if (args.arg(3) && CommandArgs::toFloat(args.arg(3), gain)) inj.setSecondGain(gain);
+    if (!inj.setOutputMode(m)) {
+      this->println("⚠️  Detener la inyección acústica antes de cambiar la salida");
+      return;
+    }
+  }
+
+  bool coseno = inj.getOutputMode() == AcousticInjector::OutputMode::COSINE;
+  bool estereo = inj.getOutputMode() == AcousticInjector::OutputMode::STEREO;
+  bool aditiva = inj.getOutputMode() == AcousticInjector::OutputMode::ADDITIVE;
+  this->printf("Salida   %s\n", coseno ? "coseno (sin ISR)" : (estereo ? "tabla en DAC1 y DAC2 (ISR timer 2)" :
+               (aditiva ? "aditiva (ISR timer 2 a 50 kHz)" : "tabla (ISR timer 2)")));
+  if (estereo) this->printf("DAC 2    %+.1f°, ganancia %.2f\n", inj.getStereoPhase(), inj.getSecondGain());
+  if (aditiva) {
+    for (uint8_t i = 0; i < AcousticInjector::OSCILLATORS; i++) {
+      float freq, level, phase;
+      inj.getOscillator(i, freq, level, phase);
+      this->printf("Osc %u    %7.1f Hz, nivel %.2f, %+.1f°%s\n", i, freq, level, phase, i == 0 ? " (portadora)" : "");
+    }
+    this->printf("Recortes %lu\n", (unsigned long)inj.getClippedSamples());
+  }
+  if (!coseno && !aditiva) this->printf("Ruido    %s\n", inj.getNoiseShaping() ? "conformado (1.er orden)" : "sin conformar");
+  this->printf("Pedida   %7.1f Hz\n", inj.getFrequency());
+  this->printf("Real     %7.1f Hz (%+.1f Hz)\n", inj.getOutputFrequency(), inj.getFrequencyError());
+  if (coseno) this->printf("RTC8M    %7.0f kHz\n", inj.getRtc8mHz() / 1000.0f);
+  const TweeterThermal& th = actuators->getThermal();
+  this->printf("Bobina   %+.1f °C, nivel máx. %.2f (continuo %.2f)%s\n", th.getRise(), th.maxLevel(),
+               th.continuousLevel(), th.isLimiting() ? ", limitando" : "");
+}
+
+// La modulación la lleva la FSM: se aplica en el siguiente ciclo de INYECCION_ACUSTICA
+void ConsoleUI::cmdModulacion(const CommandArgs& args) {
+  AcousticModulation m = fsm->getAcousticModulation();
+  const char* mode = args.arg(1);
+  if (mode) {
+    float a, b, c;
+    bool ok = true;
+    if (strcmp(mode, "no") == 0) {
+      m.mode = ModulationMode::NONE;
+    } else if (strcmp(mode, "rafaga") == 0 && CommandArgs::toFloat(args.arg(2), a) &&
+               CommandArgs::toFloat(args.arg(3), b) && a >= 1.0f && b >= 1.0f && a <= 60000.0f && b <= 60000.0f) {
+      m.mode = ModulationMode::BURST;
+      m.burstOnMs = static_cast<uint16_t>(a);
+      m.burstOffMs = static_cast<uint16_t>(b);
+    } else if (strcmp(mode, "am") == 0 && CommandArgs::toFloat(args.arg(2), a) &&
+               CommandArgs::toFloat(args.arg(3), b)) {
+      m.mode = ModulationMode::AM;
+      m.amRateHz = constrain(a, 0.1f, 50.0f);
+      m.amDepth = constrain(b, 0.0f, 1.0f);
+    } else if (strcmp(mode, "chirp") == 0 && CommandArgs::toFloat(args.arg(2), a) &&
+               CommandArgs::toFloat(args.arg(3), b) && CommandArgs::toFloat(args.arg(4), c) &&
+               a > 0.0f && b > 0.0f && c >= 1.0f && c <= 60000.0f) {
+      bool exp = args.arg(5) && strcmp(args.arg(5), "exp") == 0;
+      m.mode = exp ? ModulationMode::CHIRP_EXP : ModulationMode::CHIRP_LINEAR;
+      m.chirpStartHz = a;
+      m.chirpEndHz = b;
+      m.chirpMs = static_cast<uint16_t>(c);
+    } else {
+      ok = false;
+    }
+    if (!ok) {
+      this->println("⚠️  Uso: mod [no|rafaga ON_MS OFF_MS|am HZ PROF|chirp DESDE HASTA MS [exp]]");
+      return;
+    }
+    fsm->setAcousticModulation(m);
+  }
+
+  switch (m.mode) {
+    case ModulationMode::NONE:
+      this->println("Modulación  ninguna (tono continuo)");
+      break;
+    case ModulationMode::BURST:
+      this->printf("Modulación  ráfagas %u ms / %u ms (ciclo %.0f %%)\n", m.burstOnMs, m.burstOffMs,
+                   100.0f * m.burstOnMs / (m.burstOnMs + m.burstOffMs));
+      break;
+    case ModulationMode::AM:
+      this->printf("Modulación  AM %.1f Hz, profundidad %.2f\n", m.amRateHz, m.amDepth);
       break;
     default:
-      if (!simulationOnPython) break;
-      this->print("❓ Comando no reconocido: ");
-      this->println(String(c));
+      this->printf("Modulación  chirp %s %.0f → %.0f Hz en %u ms\n",
+                   m.mode == ModulationMode::CHIRP_EXP ? "exponencial" : "lineal", m.chirpStartHz, m.chirpEndHz, m.chirpMs);
+      break;
+  }
+  if (!actuators->getAcousticInjector().supportsModulation(m)) {
+    this->println("⚠️  La salida actual no la aplica (chirp: onda aditiva; coseno: sin modulación)");
+  }
+}
 
+// Barrido de calibración a mano: con el tono a cada frecuencia ("onda", "b"),
+// se anota el nivel medido en el conducto y al final se calcula la tabla
+void ConsoleUI::cmdEcualizacion(const CommandArgs& args) {
+  const char* op = args.arg(1);
+  if (op && strcmp(op, "med") == 0) {
+    float freq, db;
+    if (!CommandArgs::toFloat(args.arg(2), freq) || !CommandArgs::toFloat(args.arg(3), db)) {
+      this->println("⚠️  Uso: eq med HZ DB");
+      return;
+    }
+    if (!eqBuilder.addMeasurement(freq, db)) {
+      this->printf("⚠️  Medida rechazada (máximo %u frecuencias)\n", EQ_MAX_POINTS);
+      return;
+    }
+  } else if (op && strcmp(op, "calcular") == 0) {
+    AcousticEqData eq;
+    if (!eqBuilder.build(eq)) {
+      this->println("⚠️  Hacen falta medidas en al menos dos frecuencias");
+      return;
+    }
+    ConfigStore::getInstance().setEqualization(eq);
+    actuators->setEqualization(eq);
+    eqBuilder.reset();
+    this->println(">> Ecualización guardada");
+  } else if (op && strcmp(op, "borrar") == 0) {
+    ConfigStore::getInstance().setEqualization(AcousticEqData());
+    actuators->setEqualization(AcousticEqData());
+    eqBuilder.reset();
+    this->println(">> Ecualización borrada");
+  } else if (op) {
+    this->println("⚠️  Uso: eq [med HZ DB|calcular|borrar]");
+    return;
+  }
 
+  const AcousticEqData& eq = actuators->getEqualization();
+  if (eq.count == 0) this->println("Tabla    sin ecualizar");
+  for (uint8_t i = 0; i < eq.count; i++) {
+    float gain = eq.gain[i] / (float)EQ_GAIN_UNITY;
+    this->printf("Tabla    %5u Hz  ×%.2f (%+.1f dB)\n", eq.freqHz[i], gain, 20.0f * log10f(gain));
+  }
+  for (uint8_t i = 0; i < eqBuilder.size(); i++) {
+    this->printf("Medida   %5.0f Hz  %.1f dB\n", eqBuilder.frequencyAt(i), eqBuilder.levelDbAt(i));
   }
 }
 
-void ConsoleUI::imprimirDashboard() {
-  if (!fsm || !sensors || !actuators) return;
-  if (millis() < tiempoProximaImpresionHUD) return;
+// "retro eq" pasa la respuesta aprendida a las medidas de "eq": como mucho
+// EQ_MAX_POINTS bins repartidos por la banda, luego "eq calcular"
+void ConsoleUI::cmdRetorno(const CommandArgs& args) {
+  AcousticMonitor& mon = actuators->getMonitor();
+  if (!mon.isAvailable()) {
+    this->println("⚠️  Sin micrófono de retorno");
+    return;
+  }
+  const char* op = args.arg(1);
+  uint8_t learned = 0;
+  float db;
+  for (uint8_t bin = 0; bin < SYNTH_LOAD_BINS; bin++) {
+    if (mon.getBinResponse(bin, db)) learned++;
+  }
+  if (op && strcmp(op, "eq") == 0) {
+    if (learned < 2) {
+      this->println("⚠️  Hacen falta al menos dos bins aprendidos");
+      return;
+    }
+    uint8_t step = (learned + EQ_MAX_POINTS - 1) / EQ_MAX_POINTS;
+    uint8_t seen = 0, added = 0;
+    eqBuilder.reset();
+    for (uint8_t bin = 0; bin < SYNTH_LOAD_BINS; bin++) {
+      if (!mon.getBinResponse(bin, db)) continue;
+      if (seen++ % step == 0 && eqBuilder.addMeasurement(actuators->getLoadBinFrequency(bin), db)) added++;
+    }
+    this->printf(">> %u medidas pasadas a eq\n", added);
+    return;
+  } else if (op && strcmp(op, "borrar") == 0) {
+    mon.clearResponse();
+    learned = 0;
+  } else if (op) {
+    this->println("⚠️  Uso: retro [eq|borrar]");
+    return;
+  }
+
+  const GoertzelResult& r = mon.getLast();
+  this->printf("Estado   %s (%lu ventanas)\n", AcousticMonitor::statusName(mon.getStatus()), (unsigned long)mon.getWindows());
+  this->printf("Muestreo %7.0f Hz\n", mon.getSampleHz());
+  this->printf("Tono     %7.1f Hz, %.1f mV, SNR %.1f dB\n", mon.getLastFrequency(), r.amplitude * 3300.0f / 4095.0f, r.snrDb);
+  this->printf("Entrada  %.0f cuentas, RMS %.1f mV\n", r.mean, r.rms * 3300.0f / 4095.0f);
+  for (uint8_t bin = 0; bin < SYNTH_LOAD_BINS; bin++) {
+    if (!mon.getBinResponse(bin, db)) continue;
+    this->printf("Bin %3u  %5.0f Hz  %+.1f dB (%u ventanas)\n", bin, actuators->getLoadBinFrequency(bin), db,
+                 mon.getBinWindows(bin));
+  }
+  if (learned == 0) this->println("Bins     sin respuesta aprendida");
+}
+
+// "fft" arranca el espectro (por defecto 1024 puntos, 8 promedios, 64 bandas)
+// y sustituye al HUD por líneas "spec SEQ N FS BANDA_HZ HEX", un byte por
+// banda: pico en pasos de SPECTRUM_DB_STEP dB bajo el fondo de escala
+void ConsoleUI::cmdEspectro(const CommandArgs& args) {
+  AcousticMonitor& mon = actuators->getMonitor();
+  const char* op = args.arg(1);
+  if (op && strcmp(op, "no") == 0) {
+    mon.stopSpectrum();
+    streamingSpectrum = false;
+    hud.invalidate();
+    this->println("# fft fin");
+    return;
+  }
+  long size = 1024, averages = 8, bands = 64;
+  if ((op && !CommandArgs::toInt(op, size)) || (args.arg(2) && !CommandArgs::toInt(args.arg(2), averages)) ||
+      (args.arg(3) && !CommandArgs::toInt(args.arg(3), bands)) || averages < 1 || averages > SPECTRUM_MAX_AVERAGE ||
+      bands < 1 || bands > SPECTRUM_MAX_BANDS || size < FFT_MIN_SIZE || size > FFT_MAX_SIZE ||
+      !fftValidSize(static_cast<uint16_t>(size))) {
+    this->printf("⚠️  Uso: fft [N [PROMEDIOS [BANDAS]]|no]  (N potencia de 2, %u–%u)\n", FFT_MIN_SIZE, FFT_MAX_SIZE);
+    return;
+  }
+  if (!mon.startSpectrum(static_cast<uint16_t>(size), static_cast<uint8_t>(averages))) {
+    this->println("⚠️  Sin micrófono de retorno");
+    return;
+  }
+  spectrumBands = static_cast<uint8_t>(bands);
+  spectrumSeq = 0;
+  streamingSpectrum = true;
+  this->printf("# fft %ld puntos, %ld promedios, %ld bandas\n", size, averages, bands);
+}
 
-  float tpsV = sensors->getTPS().readVolts();
-  float mapV = sensors->getMAP().readVolts();
-  uint8_t dac = actuators->getAcousticInjector().getCurrentDAC();
-  bool vortexOn = actuators->isTurboOn();
-  bool injOn = actuators->isAcousticOn();
+void ConsoleUI::emitirEspectro() {
+  uint8_t bands[SPECTRUM_MAX_BANDS];
+  SpectrumInfo info;
+  uint8_t n = actuators->getMonitor().readSpectrum(bands, spectrumBands, info);
+  if (n == 0 || info.sequence == spectrumSeq) return;
+  spectrumSeq = info.sequence;
+
+  static const char hex[] = "0123456789abcdef";
+  char line[48 + 2 * SPECTRUM_MAX_BANDS];
+  int len = snprintf(line, sizeof(line), "spec %lu %u %.0f %.1f ", (unsigned long)info.sequence, info.size,
+                     info.sampleHz, info.bandHz);
+  for (uint8_t i = 0; i < n && len + 2 < (int)sizeof(line); i++) {
+    line[len++] = hex[bands[i] >> 4];
+    line[len++] = hex[bands[i] & 0x0F];
+  }
+  line[len] = '\0';
+  this->println(line);
+}
 
-  // Obtener level y freq actuales
-  float level = actuators->getAcousticInjector().getLevel();
-  float freq = actuators->getAcousticInjector().getFrequency();
+// Registro de lecturas crudas para tools/replay; el HUD se pausa mientras dura
+void ConsoleUI::cmdGrabarSensores(const CommandArgs&) {
+  recordingSensors = !recordingSensors;
+  this->printf("# rec %s\n", recordingSensors ? "inicio" : "fin");
+  if (!recordingSensors) hud.invalidate();
+}
 
-  SystemState st = fsm->getState();
-  unsigned long elapsed = (millis() - lastTransitionMS) / 1000;
+// Una muestra por ciclo de update() (20 ms), mismo formato que race_sim.py más la marca de tiempo
+void ConsoleUI::grabarMuestra() {
+  this->printf("t_ms:%lu,tps_raw:%u,map_raw:%u\n", (unsigned long)millis(),
+               (unsigned)sensors->getLastTPSRaw(), (unsigned)sensors->getLastMAPRaw());
+}
+
+// "tps_raw:1234,map_raw:3900" enviado por race_sim.py a alta frecuencia
+void ConsoleUI::cmdSimFeed(const CommandArgs& args) {
+  if (!simulationOnPython) return;
+
+  long tpsRaw, mapRaw;
+  if (args.getInt("tps_raw", tpsRaw) && args.getInt("map_raw", mapRaw)) {
+    sensors->getTPS().setSimulatedRaw(static_cast<uint16_t>(tpsRaw));
+    sensors->getMAP().setSimulatedRaw(static_cast<uint16_t>(mapRaw));
+  }
+}
+
+void ConsoleUI::cmdOverride(const CommandArgs& args) {
+  if (debug) debug->applyOverrides(args);
+}
 
+void ConsoleUI::imprimirDashboard() {
+  if (!fsm || !sensors || !actuators) return;
+  if (millis() < tiempoProximaImpresionHUD) return;
+
+  // Solo valores en caché: el HUD nunca dispara lecturas de ADC
   auto& calib = CalibrationManager::getInstance();
-  uint16_t tpsMin = calib.getTPSMin();
-  uint16_t tpsMax = calib.getTPSMax();
-  uint16_t mapMin = calib.getMAPMin();
-  uint16_t mapMax = calib.getMAPMax();
+  auto& inj = actuators->getAcousticInjector();
+  SystemState st = fsm->getState();
 
   static const char* stateNames[] = {
     "OFF", "SIN_CAL", "CALIB", "IDLE",
     "BEAM", "BOOST", "DESCAY", "DEBUG", "??"
   };
-  const char* stName = stateNames[int(st)];
-
-  float tpsMinV = tpsMin * 3.3f / 4095.0f;
-  float tpsMaxV = tpsMax * 3.3f / 4095.0f;
-  float mapMinV = mapMin * 3.3f / 4095.0f;
-  float mapMaxV = mapMax * 3.3f / 4095.0f;
-
-  // HUD en vivo: actualización en línea
-  this->printf(
-    "\r[%s|%lus] TPS=%.2fV(%.2f–%.2fV) | MAP=%.2fV(%.2f–%.2fV) | DAC=%3u | LVL=%.2f | FRQ=%.0fHz | Boost:%c | Beam:%c     ",
-    stName, elapsed,
-    tpsV, tpsMinV, tpsMaxV,
-    mapV, mapMinV, mapMaxV,
-    dac,
-    level,
-    freq,
-    vortexOn ? '1' : '0',
-    injOn ? '1' : '0'
-  );
-
-  // Detalle en nueva línea si cambió estado
-  if (st != lastState) {
-    lastState = st;
+
+  DashboardSnapshot snap;
+  snap.state    = stateNames[int(st)];
+  snap.elapsedS = (millis() - lastTransitionMS) / 1000;
+  snap.tpsV     = sensors->getLastTPSRaw() * 3.3f / 4095.0f;
+  snap.mapV     = sensors->getLastMAPRaw() * 3.3f / 4095.0f;
+  snap.tpsMinV  = calib.getTPSMin() * 3.3f / 4095.0f;
+  snap.tpsMaxV  = calib.getTPSMax() * 3.3f / 4095.0f;
+  snap.mapMinV  = calib.getMAPMin() * 3.3f / 4095.0f;
+  snap.mapMaxV  = calib.getMAPMax() * 3.3f / 4095.0f;
+  snap.dac      = inj.getCurrentDAC();
+  snap.level    = inj.getLevel();
+  snap.freq     = inj.getFrequency();
+  snap.boost    = actuators->isTurboOn();
+  snap.beam     = actuators->isAcousticOn();
+
+  // Detalle en bloque solo cuando cambia el estado
+  if (st != hudState) {
+    hudState = st;
     this->println("\n\n=== VORTEX SYSTEM DASHBOARD ===");
-    this->printf("Estado motor:      %s\n", stName);
-    this->printf("TPS Voltage:       %.3f V (raw %u–%u)\n", tpsV, tpsMin, tpsMax);
-    this->printf("MAP Voltage:       %.3f V (raw %u–%u)\n", mapV, mapMin, mapMax);
-    this->printf("DAC Output:        %u (PWM)\n", dac);
-    this->printf("Nivel acústico:    %.2f\n", level);
-    this->printf("Frecuencia onda:   %.0f Hz\n", freq);
-    this->printf("Vortex:             %s\n", vortexOn ? "ON" : "OFF");
-    this->printf("Inyector sónico:   %s\n", injOn ? "ON" : "OFF");
-    this->printf("Último cambio:     hace %lu s\n", elapsed);
+    this->printf("Estado motor:      %s\n", snap.state);
+    this->printf("TPS Voltage:       %.3f V (raw %u–%u)\n", snap.tpsV, calib.getTPSMin(), calib.getTPSMax());
+    this->printf("MAP Voltage:       %.3f V (raw %u–%u)\n", snap.mapV, calib.getMAPMin(), calib.getMAPMax());
+    this->printf("DAC Output:        %u (PWM)\n", snap.dac);
+    this->printf("Nivel acústico:    %.2f\n", snap.level);
+    this->printf("Frecuencia onda:   %.0f Hz\n", snap.freq);
+    this->printf("Vortex:             %s\n", snap.boost ? "ON" : "OFF");
+    this->printf("Inyector sónico:   %s\n", snap.beam ? "ON" : "OFF");
+    this->printf("Último cambio:     hace %lu s\n", (unsigned long)snap.elapsedS);
     this->println("==============================\n");
   }
+
+  // HUD en vivo: solo los campos que cambiaron
+  char line[DashboardModel::LINE_CAPACITY];
+  size_t len = hud.render(snap, millis(), line, sizeof(line));
+  if (len) {
+    renderingHud = true;
+    emit(line, len);
+    renderingHud = false;
+  }
 }
 
 
@@ -294,37 +826,41 @@ void ConsoleUI::toggleSistema() {
   this->printf(">> Sistema %s.\n", sistemaActivo ? "ACTIVADO" : "DESACTIVADO");
 }
 
-int ConsoleUI::parseValor(const String& linea, const String& clave) {
-  int inicio = linea.indexOf(clave + ":");
-  if (inicio == -1) return -1;
-
-  inicio += clave.length() + 1;
-  int fin = linea.indexOf(',', inicio);
-  if (fin == -1) fin = linea.length();
+void ConsoleUI::imprimirHelp() {
+  this->println("\n📘 Comandos disponibles:");
+  imprimirComandos(false);
 
-  String valorStr = linea.substring(inicio, fin);
-  return valorStr.toInt();
+  if (developerMode) {
+    this->println("\n🧪 Modo desarrollador activo:");
+    imprimirComandos(true);
+  }
 }
 
+void ConsoleUI::imprimirComandos(bool devOnly) {
+  for (size_t i = 0; i < registry.size(); ++i) {
+    const Command& cmd = registry[i];
+    if (!cmd.help || cmd.devOnly != devOnly) continue;
+    if (cmd.args[0])
+      this->printf("  %s %s → %s\n", cmd.name, cmd.args, cmd.help);
+    else
+      this->printf("  %s  → %s\n", cmd.name, cmd.help);
+  }
+}
 
-void ConsoleUI::imprimirHelp() {
-  this->println(F("\n📘 Comandos disponibles:"));
-  this->println(F("  a  → Activar/Desactivar sistema completo (seguridad/falla)"));
-  this->println(F("  c  → Ejecutar rutina de calibración de sensores"));
-  this->println(F("  m  → Mostrar menú de comandos"));
-  this->println(F("  s  → Activar/Desactivar dashboard del sistema"));
-  this->println(F("  d  → Activar modo desarrollador"));
-
-  if (developerMode) {
-    this->println(F("\n🧪 Modo desarrollador activo:"));
-    this->println(F("  b  → Probar sonido acústico"));
-    this->println(F("  i  → Activar relé INYECCIÓN_ACÚSTICA"));
-    this->println(F("  t  → Activar relé TURBO"));
-    this->println(F("  u  → (Comando dev pendiente)"));
-    this->println(F("  x  → Paro manual, volver a IDLE"));
-    this->println(F("  v  → Visualizar curva TPS-MAP (pendiente desarrollo)"));
-    this->println(F("  r  → Borrar calibración actual"));
-    this->println(F("  z  → Activar/Desactivar modo simulación"));
+void ConsoleUI::imprimirDeriva() {
+  const DriftCompensator& drift = CalibrationManager::getInstance().getDrift();
+  if (!drift.isActive()) {
+    this->println("Deriva: inactiva (sin calibración)");
+    return;
+  }
+  const char* names[] = { "TPS_MIN", "TPS_MAX", "MAP_MAX" };
+  const EndpointStatus* st[] = { &drift.tpsMinStatus(), &drift.tpsMaxStatus(), &drift.mapMaxStatus() };
+  for (int i = 0; i < 3; ++i) {
+    this->printf("Deriva %s: ref=%u est=%.1f (%+.1f) obs=%lu rech=%lu residuo=%.1f\n",
+                 names[i], st[i]->reference, st[i]->estimate,
+                 st[i]->estimate - st[i]->reference,
+                 (unsigned long)st[i]->observations, (unsigned long)st[i]->rejected,
+                 st[i]->residual);
   }
 }
 
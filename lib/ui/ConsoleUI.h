@@ -3,6 +3,12 @@
 #include "StateMachine.h"
 #include "SensorManager.h"
 #include "ActuatorManager.h" 
+#include "DebugManager.h"
+#include "CommandParser.h"
+#include "CommandRegistry.h"
+#include "ByteRing.h"
+#include "DashboardModel.h"
+#include "Metrics.h"
 
 class ConsoleUI {
 public:
@@ -12,45 +18,132 @@ public:
   virtual void setFSM(StateMachine* fsmRef);
   virtual void attachSensors(SensorManager* sensorManagerPtr);
   virtual void attachActuators(ActuatorManager* actuatorManagerPtr);
+  void attachDebug(DebugManager* debugManagerPtr);
+  void attachThresholds(ThresholdManager* thresholdManagerPtr) { thresholds = thresholdManagerPtr; }
 
   virtual bool getCalibRequest();
   virtual void toggleSistema();
   virtual bool isSistemaActivo() const { 
     return sistemaActivo; }
   virtual void imprimirDashboard();
-  virtual int parseValor(const String& linea, const String& clave);
   void setMirror(ConsoleUI* mirrorUI) { this->mirror = mirrorUI; }
-  virtual void print(const String& msg) = 0;
-  virtual void println(const String& msg) = 0;
-  virtual void printf(const char* fmt, ...) = 0;
+
+  // Salida no bloqueante: todo se encola en el buffer propio y lo drena drainOutput()
+  void print(const char* msg);
+  void print(const String& msg);
+  void println(const char* msg);
+  void println(const String& msg);
+  void printf(const char* fmt, ...);
+
+  /**
+   * Entrega al dispositivo lo que acepte sin bloquear.
+   * Llamar desde la tarea de drenado (único consumidor del buffer).
+   */
+  void drainOutput();
+  void setOutputPolicy(ByteRing::Policy policy) { output.setPolicy(policy); }
+  ByteRing::Stats getOutputStats() const { return output.getStats(); }
   virtual bool isSimulation() const { return  simulationOnPython; };
 
 
   virtual bool isDeveloperMode() const;
 protected:
+  using Registry = CommandRegistry<ConsoleUI>;
+  using Command  = Registry::Command;
+
+  static constexpr size_t INPUT_BUDGET = 256;      // Bytes de entrada procesados por update()
+  static constexpr uint32_t OUTPUT_CAPACITY = 2048; // Buffer de salida por consola (potencia de dos)
+  static constexpr uint32_t OUTPUT_HEADROOM = OUTPUT_CAPACITY / 4; // Libre que deja DROP_OLDEST sin cliente
+  static constexpr unsigned long HUD_TICK_MS = 100;  // Revisión del HUD; cada campo tiene su propio límite
+
   bool sistemaActivo = true;
   StateMachine*      fsm = nullptr;
   SensorManager*     sensors = nullptr;
   ActuatorManager*   actuators = nullptr;  
+  DebugManager*      debug = nullptr;
+  ThresholdManager*  thresholds = nullptr;
 
   bool dashboardEnabled = true;
   bool consoleCalibRequested = false;
   bool developerMode = false;
   bool simulationOnPython = false;
+  bool recordingSensors = false;  // "rec": volcado de lecturas crudas en lugar del HUD
+  bool streamingSpectrum = false; // "fft": una línea por espectro promediado en lugar del HUD
+  uint8_t  spectrumBands = 64;
+  uint32_t spectrumSeq = 0;       // Último espectro emitido
+  AcousticEqBuilder eqBuilder;    // Medidas de "eq med" hasta "eq calcular"
 
   unsigned long lastTransitionMS = 0;
   unsigned long tiempoProximaImpresionHUD = 0;
 
   SystemState lastState = SystemState::OFF;
+  SystemState hudState = SystemState::OFF;  // Último estado mostrado en el bloque de detalle
+
+  DashboardModel hud;
+
+  // Compartidos por ambas consolas: update() corre en ConsoleUpdate y drainOutput() en ConsoleDrain
+  Counter* rxBytes   = &MetricsRegistry::getInstance().counter("console.rx_bytes");
+  Counter* lineCount = &MetricsRegistry::getInstance().counter("console.lines");
+  Counter* txBytes   = &MetricsRegistry::getInstance().counter("console.tx_bytes");
+  bool renderingHud = false;
+  unsigned long lastHudTick = 0;
 
   
 
+  LineAssembler lineBuffer;  // Única línea en construcción (sin String)
+
   // Métodos virtuales puros que deben implementarse en SerialUI o BLEUI
-  virtual bool inputAvailable() = 0;
-  virtual String readLine() = 0;
+  /// Siguiente byte recibido, o -1 si no hay datos
+  virtual int readChar() = 0;
+  /// Bytes que el dispositivo acepta ahora mismo sin bloquear
+  virtual size_t writeCapacity() = 0;
+  virtual void writeOut(const uint8_t* data, size_t len) = 0;
+
+  /// Encola en el buffer propio y, si esta consola es la activa, también en el espejo
+  void emit(const char* data, size_t len);
 
-  virtual void interpretarComando(char c);
+  void procesarLinea(char* linea);
   virtual void imprimirHelp();
+  void imprimirComandos(bool devOnly);
+  void imprimirDeriva();
+
+  // Manejadores de la tabla de comandos
+  void cmdSistema(const CommandArgs& args);
+  void cmdPruebaAcustica(const CommandArgs& args);
+  void cmdCalibrar(const CommandArgs& args);
+  void cmdDesarrollador(const CommandArgs& args);
+  void cmdReleInyector(const CommandArgs& args);
+  void cmdAyuda(const CommandArgs& args);
+  void cmdDetenerAcustico(const CommandArgs& args);
+  void cmdBorrarCalibracion(const CommandArgs& args);
+  void cmdDashboard(const CommandArgs& args);
+  void cmdReleTurbo(const CommandArgs& args);
+  void cmdPendiente(const CommandArgs& args);
+  void cmdCurva(const CommandArgs& args);
+  void cmdParoManual(const CommandArgs& args);
+  void cmdSimulacion(const CommandArgs& args);
+  void cmdSensores(const CommandArgs& args);
+  void cmdSalida(const CommandArgs& args);
+  void cmdPerf(const CommandArgs& args);
+  void cmdTelemetria(const CommandArgs& args);
+  void cmdGrabarSensores(const CommandArgs& args);
+  void cmdUmbrales(const CommandArgs& args);
+  void cmdPerfil(const CommandArgs& args);
+  void cmdOnda(const CommandArgs& args);
+  void cmdModulacion(const CommandArgs& args);
+  void cmdEcualizacion(const CommandArgs& args);
+  void cmdRetorno(const CommandArgs& args);
+  void cmdEspectro(const CommandArgs& args);
+  void grabarMuestra();
+  void emitirEspectro();
+  void cmdSimFeed(const CommandArgs& args);
+  void cmdOverride(const CommandArgs& args);
+
+  static const Command COMMANDS[];
+  static const Registry registry;
   ConsoleUI* mirror = nullptr;  // UI secundaria para eco
+  ConsoleUI** activeUi = nullptr;  // puntero al puntero global ui
+
+  uint8_t  outputStorage[OUTPUT_CAPACITY];
+  ByteRing output{outputStorage, OUTPUT_CAPACITY};
 
 };
@@ -0,0 +1,95 @@
+#include "DashboardModel.h"
+#include <stdio.h>
+#include <string.h>
+
+// Orden y anchos del HUD; los intervalos evitan repintar ruido de ADC a cada ciclo
+const DashboardModel::FieldSpec DashboardModel::SPECS[FIELD_COUNT] = {
+  // prefijo          ancho  intervalo
+  { "[",                7,     0    },  // STATE
+  { "|",                5,     1000 },  // ELAPSED
+  { "s] TPS=",          4,     200  },  // TPS
+  { "V(",               9,     1000 },  // TPS_RANGE
+  { "V) | MAP=",        4,     200  },  // MAP
+  { "V(",               9,     1000 },  // MAP_RANGE
+  { "V) | DAC=",        3,     100  },  // DAC
+  { " | LVL=",          4,     200  },  // LEVEL
+  { " | FRQ=",          5,     200  },  // FREQ
+  { "Hz | Boost:",      1,     0    },  // BOOST
+  { " | Beam:",         1,     0    },  // BEAM
+};
+
+DashboardModel::DashboardModel() {
+  uint16_t col = 0;
+  for (uint8_t f = 0; f < FIELD_COUNT; ++f) {
+    col += strlen(SPECS[f].prefix);
+    column[f] = static_cast<uint8_t>(col);
+    col += SPECS[f].width;
+    cache[f][0] = '\0';
+    lastRenderMs[f] = 0;
+  }
+}
+
+void DashboardModel::format(Field f, const DashboardSnapshot& snap, char* dst) {
+  char tmp[24];
+  switch (f) {
+    case STATE:     snprintf(tmp, sizeof(tmp), "%s", snap.state ? snap.state : "??"); break;
+    case ELAPSED:   snprintf(tmp, sizeof(tmp), "%lu", (unsigned long)snap.elapsedS); break;
+    case TPS:       snprintf(tmp, sizeof(tmp), "%.2f", snap.tpsV); break;
+    case TPS_RANGE: snprintf(tmp, sizeof(tmp), "%.2f-%.2f", snap.tpsMinV, snap.tpsMaxV); break;
+    case MAP:       snprintf(tmp, sizeof(tmp), "%.2f", snap.mapV); break;
+    case MAP_RANGE: snprintf(tmp, sizeof(tmp), "%.2f-%.2f", snap.mapMinV, snap.mapMaxV); break;
+    case DAC:       snprintf(tmp, sizeof(tmp), "%3u", snap.dac); break;
+    case LEVEL:     snprintf(tmp, sizeof(tmp), "%.2f", snap.level); break;
+    case FREQ:      snprintf(tmp, sizeof(tmp), "%.0f", snap.freq); break;
+    case BOOST:     snprintf(tmp, sizeof(tmp), "%c", snap.boost ? '1' : '0'); break;
+    case BEAM:      snprintf(tmp, sizeof(tmp), "%c", snap.beam ? '1' : '0'); break;
+    default:        tmp[0] = '\0'; break;
+  }
+
+  // Ancho fijo: se rellena con espacios o se recorta para no desplazar columnas
+  size_t width = SPECS[f].width;
+  size_t n = strlen(tmp);
+  if (n > width) n = width;
+  memcpy(dst, tmp, n);
+  memset(dst + n, ' ', width - n);
+  dst[width] = '\0';
+}
+
+size_t DashboardModel::render(const DashboardSnapshot& snap, uint32_t nowMs, char* out, size_t cap) {
+  char value[MAX_WIDTH + 1];
+  size_t len = 0;
+
+  if (fullPending) {
+    // Línea nueva completa: borrar lo que hubiera y escribir prefijos + valores
+    int n = snprintf(out, cap, "\r\x1b[2K");
+    if (n < 0 || static_cast<size_t>(n) >= cap) return 0;
+    len = n;
+    for (uint8_t f = 0; f < FIELD_COUNT; ++f) {
+      format(static_cast<Field>(f), snap, value);
+      n = snprintf(out + len, cap - len, "%s%s", SPECS[f].prefix, value);
+      if (n < 0 || static_cast<size_t>(n) >= cap - len) return 0;  // Buffer insuficiente: se reintenta
+      len += n;
+      memcpy(cache[f], value, sizeof(value));
+      lastRenderMs[f] = nowMs;
+    }
+    fullPending = false;
+    fullRenders++;
+    return len;
+  }
+
+  for (uint8_t f = 0; f < FIELD_COUNT; ++f) {
+    if (nowMs - lastRenderMs[f] < SPECS[f].minIntervalMs) continue;
+
+    format(static_cast<Field>(f), snap, value);
+    if (strcmp(value, cache[f]) == 0) continue;
+
+    // CSI n G: columna absoluta (base 1) dentro de la línea del HUD
+    int n = snprintf(out + len, cap - len, "\x1b[%uG%s", column[f] + 1u, value);
+    if (n < 0 || static_cast<size_t>(n) >= cap - len) break;  // El resto queda para la próxima vez
+    len += n;
+    memcpy(cache[f], value, sizeof(value));
+    lastRenderMs[f] = nowMs;
+    fieldRenders++;
+  }
+  return len;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @struct DashboardSnapshot
+ * Valores a mostrar en el HUD, ya leídos de los caches del sistema
+ * (nunca del ADC ni de otro hardware).
+ */
+struct DashboardSnapshot {
+  const char* state;
+  uint32_t elapsedS;
+  float tpsV, tpsMinV, tpsMaxV;
+  float mapV, mapMinV, mapMaxV;
+  uint8_t dac;
+  float level;
+  float freq;
+  bool boost;
+  bool beam;
+};
+
+/**
+ * @class DashboardModel
+ * HUD de una línea con campos en columnas fijas.
+ *
+ * Guarda el último texto enviado de cada campo y solo reescribe los que
+ * cambiaron, posicionando el cursor con secuencias ANSI (CSI n G, columna
+ * absoluta). El repintado completo empieza con CR + CSI 2K.
+ * Cada campo tiene su propio intervalo mínimo entre repintados.
+ * No depende de Arduino: render() solo escribe en el buffer recibido.
+ */
+class DashboardModel {
+public:
+  enum Field : uint8_t {
+    STATE, ELAPSED, TPS, TPS_RANGE, MAP, MAP_RANGE,
+    DAC, LEVEL, FREQ, BOOST, BEAM,
+    FIELD_COUNT
+  };
+
+  static constexpr size_t MAX_WIDTH = 12;     ///< Ancho máximo de un campo
+  static constexpr size_t LINE_CAPACITY = 192; ///< Buffer suficiente para un repintado completo
+
+  DashboardModel();
+
+  /**
+   * Genera la salida necesaria para dejar el HUD al día.
+   * @param snap  Valores actuales.
+   * @param nowMs Tiempo actual (ms) para el límite por campo.
+   * @param out   Destino; se recomienda LINE_CAPACITY.
+   * @param cap   Tamaño de out.
+   * @return Bytes escritos (0 si no hay nada que cambiar).
+   */
+  size_t render(const DashboardSnapshot& snap, uint32_t nowMs, char* out, size_t cap);
+
+  /// Fuerza un repintado completo (otra salida movió el cursor)
+  void invalidate() { fullPending = true; }
+
+  uint32_t getFullRenders() const { return fullRenders; }
+  uint32_t getFieldRenders() const { return fieldRenders; }
+
+private:
+  struct FieldSpec {
+    const char* prefix;       ///< Texto fijo antes del valor
+    uint8_t     width;        ///< Columnas reservadas al valor
+    uint16_t    minIntervalMs;
+  };
+  static const FieldSpec SPECS[FIELD_COUNT];
+
+  char     cache[FIELD_COUNT][MAX_WIDTH + 1];
+  uint32_t lastRenderMs[FIELD_COUNT];
+  uint8_t  column[FIELD_COUNT];
+  bool     fullPending = true;
+  uint32_t fullRenders = 0;
+  uint32_t fieldRenders = 0;
+
+  static void format(Field f, const DashboardSnapshot& snap, char* dst);
+};
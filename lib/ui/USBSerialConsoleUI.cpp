@@ -1,10 +1,9 @@
 #include "USBSerialConsoleUI.h"
-#include <stdarg.h>
 
 void USBSerialConsoleUI::begin() {
   Serial.begin(115200);
   while (!Serial);
-  Serial.println("\n=== Consola Vortex-Acústico Iniciada ===");
+  this->println("\n=== Consola Vortex-Acústico Iniciada ===");
   imprimirHelp();
 }
 
@@ -12,33 +11,16 @@ void USBSerialConsoleUI::update() {
   ConsoleUI::update();
 }
 
-bool USBSerialConsoleUI::inputAvailable() {
-  return Serial.available() > 0;
+int USBSerialConsoleUI::readChar() {
+  return Serial.read();
 }
 
-String USBSerialConsoleUI::readLine() {
-  return Serial.readStringUntil('\n');
+size_t USBSerialConsoleUI::writeCapacity() {
+  // Solo lo que cabe en el FIFO/buffer del UART sin esperar
+  int room = Serial.availableForWrite();
+  return room > 0 ? static_cast<size_t>(room) : 0;
 }
 
-void USBSerialConsoleUI::print(const String& msg) {
-  Serial.print(msg);
-  if (mirror && this == *ui) 
-    mirror->print(msg);
-}
-
-void USBSerialConsoleUI::println(const String& msg) {
-  Serial.println(msg);
-    if (mirror && this == *ui) 
-      mirror->println(msg);
-}
-
-void USBSerialConsoleUI::printf(const char* fmt, ...) {
-  char buf[256];
-  va_list args;
-  va_start(args, fmt);
-  vsnprintf(buf, sizeof(buf), fmt, args);
-  va_end(args);
-  Serial.print(buf);
-  if (mirror && this == *ui) 
-    mirror->print(buf);
+void USBSerialConsoleUI::writeOut(const uint8_t* data, size_t len) {
+  Serial.write(data, len);
 }
@@ -3,16 +3,14 @@
 
 class USBSerialConsoleUI : public ConsoleUI {
 public:
-  USBSerialConsoleUI(ConsoleUI** uiPtr): ui(uiPtr) {}//Puntero
+  USBSerialConsoleUI(ConsoleUI** uiPtr) { activeUi = uiPtr; }//Puntero
 
 
   void begin() override;
   void update() override;
-  bool inputAvailable() override;
-  String readLine() override;
-  void print(const String& msg) override;
-  void println(const String& msg) override;
-  void printf(const char* fmt, ...) override;
-  ConsoleUI** ui;  // puntero al puntero global ui
+  int readChar() override;
 
+protected:
+  size_t writeCapacity() override;
+  void writeOut(const uint8_t* data, size_t len) override;
 };
@@ -0,0 +1,137 @@
+#include "BleProtocol.h"
+#include <string.h>
+
+static inline void putU16(uint8_t* p, uint16_t v) {
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+static inline void putU32(uint8_t* p, uint32_t v) {
+  putU16(p, static_cast<uint16_t>(v));
+  putU16(p + 2, static_cast<uint16_t>(v >> 16));
+}
+
+static inline uint16_t getU16(const uint8_t* p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t getU32(const uint8_t* p) {
+  return getU16(p) | (static_cast<uint32_t>(getU16(p + 2)) << 16);
+}
+
+int16_t telemetryCenti(float percent) {
+  float v = percent * 100.0f;
+  if (v > 32767.0f) return 32767;
+  if (v < -32768.0f) return -32768;
+  return static_cast<int16_t>(v < 0.0f ? v - 0.5f : v + 0.5f);
+}
+
+void TelemetryBatcher::setPayloadLimit(size_t payload) {
+  if (payload < BLE_MIN_PAYLOAD) payload = BLE_MIN_PAYLOAD;
+  if (payload > BLE_MAX_PAYLOAD) payload = BLE_MAX_PAYLOAD;
+  limit = payload;
+}
+
+bool TelemetryBatcher::fits(const TelemetrySample& s) const {
+  if (count() == 0) return true;
+  if (size() + BLE_TELEMETRY_SAMPLE > limit) return false;
+  return s.tMs - baseMs <= 0xFFFF;
+}
+
+void TelemetryBatcher::add(const TelemetrySample& s) {
+  if (count() == 0) {
+    baseMs = s.tMs;
+    putU32(frame + 4, baseMs);
+  }
+  uint8_t* p = frame + size();
+  putU16(p, static_cast<uint16_t>(s.tMs - baseMs));
+  p[2] = s.state;
+  p[3] = s.flags;
+  putU16(p + 4, static_cast<uint16_t>(s.tpsCenti));
+  putU16(p + 6, static_cast<uint16_t>(s.mapCenti));
+  putU16(p + 8, s.freqHz);
+  p[10] = s.level;
+  p[11] = s.profile;
+  frame[2]++;
+}
+
+void TelemetryBatcher::reset() {
+  frame[1]++;
+  frame[2] = 0;
+}
+
+size_t decodeTelemetry(const uint8_t* frame, size_t len, TelemetryFrameInfo& info,
+                       TelemetrySample* out, size_t max) {
+  if (len < BLE_TELEMETRY_HEADER || frame[0] != BLE_FRAME_TELEMETRY || frame[3] != BLE_PROTOCOL_VERSION) {
+    return 0;
+  }
+  info.seq = frame[1];
+  info.count = frame[2];
+  info.baseMs = getU32(frame + 4);
+  if (len != BLE_TELEMETRY_HEADER + info.count * BLE_TELEMETRY_SAMPLE) return 0;
+
+  size_t n = info.count < max ? info.count : max;
+  const uint8_t* p = frame + BLE_TELEMETRY_HEADER;
+  for (size_t i = 0; i < n; ++i, p += BLE_TELEMETRY_SAMPLE) {
+    TelemetrySample& s = out[i];
+    s.tMs = info.baseMs + getU16(p);
+    s.state = p[2];
+    s.flags = p[3];
+    s.tpsCenti = static_cast<int16_t>(getU16(p + 4));
+    s.mapCenti = static_cast<int16_t>(getU16(p + 6));
+    s.freqHz = getU16(p + 8);
+    s.level = p[10];
+    s.profile = p[11];
+  }
+  return n;
+}
+
+bool decodeControl(const uint8_t* data, size_t len, ControlCommand& out) {
+  if (len == 0) return false;
+  out = ControlCommand();
+  out.op = static_cast<BleOp>(data[0]);
+
+  switch (out.op) {
+    case BleOp::SET_VALUE: {
+      if (len != 6) return false;
+      out.index = data[1];
+      uint32_t bits = getU32(data + 2);
+      memcpy(&out.value, &bits, sizeof(out.value));
+      return out.value == out.value;  // NaN no es un umbral
+    }
+    case BleOp::SELECT_PROFILE:
+      if (len != 2) return false;
+      out.index = data[1];
+      return true;
+    case BleOp::SAVE:
+    case BleOp::CALIBRATE:
+      return len == 1;
+    case BleOp::TELEMETRY_RATE:
+      if (len != 3) return false;
+      out.intervalMs = getU16(data + 1);
+      return true;
+    default:
+      return false;
+  }
+}
+
+size_t encodeControl(const ControlCommand& cmd, uint8_t* out) {
+  out[0] = static_cast<uint8_t>(cmd.op);
+  switch (cmd.op) {
+    case BleOp::SET_VALUE: {
+      out[1] = cmd.index;
+      uint32_t bits;
+      memcpy(&bits, &cmd.value, sizeof(bits));
+      putU32(out + 2, bits);
+      return 6;
+    }
+    case BleOp::SELECT_PROFILE:
+      out[1] = cmd.index;
+      return 2;
+    case BleOp::TELEMETRY_RATE:
+      putU16(out + 1, cmd.intervalMs);
+      return 3;
+    default:
+      return 1;
+  }
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Protocolo binario del servicio BLE (BleConsoleUI). Todo es little-endian
+ * y se escribe byte a byte, así el mismo código corre en el ESP32 y en el host.
+ *
+ * Telemetría (notify), varias muestras por notificación:
+ *
+ *   [0] 0x01  [1] seq  [2] n  [3] versión  [4..7] t0_ms
+ *   n × 12 bytes:
+ *     u16 dt_ms   desde t0_ms
+ *     u8  estado  SystemState
+ *     u8  flags   TELEMETRY_FLAG_*
+ *     i16 tps     % × 100
+ *     i16 map     % × 100
+ *     u16 freq    Hz de la onda acústica
+ *     u8  nivel   0–255
+ *     u8  perfil  índice del perfil activo
+ *
+ * seq sube en cada notificación: un salto indica notificaciones perdidas.
+ *
+ * Control (write), un comando por escritura:
+ *
+ *   0x01 SET_VALUE       u8 clave, f32 valor  (clave = índice en ThresholdManager::listKeys())
+ *   0x02 SELECT_PROFILE  u8 índice
+ *   0x03 SAVE            valida, aplica y guarda los SET_VALUE acumulados
+ *   0x04 CALIBRATE
+ *   0x05 TELEMETRY_RATE  u16 intervalo_ms (0 = sin telemetría)
+ */
+
+constexpr uint8_t BLE_PROTOCOL_VERSION = 1;
+constexpr uint8_t BLE_FRAME_TELEMETRY  = 0x01;
+
+constexpr size_t BLE_TELEMETRY_HEADER = 8;
+constexpr size_t BLE_TELEMETRY_SAMPLE = 12;
+constexpr size_t BLE_MIN_PAYLOAD      = 20;   ///< ATT_MTU por defecto (23) menos 3
+constexpr size_t BLE_MAX_PAYLOAD      = 244;  ///< ATT_MTU 247 menos 3
+
+constexpr uint8_t TELEMETRY_FLAG_ACOUSTIC = 0x01;
+constexpr uint8_t TELEMETRY_FLAG_VORTEX   = 0x02;
+constexpr uint8_t TELEMETRY_FLAG_CALIB    = 0x04;
+
+/**
+ * @struct TelemetrySample
+ * Una vuelta del lazo de control, ya en las unidades del cable.
+ */
+struct TelemetrySample {
+  uint32_t tMs = 0;
+  uint8_t  state = 0;
+  uint8_t  flags = 0;
+  int16_t  tpsCenti = 0;   ///< % × 100
+  int16_t  mapCenti = 0;   ///< % × 100
+  uint16_t freqHz = 0;
+  uint8_t  level = 0;
+  uint8_t  profile = 0;
+};
+
+/// Convierte un % a la escala del cable, saturando
+int16_t telemetryCenti(float percent);
+
+/**
+ * @class TelemetryBatcher
+ * Arma una notificación de telemetría en memoria fija. El tamaño máximo lo
+ * fija el MTU negociado con el cliente.
+ */
+class TelemetryBatcher {
+public:
+  /// @param payload Bytes útiles por notificación (ATT_MTU - 3), entre BLE_MIN_PAYLOAD y BLE_MAX_PAYLOAD.
+  void setPayloadLimit(size_t payload);
+  size_t getPayloadLimit() const { return limit; }
+
+  /// false si la muestra no cabe en la trama en curso (llena o dt fuera de rango)
+  bool fits(const TelemetrySample& s) const;
+  /// Añade una muestra; la trama debe tener sitio (fits())
+  void add(const TelemetrySample& s);
+
+  uint8_t count() const { return frame[2]; }
+  uint32_t firstMs() const { return baseMs; }
+  const uint8_t* data() const { return frame; }
+  size_t size() const { return BLE_TELEMETRY_HEADER + count() * BLE_TELEMETRY_SAMPLE; }
+
+  /// Tras enviar la trama: la vacía y avanza seq
+  void reset();
+
+private:
+  uint8_t frame[BLE_MAX_PAYLOAD] = {BLE_FRAME_TELEMETRY, 0, 0, BLE_PROTOCOL_VERSION};
+  size_t limit = BLE_MIN_PAYLOAD;
+  uint32_t baseMs = 0;
+};
+
+/**
+ * @struct TelemetryFrameInfo
+ * Cabecera de una trama recibida.
+ */
+struct TelemetryFrameInfo {
+  uint8_t  seq = 0;
+  uint8_t  count = 0;
+  uint32_t baseMs = 0;
+};
+
+/**
+ * Decodifica una notificación de telemetría (lado cliente).
+ * @param out Hasta max muestras.
+ * @return Muestras decodificadas; 0 si la trama no es válida.
+ */
+size_t decodeTelemetry(const uint8_t* frame, size_t len, TelemetryFrameInfo& info,
+                       TelemetrySample* out, size_t max);
+
+enum class BleOp : uint8_t {
+  SET_VALUE      = 0x01,
+  SELECT_PROFILE = 0x02,
+  SAVE           = 0x03,
+  CALIBRATE      = 0x04,
+  TELEMETRY_RATE = 0x05,
+};
+
+/**
+ * @struct ControlCommand
+ * Comando de la característica de control ya decodificado.
+ */
+struct ControlCommand {
+  BleOp    op = BleOp::SAVE;
+  uint8_t  index = 0;      ///< Clave (SET_VALUE) o perfil (SELECT_PROFILE)
+  float    value = 0.0f;   ///< SET_VALUE
+  uint16_t intervalMs = 0; ///< TELEMETRY_RATE
+};
+
+constexpr size_t BLE_MAX_CONTROL = 6;
+
+/// @return false si la escritura no es un comando válido
+bool decodeControl(const uint8_t* data, size_t len, ControlCommand& out);
+/// Lado cliente. @return Bytes escritos en out (BLE_MAX_CONTROL como máximo)
+size_t encodeControl(const ControlCommand& cmd, uint8_t* out);
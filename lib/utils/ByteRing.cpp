@@ -0,0 +1,118 @@
+#include "ByteRing.h"
+#include <string.h>
+
+ByteRing::ByteRing(uint8_t* storage, uint32_t capacity, Policy p)
+  : buf(storage), cap(capacity), mask(capacity - 1), policy(p) {}
+
+void ByteRing::copyIn(uint32_t pos, const uint8_t* data, uint32_t len) {
+  uint32_t start = pos & mask;
+  uint32_t first = len < cap - start ? len : cap - start;
+  memcpy(buf + start, data, first);
+  memcpy(buf, data + first, len - first);
+}
+
+void ByteRing::copyOut(uint32_t pos, uint8_t* dst, uint32_t len) const {
+  uint32_t start = pos & mask;
+  uint32_t first = len < cap - start ? len : cap - start;
+  memcpy(dst, buf + start, first);
+  memcpy(dst + first, buf, len - first);
+}
+
+void ByteRing::noteLoss(uint32_t bytes) {
+  dropped.fetch_add(bytes, std::memory_order_relaxed);
+  overflows.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool ByteRing::write(const uint8_t* data, uint32_t len) {
+  if (len == 0) return true;
+  uint32_t header = policy == Policy::DROP_OLDEST ? HEADER : 0;
+  uint32_t h = head.load(std::memory_order_relaxed);
+  uint32_t used = h - tail.load(std::memory_order_acquire);
+
+  // Los bytes pendientes siguen siendo del consumidor: si no cabe, se pierde
+  // el nuevo y, con DROP_OLDEST, es el consumidor quien libra lo antiguo
+  if (len > cap - header || len + header > cap - used) {
+    noteLoss(len);
+    return false;
+  }
+
+  if (header) {
+    uint16_t n = static_cast<uint16_t>(len);
+    copyIn(h, reinterpret_cast<const uint8_t*>(&n), header);
+  }
+  copyIn(h + header, data, len);
+  head.store(h + header + len, std::memory_order_release);
+
+  written.fetch_add(len, std::memory_order_relaxed);
+  if (used + header + len > highWater.load(std::memory_order_relaxed)) {
+    highWater.store(used + header + len, std::memory_order_relaxed);
+  }
+  return true;
+}
+
+uint32_t ByteRing::read(uint8_t* dst, uint32_t max) {
+  uint32_t t = tail.load(std::memory_order_relaxed);
+  uint32_t h = head.load(std::memory_order_acquire);
+
+  if (policy == Policy::DROP_NEWEST) {
+    uint32_t n = h - t;
+    if (n > max) n = max;
+    copyOut(t, dst, n);
+    tail.store(t + n, std::memory_order_release);
+    return n;
+  }
+
+  // Cada longitud se publica junto con su mensaje: si hay una, está entero
+  uint32_t out = 0;
+  while (out < max && t != h) {
+    if (msgLeft == 0) {
+      uint16_t n;
+      copyOut(t, reinterpret_cast<uint8_t*>(&n), HEADER);
+      t += HEADER;
+      msgLeft = n;
+    }
+    uint32_t n = msgLeft < max - out ? msgLeft : max - out;
+    copyOut(t, dst + out, n);
+    t += n;
+    out += n;
+    msgLeft -= n;
+  }
+  tail.store(t, std::memory_order_release);
+  return out;
+}
+
+uint32_t ByteRing::discardOldest(uint32_t room) {
+  if (policy != Policy::DROP_OLDEST) return 0;
+  uint32_t t = tail.load(std::memory_order_relaxed);
+  uint32_t h = head.load(std::memory_order_acquire);
+
+  uint32_t lost = 0;
+  while (cap - (h - t) < room && t != h) {
+    if (msgLeft == 0) {
+      uint16_t n;
+      copyOut(t, reinterpret_cast<uint8_t*>(&n), HEADER);
+      t += HEADER;
+      msgLeft = n;
+    }
+    t += msgLeft;
+    lost += msgLeft;
+    msgLeft = 0;
+  }
+  if (lost == 0) return 0;
+  noteLoss(lost);
+  tail.store(t, std::memory_order_release);
+  return lost;
+}
+
+uint32_t ByteRing::size() const {
+  return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+}
+
+ByteRing::Stats ByteRing::getStats() const {
+  Stats s;
+  s.written   = written.load(std::memory_order_relaxed);
+  s.dropped   = dropped.load(std::memory_order_relaxed);
+  s.overflows = overflows.load(std::memory_order_relaxed);
+  s.highWater = highWater.load(std::memory_order_relaxed);
+  return s;
+}
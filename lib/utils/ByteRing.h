@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @class ByteRing
+ * Buffer circular de bytes sin bloqueos para un productor y un consumidor
+ * (la tarea que imprime y la tarea que drena hacia el UART/SPP).
+ *
+ * Nunca bloquea al productor y nunca escribe sobre bytes que el consumidor
+ * no ha drenado, así que las dos copias no se solapan. Cuando no hay espacio
+ * el mensaje nuevo se descarta completo (no se cortan mensajes). Qué se
+ * pierde mientras el sumidero no acepta nada depende de la política:
+ *  - DROP_NEWEST: lo pendiente se conserva y sale en orden.
+ *  - DROP_OLDEST: cada mensaje lleva delante su longitud (2 bytes) y el
+ *    consumidor, con el sumidero cerrado, tira mensajes antiguos enteros con
+ *    discardOldest() para dejar sitio; al reabrirse sale lo más reciente.
+ */
+class ByteRing {
+public:
+  enum class Policy { DROP_NEWEST, DROP_OLDEST };
+
+  struct Stats {
+    uint32_t written;       ///< Bytes aceptados
+    uint32_t dropped;       ///< Bytes perdidos por desbordamiento
+    uint32_t overflows;     ///< Eventos de desbordamiento
+    uint32_t highWater;     ///< Máxima ocupación observada
+  };
+
+  /**
+   * @param storage  Memoria del buffer (propiedad del llamador).
+   * @param capacity Tamaño en bytes; debe ser potencia de dos.
+   */
+  ByteRing(uint8_t* storage, uint32_t capacity, Policy policy = Policy::DROP_NEWEST);
+
+  /**
+   * Productor: copia len bytes sin bloquear.
+   * @return false si el mensaje se descartó por falta de espacio.
+   */
+  bool write(const uint8_t* data, uint32_t len);
+
+  /**
+   * Consumidor: copia hasta max bytes a dst, sin las longitudes de DROP_OLDEST.
+   * @return Bytes copiados (0 si está vacío).
+   */
+  uint32_t read(uint8_t* dst, uint32_t max);
+
+  /**
+   * Consumidor, con el sumidero cerrado: con DROP_OLDEST tira mensajes
+   * antiguos enteros hasta dejar al menos room bytes libres. Si uno quedó a
+   * medio entregar se tira también su resto. Con DROP_NEWEST no hace nada.
+   * @return Bytes de mensaje descartados.
+   */
+  uint32_t discardOldest(uint32_t room);
+
+  /// Bytes ocupados (incluye las longitudes de DROP_OLDEST)
+  uint32_t size() const;
+  uint32_t capacity() const { return cap; }
+
+  /// Solo con el buffer vacío: DROP_OLDEST cambia el formato interno
+  void setPolicy(Policy p) { policy = p; }
+  Policy getPolicy() const { return policy; }
+  Stats getStats() const;
+
+private:
+  static constexpr uint32_t HEADER = sizeof(uint16_t);  ///< Longitud delante de cada mensaje con DROP_OLDEST
+
+  uint8_t* buf;
+  uint32_t cap;
+  uint32_t mask;
+  Policy policy;
+
+  std::atomic<uint32_t> head{0};  ///< Fin de los datos publicados (productor)
+  std::atomic<uint32_t> tail{0};  ///< Inicio de los datos pendientes (consumidor)
+  uint32_t msgLeft = 0;           ///< DROP_OLDEST: resto del mensaje en curso (consumidor)
+
+  std::atomic<uint32_t> written{0};
+  std::atomic<uint32_t> dropped{0};
+  std::atomic<uint32_t> overflows{0};
+  std::atomic<uint32_t> highWater{0};
+
+  void copyIn(uint32_t pos, const uint8_t* data, uint32_t len);
+  void copyOut(uint32_t pos, uint8_t* dst, uint32_t len) const;
+  void noteLoss(uint32_t bytes);
+};
@@ -0,0 +1,115 @@
+#include "CommandParser.h"
+#include <stdlib.h>
+#include <string.h>
+
+bool LineAssembler::push(char c) {
+  if (c == '\r') return false;
+
+  if (c == '\n') {
+    if (discarding) {
+      // Fin de la línea demasiado larga: se ignora completa
+      discarding = false;
+      reset();
+      return false;
+    }
+    buf[len] = '\0';
+    return true;
+  }
+
+  if (discarding) return false;
+
+  if (len >= CAPACITY - 1) {
+    discarding = true;
+    ++overflows;
+    return false;
+  }
+  buf[len++] = c;
+  return false;
+}
+
+static inline bool isSeparator(char c) {
+  return c == ',' || c == ' ' || c == '\t';
+}
+
+uint8_t tokenizeCommand(char* line, CommandArgs& out) {
+  out.count = 0;
+
+  // Recortar espacios al inicio y al final
+  while (*line == ' ' || *line == '\t') ++line;
+  size_t n = strlen(line);
+  while (n > 0 && (line[n - 1] == ' ' || line[n - 1] == '\t')) line[--n] = '\0';
+  if (n == 0) return 0;
+
+  char* p = line;
+  while (*p && out.count < CommandArgs::MAX_FIELDS) {
+    while (isSeparator(*p)) ++p;
+    if (!*p) break;
+
+    CommandArgs::Field& f = out.fields[out.count++];
+    f.key = p;
+    f.value = nullptr;
+    while (*p && !isSeparator(*p)) {
+      if (*p == ':' && !f.value) {
+        *p = '\0';
+        f.value = p + 1;
+      }
+      ++p;
+    }
+    if (*p) *p++ = '\0';
+  }
+  return out.count;
+}
+
+const char* CommandArgs::find(const char* key) const {
+  for (uint8_t i = 0; i < count; ++i) {
+    if (fields[i].value && strcmp(fields[i].key, key) == 0) return fields[i].value;
+  }
+  return nullptr;
+}
+
+bool CommandArgs::toInt(const char* text, long& out) {
+  if (!text || !*text) return false;
+  char* end;
+  long v = strtol(text, &end, 10);
+  if (*end) return false;
+  out = v;
+  return true;
+}
+
+bool CommandArgs::toFloat(const char* text, float& out) {
+  if (!text || !*text) return false;
+
+  bool negative = false;
+  if (*text == '-' || *text == '+') negative = (*text++ == '-');
+
+  float value = 0.0f;
+  float scale = 1.0f;
+  bool digits = false;
+  bool fraction = false;
+  for (; *text; ++text) {
+    if (*text >= '0' && *text <= '9') {
+      digits = true;
+      if (fraction) {
+        scale *= 0.1f;
+        value += (*text - '0') * scale;
+      } else {
+        value = value * 10.0f + (*text - '0');
+      }
+    } else if (*text == '.' && !fraction) {
+      fraction = true;
+    } else {
+      return false;
+    }
+  }
+  if (!digits) return false;
+  out = negative ? -value : value;
+  return true;
+}
+
+bool CommandArgs::getInt(const char* key, long& out) const {
+  return toInt(find(key), out);
+}
+
+bool CommandArgs::getFloat(const char* key, float& out) const {
+  return toFloat(find(key), out);
+}
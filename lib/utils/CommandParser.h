@@ -0,0 +1,76 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @class LineAssembler
+ * Arma líneas de comando carácter a carácter sobre un buffer fijo.
+ * No reserva memoria: sustituye a readStringUntil('\n').
+ */
+class LineAssembler {
+public:
+  static constexpr size_t CAPACITY = 128;
+
+  /**
+   * Agrega un carácter recibido.
+   * @return true cuando hay una línea completa disponible en data().
+   */
+  bool push(char c);
+
+  /// Línea completa terminada en '\0' (válida hasta el siguiente reset())
+  char* data() { return buf; }
+  size_t length() const { return len; }
+  void reset() { len = 0; buf[0] = '\0'; }
+
+  /// Líneas descartadas por superar CAPACITY
+  uint32_t getOverflows() const { return overflows; }
+
+private:
+  char buf[CAPACITY];
+  size_t len = 0;
+  bool discarding = false;
+  uint32_t overflows = 0;
+};
+
+/**
+ * @struct CommandArgs
+ * Línea ya separada en campos, apuntando dentro del buffer original.
+ *
+ * Los campos se separan por comas o espacios; cada campo puede ser "clave:valor"
+ * ("tps_raw:1234,map_raw:3900") o una palabra suelta ("thr INJ_TPS_ON 12").
+ * El nombre del comando es la clave del primer campo.
+ */
+struct CommandArgs {
+  static constexpr uint8_t MAX_FIELDS = 8;
+
+  struct Field {
+    const char* key;
+    const char* value;  ///< nullptr si el campo no tenía ':'
+  };
+
+  Field   fields[MAX_FIELDS];
+  uint8_t count = 0;
+
+  const char* name() const { return count ? fields[0].key : ""; }
+
+  /// Campo posicional i (0 = nombre del comando)
+  const char* arg(uint8_t i) const { return i < count ? fields[i].key : nullptr; }
+
+  /// Valor del campo "clave:valor", nullptr si no está
+  const char* find(const char* key) const;
+
+  bool getInt(const char* key, long& out) const;
+  bool getFloat(const char* key, float& out) const;
+
+  static bool toInt(const char* text, long& out);
+  /// Decimal simple ("-12.5"); sin exponente para no depender de strtod (que reserva memoria en newlib)
+  static bool toFloat(const char* text, float& out);
+};
+
+/**
+ * Separa la línea en campos modificándola en el sitio.
+ * @param line Línea terminada en '\0'; se recorta y se insertan terminadores.
+ * @return Número de campos.
+ */
+uint8_t tokenizeCommand(char* line, CommandArgs& out);
@@ -1,5 +1,4 @@
 #include "DebugManager.h"
-#include <string.h>  // Para strlen()
 
 // Cantidad total de señales simulables
 constexpr int OVERRIDE_COUNT = 4;
@@ -57,30 +56,18 @@ float DebugManager::getLevel() const {
   return getValue(DebugTarget::INYECTOR);
 }
 
-void DebugManager::updateFromSerial(Stream& serial) {
-  if (!serial.available()) return;
-
-  String line = serial.readStringUntil('\n');
-  line.trim();
-
-  setIfPresent(line, "tps:", DebugTarget::TPS);
-  setIfPresent(line, "map:", DebugTarget::MAP);
-  setIfPresent(line, "vortex:", DebugTarget::VORTEX);
-  setIfPresent(line, "iny:", DebugTarget::INYECTOR);
+void DebugManager::applyOverrides(const CommandArgs& args) {
+  setIfPresent(args, "tps", DebugTarget::TPS);
+  setIfPresent(args, "map", DebugTarget::MAP);
+  setIfPresent(args, "vortex", DebugTarget::VORTEX);
+  setIfPresent(args, "iny", DebugTarget::INYECTOR);
 }
 
-void DebugManager::setIfPresent(const String& line,
-                                const char* prefix,
+void DebugManager::setIfPresent(const CommandArgs& args,
+                                const char* key,
                                 DebugTarget target) {
-  int start = line.indexOf(prefix);
-  if (start < 0) return;
-
-  int valStart = start + strlen(prefix);
-  int valEnd   = line.indexOf(',', valStart);
-  if (valEnd < 0) valEnd = line.length();
-
-  String valStr = line.substring(valStart, valEnd);
-  float valor   = valStr.toFloat();
+  float valor;
+  if (!args.getFloat(key, valor)) return;
 
   if (target == DebugTarget::VORTEX || target == DebugTarget::INYECTOR) {
     if (valor <= 0.0f)
@@ -1,6 +1,6 @@
 #pragma once
 
-#include <Arduino.h>
+#include "CommandParser.h"
 
 /**
  * Señales que pueden ser overrideadas para simulación o debugging.
@@ -56,12 +56,12 @@ public:
   float getLevel() const;
 
   /**
-   * updateFromSerial()
-   * Lee una línea de texto enviada por Serial (ej: "tps:2.1,map:3.1,turbo:1,iny:0.75")
-   * Extrae valores y activa/desactiva los overrides correspondientes.
-   * @param serial Puerto Serial conectado al simulador Python
+   * applyOverrides()
+   * Aplica una línea ya separada por la consola (ej: "tps:2.1,map:3.1,vortex:1,iny:0.75").
+   * Activa/desactiva los overrides de los campos presentes.
+   * @param args Campos de la línea recibida
    */
-  void updateFromSerial(Stream& serial);
+  void applyOverrides(const CommandArgs& args);
 
 private:
   static constexpr int OVERRIDE_COUNT = 4;  // Total de canales soportados
@@ -73,10 +73,10 @@ private:
 
   /**
    * setIfPresent()
-   * Busca el prefijo en la línea, extrae valor y activa override si corresponde.
-   * @param line   Línea completa de texto recibida
-   * @param prefix Prefijo del campo (ej: "tps:")
+   * Busca la clave entre los campos y activa override si corresponde.
+   * @param args   Campos de la línea recibida
+   * @param key    Clave del campo (ej: "tps")
    * @param target Canal que se está procesando
    */
-  void setIfPresent(const String& line, const char* prefix, DebugTarget target);
+  void setIfPresent(const CommandArgs& args, const char* key, DebugTarget target);
 };
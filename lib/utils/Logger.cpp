@@ -0,0 +1,168 @@
+#include "Logger.h"
+#include <stdio.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <Arduino.h>
+static uint32_t logNowMs() { return millis(); }
+#else
+#include <chrono>
+static uint32_t logNowMs() {
+  using namespace std::chrono;
+  return static_cast<uint32_t>(
+    duration_cast<milliseconds>(steady_clock::now().time_since_epoch()).count());
+}
+#endif
+
+Logger& Logger::getInstance() {
+  static Logger inst;
+  return inst;
+}
+
+Logger::Logger() {
+  for (uint32_t i = 0; i < CAPACITY; ++i) {
+    cells[i].seq.store(i, std::memory_order_relaxed);
+  }
+}
+
+bool Logger::push(uint8_t level, const char* fmt, const LogArg* args, uint8_t argc) {
+  uint32_t pos = enqueuePos.load(std::memory_order_relaxed);
+  Cell* cell;
+  for (;;) {
+    cell = &cells[pos & (CAPACITY - 1)];
+    uint32_t seq = cell->seq.load(std::memory_order_acquire);
+    int32_t diff = static_cast<int32_t>(seq - pos);
+    if (diff == 0) {
+      // Celda libre: reservarla; si otro productor ganó, pos se actualiza y se reintenta
+      if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+    } else if (diff < 0) {
+      dropped.fetch_add(1, std::memory_order_relaxed);  // Cola llena
+      return false;
+    } else {
+      pos = enqueuePos.load(std::memory_order_relaxed);
+    }
+  }
+
+  Record& rec = cell->rec;
+  rec.fmt = fmt;
+  rec.timestampMs = logNowMs();
+  rec.level = level;
+  rec.argc = argc > MAX_ARGS ? MAX_ARGS : argc;
+  for (uint8_t i = 0; i < rec.argc; ++i) {
+    rec.types[i] = args[i].type;
+    rec.values[i] = args[i].v;
+  }
+
+  cell->seq.store(pos + 1, std::memory_order_release);  // Publicar
+  return true;
+}
+
+size_t Logger::drain(Sink sink, size_t maxRecords) {
+  char line[LINE_MAX];
+  size_t delivered = 0;
+
+  while (delivered < maxRecords) {
+    Cell& cell = cells[dequeuePos & (CAPACITY - 1)];
+    uint32_t seq = cell.seq.load(std::memory_order_acquire);
+    if (static_cast<int32_t>(seq - (dequeuePos + 1)) < 0) break;  // Vacía o aún sin publicar
+
+    Record rec = cell.rec;
+    cell.seq.store(dequeuePos + CAPACITY, std::memory_order_release);  // Liberar la celda cuanto antes
+    dequeuePos++;
+
+    size_t len = format(rec, line, sizeof(line));
+    if (sink && len) sink(line, len);
+    delivered++;
+  }
+  return delivered;
+}
+
+// Expande el formato consumiendo los argumentos en orden; cada especificador
+// se reescribe sin modificadores de longitud según el tipo capturado.
+static size_t expand(const Logger::Record& rec, char* out, size_t cap) {
+  size_t len = 0;
+  uint8_t next = 0;
+  const char* p = rec.fmt;
+
+  while (*p && len + 1 < cap) {
+    if (*p != '%') {
+      out[len++] = *p++;
+      continue;
+    }
+    if (p[1] == '%') {
+      out[len++] = '%';
+      p += 2;
+      continue;
+    }
+
+    // %[flags][ancho][.precisión][longitud]conversión
+    char spec[16];
+    size_t s = 0;
+    spec[s++] = *p++;
+    while (*p && strchr("-+ #0123456789.", *p) && s < sizeof(spec) - 3) spec[s++] = *p++;
+    while (*p && strchr("hlLqjzt", *p)) p++;
+    char conv = *p ? *p++ : 's';
+
+    int n = 0;
+    size_t room = cap - len;
+    if (next >= rec.argc) {
+      n = snprintf(out + len, room, "?");
+    } else {
+      const char t = rec.types[next];
+      const LogValue& a = rec.values[next++];
+      spec[s] = conv;
+      spec[s + 1] = '\0';
+      switch (conv) {
+        case 'd': case 'i': case 'c':
+          n = snprintf(out + len, room, spec, t == 'f' ? static_cast<int>(a.f) : static_cast<int>(a.i));
+          break;
+        case 'u': case 'x': case 'X': case 'o':
+          n = snprintf(out + len, room, spec, t == 'f' ? static_cast<unsigned>(a.f) : static_cast<unsigned>(a.u));
+          break;
+        case 'f': case 'F': case 'e': case 'E': case 'g': case 'G':
+          n = snprintf(out + len, room, spec,
+                       t == 'f' ? static_cast<double>(a.f)
+                       : t == 'u' ? static_cast<double>(a.u) : static_cast<double>(a.i));
+          break;
+        case 's':
+          n = snprintf(out + len, room, spec, t == 's' && a.s ? a.s : "?");
+          break;
+        default:
+          n = snprintf(out + len, room, "?");
+          break;
+      }
+    }
+    if (n < 0) break;
+    len += (static_cast<size_t>(n) < room) ? n : room - 1;
+  }
+  out[len] = '\0';
+  return len;
+}
+
+size_t Logger::format(const Record& rec, char* out, size_t cap) {
+  static const char LEVEL_TAGS[] = "-EWID";
+  if (cap < 16) return 0;
+
+  // Línea de progreso: sin prefijo ni salto
+  if (rec.fmt[0] == '\r') return expand(rec, out, cap);
+
+  // Los saltos iniciales van antes del prefijo (separan de una línea de progreso)
+  Record body = rec;
+  size_t lead = 0;
+  while (body.fmt[0] == '\n' && lead < 4) {
+    out[lead++] = '\n';
+    body.fmt++;
+  }
+
+  int n = snprintf(out + lead, cap - lead, "[%lu] %c ", (unsigned long)rec.timestampMs,
+                   rec.level <= VORTEX_LOG_DEBUG ? LEVEL_TAGS[rec.level] : '?');
+  if (n < 0 || static_cast<size_t>(n) >= cap - lead - 3) return 0;
+  n += lead;
+
+  size_t len = n + expand(body, out + n, cap - n - 2);  // Reserva para "\r\n"
+  while (len > 0 && (out[len - 1] == '\n' || out[len - 1] == '\r')) len--;
+  out[len++] = '\r';
+  out[len++] = '\n';
+  out[len] = '\0';
+  return len;
+}
@@ -0,0 +1,142 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Niveles de log. VORTEX_LOG_LEVEL (build_flags) fija el máximo compilado:
+ * las llamadas por encima desaparecen por completo del binario, argumentos
+ * y cadena de formato incluidos.
+ */
+#define VORTEX_LOG_NONE  0
+#define VORTEX_LOG_ERROR 1
+#define VORTEX_LOG_WARN  2
+#define VORTEX_LOG_INFO  3
+#define VORTEX_LOG_DEBUG 4
+
+#ifndef VORTEX_LOG_LEVEL
+#define VORTEX_LOG_LEVEL VORTEX_LOG_INFO
+#endif
+
+#if VORTEX_LOG_LEVEL >= VORTEX_LOG_ERROR
+#define LOG_E(fmt, ...) Logger::getInstance().log(VORTEX_LOG_ERROR, fmt, ##__VA_ARGS__)
+#else
+#define LOG_E(fmt, ...) do {} while (0)
+#endif
+
+#if VORTEX_LOG_LEVEL >= VORTEX_LOG_WARN
+#define LOG_W(fmt, ...) Logger::getInstance().log(VORTEX_LOG_WARN, fmt, ##__VA_ARGS__)
+#else
+#define LOG_W(fmt, ...) do {} while (0)
+#endif
+
+#if VORTEX_LOG_LEVEL >= VORTEX_LOG_INFO
+#define LOG_I(fmt, ...) Logger::getInstance().log(VORTEX_LOG_INFO, fmt, ##__VA_ARGS__)
+#else
+#define LOG_I(fmt, ...) do {} while (0)
+#endif
+
+#if VORTEX_LOG_LEVEL >= VORTEX_LOG_DEBUG
+#define LOG_D(fmt, ...) Logger::getInstance().log(VORTEX_LOG_DEBUG, fmt, ##__VA_ARGS__)
+#else
+#define LOG_D(fmt, ...) do {} while (0)
+#endif
+
+/// Valor crudo de un argumento (32 bits en el ESP32)
+union LogValue {
+  int32_t     i;
+  uint32_t    u;
+  float       f;
+  const char* s;
+};
+
+/**
+ * @struct LogArg
+ * Argumento crudo capturado en la llamada; se formatea más tarde.
+ * Las cadenas (%s) se guardan como puntero: deben ser literales o de vida estática.
+ */
+struct LogArg {
+  char     type;  ///< 'i' entero, 'u' sin signo, 'f' flotante, 's' cadena
+  LogValue v;
+};
+
+inline LogArg toLogArg(int v)                { LogArg a; a.type = 'i'; a.v.i = v; return a; }
+inline LogArg toLogArg(long v)               { LogArg a; a.type = 'i'; a.v.i = static_cast<int32_t>(v); return a; }
+inline LogArg toLogArg(long long v)          { LogArg a; a.type = 'i'; a.v.i = static_cast<int32_t>(v); return a; }
+inline LogArg toLogArg(unsigned v)           { LogArg a; a.type = 'u'; a.v.u = v; return a; }
+inline LogArg toLogArg(unsigned long v)      { LogArg a; a.type = 'u'; a.v.u = static_cast<uint32_t>(v); return a; }
+inline LogArg toLogArg(unsigned long long v) { LogArg a; a.type = 'u'; a.v.u = static_cast<uint32_t>(v); return a; }
+inline LogArg toLogArg(double v)             { LogArg a; a.type = 'f'; a.v.f = static_cast<float>(v); return a; }
+inline LogArg toLogArg(const char* v)        { LogArg a; a.type = 's'; a.v.s = v; return a; }
+
+/**
+ * @class Logger
+ * Log diferido: las llamadas solo encolan un registro compacto
+ * (puntero al formato, marca de tiempo, argumentos crudos) en una cola
+ * MPSC sin bloqueos (Vyukov). Una tarea de baja prioridad llama a drain(),
+ * que formatea y entrega cada línea al sink.
+ *
+ * Si la cola está llena el registro se descarta y se cuenta.
+ */
+class Logger {
+public:
+  static constexpr uint8_t  MAX_ARGS = 8;
+  static constexpr uint32_t CAPACITY = 32;   // Registros en cola (potencia de dos)
+  static constexpr size_t   LINE_MAX = 160;  // Línea formateada más larga
+
+  struct Record {
+    const char* fmt;
+    uint32_t    timestampMs;
+    uint8_t     level;
+    uint8_t     argc;
+    char        types[MAX_ARGS];
+    LogValue    values[MAX_ARGS];
+  };
+
+  /// Destino de las líneas ya formateadas
+  typedef void (*Sink)(const char* text, size_t len);
+
+  static Logger& getInstance();
+
+  template <typename... Args>
+  void log(uint8_t level, const char* fmt, Args... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "Demasiados argumentos para un registro de log");
+    const LogArg packed[sizeof...(Args) + 1] = { toLogArg(args)... };
+    push(level, fmt, packed, sizeof...(Args));
+  }
+
+  /**
+   * Productor (cualquier tarea, nunca desde ISR): copia el registro a la cola.
+   * @return false si la cola estaba llena.
+   */
+  bool push(uint8_t level, const char* fmt, const LogArg* args, uint8_t argc);
+
+  /**
+   * Consumidor único: formatea y entrega hasta maxRecords registros.
+   * @return Registros entregados.
+   */
+  size_t drain(Sink sink, size_t maxRecords = 8);
+
+  /**
+   * Formatea un registro como "[ms] N mensaje\r\n".
+   * Un mensaje que empieza con '\r' se entrega tal cual (línea que se redibuja en el sitio).
+   * @return Longitud escrita en out (sin el terminador).
+   */
+  static size_t format(const Record& rec, char* out, size_t cap);
+
+  uint32_t getDropped() const { return dropped.load(std::memory_order_relaxed); }
+
+private:
+  Logger();
+
+  struct Cell {
+    std::atomic<uint32_t> seq;
+    Record rec;
+  };
+
+  Cell cells[CAPACITY];
+  std::atomic<uint32_t> enqueuePos{0};
+  uint32_t dequeuePos = 0;  // Solo lo toca el consumidor
+  std::atomic<uint32_t> dropped{0};
+};
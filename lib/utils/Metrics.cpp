@@ -0,0 +1,120 @@
+#include "Metrics.h"
+#include <stdio.h>
+#include <string.h>
+
+uint32_t Histogram::getMean() const {
+  uint32_t n = getCount();
+  return n ? sum.load(std::memory_order_relaxed) / n : 0;
+}
+
+uint32_t Histogram::percentile(float q) const {
+  uint32_t n = getCount();
+  if (n == 0) return 0;
+  uint32_t rank = static_cast<uint32_t>(q * n);
+  uint32_t seen = 0;
+  for (uint8_t b = 0; b < BUCKETS; ++b) {
+    seen += buckets[b].load(std::memory_order_relaxed);
+    if (seen > rank) {
+      if (b == BUCKETS - 1) return getMax();  // Cubeta abierta
+      uint32_t upper = b == 0 ? 0 : (1u << b) - 1;
+      return upper < getMax() ? upper : getMax();
+    }
+  }
+  return getMax();
+}
+
+MetricsRegistry& MetricsRegistry::getInstance() {
+  static MetricsRegistry inst;
+  return inst;
+}
+
+// Búsqueda lineal: solo se usa al registrar, nunca en el camino caliente
+template <typename T>
+static T& findOrAdd(const char* name, T* pool, const char** names, uint8_t& used,
+                    uint8_t capacity, T& spare) {
+  for (uint8_t i = 0; i < used; ++i) {
+    if (strcmp(names[i], name) == 0) return pool[i];
+  }
+  if (used >= capacity) return spare;
+  names[used] = name;
+  return pool[used++];
+}
+
+Counter& MetricsRegistry::counter(const char* name) {
+  return findOrAdd(name, counters, counterNames, counterCount, MAX_COUNTERS, spareCounter);
+}
+
+Gauge& MetricsRegistry::gauge(const char* name) {
+  return findOrAdd(name, gauges, gaugeNames, gaugeCount, MAX_GAUGES, spareGauge);
+}
+
+Histogram& MetricsRegistry::histogram(const char* name) {
+  return findOrAdd(name, histograms, histogramNames, histogramCount, MAX_HISTOGRAMS, spareHistogram);
+}
+
+size_t MetricsRegistry::describe(uint8_t i, uint32_t nowMs, char* out, size_t cap) const {
+  int n = 0;
+  if (i < counterCount) {
+    const Counter& c = counters[i];
+    uint32_t elapsed = nowMs - snapshotMs;
+    uint32_t delta = c.get() - c.prevValue;
+    float rate = elapsed ? delta * 1000.0f / elapsed : 0.0f;
+    n = snprintf(out, cap, "%-22s %10lu  (%.1f/s)", counterNames[i],
+                 (unsigned long)c.get(), rate);
+  } else if ((i -= counterCount) < gaugeCount) {
+    n = snprintf(out, cap, "%-22s %10ld", gaugeNames[i], (long)gauges[i].get());
+  } else if ((i -= gaugeCount) < histogramCount) {
+    const Histogram& h = histograms[i];
+    n = snprintf(out, cap, "%-22s n=%lu media=%lu p50<=%lu p99<=%lu max=%lu",
+                 histogramNames[i], (unsigned long)h.getCount(), (unsigned long)h.getMean(),
+                 (unsigned long)h.percentile(0.5f), (unsigned long)h.percentile(0.99f),
+                 (unsigned long)h.getMax());
+  } else {
+    return 0;
+  }
+  if (n < 0) return 0;
+  return static_cast<size_t>(n) < cap ? n : cap - 1;
+}
+
+void MetricsRegistry::markSnapshot(uint32_t nowMs) {
+  for (uint8_t i = 0; i < counterCount; ++i) {
+    counters[i].prevValue = counters[i].get();
+  }
+  snapshotMs = nowMs;
+}
+
+size_t MetricsRegistry::writeTelemetry(uint32_t nowMs, char* out, size_t cap) const {
+  if (cap == 0) return 0;
+  int n = snprintf(out, cap, "tlm:%lu", (unsigned long)nowMs);
+  if (n < 0 || static_cast<size_t>(n) >= cap) {
+    out[0] = '\0';
+    return 0;
+  }
+  size_t len = n;
+
+  // Cada campo se añade completo o no se añade
+  auto append = [&](const char* name, const char* suffix, unsigned long value) {
+    int m = snprintf(out + len, cap - len, ",%s%s:%lu", name, suffix, value);
+    if (m < 0 || static_cast<size_t>(m) >= cap - len) {
+      out[len] = '\0';
+      return false;
+    }
+    len += m;
+    return true;
+  };
+
+  for (uint8_t i = 0; i < counterCount; ++i) {
+    if (!append(counterNames[i], "", counters[i].get())) return len;
+  }
+  for (uint8_t i = 0; i < gaugeCount; ++i) {
+    // Los gauges negativos se envían como su valor sin signo de 32 bits
+    if (!append(gaugeNames[i], "", static_cast<uint32_t>(gauges[i].get()))) return len;
+  }
+  for (uint8_t i = 0; i < histogramCount; ++i) {
+    const Histogram& h = histograms[i];
+    if (!append(histogramNames[i], ".n", h.getCount())) return len;
+    if (!append(histogramNames[i], ".p99", h.percentile(0.99f))) return len;
+    if (!append(histogramNames[i], ".max", h.getMax())) return len;
+  }
+  return len;
+}
@@ -0,0 +1,126 @@
+#pragma once
+
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Métricas de tiempo de ejecución con memoria fija.
+ *
+ * Cada métrica tiene un único escritor (una tarea o una ISR); la actualización
+ * es una carga y un almacenamiento relajados, sin RMW ni bloqueos, así que es
+ * segura desde IRAM/ISR. Los lectores (consola, telemetría) pueden ver valores
+ * ligeramente atrasados, nunca rotos.
+ */
+
+/// Contador monótono (eventos, bytes)
+class Counter {
+public:
+  void inc(uint32_t n = 1) {
+    value.store(value.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+  }
+  uint32_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+  friend class MetricsRegistry;
+  std::atomic<uint32_t> value{0};
+  uint32_t prevValue = 0;  // Solo lector: base para la tasa
+};
+
+/// Valor instantáneo (carga, memoria libre, profundidad de cola)
+class Gauge {
+public:
+  void set(int32_t v) { value.store(v, std::memory_order_relaxed); }
+  int32_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+  std::atomic<int32_t> value{0};
+};
+
+/**
+ * @class Histogram
+ * Distribución en cubetas log2 (0, 1, 2-3, 4-7, ... >= 2^14), típicamente en µs.
+ */
+class Histogram {
+public:
+  static constexpr uint8_t BUCKETS = 16;
+
+  void record(uint32_t v) {
+    uint8_t b = v ? 32 - __builtin_clz(v) : 0;
+    if (b >= BUCKETS) b = BUCKETS - 1;
+    buckets[b].store(buckets[b].load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    count.store(count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    sum.store(sum.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    if (v > maxValue.load(std::memory_order_relaxed)) maxValue.store(v, std::memory_order_relaxed);
+  }
+
+  uint32_t getCount() const { return count.load(std::memory_order_relaxed); }
+  uint32_t getMax() const { return maxValue.load(std::memory_order_relaxed); }
+  uint32_t getMean() const;
+  /// Límite superior de la cubeta que contiene el percentil q (0..1)
+  uint32_t percentile(float q) const;
+
+private:
+  std::atomic<uint32_t> buckets[BUCKETS] = {};
+  std::atomic<uint32_t> count{0};
+  std::atomic<uint32_t> sum{0};
+  std::atomic<uint32_t> maxValue{0};
+};
+
+/**
+ * @class MetricsRegistry
+ * Catálogo de métricas con nombre. Registrar en setup()/begin(), antes de que
+ * arranquen los escritores; después los módulos solo usan la referencia.
+ * Si el catálogo se llena se entrega una métrica de descarte (nunca nullptr).
+ */
+class MetricsRegistry {
+public:
+  static constexpr uint8_t MAX_COUNTERS = 24;
+  static constexpr uint8_t MAX_GAUGES = 24;
+  static constexpr uint8_t MAX_HISTOGRAMS = 8;
+
+  static MetricsRegistry& getInstance();
+
+  /// Busca o crea la métrica; name debe ser un literal (se guarda el puntero)
+  Counter& counter(const char* name);
+  Gauge& gauge(const char* name);
+  Histogram& histogram(const char* name);
+
+  /// Número total de métricas registradas
+  uint8_t size() const { return counterCount + gaugeCount + histogramCount; }
+
+  /**
+   * Línea legible de la métrica i (0..size()-1). Los contadores incluyen la
+   * tasa por segundo desde el último markSnapshot().
+   * @return Longitud escrita, 0 si i está fuera de rango.
+   */
+  size_t describe(uint8_t i, uint32_t nowMs, char* out, size_t cap) const;
+
+  /// Fija la base de las tasas de los contadores
+  void markSnapshot(uint32_t nowMs);
+
+  /**
+   * Registro de telemetría en una línea "tlm:<ms>,nombre:valor,...".
+   * Usa el mismo formato clave:valor que acepta la consola.
+   * @return Longitud escrita (se trunca en el último campo completo).
+   */
+  size_t writeTelemetry(uint32_t nowMs, char* out, size_t cap) const;
+
+private:
+  MetricsRegistry() = default;
+
+  Counter   counters[MAX_COUNTERS];
+  Gauge     gauges[MAX_GAUGES];
+  Histogram histograms[MAX_HISTOGRAMS];
+  const char* counterNames[MAX_COUNTERS] = {};
+  const char* gaugeNames[MAX_GAUGES] = {};
+  const char* histogramNames[MAX_HISTOGRAMS] = {};
+  uint8_t counterCount = 0;
+  uint8_t gaugeCount = 0;
+  uint8_t histogramCount = 0;
+  uint32_t snapshotMs = 0;
+
+  Counter   spareCounter;
+  Gauge     spareGauge;
+  Histogram spareHistogram;
+};
@@ -0,0 +1,88 @@
+#ifdef ARDUINO
+
+#include "SystemMetrics.h"
+#include <esp_freertos_hooks.h>
+#include <esp_heap_caps.h>
+#include <esp_timer.h>
+
+// Entre dos llamadas seguidas del hook de idle no pasa más que esto;
+// un hueco mayor significa que el núcleo estuvo ocupado en otra cosa
+static constexpr int64_t IDLE_GAP_US = 50;
+
+static volatile int64_t  lastHookUs[2] = {0, 0};
+static volatile uint32_t idleUs[2] = {0, 0};
+
+SystemMetrics& SystemMetrics::getInstance() {
+  static SystemMetrics inst;
+  return inst;
+}
+
+void SystemMetrics::accountIdle(uint8_t cpu) {
+  int64_t now = esp_timer_get_time();
+  int64_t delta = now - lastHookUs[cpu];
+  if (delta > 0 && delta < IDLE_GAP_US) idleUs[cpu] += static_cast<uint32_t>(delta);
+  lastHookUs[cpu] = now;
+}
+
+// false: el idle sigue girando en lugar de dormir en WAITI, así la medida es continua
+bool SystemMetrics::idleHookCpu0() {
+  accountIdle(0);
+  return false;
+}
+
+bool SystemMetrics::idleHookCpu1() {
+  accountIdle(1);
+  return false;
+}
+
+void SystemMetrics::begin() {
+  MetricsRegistry& reg = MetricsRegistry::getInstance();
+  cpuLoad[0]  = &reg.gauge("cpu0.load_pct");
+  cpuLoad[1]  = &reg.gauge("cpu1.load_pct");
+  heapFree    = &reg.gauge("heap.free");
+  heapMinFree = &reg.gauge("heap.min_free");
+  heapLargest = &reg.gauge("heap.largest");
+  heapFrag    = &reg.gauge("heap.frag_pct");
+
+  esp_register_freertos_idle_hook_for_cpu(&SystemMetrics::idleHookCpu0, 0);
+  esp_register_freertos_idle_hook_for_cpu(&SystemMetrics::idleHookCpu1, 1);
+  lastSampleUs = esp_timer_get_time();
+}
+
+void SystemMetrics::watchTask(const char* gaugeName, TaskHandle_t handle) {
+  if (!handle || taskCount >= MAX_TASKS) return;
+  tasks[taskCount].handle = handle;
+  tasks[taskCount].gauge = &MetricsRegistry::getInstance().gauge(gaugeName);
+  taskCount++;
+}
+
+void SystemMetrics::sample() {
+  if (!heapFree) return;  // begin() no llamado
+
+  int64_t now = esp_timer_get_time();
+  uint32_t window = static_cast<uint32_t>(now - lastSampleUs);
+  lastSampleUs = now;
+  for (uint8_t cpu = 0; cpu < 2; ++cpu) {
+    uint32_t idle = idleUs[cpu];
+    uint32_t idleDelta = idle - idleUsAtSample[cpu];
+    idleUsAtSample[cpu] = idle;
+    if (window == 0) continue;
+    if (idleDelta > window) idleDelta = window;
+    cpuLoad[cpu]->set(100 - static_cast<int32_t>(static_cast<uint64_t>(idleDelta) * 100 / window));
+  }
+
+  size_t freeBytes = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+  size_t largest = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+  heapFree->set(static_cast<int32_t>(freeBytes));
+  heapMinFree->set(static_cast<int32_t>(heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT)));
+  heapLargest->set(static_cast<int32_t>(largest));
+  // Fragmentación: cuánto del heap libre no está en el bloque más grande
+  heapFrag->set(freeBytes ? 100 - static_cast<int32_t>(largest * 100 / freeBytes) : 0);
+
+  for (uint8_t i = 0; i < taskCount; ++i) {
+    // En el ESP32 la marca de agua ya viene en bytes
+    tasks[i].gauge->set(static_cast<int32_t>(uxTaskGetStackHighWaterMark(tasks[i].handle)));
+  }
+}
+
+#endif // ARDUINO
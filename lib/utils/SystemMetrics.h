@@ -0,0 +1,58 @@
+#pragma once
+
+#ifdef ARDUINO
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include "Metrics.h"
+
+/**
+ * @class SystemMetrics
+ * Métricas del ESP32 que no pertenecen a ningún módulo: carga por núcleo
+ * (tiempo en los hooks de idle), memoria libre y fragmentación del heap,
+ * y high-water mark de pila de las tareas vigiladas.
+ * sample() vuelca todo en gauges del MetricsRegistry.
+ */
+class SystemMetrics {
+public:
+  static constexpr uint8_t MAX_TASKS = 8;
+
+  static SystemMetrics& getInstance();
+
+  /// Registra los hooks de idle de ambos núcleos
+  void begin();
+
+  /**
+   * Vigila la pila de una tarea.
+   * @param gaugeName Literal, p. ej. "stack.SensorPolling" (bytes libres mínimos).
+   */
+  void watchTask(const char* gaugeName, TaskHandle_t handle);
+
+  /// Recalcula carga, heap y pilas; llamar periódicamente (p. ej. cada segundo)
+  void sample();
+
+private:
+  SystemMetrics() = default;
+
+  static bool idleHookCpu0();
+  static bool idleHookCpu1();
+  static void accountIdle(uint8_t cpu);
+
+  struct WatchedTask {
+    TaskHandle_t handle;
+    Gauge* gauge;
+  };
+  WatchedTask tasks[MAX_TASKS];
+  uint8_t taskCount = 0;
+
+  Gauge* cpuLoad[2] = {nullptr, nullptr};
+  Gauge* heapFree = nullptr;
+  Gauge* heapMinFree = nullptr;
+  Gauge* heapLargest = nullptr;
+  Gauge* heapFrag = nullptr;
+
+  int64_t lastSampleUs = 0;
+  uint32_t idleUsAtSample[2] = {0, 0};
+};
+
+#endif // ARDUINO
@@ -5,18 +5,32 @@
 #include "ActuatorManager.h"
 #include "SensorManager.h"
 #include "USBSerialConsoleUI.h"
+#if VORTEX_BT_BLE
+#include "BleConsoleUI.h"
+#else
 #include "BluetoothSerialConsoleUI.h"
-#include <BluetoothSerial.h>
+#endif
 #include "ThresholdManager.h"
+#include "ConfigStore.h"
+#include "NvsStorageBackend.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "SystemMetrics.h"
 
 
 
+// 1: servicio BLE GATT en lugar de la consola SPP clásica (platformio.ini)
+#ifndef VORTEX_BT_BLE
+#define VORTEX_BT_BLE 0
+#endif
+
 // PIN-OUT
 constexpr uint8_t PIN_MAP             = 35;
 constexpr uint8_t PIN_TPS             = 34;
 constexpr uint8_t PIN_RELAY_TURBO     =  2;
 constexpr uint8_t PIN_RELAY_ACOUSTIC  =  4;
 constexpr uint8_t PIN_DAC_ACOUSTIC    = 25;
+constexpr uint8_t PIN_MIC_FEEDBACK    = 36;  // ADC1, micrófono del conducto (solo entrada)
 
 // Objetos globales
 StateMachine       fsm;
@@ -24,12 +38,23 @@ SensorManager      sensors;
 ActuatorManager    actuators;
 ConsoleUI* ui = nullptr;
 USBSerialConsoleUI usbConsoleUI(&ui);
-BluetoothSerialConsoleUI btConsoleUI(&ui);
-BluetoothSerial SerialBT;
+#if VORTEX_BT_BLE
+BleConsoleUI btConsoleUI(&ui);              // GATT: telemetría binaria + control + consola
+#else
+BluetoothSerialConsoleUI btConsoleUI(&ui);  // SPP clásico: solo consola de texto
+#endif
 CalibrationManager& calib = CalibrationManager::getInstance();
 DebugManager       debugMgr;
+NvsStorageBackend  nvsBackend;
 ThresholdManager* thresholdManagerPtr;
 bool calibLoaded = false;
+Histogram* controlUs = &MetricsRegistry::getInstance().histogram("loop.control_us");
+TaskHandle_t hSensorPolling = nullptr;
+TaskHandle_t hConsoleUpdate = nullptr;
+TaskHandle_t hConsoleDrain = nullptr;
+TaskHandle_t hLogDrain = nullptr;
+TaskHandle_t hConfigFlush = nullptr;
+TaskHandle_t hAcousticFeedback = nullptr;
 
 void TaskSensorUpdate(void* param) {
   SensorManager* sensorMgr = static_cast<SensorManager*>(param);
@@ -41,23 +66,62 @@ void TaskSensorUpdate(void* param) {
 void TaskConsoleUpdate(void* param) {
   for (;;) {
     static bool clientePrevio = false;
-    bool clienteActual = SerialBT.hasClient();
+    bool clienteActual = btConsoleUI.isSistemaActivo();
 
     if (clienteActual && !clientePrevio) {
-      Serial.println("→ Cliente Bluetooth conectado. Cambiando a BLE UI.");
+      usbConsoleUI.println("→ Cliente Bluetooth conectado. Cambiando a BLE UI.");
       ui = &btConsoleUI;
     } else if (!clienteActual && clientePrevio) {
-      Serial.println("→ Cliente Bluetooth desconectado. Volviendo a Serial UI.");
+      usbConsoleUI.println("→ Cliente Bluetooth desconectado. Volviendo a Serial UI.");
       ui = &usbConsoleUI;
     }
     clientePrevio = clienteActual;
 
     if (ui) ui->update();
-    debugMgr.updateFromSerial(Serial);
     
     vTaskDelay(pdMS_TO_TICKS(20));  // ajusta según necesidad
   }
 }
+void TaskConsoleDrain(void* param) {
+  for (;;) {
+    usbConsoleUI.drainOutput();             // Entrega solo lo que cabe sin bloquear
+    btConsoleUI.drainOutput();
+#if VORTEX_BT_BLE
+    btConsoleUI.drainTelemetry(millis());   // Notificaciones agrupadas según el MTU
+#endif
+    vTaskDelay(pdMS_TO_TICKS(5));
+  }
+}
+void TaskLogDrain(void* param) {
+  for (;;) {
+    // Formateo y UART fuera del lazo de control
+    Logger::getInstance().drain([](const char* text, size_t len) {
+      Serial.write(reinterpret_cast<const uint8_t*>(text), len);
+    });
+    vTaskDelay(pdMS_TO_TICKS(10));
+  }
+}
+void TaskMetrics(void* param) {
+  SystemMetrics& sys = SystemMetrics::getInstance();
+  for (;;) {
+    sys.sample();                           // Carga por núcleo, heap y pilas
+    vTaskDelay(pdMS_TO_TICKS(1000));
+  }
+}
+void TaskAcousticFeedback(void* param) {
+  AcousticMonitor* monitor = static_cast<AcousticMonitor*>(param);
+  for (;;) {
+    monitor->service();                     // Una ventana del micrófono si el inyector suena
+    vTaskDelay(pdMS_TO_TICKS(FEEDBACK_PERIOD_MS));
+  }
+}
+void TaskConfigFlush(void* param) {
+  ConfigStore* store = static_cast<ConfigStore*>(param);
+  for (;;) {
+    store->service(millis());               // Escribe a flash fuera del lazo de control
+    vTaskDelay(pdMS_TO_TICKS(100));
+  }
+}
 
 
 
@@ -65,7 +129,7 @@ void setup() {
 
   // Inicializar sensores y actuadores
   sensors.begin(PIN_MAP, PIN_TPS);
-  actuators.begin(PIN_RELAY_TURBO, PIN_DAC_ACOUSTIC, PIN_RELAY_ACOUSTIC);
+  actuators.begin(PIN_RELAY_TURBO, PIN_DAC_ACOUSTIC, PIN_RELAY_ACOUSTIC, PIN_MIC_FEEDBACK);
 
   xTaskCreatePinnedToCore(
     TaskSensorUpdate,
@@ -73,33 +137,25 @@ void setup() {
     2048,
     &sensors,  // tu instancia global o singleton
     1,         // prioridad baja
-    nullptr,
+    &hSensorPolling,
     1          // core 1 si se usa Wifi o BT
   );
 
-  xTaskCreatePinnedToCore(
-    TaskConsoleUpdate,
-    "ConsoleUpdate",
-    4096,     // más memoria si usas Bluetooth
-    nullptr,
-    1,        // misma prioridad que sensores
-    nullptr,
-    0         // Core 0, deja sensores en core 1
-  );
-
   // Iniciar UI Serial USB
   usbConsoleUI.begin();
   usbConsoleUI.setFSM(&fsm);
   usbConsoleUI.attachSensors(&sensors);
   usbConsoleUI.attachActuators(&actuators);
+  usbConsoleUI.attachDebug(&debugMgr);
   usbConsoleUI.imprimirDashboard();
 
-  // Iniciar UI Bluetooth Serial clásico
+  // Iniciar UI Bluetooth (BLE o SPP clásico según VORTEX_BT_BLE)
   //SerialBT.setPin("0000");  // Opcional
   btConsoleUI.begin();
   btConsoleUI.setFSM(&fsm);
   btConsoleUI.attachSensors(&sensors);
   btConsoleUI.attachActuators(&actuators);
+  btConsoleUI.attachDebug(&debugMgr);
   btConsoleUI.imprimirDashboard();
 
   usbConsoleUI.setMirror(&btConsoleUI);
@@ -107,20 +163,98 @@ void setup() {
 
   ui = &usbConsoleUI;
 
+  // Las tareas de consola arrancan cuando las UIs ya están listas:
+  // a partir de aquí solo ConsoleUpdate escribe en los buffers de salida
+  xTaskCreatePinnedToCore(
+    TaskConsoleUpdate,
+    "ConsoleUpdate",
+    4096,     // más memoria si usas Bluetooth
+    nullptr,
+    1,        // misma prioridad que sensores
+    &hConsoleUpdate,
+    0         // Core 0, deja sensores en core 1
+  );
+  xTaskCreatePinnedToCore(
+    TaskConsoleDrain,
+    "ConsoleDrain",
+    2048,
+    nullptr,
+    1,
+    &hConsoleDrain,
+    0         // Core 0, junto a la consola
+  );
+
+  xTaskCreatePinnedToCore(
+    TaskLogDrain,
+    "LogDrain",
+    3072,     // snprintf con flotantes
+    nullptr,
+    tskIDLE_PRIORITY,  // Solo cuando no hay nada más que hacer
+    &hLogDrain,
+    0
+  );
+
   esp_log_level_set("*", ESP_LOG_WARN);  // Silencia todos los módulos, solo muestra WARN o superior
 
 
 
   // Estado inicial
+  ConfigStore& config = ConfigStore::getInstance();
+  config.begin(&nvsBackend);
+  xTaskCreatePinnedToCore(
+    TaskConfigFlush,
+    "ConfigFlush",
+    3072,     // NVS necesita algo de pila
+    &config,
+    1,
+    &hConfigFlush,
+    0         // Core 0, lejos del lazo de control
+  );
+
+  if (actuators.getMonitor().isAvailable()) {
+    xTaskCreatePinnedToCore(
+      TaskAcousticFeedback,
+      "AcousticFeedback",
+      3072,     // Buffer del DMA en la pila
+      &actuators.getMonitor(),
+      1,        // Baja: solo espera al DMA y suma
+      &hAcousticFeedback,
+      0         // Core 0, lejos del lazo de control
+    );
+  }
+
   calib.begin(&sensors);
   bool calibLoaded = calib.loadCalibration();
   thresholdManagerPtr = new ThresholdManager();
   if (!thresholdManagerPtr->begin()) {
     Serial.println("❌ Error al iniciar ThresholdManager");
   }
+  usbConsoleUI.attachThresholds(thresholdManagerPtr);
+  btConsoleUI.attachThresholds(thresholdManagerPtr);
 
+  actuators.setEqualization(config.getEqualization());  // Antes del mapa que fija la FSM
   fsm.begin(calibLoaded, &actuators, thresholdManagerPtr);
 
+  // Métricas del sistema: pilas de las tareas propias y del loop de Arduino
+  SystemMetrics& sys = SystemMetrics::getInstance();
+  sys.begin();
+  sys.watchTask("stack.SensorPolling", hSensorPolling);
+  sys.watchTask("stack.ConsoleUpdate", hConsoleUpdate);
+  sys.watchTask("stack.ConsoleDrain", hConsoleDrain);
+  sys.watchTask("stack.LogDrain", hLogDrain);
+  sys.watchTask("stack.ConfigFlush", hConfigFlush);
+  if (hAcousticFeedback) sys.watchTask("stack.AcousticFeedback", hAcousticFeedback);
+  sys.watchTask("stack.loop", xTaskGetCurrentTaskHandle());
+  xTaskCreatePinnedToCore(
+    TaskMetrics,
+    "Metrics",
+    2048,
+    nullptr,
+    tskIDLE_PRIORITY,
+    nullptr,
+    0
+  );
+
   actuators.stopAll();
 
   if (!calibLoaded)
@@ -142,12 +276,13 @@ void loop() {
     hasTriedLoad = true;
   }
   if (ui->getCalibRequest()) {
-      calib.clearCalibration();
+      calib.startCalibration();
   }
   calib.update(ui->isSimulation());
 
 
   if (sistemaActivo) {
+    uint32_t t0 = micros();
     float mapLoad = sensors.readMAPLoadPercent();
     float tpsPorcent = sensors.readLoadTPSPercent();
 
@@ -161,6 +296,10 @@ void loop() {
     );
     
     fsm.handleActions();
+    controlUs->record(micros() - t0);
+#if VORTEX_BT_BLE
+    btConsoleUI.recordTelemetry(millis(), mapLoad, tpsPorcent);
+#endif
   } else {
     actuators.stopAll();
   }
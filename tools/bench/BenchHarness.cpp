@@ -0,0 +1,229 @@
+#include "BenchHarness.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+/*
+ * Runner de la suite.
+ *
+ *   vortex_bench [--filter=TEXTO] [--min-time=SEG] [--repetitions=N]
+ *                [--out=resultados.json] [--baseline=baseline.json] [--tolerance=0.25]
+ *
+ * Con --baseline compara cada benchmark contra la línea base y termina con
+ * código 1 si alguno es más lento que base * (1 + tolerance).
+ */
+namespace bench {
+
+namespace {
+
+struct Registered {
+  const char* name;
+  Function fn;
+};
+
+struct Result {
+  std::string name;
+  uint64_t iterations;
+  double nsPerIter;
+};
+
+std::vector<Registered>& registry() {
+  static std::vector<Registered> list;
+  return list;
+}
+
+int64_t nowNs() {
+  using namespace std::chrono;
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+double measure(Function fn, uint64_t iterations) {
+  State st(iterations);
+  fn(st);
+  return st.elapsedNs();
+}
+
+Result run(const Registered& b, double minTimeS, int repetitions) {
+  // Ajuste de iteraciones: crecer hasta que una corrida dure al menos minTime
+  const double minNs = minTimeS * 1e9;
+  uint64_t n = 1;
+  double elapsed = measure(b.fn, n);
+  while (elapsed < minNs && n < (1ull << 40)) {
+    double factor = elapsed > 0 ? (minNs * 1.2) / elapsed : 100.0;
+    factor = std::min(std::max(factor, 2.0), 100.0);
+    n = static_cast<uint64_t>(n * factor);
+    elapsed = measure(b.fn, n);
+  }
+
+  std::vector<double> samples;
+  samples.push_back(elapsed / n);
+  for (int r = 1; r < repetitions; ++r) {
+    samples.push_back(measure(b.fn, n) / n);
+  }
+  std::sort(samples.begin(), samples.end());
+  return Result{b.name, n, samples[samples.size() / 2]};
+}
+
+const char* baseName(const char* path) {
+  const char* slash = strrchr(path, '/');
+  return slash ? slash + 1 : path;
+}
+
+std::string toJson(const std::vector<Result>& results, const char* executable) {
+  std::ostringstream os;
+  os << "{\n  \"context\": {\n"
+     << "    \"executable\": \"" << baseName(executable) << "\",\n"
+#ifdef NDEBUG
+     << "    \"build\": \"release\",\n"
+#else
+     << "    \"build\": \"debug\",\n"
+#endif
+     << "    \"compiler\": \"" << __VERSION__ << "\"\n"
+     << "  },\n  \"benchmarks\": [\n";
+  for (size_t i = 0; i < results.size(); ++i) {
+    char line[256];
+    snprintf(line, sizeof(line),
+             "    {\"name\": \"%s\", \"iterations\": %llu, \"real_time\": %.3f, \"time_unit\": \"ns\"}%s\n",
+             results[i].name.c_str(), (unsigned long long)results[i].iterations,
+             results[i].nsPerIter, i + 1 < results.size() ? "," : "");
+    os << line;
+  }
+  os << "  ]\n}\n";
+  return os.str();
+}
+
+// Lector mínimo para el JSON que escribe toJson(): pares name / real_time
+bool loadBaseline(const std::string& path, std::vector<Result>& out) {
+  std::ifstream in(path);
+  if (!in) return false;
+  std::stringstream buf;
+  buf << in.rdbuf();
+  const std::string text = buf.str();
+
+  size_t pos = 0;
+  while ((pos = text.find("\"name\"", pos)) != std::string::npos) {
+    size_t q1 = text.find('"', text.find(':', pos) + 1);
+    size_t q2 = text.find('"', q1 + 1);
+    size_t rt = text.find("\"real_time\"", q2);
+    if (q1 == std::string::npos || q2 == std::string::npos || rt == std::string::npos) break;
+    size_t colon = text.find(':', rt);
+    Result r;
+    r.name = text.substr(q1 + 1, q2 - q1 - 1);
+    r.iterations = 0;
+    r.nsPerIter = strtod(text.c_str() + colon + 1, nullptr);
+    out.push_back(r);
+    pos = colon;
+  }
+  return true;
+}
+
+const char* argValue(const char* arg, const char* key) {
+  size_t n = strlen(key);
+  return strncmp(arg, key, n) == 0 ? arg + n : nullptr;
+}
+
+}  // namespace
+
+void State::startTiming() {
+  if (running) return;
+  running = true;
+  startNs = nowNs();
+}
+
+void State::stopTiming() {
+  if (!running) return;
+  accumulatedNs += static_cast<double>(nowNs() - startNs);
+  running = false;
+}
+
+int registerBenchmark(const char* name, Function fn) {
+  registry().push_back(Registered{name, fn});
+  return static_cast<int>(registry().size());
+}
+
+}  // namespace bench
+
+int main(int argc, char** argv) {
+  using namespace bench;
+
+  const char* filter = nullptr;
+  const char* outPath = nullptr;
+  const char* baselinePath = nullptr;
+  double minTime = 0.2;
+  double tolerance = 0.25;
+  int repetitions = 5;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* v;
+    if ((v = argValue(argv[i], "--filter="))) filter = v;
+    else if ((v = argValue(argv[i], "--out="))) outPath = v;
+    else if ((v = argValue(argv[i], "--baseline="))) baselinePath = v;
+    else if ((v = argValue(argv[i], "--min-time="))) minTime = atof(v);
+    else if ((v = argValue(argv[i], "--tolerance="))) tolerance = atof(v);
+    else if ((v = argValue(argv[i], "--repetitions="))) repetitions = std::max(1, atoi(v));
+    else {
+      fprintf(stderr, "Opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  std::vector<Registered> selected;
+  for (const Registered& b : registry()) {
+    if (!filter || strstr(b.name, filter)) selected.push_back(b);
+  }
+  std::sort(selected.begin(), selected.end(),
+            [](const Registered& a, const Registered& b) { return strcmp(a.name, b.name) < 0; });
+
+  std::vector<Result> baseline;
+  if (baselinePath && !loadBaseline(baselinePath, baseline)) {
+    fprintf(stderr, "No se pudo leer la línea base %s\n", baselinePath);
+    return 2;
+  }
+
+  printf("%-32s %14s %14s %12s\n", "Benchmark", "ns/iter", "iteraciones", baselinePath ? "vs base" : "");
+  std::vector<Result> results;
+  int regressions = 0;
+  for (const Registered& b : selected) {
+    Result r = run(b, minTime, repetitions);
+    results.push_back(r);
+
+    char verdict[40] = "";
+    if (baselinePath) {
+      auto it = std::find_if(baseline.begin(), baseline.end(),
+                             [&](const Result& x) { return x.name == r.name; });
+      if (it == baseline.end() || it->nsPerIter <= 0) {
+        snprintf(verdict, sizeof(verdict), "nuevo");
+      } else {
+        double ratio = r.nsPerIter / it->nsPerIter;
+        bool regressed = ratio > 1.0 + tolerance;
+        regressions += regressed;
+        snprintf(verdict, sizeof(verdict), "%+6.1f%%%s", (ratio - 1.0) * 100.0,
+                 regressed ? "  REGRESIÓN" : "");
+      }
+    }
+    printf("%-32s %14.2f %14llu %12s\n", r.name.c_str(), r.nsPerIter,
+           (unsigned long long)r.iterations, verdict);
+    fflush(stdout);
+  }
+
+  if (outPath) {
+    std::ofstream out(outPath);
+    out << toJson(results, argv[0]);
+    if (!out) {
+      fprintf(stderr, "No se pudo escribir %s\n", outPath);
+      return 2;
+    }
+  }
+
+  if (baselinePath) {
+    printf("\n%d regresión(es) por encima de %.0f%%\n", regressions, tolerance * 100.0);
+  }
+  return regressions ? 1 : 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Arnés mínimo de micro-benchmarks al estilo Google Benchmark, sin
+ * dependencias externas:
+ *
+ *   static void BM_Algo(bench::State& st) {
+ *     for (auto _ : st) { bench::doNotOptimize(algo()); }
+ *   }
+ *   BENCHMARK(BM_Algo);
+ *
+ * El runner (BenchHarness.cpp) ajusta las iteraciones, repite la medida,
+ * informa la mediana en ns/iteración y puede escribir JSON y compararlo
+ * contra una línea base.
+ */
+namespace bench {
+
+class State {
+public:
+  explicit State(uint64_t iterations) : total(iterations) {}
+
+  /// Valor del "for (auto _ : st)"; marcado unused para no disparar -Wunused-variable
+  struct __attribute__((unused)) Value {};
+
+  struct Iterator {
+    State* st;
+    uint64_t left;
+    bool operator!=(const Iterator&) {
+      if (left != 0) return true;
+      st->stopTiming();
+      return false;
+    }
+    void operator++() { --left; }
+    Value operator*() const { return Value(); }
+  };
+
+  Iterator begin() {
+    startTiming();
+    return Iterator{this, total};
+  }
+  Iterator end() { return Iterator{this, 0}; }
+
+  uint64_t iterations() const { return total; }
+
+  /// Excluir trabajo de preparación o limpieza dentro del lazo
+  void pauseTiming() { stopTiming(); }
+  void resumeTiming() { startTiming(); }
+
+  double elapsedNs() const { return accumulatedNs; }
+
+private:
+  void startTiming();
+  void stopTiming();
+
+  uint64_t total;
+  int64_t startNs = 0;
+  bool running = false;
+  double accumulatedNs = 0.0;
+};
+
+typedef void (*Function)(State&);
+
+int registerBenchmark(const char* name, Function fn);
+
+/// Impide que el compilador descarte un resultado
+template <typename T>
+inline void doNotOptimize(T const& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+  asm volatile("" : : : "memory");
+}
+
+}  // namespace bench
+
+#define BENCHMARK(fn) static int bench_registered_##fn = ::bench::registerBenchmark(#fn, fn)
@@ -0,0 +1,64 @@
+// Protocolo BLE: armado de tramas de telemetría y decodificación en ambos sentidos
+#include "BenchHarness.h"
+#include "BleProtocol.h"
+
+static TelemetrySample sampleAt(uint32_t i) {
+  TelemetrySample s;
+  s.tMs = i * 20;
+  s.state = static_cast<uint8_t>(i % 7);
+  s.flags = TELEMETRY_FLAG_CALIB | (i & 1 ? TELEMETRY_FLAG_ACOUSTIC : 0);
+  s.tpsCenti = telemetryCenti((i % 100) * 1.01f);
+  s.mapCenti = telemetryCenti((i % 80) * 1.1f);
+  s.freqHz = static_cast<uint16_t>(4200 + i % 2200);
+  s.level = static_cast<uint8_t>(i);
+  return s;
+}
+
+// Una muestra por iteración, con el MTU de 247: cada 19 muestras sale una trama
+static void BM_BleBatchSample(bench::State& st) {
+  TelemetryBatcher batcher;
+  batcher.setPayloadLimit(BLE_MAX_PAYLOAD);
+  uint32_t i = 0;
+  size_t sent = 0;
+  for (auto _ : st) {
+    TelemetrySample s = sampleAt(i++);
+    if (!batcher.fits(s)) {
+      sent += batcher.size();
+      batcher.reset();
+    }
+    batcher.add(s);
+  }
+  bench::doNotOptimize(sent);
+}
+BENCHMARK(BM_BleBatchSample);
+
+// Trama completa de 19 muestras, lado cliente
+static void BM_BleDecodeFrame(bench::State& st) {
+  TelemetryBatcher batcher;
+  batcher.setPayloadLimit(BLE_MAX_PAYLOAD);
+  for (uint32_t i = 0; batcher.fits(sampleAt(i)); ++i) batcher.add(sampleAt(i));
+
+  TelemetrySample out[32];
+  TelemetryFrameInfo info;
+  for (auto _ : st) {
+    bench::doNotOptimize(decodeTelemetry(batcher.data(), batcher.size(), info, out, 32));
+  }
+  bench::doNotOptimize(out[0].tMs);
+}
+BENCHMARK(BM_BleDecodeFrame);
+
+static void BM_BleDecodeControl(bench::State& st) {
+  ControlCommand cmd;
+  cmd.op = BleOp::SET_VALUE;
+  cmd.index = 1;
+  cmd.value = 12.5f;
+  uint8_t frame[BLE_MAX_CONTROL];
+  size_t len = encodeControl(cmd, frame);
+
+  ControlCommand decoded;
+  for (auto _ : st) {
+    bench::doNotOptimize(decodeControl(frame, len, decoded));
+  }
+  bench::doNotOptimize(decoded.value);
+}
+BENCHMARK(BM_BleDecodeControl);
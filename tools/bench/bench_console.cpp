@@ -0,0 +1,136 @@
+// Consola: armado y parseo de líneas, despacho, HUD y buffer de salida
+#include "BenchHarness.h"
+#include "ByteRing.h"
+#include "CommandParser.h"
+#include "CommandRegistry.h"
+#include "DashboardModel.h"
+#include <string.h>
+
+static const char SIM_FEED[] = "tps_raw:1234,map_raw:3900\n";
+
+static void BM_ConsoleParseSimFeed(bench::State& st) {
+  LineAssembler line;
+  long tps = 0, map = 0;
+  for (auto _ : st) {
+    for (const char* p = SIM_FEED; *p; ++p) {
+      if (line.push(*p)) {
+        CommandArgs args;
+        tokenizeCommand(line.data(), args);
+        args.getInt("tps_raw", tps);
+        args.getInt("map_raw", map);
+        line.reset();
+      }
+    }
+  }
+  bench::doNotOptimize(tps + map);
+}
+BENCHMARK(BM_ConsoleParseSimFeed);
+
+namespace {
+
+struct FakeConsole {
+  const char* name = "fake";  // Tamaño similar a un objeto real (evita un falso -Warray-bounds de GCC)
+  uint32_t hits = 0;
+  void handle(const CommandArgs&) { hits++; }
+};
+
+using FakeRegistry = CommandRegistry<FakeConsole>;
+
+// Mismo tamaño que la tabla de ConsoleUI; el comando buscado va al final
+const FakeRegistry::Command FAKE_COMMANDS[] = {
+  { "a", "", "", &FakeConsole::handle, false }, { "c", "", "", &FakeConsole::handle, false },
+  { "m", "", "", &FakeConsole::handle, false }, { "s", "", "", &FakeConsole::handle, false },
+  { "d", "", "", &FakeConsole::handle, false }, { "n", "", "", &FakeConsole::handle, false },
+  { "b", "", "", &FakeConsole::handle, true  }, { "i", "", "", &FakeConsole::handle, true  },
+  { "t", "", "", &FakeConsole::handle, true  }, { "u", "", "", &FakeConsole::handle, true  },
+  { "x", "", "", &FakeConsole::handle, true  }, { "v", "", "", &FakeConsole::handle, true  },
+  { "r", "", "", &FakeConsole::handle, true  }, { "z", "", "", &FakeConsole::handle, true  },
+  { "k", "", "", &FakeConsole::handle, true  }, { "o", "", "", &FakeConsole::handle, true  },
+  { "perf", "", "", &FakeConsole::handle, false }, { "tlm", "", nullptr, &FakeConsole::handle, false },
+  { "tps", "", nullptr, &FakeConsole::handle, false }, { "map", "", nullptr, &FakeConsole::handle, false },
+  { "vortex", "", nullptr, &FakeConsole::handle, false }, { "iny", "", nullptr, &FakeConsole::handle, false },
+  { "tps_raw", "", nullptr, &FakeConsole::handle, false },
+};
+
+const FakeRegistry FAKE_REGISTRY(FAKE_COMMANDS);
+
+}  // namespace
+
+static void BM_ConsoleDispatch(bench::State& st) {
+  FakeConsole console;
+  char buf[sizeof(SIM_FEED)];
+  for (auto _ : st) {
+    memcpy(buf, SIM_FEED, sizeof(SIM_FEED) - 1);
+    buf[sizeof(SIM_FEED) - 2] = '\0';
+    CommandArgs args;
+    tokenizeCommand(buf, args);
+    FAKE_REGISTRY.dispatch(console, args, false);
+  }
+  bench::doNotOptimize(console.hits);
+}
+BENCHMARK(BM_ConsoleDispatch);
+
+static DashboardSnapshot steadySnapshot() {
+  DashboardSnapshot s;
+  s.state = "IDLE";
+  s.elapsedS = 12;
+  s.tpsV = 0.61f; s.tpsMinV = 0.50f; s.tpsMaxV = 4.20f;
+  s.mapV = 1.10f; s.mapMinV = 0.90f; s.mapMaxV = 3.10f;
+  s.dac = 128; s.level = 0.0f; s.freq = 0.0f;
+  s.boost = false; s.beam = false;
+  return s;
+}
+
+// Nada cambió: el caso más frecuente en ralentí
+static void BM_DashboardRenderSteady(bench::State& st) {
+  DashboardModel hud;
+  DashboardSnapshot s = steadySnapshot();
+  char out[DashboardModel::LINE_CAPACITY];
+  uint32_t now = 0;
+  hud.render(s, now, out, sizeof(out));
+  for (auto _ : st) {
+    now += 100;
+    bench::doNotOptimize(hud.render(s, now, out, sizeof(out)));
+  }
+}
+BENCHMARK(BM_DashboardRenderSteady);
+
+// Transitorio: TPS, MAP, DAC y nivel cambian en cada tick
+static void BM_DashboardRenderTransient(bench::State& st) {
+  DashboardModel hud;
+  DashboardSnapshot s = steadySnapshot();
+  char out[DashboardModel::LINE_CAPACITY];
+  uint32_t now = 0;
+  for (auto _ : st) {
+    now += 250;
+    s.tpsV = 0.5f + (now % 3000) * 0.001f;
+    s.mapV = 0.9f + (now % 2000) * 0.001f;
+    s.dac = static_cast<uint8_t>(now);
+    s.level = (now % 1000) * 0.001f;
+    bench::doNotOptimize(hud.render(s, now, out, sizeof(out)));
+  }
+}
+BENCHMARK(BM_DashboardRenderTransient);
+
+static void BM_DashboardRenderFull(bench::State& st) {
+  DashboardModel hud;
+  DashboardSnapshot s = steadySnapshot();
+  char out[DashboardModel::LINE_CAPACITY];
+  for (auto _ : st) {
+    hud.invalidate();
+    bench::doNotOptimize(hud.render(s, 0, out, sizeof(out)));
+  }
+}
+BENCHMARK(BM_DashboardRenderFull);
+
+static void BM_ConsoleRingWriteRead(bench::State& st) {
+  static uint8_t storage[2048];
+  ByteRing ring(storage, sizeof(storage));
+  const uint8_t line[64] = {};
+  uint8_t sink[64];
+  for (auto _ : st) {
+    ring.write(line, sizeof(line));
+    bench::doNotOptimize(ring.read(sink, sizeof(sink)));
+  }
+}
+BENCHMARK(BM_ConsoleRingWriteRead);
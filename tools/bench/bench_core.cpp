@@ -0,0 +1,101 @@
+// Lazo de control: umbrales y StateMachine::update
+#include "BenchHarness.h"
+#include "ConfigStore.h"
+#include "DebugManager.h"
+#include "FileStorageBackend.h"
+#include "StateMachine.h"
+#include "ThresholdManager.h"
+#include <atomic>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+// Actuadores de mentira: solo recuerdan el estado
+class NullActuators : public ActuatorControl {
+public:
+  void update() override {}
+  void startVortex() override { vortex = true; }
+  void stopVortex() override { vortex = false; }
+  void startAcoustic(float) override { acoustic = true; }
+  void stopAcoustic() override { acoustic = false; }
+  void setAcousticParameters(float, float, const AcousticModulation&) override {}
+  bool isAcousticOn() const override { return acoustic; }
+  void setActuationMap(const ActuationMap&) override {}
+
+  bool vortex = false;
+  bool acoustic = false;
+};
+
+// ConfigStore sobre un archivo temporal, una sola vez para toda la suite
+ThresholdManager& thresholdManager() {
+  static FileStorageBackend backend("/tmp/vortex_bench_config_" + std::to_string(getpid()) + ".bin");
+  static ThresholdManager manager;
+  static bool ready = false;
+  if (!ready) {
+    backend.erase();
+    ConfigStore::getInstance().begin(&backend);
+    manager.begin();
+    ready = true;
+  }
+  return manager;
+}
+
+}  // namespace
+
+static void BM_ThresholdFetch(bench::State& st) {
+  ThresholdManager& manager = thresholdManager();
+  for (auto _ : st) {
+    bench::doNotOptimize(manager.getThresholds());
+  }
+}
+BENCHMARK(BM_ThresholdFetch);
+
+// Ciclo de carga que recorre IDLE → INYECCION → VORTEX → DESCAYENDO y vuelta
+static void BM_StateMachineUpdate(bench::State& st) {
+  NullActuators actuators;
+  DebugManager debug;
+  StateMachine fsm;
+  fsm.begin(true, &actuators, &thresholdManager());
+
+  uint32_t step = 0;
+  for (auto _ : st) {
+    uint32_t phase = step++ % 400;
+    float load = phase < 200 ? phase * 0.5f : (400 - phase) * 0.5f;
+    fsm.update(load, load, false, false, true, debug);
+    fsm.handleActions();
+  }
+  bench::doNotOptimize(fsm.getState());
+}
+BENCHMARK(BM_StateMachineUpdate);
+
+// Lado del loop mientras la consola alterna perfiles sin parar; que cada
+// cambio deje un perfil completo lo comprueba tools/test (ThresholdManager)
+static void BM_ProfileSwitch(bench::State& st) {
+  thresholdManager();  // ConfigStore montado para selectProfile()
+  ThresholdManager manager;
+  int other = manager.createProfile("bench");
+
+  std::atomic<bool> stop{false};
+  std::thread console([&]() {
+    uint8_t next = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+      manager.selectProfile(next);
+      next = next ? 0 : static_cast<uint8_t>(other);
+    }
+  });
+
+  const TuningProfile* profile = &manager.active();
+  uint32_t switches = 0;
+  for (auto _ : st) {
+    if (manager.applyPending()) {
+      profile = &manager.active();
+      switches++;
+    }
+    bench::doNotOptimize(profile->thresholds.INJ_TPS_ON);
+  }
+  stop = true;
+  console.join();
+  bench::doNotOptimize(switches);
+}
+BENCHMARK(BM_ProfileSwitch);
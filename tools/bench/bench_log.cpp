@@ -0,0 +1,75 @@
+// Costo de una llamada de log en el lado productor (solo encolar).
+// Se drena fuera del tiempo medido cada Logger::CAPACITY llamadas, así
+// siempre se mide el camino de encolado y no el descarte por cola llena.
+#include "BenchHarness.h"
+#include "Logger.h"
+#include <stdio.h>
+
+static void nullSink(const char*, size_t) {}
+
+template <typename Fn>
+static void runLogBench(bench::State& st, Fn fn) {
+  Logger& log = Logger::getInstance();
+  log.drain(nullSink, Logger::CAPACITY);
+  uint32_t i = 0;
+  for (auto _ : st) {
+    fn(i);
+    if (++i % Logger::CAPACITY == 0) {
+      st.pauseTiming();
+      log.drain(nullSink, Logger::CAPACITY);
+      st.resumeTiming();
+    }
+  }
+  log.drain(nullSink, Logger::CAPACITY);
+}
+
+static void BM_LogNoArgs(bench::State& st) {
+  runLogBench(st, [](uint32_t) { LOG_I("→ Transición: IDLE → INYECCION_ACUSTICA"); });
+}
+BENCHMARK(BM_LogNoArgs);
+
+static void BM_LogTwoArgs(bench::State& st) {
+  runLogBench(st, [](uint32_t i) { LOG_I(">> Estado forzado a: %d (%s)", int(i), "DEBUG"); });
+}
+BENCHMARK(BM_LogTwoArgs);
+
+static void BM_LogSevenArgs(bench::State& st) {
+  runLogBench(st, [](uint32_t i) {
+    float v = i * 0.01f;
+    LOG_I("\rTPS=%.2fV [%.2f ⇄ %.2f] | MAP=%.2fV [%.2f ⇄ %.2f] | Q=%3.0f%%   ",
+          v, 0.5f, 4.2f, v + 1.0f, 0.9f, 3.1f, 87.0f);
+  });
+}
+BENCHMARK(BM_LogSevenArgs);
+
+// Referencia: formatear en el momento, como hacía Serial.printf
+static void BM_LogEagerSnprintf(bench::State& st) {
+  char buf[Logger::LINE_MAX];
+  uint32_t i = 0;
+  for (auto _ : st) {
+    float v = (i++) * 0.01f;
+    snprintf(buf, sizeof(buf), "\rTPS=%.2fV [%.2f ⇄ %.2f] | MAP=%.2fV [%.2f ⇄ %.2f] | Q=%3.0f%%   ",
+             v, 0.5f, 4.2f, v + 1.0f, 0.9f, 3.1f, 87.0f);
+    bench::doNotOptimize(buf);
+  }
+}
+BENCHMARK(BM_LogEagerSnprintf);
+
+// Lado consumidor: formatear un registro ya encolado
+static void BM_LogFormatRecord(bench::State& st) {
+  Logger::Record rec;
+  const LogArg args[] = { toLogArg(1.25f), toLogArg(0.5f), toLogArg(4.2f), toLogArg(87) };
+  rec.fmt = "TPS=%.2fV [%.2f ⇄ %.2f] Q=%d%%";
+  rec.timestampMs = 123456;
+  rec.level = VORTEX_LOG_INFO;
+  rec.argc = 4;
+  for (uint8_t i = 0; i < rec.argc; ++i) {
+    rec.types[i] = args[i].type;
+    rec.values[i] = args[i].v;
+  }
+  char out[Logger::LINE_MAX];
+  for (auto _ : st) {
+    bench::doNotOptimize(Logger::format(rec, out, sizeof(out)));
+  }
+}
+BENCHMARK(BM_LogFormatRecord);
@@ -0,0 +1,51 @@
+// Costo por actualización de métricas; fetch_add atómico como referencia
+// de lo que costaría un contador con varios escritores.
+#include "BenchHarness.h"
+#include "Metrics.h"
+#include <atomic>
+
+static void BM_MetricsCounterInc(bench::State& st) {
+  Counter& counter = MetricsRegistry::getInstance().counter("bench.counter");
+  for (auto _ : st) {
+    counter.inc();
+  }
+  bench::doNotOptimize(counter.get());
+}
+BENCHMARK(BM_MetricsCounterInc);
+
+static void BM_MetricsGaugeSet(bench::State& st) {
+  Gauge& gauge = MetricsRegistry::getInstance().gauge("bench.gauge");
+  int32_t v = 0;
+  for (auto _ : st) {
+    gauge.set(v++);
+  }
+  bench::doNotOptimize(gauge.get());
+}
+BENCHMARK(BM_MetricsGaugeSet);
+
+static void BM_MetricsHistogramRecord(bench::State& st) {
+  Histogram& histogram = MetricsRegistry::getInstance().histogram("bench.hist_us");
+  uint32_t v = 0;
+  for (auto _ : st) {
+    histogram.record((v++) & 0x3FF);
+  }
+  bench::doNotOptimize(histogram.getCount());
+}
+BENCHMARK(BM_MetricsHistogramRecord);
+
+static void BM_MetricsAtomicFetchAdd(bench::State& st) {
+  std::atomic<uint32_t> shared{0};
+  for (auto _ : st) {
+    shared.fetch_add(1, std::memory_order_relaxed);
+  }
+  bench::doNotOptimize(shared.load());
+}
+BENCHMARK(BM_MetricsAtomicFetchAdd);
+
+static void BM_MetricsTelemetryRecord(bench::State& st) {
+  char out[512];
+  for (auto _ : st) {
+    bench::doNotOptimize(MetricsRegistry::getInstance().writeTelemetry(1000, out, sizeof(out)));
+  }
+}
+BENCHMARK(BM_MetricsTelemetryRecord);
@@ -0,0 +1,136 @@
+// Conversión de sensores y calibración/deriva por muestra
+#include "BenchHarness.h"
+#include "CalibrationEngine.h"
+#include "DriftCompensator.h"
+#include "FixedFft.h"
+#include "GoertzelDetector.h"
+#include "SensorMath.h"
+#include "SpectrumAnalyzer.h"
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+static void BM_SensorRawToPercent(bench::State& st) {
+  uint16_t raw = 0;
+  float acc = 0.0f;
+  for (auto _ : st) {
+    acc += rawToPercent(raw, 420, 3780);
+    raw = (raw + 37) & 0x0FFF;
+  }
+  bench::doNotOptimize(acc);
+}
+BENCHMARK(BM_SensorRawToPercent);
+
+static void BM_SensorRawToVolts(bench::State& st) {
+  uint16_t raw = 0;
+  float acc = 0.0f;
+  for (auto _ : st) {
+    acc += rawToVolts(raw);
+    raw = (raw + 37) & 0x0FFF;
+  }
+  bench::doNotOptimize(acc);
+}
+BENCHMARK(BM_SensorRawToVolts);
+
+static void BM_CalibrationAddSample(bench::State& st) {
+  static CalibrationEngine engine;
+  engine.reset();
+  uint16_t tps = 400, map = 3900;
+  for (auto _ : st) {
+    engine.addSample(tps, map);
+    tps = 400 + ((tps + 13) % 3000);
+    map = 900 + ((map + 7) % 3000);
+  }
+}
+BENCHMARK(BM_CalibrationAddSample);
+
+static void BM_CalibrationEvaluate(bench::State& st) {
+  static CalibrationEngine engine;
+  engine.reset();
+  for (uint32_t i = 0; i < 4000; ++i) {
+    engine.addSample(400 + (i * 13) % 3000, 900 + (i * 7) % 3000);
+  }
+  for (auto _ : st) {
+    bench::doNotOptimize(engine.evaluate());
+  }
+}
+BENCHMARK(BM_CalibrationEvaluate);
+
+static void BM_DriftUpdate(bench::State& st) {
+  CalibrationData calib;
+  calib.tpsMin = calib.tpsMinRef = 420;
+  calib.tpsMax = calib.tpsMaxRef = 3780;
+  calib.mapMin = calib.mapMinRef = 900;
+  calib.mapMax = calib.mapMaxRef = 3900;
+  calib.valid = 1;
+  DriftCompensator drift;
+  drift.begin(calib);
+
+  uint32_t nowMs = 0;
+  uint16_t tps = 421;
+  for (auto _ : st) {
+    bench::doNotOptimize(drift.update(tps, 3901, nowMs));
+    nowMs += 10;
+    tps = (nowMs / 5000) % 2 ? 3779 : 421;
+  }
+}
+BENCHMARK(BM_DriftUpdate);
+
+// Coste por muestra del ADC: una multiplicación y dos sumas más la energía
+static void BM_GoertzelPush(bench::State& st) {
+  GoertzelDetector det;
+  det.tune(5000.0f, 40000.0f, 400);
+  // Tono de 5 kHz a 40 kHz sobre la continua, con ruido de unas cuentas
+  float samples[1024];
+  uint32_t seed = 1;
+  for (uint16_t i = 0; i < 1024; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    samples[i] = floorf(2048.0f + 200.0f * sinf(2.0f * static_cast<float>(M_PI) * i / 8.0f) +
+                        static_cast<float>(seed >> 28) - 8.0f);
+  }
+  uint32_t n = 0, windows = 0;
+  for (auto _ : st) {
+    if (det.push(samples[n++ & 1023])) windows++;
+  }
+  bench::doNotOptimize(windows);
+}
+BENCHMARK(BM_GoertzelPush);
+
+// FFT Q15 sobre ruido blanco a media escala, por tamaño
+template <uint16_t N>
+static void fftBench(bench::State& st) {
+  static int16_t source[N], re[N], im[N];
+  uint32_t seed = 99;
+  for (uint16_t i = 0; i < N; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    source[i] = static_cast<int16_t>(static_cast<int32_t>(seed >> 16) - 32768) / 2;
+  }
+  for (auto _ : st) {
+    memcpy(re, source, sizeof(re));
+    memset(im, 0, sizeof(im));
+    fftQ15(re, im, N);
+    bench::doNotOptimize(re[1]);
+  }
+}
+
+static void BM_FftQ15_256(bench::State& st) { fftBench<256>(st); }
+static void BM_FftQ15_512(bench::State& st) { fftBench<512>(st); }
+static void BM_FftQ15_1024(bench::State& st) { fftBench<1024>(st); }
+static void BM_FftQ15_2048(bench::State& st) { fftBench<2048>(st); }
+BENCHMARK(BM_FftQ15_256);
+BENCHMARK(BM_FftQ15_512);
+BENCHMARK(BM_FftQ15_1024);
+BENCHMARK(BM_FftQ15_2048);
+
+// Un bloque completo como en la tarea del monitor: continua, Hann, FFT y media
+static void BM_SpectrumProcess2048(bench::State& st) {
+  SpectrumAnalyzer sa;
+  sa.configure(2048, 38871.0f, 8);
+  std::vector<int16_t> source(2048);
+  for (uint16_t i = 0; i < 2048; ++i) source[i] = static_cast<int16_t>(8000.0 * sin(i * 0.8));
+  for (auto _ : st) {
+    memcpy(sa.input(), source.data(), 2048 * sizeof(int16_t));
+    bench::doNotOptimize(sa.process());
+  }
+}
+BENCHMARK(BM_SpectrumProcess2048);
@@ -0,0 +1,259 @@
+// Camino por muestra de la ISR del inyector acústico (AcousticInjector::onTimer),
+// comparado con el anterior, y su reajuste desde el lazo de control (ActuatorManager::setAcousticParameters)
+#include "AcousticEq.h"
+#include "AdditiveSynth.h"
+#include "BenchHarness.h"
+#include "SynthKernel.h"
+#include "SynthTuningTable.h"
+#include "TweeterThermal.h"
+#include "Metrics.h"
+#include <string.h>
+
+// Camino anterior de onTimer(): estado detrás de _instance, índice con
+// módulo, saturación y dac_output_voltage(). El driver se modela con su
+// cuerpo en IDF 3.3: validar el canal y tres lectura-escritura de registros.
+struct LegacyInjector {
+  uint8_t index = 0;
+  volatile uint8_t levelInt = 200;
+  uint8_t lastDAC = 128;
+  uint8_t channel = 0;
+  Counter ticks;
+};
+
+static LegacyInjector* legacyInstance;
+static volatile uint32_t toneReg, cwReg, padReg;
+
+static __attribute__((noinline)) int dacOutputVoltageModel(uint8_t channel, uint8_t value) {
+  if (channel > 1) return -1;
+  toneReg = toneReg & ~(1u << 16);
+  cwReg = cwReg & ~(1u << (24 + channel));
+  padReg = (padReg & ~(0xFFu << SYNTH_DAC_SHIFT)) | ((uint32_t)value << SYNTH_DAC_SHIFT);
+  return 0;
+}
+
+static void BM_SynthIsrLegacy(bench::State& st) {
+  LegacyInjector inj;
+  legacyInstance = &inj;
+  for (auto _ : st) {
+    if (!legacyInstance) continue;
+    int16_t delta = (int16_t)SYNTH_SINE_TABLE[legacyInstance->index] - 128;
+    int16_t modulated = 128 + ((delta * legacyInstance->levelInt) >> 8);
+    if (modulated < 0) modulated = 0;
+    if (modulated > 255) modulated = 255;
+    dacOutputVoltageModel(legacyInstance->channel, (uint8_t)modulated);
+    legacyInstance->lastDAC = (uint8_t)modulated;
+    legacyInstance->index = synthNextIndex(legacyInstance->index, SYNTH_TABLE_SIZE);
+    legacyInstance->ticks.inc();
+  }
+  bench::doNotOptimize(inj.lastDAC);
+}
+BENCHMARK(BM_SynthIsrLegacy);
+
+// ISR actual: un único estado, índice con máscara y escritura directa al registro
+static SynthIsrState isrState;
+static volatile uint32_t dacRegister;
+
+static void BM_SynthIsrSample(bench::State& st) {
+  SynthIsrState& s = isrState;
+  memcpy(s.table, SYNTH_SINE_TABLE, sizeof(s.table));
+  s.dacReg = &dacRegister;
+  s.levelInt = 200;
+  for (auto _ : st) {
+    synthDacWrite(s.dacReg, synthIsrStep(s));
+  }
+  bench::doNotOptimize(s.lastDAC);
+}
+BENCHMARK(BM_SynthIsrSample);
+
+// Con el conformado de ruido activo: el mismo código, el resto ya no se descarta
+static void BM_SynthIsrSampleShaped(bench::State& st) {
+  SynthIsrState& s = isrState;
+  memcpy(s.table, SYNTH_SINE_TABLE, sizeof(s.table));
+  s.dacReg = &dacRegister;
+  s.levelInt = 13;  // ~5 %: donde el conformado importa
+  s.shapeMask = 0xFF;
+  for (auto _ : st) {
+    synthDacWrite(s.dacReg, synthIsrStep(s));
+  }
+  s.shapeMask = 0;
+  bench::doNotOptimize(s.lastDAC);
+}
+BENCHMARK(BM_SynthIsrSampleShaped);
+
+// Nivel cambiando en cada muestra (rampa de update() concurrente)
+static void BM_SynthIsrSampleLevelRamp(bench::State& st) {
+  SynthIsrState& s = isrState;
+  memcpy(s.table, SYNTH_SINE_TABLE, sizeof(s.table));
+  s.dacReg = &dacRegister;
+  uint32_t n = 0;
+  for (auto _ : st) {
+    s.levelInt = static_cast<uint8_t>(n++);
+    synthDacWrite(s.dacReg, synthIsrStep(s));
+  }
+}
+BENCHMARK(BM_SynthIsrSampleLevelRamp);
+
+// Estéreo: los dos canales desde el mismo índice, el segundo desfasado
+static volatile uint32_t dac2Register;
+
+static void BM_SynthStereoStep(bench::State& st) {
+  SynthIsrState& s = isrState;
+  memcpy(s.table, SYNTH_SINE_TABLE, sizeof(s.table));
+  s.dacReg = &dacRegister;
+  s.dac2Reg = &dac2Register;
+  s.levelInt = 200;
+  s.levelInt2 = 150;
+  s.phaseOffset = synthPhaseFromDegrees(100.0f);
+  for (auto _ : st) {
+    SynthFrame f = synthStereoStep(s);
+    synthDacWrite(s.dacReg, f.dac1);
+    synthDacWrite(s.dac2Reg, f.dac2);
+  }
+  s.dac2Reg = nullptr;
+  bench::doNotOptimize(s.lastDAC2);
+}
+BENCHMARK(BM_SynthStereoStep);
+
+// Aditiva: coste por muestra según el número de osciladores
+template <uint8_t N>
+static void additiveBench(bench::State& st) {
+  static AdditiveState<N> s;
+  uint8_t levels[N];
+  additiveFillTable(s.table);
+  for (uint8_t i = 0; i < N; ++i) {
+    levels[i] = 200 / N;
+    s.osc[i].level = levels[i];
+    s.osc[i].phase = additivePhase(90.0f);
+    s.osc[i].increment = additiveIncrement(i == 0 ? 5300.0f : HELMHOLTZ_HZ * (i + 1));
+  }
+  s.gain = additiveGain(levels, N, 255);
+  for (auto _ : st) {
+    synthDacWrite(&dacRegister, additiveStep(s));
+  }
+  bench::doNotOptimize(dacRegister);
+}
+
+static void BM_AdditiveStep1(bench::State& st) { additiveBench<1>(st); }
+static void BM_AdditiveStep2(bench::State& st) { additiveBench<2>(st); }
+static void BM_AdditiveStep4(bench::State& st) { additiveBench<4>(st); }
+static void BM_AdditiveStep8(bench::State& st) { additiveBench<8>(st); }
+BENCHMARK(BM_AdditiveStep1);
+BENCHMARK(BM_AdditiveStep2);
+BENCHMARK(BM_AdditiveStep4);
+BENCHMARK(BM_AdditiveStep8);
+
+// Lo que costaría interpolar en cada ciclo del lazo, frente a leer el bin
+static void BM_EqGainAt(bench::State& st) {
+  AcousticEqBuilder b;
+  for (uint8_t i = 0; i < EQ_MAX_POINTS; ++i) b.addMeasurement(4200.0f + 200.0f * i, (i % 3) - 1.0f);
+  AcousticEqData eq;
+  b.build(eq);
+  uint32_t n = 0;
+  for (auto _ : st) {
+    bench::doNotOptimize(eqGainAt(eq, 4200.0f + static_cast<float>(n++ % 2200)));
+  }
+}
+BENCHMARK(BM_EqGainAt);
+
+// Moduladores: la ISR de la tabla con ráfagas y con AM
+static void BM_SynthModulatedBurst(bench::State& st) {
+  SynthIsrState& s = isrState;
+  memcpy(s.table, SYNTH_SINE_TABLE, sizeof(s.table));
+  s.dacReg = &dacRegister;
+  s.levelInt = 200;
+  AcousticModulation cfg;
+  cfg.mode = ModulationMode::BURST;
+  synthModConfigure(s.mod, cfg, float(SYNTH_TIMER_HZ) / 12.0f);
+  for (auto _ : st) {
+    synthDacWrite(s.dacReg, synthIsrStep(s));
+  }
+  s.mod = SynthModState();
+  bench::doNotOptimize(s.lastDAC);
+}
+BENCHMARK(BM_SynthModulatedBurst);
+
+static void BM_SynthModulatedAM(bench::State& st) {
+  SynthIsrState& s = isrState;
+  memcpy(s.table, SYNTH_SINE_TABLE, sizeof(s.table));
+  s.dacReg = &dacRegister;
+  s.levelInt = 200;
+  AcousticModulation cfg;
+  cfg.mode = ModulationMode::AM;
+  synthModConfigure(s.mod, cfg, float(SYNTH_TIMER_HZ) / 12.0f);
+  for (auto _ : st) {
+    synthDacWrite(s.dacReg, synthIsrStep(s));
+  }
+  s.mod = SynthModState();
+  bench::doNotOptimize(s.lastDAC);
+}
+BENCHMARK(BM_SynthModulatedAM);
+
+// Aditiva de 4 osciladores con el chirp exponencial sobre la portadora
+static void BM_AdditiveChirpExp(bench::State& st) {
+  static AdditiveState<4> s;
+  uint8_t levels[4] = {255, 128, 40, 20};
+  additiveFillTable(s.table);
+  for (uint8_t i = 0; i < 4; ++i) {
+    s.osc[i].level = levels[i];
+    s.osc[i].increment = additiveIncrement(HELMHOLTZ_HZ * (i + 1));
+  }
+  s.gain = additiveGain(levels, 4, 255);
+  AcousticModulation cfg;
+  cfg.mode = ModulationMode::CHIRP_EXP;
+  synthModConfigure(s.mod, cfg, ADDITIVE_SAMPLE_HZ);
+  for (auto _ : st) {
+    synthDacWrite(&dacRegister, additiveStep(s));
+  }
+  bench::doNotOptimize(dacRegister);
+}
+BENCHMARK(BM_AdditiveChirpExp);
+
+// Lo que hacía ActuatorManager::setAcousticParameters cada 20 ms: mapeo y
+// división en float y escritura del timer aunque la carga no se mueva
+static volatile uint32_t timerAlarm;
+
+// Carga MAP con ruido de sensor alrededor de un punto que deriva despacio
+static float mapLoadAt(uint32_t n) {
+  return 40.0f + 0.001f * static_cast<float>(n % 20000) + 0.25f * static_cast<float>(static_cast<int>(n % 7) - 3);
+}
+
+static void BM_AcousticParamsFloat(bench::State& st) {
+  ActuationMap map;
+  uint32_t n = 0;
+  for (auto _ : st) {
+    float freq = synthFrequencyForLoad(mapLoadAt(n++), map.freqMinHz, map.freqMaxHz);
+    timerAlarm = synthTimerPeriodUs(freq, SYNTH_TABLE_SIZE);
+  }
+}
+BENCHMARK(BM_AcousticParamsFloat);
+
+// Lo mismo con la tabla de carga: un bin y solo se escribe el timer si cambia
+static void BM_AcousticParamsTable(bench::State& st) {
+  SynthTuningTable table;
+  uint8_t loadBin = 0xFF;
+  uint32_t n = 0, writes = 0;
+  for (auto _ : st) {
+    uint8_t bin = SynthTuningTable::binForLoad(mapLoadAt(n++));
+    if (bin != loadBin) {
+      loadBin = bin;
+      uint32_t period = table.periodUs(bin);
+      if (period != timerAlarm) {
+        timerAlarm = period;
+        writes++;
+      }
+    }
+  }
+  bench::doNotOptimize(writes);
+}
+BENCHMARK(BM_AcousticParamsTable);
+
+// Modelo térmico: coste por ciclo del lazo, paso casi fijo y la exp solo cuando cambia
+static void BM_TweeterThermal(bench::State& st) {
+  TweeterThermal th;
+  uint32_t t = 0, n = 0;
+  for (auto _ : st) {
+    t += (n & 63) ? 20 : 21;
+    bench::doNotOptimize(th.apply(t, 0.5f + 0.5f * static_cast<float>(n++ & 1)));
+  }
+}
+BENCHMARK(BM_TweeterThermal);
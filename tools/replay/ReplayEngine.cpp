@@ -0,0 +1,107 @@
+#include "ReplayEngine.h"
+#include "SensorMath.h"
+#include <math.h>
+
+void RecordingActuators::emit(TimelineKind kind, int32_t value) {
+  if (sink) sink->onEvent(TimelineEvent{now, kind, value});
+}
+
+void RecordingActuators::startVortex() {
+  if (vortex) return;
+  vortex = true;
+  emit(TimelineKind::VORTEX, 1);
+}
+
+void RecordingActuators::stopVortex() {
+  if (!vortex) return;
+  vortex = false;
+  emit(TimelineKind::VORTEX, 0);
+}
+
+void RecordingActuators::startAcoustic(float level) {
+  if (!acoustic) {
+    acoustic = true;
+    emit(TimelineKind::ACOUSTIC, 1);
+  }
+  setLevel(thermal.apply(now, level, duty));
+}
+
+void RecordingActuators::stopAcoustic() {
+  if (!acoustic) return;
+  thermal.off(now);
+  acoustic = false;
+  levelPct = freqHz = -1;
+  emit(TimelineKind::ACOUSTIC, 0);
+}
+
+void RecordingActuators::setLevel(float level) {
+  int32_t pct = static_cast<int32_t>(lroundf(level * 100.0f));
+  if (pct == levelPct) return;
+  levelPct = pct;
+  emit(TimelineKind::LEVEL, pct);
+}
+
+// Igual que ActuatorManager: la frecuencia sale del bin de carga MAP. La
+// modulación es por muestra y solo entra en el límite térmico
+void RecordingActuators::setAcousticParameters(float level, float mapLoadPercent, const AcousticModulation& modulation) {
+  uint8_t bin = SynthTuningTable::binForLoad(mapLoadPercent);
+  duty = modulationDuty(modulation);
+  setLevel(thermal.apply(now, level * tuning.gain(bin), duty));
+  float binHz = tuning.frequencyHz(bin);
+  int32_t freq = static_cast<int32_t>(lroundf(binHz / FREQ_STEP_HZ)) * FREQ_STEP_HZ;
+  if (freq == freqHz) return;
+  freqHz = freq;
+  emit(TimelineKind::FREQ, freq);
+}
+
+ReplayEngine::ReplayEngine(ThresholdManager* thresholds, const ReplayConfig& config, TimelineSink* sink)
+    : config(config), sink(sink), actuators(sink) {
+  if (this->config.loopMs == 0) this->config.loopMs = 1;
+  actuators.setEqualization(config.eq);  // Antes del mapa que fija la FSM
+  fsm.begin(true, &actuators, thresholds);
+  if (config.drift) drift.begin(config.calib);
+}
+
+void ReplayEngine::feed(const SensorSample& s) {
+  if (!started) {
+    started = true;
+    nextTickMs = s.tMs;
+  } else if (s.tMs - current.tMs > config.maxGapMs) {
+    // Registro cortado (o consola pausada): no simular el hueco ciclo a ciclo
+    while (nextTickMs <= current.tMs) tick(nextTickMs);
+    nextTickMs = s.tMs;
+    gaps++;
+  } else {
+    while (nextTickMs < s.tMs) tick(nextTickMs);
+  }
+  current = s;
+  samples++;
+}
+
+void ReplayEngine::finish() {
+  if (!started) return;
+  while (nextTickMs <= current.tMs) tick(nextTickMs);
+}
+
+void ReplayEngine::tick(uint32_t tMs) {
+  nextTickMs = tMs + config.loopMs;
+  ticks++;
+  actuators.setTime(tMs);
+
+  if (config.drift && drift.update(current.tpsRaw, current.mapRaw, tMs)) {
+    drift.apply(config.calib);
+  }
+
+  const CalibrationData& c = config.calib;
+  float mapLoad = rawToPercent(current.mapRaw, c.mapMin, c.mapMax);
+  float tpsLoad = rawToPercent(current.tpsRaw, c.tpsMin, c.tpsMax);
+
+  fsm.update(mapLoad, tpsLoad, false, false, true, debug);
+  fsm.handleActions();
+
+  SystemState st = fsm.getState();
+  if (st != lastState) {
+    lastState = st;
+    if (sink) sink->onEvent(TimelineEvent{tMs, TimelineKind::STATE, static_cast<int32_t>(st)});
+  }
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "ActuatorControl.h"
+#include "ConfigSchema.h"
+#include "DebugManager.h"
+#include "DriftCompensator.h"
+#include "SensorLog.h"
+#include "StateMachine.h"
+#include "SynthTuningTable.h"
+#include "ThresholdManager.h"
+#include "Timeline.h"
+#include "TweeterThermal.h"
+
+/**
+ * @struct ReplayConfig
+ * Parámetros del lazo simulado.
+ */
+struct ReplayConfig {
+  CalibrationData calib;      ///< Rangos crudos para convertir a % (como SensorManager)
+  uint32_t loopMs = 20;       ///< Periodo de loop() en el firmware
+  uint32_t maxGapMs = 1000;   ///< Huecos mayores se saltan sin simular ciclos
+  bool drift = false;         ///< Aplicar la compensación de deriva como en campo
+  AcousticEqData eq;          ///< Ecualización del tweeter (la del blob con --config)
+};
+
+/**
+ * @class RecordingActuators
+ * Actuadores de host: en lugar de mover relés y DAC emiten eventos de la
+ * línea de tiempo cuando algo cambia.
+ */
+class RecordingActuators : public ActuatorControl {
+public:
+  explicit RecordingActuators(TimelineSink* sink) : sink(sink) {}
+
+  void setTime(uint32_t tMs) { now = tMs; }
+
+  void update() override {}
+  void startVortex() override;
+  void stopVortex() override;
+  void startAcoustic(float level) override;
+  void stopAcoustic() override;
+  void setAcousticParameters(float level, float mapLoadPercent, const AcousticModulation& modulation) override;
+  bool isAcousticOn() const override { return acoustic; }
+  void setActuationMap(const ActuationMap& map) override {
+    tuning.build(map);
+    tuning.applyEq(eq);
+  }
+  void setEqualization(const AcousticEqData& table) {
+    eq = table;
+    tuning.applyEq(eq);
+  }
+
+private:
+  void emit(TimelineKind kind, int32_t value);
+  void setLevel(float level);
+
+  TimelineSink* sink;
+  uint32_t now = 0;
+  bool vortex = false;
+  bool acoustic = false;
+  int32_t levelPct = -1;  ///< -1: sin valor emitido desde el último start
+  int32_t freqHz = -1;
+  SynthTuningTable tuning;
+  AcousticEqData eq;
+  TweeterThermal thermal;  ///< Mismo límite térmico que ActuatorManager
+  float duty = 1.0f;       ///< modulationDuty() de la última modulación
+};
+
+/**
+ * @class ReplayEngine
+ * Reproduce un registro de sensores a través de la misma cadena que el
+ * firmware: conversión cruda → % (SensorMath, como SensorManager::update),
+ * StateMachine::update/handleActions cada loopMs de tiempo del registro, y
+ * actuadores que registran la línea de tiempo.
+ *
+ * El reloj es el del registro: se procesa tan rápido como lo permita la CPU.
+ */
+class ReplayEngine {
+public:
+  ReplayEngine(ThresholdManager* thresholds, const ReplayConfig& config, TimelineSink* sink);
+
+  /// Aplica una muestra; antes corre los ciclos de control que tocaban con la anterior
+  void feed(const SensorSample& s);
+
+  /// Corre el último ciclo pendiente; llamar al terminar el registro
+  void finish();
+
+  uint64_t getSamples() const { return samples; }
+  uint64_t getTicks() const { return ticks; }
+  uint64_t getGaps() const { return gaps; }
+  SystemState getState() const { return fsm.getState(); }
+
+private:
+  void tick(uint32_t tMs);
+
+  ReplayConfig config;
+  TimelineSink* sink;
+  RecordingActuators actuators;
+  DebugManager debug;
+  StateMachine fsm;
+  DriftCompensator drift;
+
+  SensorSample current{};
+  bool started = false;
+  uint32_t nextTickMs = 0;
+  SystemState lastState = SystemState::UNKNOWN;
+
+  uint64_t samples = 0;
+  uint64_t ticks = 0;
+  uint64_t gaps = 0;
+};
@@ -0,0 +1,149 @@
+#include "SensorLog.h"
+#include "CommandParser.h"
+#include <string.h>
+
+static const char MAGIC[4] = {'V', 'X', 'S', 'L'};
+static constexpr uint16_t RECORD_SIZE = 8;
+static constexpr size_t IO_BUFFER = 1 << 16;
+
+static uint16_t readU16(const uint8_t* p) { return p[0] | (p[1] << 8); }
+static uint32_t readU32(const uint8_t* p) {
+  return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+static void writeU16(uint8_t* p, uint16_t v) { p[0] = v; p[1] = v >> 8; }
+static void writeU32(uint8_t* p, uint32_t v) {
+  p[0] = v; p[1] = v >> 8; p[2] = v >> 16; p[3] = v >> 24;
+}
+
+bool SensorLogReader::open(const char* path, uint32_t step) {
+  close();
+  stepMs = step;
+  started = false;
+  lastMs = offsetMs = 0;
+  skipped = 0;
+  timeResets = 0;
+
+  if (strcmp(path, "-") == 0) {
+    file = stdin;
+    ownsFile = false;
+    binary = false;
+    return true;
+  }
+
+  file = fopen(path, "rb");
+  if (!file) return false;
+  ownsFile = true;
+  setvbuf(file, nullptr, _IOFBF, IO_BUFFER);
+
+  uint8_t header[8];
+  size_t n = fread(header, 1, sizeof(header), file);
+  binary = n == sizeof(header) && memcmp(header, MAGIC, sizeof(MAGIC)) == 0;
+  if (binary) {
+    if (readU16(header + 4) != SensorLogWriter::VERSION || readU16(header + 6) != RECORD_SIZE) {
+      close();
+      return false;
+    }
+  } else {
+    rewind(file);
+  }
+  return true;
+}
+
+void SensorLogReader::close() {
+  if (file && ownsFile) fclose(file);
+  file = nullptr;
+  ownsFile = false;
+}
+
+bool SensorLogReader::next(SensorSample& out) {
+  if (!file) return false;
+  if (!(binary ? nextBinary(out) : nextText(out))) return false;
+
+  // Tiempo monótono aunque el ESP32 se haya reiniciado durante la captura
+  uint32_t t = out.tMs + offsetMs;
+  if (started && t < lastMs) {
+    offsetMs += lastMs + stepMs - t;
+    t = lastMs + stepMs;
+    timeResets++;
+  }
+  out.tMs = lastMs = t;
+  started = true;
+  return true;
+}
+
+bool SensorLogReader::nextText(SensorSample& out) {
+  while (fgets(line, sizeof(line), file)) {
+    size_t len = strlen(line);
+    if (len == sizeof(line) - 1 && line[len - 1] != '\n') {
+      // Línea demasiado larga: descartar el resto
+      int c;
+      while ((c = fgetc(file)) != EOF && c != '\n') {}
+      skipped++;
+      continue;
+    }
+
+    while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+    char* p = line;
+    while (*p == ' ' || *p == '\t' || *p == '\r') ++p;
+    if (*p == '\0' || *p == '#') continue;
+
+    CommandArgs args;
+    tokenizeCommand(p, args);
+    long tps, map, t;
+    if (!args.getInt("tps_raw", tps) || !args.getInt("map_raw", map) ||
+        tps < 0 || tps > 4095 || map < 0 || map > 4095) {
+      skipped++;
+      continue;
+    }
+    if (args.getInt("t_ms", t) && t >= 0) {
+      out.tMs = static_cast<uint32_t>(t);
+    } else {
+      out.tMs = started ? lastMs - offsetMs + stepMs : 0;
+    }
+    out.tpsRaw = static_cast<uint16_t>(tps);
+    out.mapRaw = static_cast<uint16_t>(map);
+    return true;
+  }
+  return false;
+}
+
+bool SensorLogReader::nextBinary(SensorSample& out) {
+  uint8_t rec[RECORD_SIZE];
+  if (fread(rec, 1, sizeof(rec), file) != sizeof(rec)) return false;
+  out.tMs = readU32(rec);
+  out.tpsRaw = readU16(rec + 4);
+  out.mapRaw = readU16(rec + 6);
+  return true;
+}
+
+bool SensorLogWriter::open(const char* path) {
+  close();
+  file = fopen(path, "wb");
+  if (!file) return false;
+  setvbuf(file, nullptr, _IOFBF, IO_BUFFER);
+  failed = false;
+
+  uint8_t header[8];
+  memcpy(header, MAGIC, sizeof(MAGIC));
+  writeU16(header + 4, VERSION);
+  writeU16(header + 6, RECORD_SIZE);
+  failed = fwrite(header, 1, sizeof(header), file) != sizeof(header);
+  return !failed;
+}
+
+bool SensorLogWriter::write(const SensorSample& s) {
+  if (!file) return false;
+  uint8_t rec[RECORD_SIZE];
+  writeU32(rec, s.tMs);
+  writeU16(rec + 4, s.tpsRaw);
+  writeU16(rec + 6, s.mapRaw);
+  if (fwrite(rec, 1, sizeof(rec), file) != sizeof(rec)) failed = true;
+  return !failed;
+}
+
+bool SensorLogWriter::close() {
+  if (!file) return !failed;
+  if (fclose(file) != 0) failed = true;
+  file = nullptr;
+  return !failed;
+}
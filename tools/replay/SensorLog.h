@@ -0,0 +1,93 @@
+#pragma once
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Registros de sensores para el replay.
+ *
+ * Texto: una muestra por línea, el formato que envía race_sim.py más la marca
+ * de tiempo que añaden el comando "rec" del firmware y LOG_PATH del simulador:
+ *
+ *   t_ms:1520,tps_raw:2792,map_raw:3787
+ *
+ * Sin t_ms las muestras se espacian stepMs. Se ignoran las líneas vacías, las
+ * que empiezan por '#' y cualquier otra que no traiga tps_raw y map_raw (HUD,
+ * logs del ESP mezclados en la captura).
+ *
+ * Binario: cabecera de 8 bytes ("VXSL", versión y tamaño de registro, uint16
+ * little-endian) y registros de 8 bytes {uint32 t_ms, uint16 tps, uint16 map}.
+ */
+
+struct SensorSample {
+  uint32_t tMs;
+  uint16_t tpsRaw;
+  uint16_t mapRaw;
+};
+
+/**
+ * @class SensorLogReader
+ * Lectura secuencial de un registro de texto o binario (se detecta por la
+ * cabecera). Memoria constante: una línea o un registro por vez.
+ */
+class SensorLogReader {
+public:
+  static constexpr size_t LINE_MAX = 256;
+
+  ~SensorLogReader() { close(); }
+
+  /**
+   * @param path Archivo de registro; "-" lee texto de stdin.
+   * @param stepMs Separación de las muestras de texto sin t_ms.
+   * @return false si no se pudo abrir o la cabecera binaria no es válida.
+   */
+  bool open(const char* path, uint32_t stepMs);
+  void close();
+
+  /**
+   * Siguiente muestra con tiempo no decreciente.
+   * @return false al llegar al final.
+   */
+  bool next(SensorSample& out);
+
+  bool isBinary() const { return binary; }
+  /// Líneas de texto descartadas por no traer una muestra
+  uint64_t getSkipped() const { return skipped; }
+  /// Veces que el tiempo retrocedió (reinicio del ESP32 a mitad de captura)
+  uint32_t getTimeResets() const { return timeResets; }
+
+private:
+  bool nextText(SensorSample& out);
+  bool nextBinary(SensorSample& out);
+
+  FILE* file = nullptr;
+  bool ownsFile = false;
+  bool binary = false;
+  bool started = false;
+  uint32_t stepMs = 20;
+  uint32_t lastMs = 0;
+  uint32_t offsetMs = 0;  ///< Corrección acumulada tras cada reinicio
+  uint64_t skipped = 0;
+  uint32_t timeResets = 0;
+  char line[LINE_MAX];
+};
+
+/**
+ * @class SensorLogWriter
+ * Escribe el formato binario (para convertir capturas de texto largas).
+ */
+class SensorLogWriter {
+public:
+  static constexpr uint16_t VERSION = 1;
+
+  ~SensorLogWriter() { close(); }
+
+  bool open(const char* path);
+  bool write(const SensorSample& s);
+  /// @return false si alguna escritura falló
+  bool close();
+
+private:
+  FILE* file = nullptr;
+  bool failed = false;
+};
@@ -0,0 +1,113 @@
+#include "Timeline.h"
+#include "StateMachine.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const char* const KIND_NAMES[] = {"state", "vortex", "acoustic", "level", "freq"};
+
+// Mismo orden que SystemState
+static const char* const STATE_NAMES[] = {
+  "OFF", "SIN_CALIBRAR", "CALIBRATION", "IDLE",
+  "INYECCION_ACUSTICA", "VORTEX", "DESCAYENDO", "DEBUG", "UNKNOWN"
+};
+static_assert(sizeof(STATE_NAMES) / sizeof(STATE_NAMES[0]) == static_cast<size_t>(SystemState::UNKNOWN) + 1,
+              "STATE_NAMES no coincide con SystemState");
+
+int formatTimelineEvent(const TimelineEvent& ev, char* out, size_t cap) {
+  const char* kind = KIND_NAMES[static_cast<uint8_t>(ev.kind)];
+  if (ev.kind == TimelineKind::STATE) {
+    const char* name = ev.value >= 0 && ev.value <= static_cast<int32_t>(SystemState::UNKNOWN)
+                         ? STATE_NAMES[ev.value] : "??";
+    return snprintf(out, cap, "%lu %s %s", (unsigned long)ev.tMs, kind, name);
+  }
+  return snprintf(out, cap, "%lu %s %ld", (unsigned long)ev.tMs, kind, (long)ev.value);
+}
+
+bool parseTimelineEvent(const char* line, TimelineEvent& out) {
+  char kind[16], value[32];
+  unsigned long t;
+  if (sscanf(line, "%lu %15s %31s", &t, kind, value) != 3) return false;
+
+  out.tMs = static_cast<uint32_t>(t);
+  for (uint8_t k = 0; k < sizeof(KIND_NAMES) / sizeof(KIND_NAMES[0]); ++k) {
+    if (strcmp(kind, KIND_NAMES[k]) != 0) continue;
+    out.kind = static_cast<TimelineKind>(k);
+    if (out.kind == TimelineKind::STATE) {
+      for (int32_t s = 0; s <= static_cast<int32_t>(SystemState::UNKNOWN); ++s) {
+        if (strcmp(value, STATE_NAMES[s]) == 0) {
+          out.value = s;
+          return true;
+        }
+      }
+      return false;
+    }
+    char* end;
+    out.value = static_cast<int32_t>(strtol(value, &end, 10));
+    return *end == '\0';
+  }
+  return false;
+}
+
+void TimelineWriter::onEvent(const TimelineEvent& ev) {
+  char text[64];
+  formatTimelineEvent(ev, text, sizeof(text));
+  fputs(text, out);
+  fputc('\n', out);
+}
+
+TimelineDiff::TimelineDiff(FILE* golden, FILE* report, uint32_t toleranceMs, uint32_t maxReported)
+    : golden(golden), report(report), toleranceMs(toleranceMs), maxReported(maxReported) {}
+
+bool TimelineDiff::readGolden(TimelineEvent& out) {
+  while (fgets(line, sizeof(line), golden)) {
+    if (parseTimelineEvent(line, out)) return true;
+  }
+  goldenDone = true;
+  return false;
+}
+
+void TimelineDiff::dropFront() {
+  memmove(window, window + 1, (windowCount - 1) * sizeof(TimelineEvent));
+  windowCount--;
+}
+
+void TimelineDiff::reportDiff(char sign, const TimelineEvent& ev) {
+  if (differences++ >= maxReported || !report) return;
+  char text[64];
+  formatTimelineEvent(ev, text, sizeof(text));
+  fprintf(report, "%c %s\n", sign, text);
+}
+
+void TimelineDiff::onEvent(const TimelineEvent& ev) {
+  // Cargar los dorados que todavía podrían emparejarse con este evento
+  while (!goldenDone && windowCount < WINDOW &&
+         (windowCount == 0 || window[windowCount - 1].tMs <= ev.tMs + toleranceMs)) {
+    if (!readGolden(window[windowCount])) break;
+    windowCount++;
+  }
+
+  // Los que quedaron atrás ya no tienen pareja posible
+  while (windowCount > 0 && window[0].tMs + toleranceMs < ev.tMs) {
+    reportDiff('-', window[0]);
+    dropFront();
+  }
+
+  for (uint8_t i = 0; i < windowCount; ++i) {
+    const TimelineEvent& g = window[i];
+    uint32_t dt = g.tMs > ev.tMs ? g.tMs - ev.tMs : ev.tMs - g.tMs;
+    if (dt <= toleranceMs && g.kind == ev.kind && g.value == ev.value) {
+      memmove(window + i, window + i + 1, (windowCount - i - 1) * sizeof(TimelineEvent));
+      windowCount--;
+      matched++;
+      return;
+    }
+  }
+  reportDiff('+', ev);
+}
+
+void TimelineDiff::finish() {
+  for (uint8_t i = 0; i < windowCount; ++i) reportDiff('-', window[i]);
+  windowCount = 0;
+  TimelineEvent ev;
+  while (readGolden(ev)) reportDiff('-', ev);
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Línea de tiempo de salida del replay: solo los cambios, uno por línea.
+ *
+ *   20 state OFF
+ *   1540 state INYECCION_ACUSTICA
+ *   1540 acoustic 1
+ *   1540 level 37
+ *   1540 freq 4620
+ *
+ * level es el nivel acústico en % entero y freq la frecuencia de onda en
+ * pasos de FREQ_STEP_HZ; así la traza dorada no depende del redondeo de floats.
+ */
+
+enum class TimelineKind : uint8_t {
+  STATE,
+  VORTEX,
+  ACOUSTIC,
+  LEVEL,
+  FREQ
+};
+
+struct TimelineEvent {
+  uint32_t     tMs;
+  TimelineKind kind;
+  int32_t      value;  ///< SystemState, 0/1, % o Hz según kind
+};
+
+static constexpr int32_t FREQ_STEP_HZ = 10;
+
+/**
+ * @class TimelineSink
+ * Destino de los eventos que genera ReplayEngine.
+ */
+class TimelineSink {
+public:
+  virtual ~TimelineSink() = default;
+  virtual void onEvent(const TimelineEvent& ev) = 0;
+};
+
+/// Formatea un evento sin salto de línea; devuelve la longitud escrita
+int formatTimelineEvent(const TimelineEvent& ev, char* out, size_t cap);
+
+/**
+ * Interpreta una línea de traza.
+ * @return false si la línea no es un evento (vacía, comentario o mal formada).
+ */
+bool parseTimelineEvent(const char* line, TimelineEvent& out);
+
+/**
+ * @class TimelineWriter
+ * Escribe eventos en un archivo de traza.
+ */
+class TimelineWriter : public TimelineSink {
+public:
+  explicit TimelineWriter(FILE* out) : out(out) {}
+  void onEvent(const TimelineEvent& ev) override;
+
+private:
+  FILE* out;
+};
+
+/**
+ * @class TimelineDiff
+ * Compara en streaming la traza del replay con la dorada.
+ *
+ * Ambas están ordenadas por tiempo. Cada evento del replay busca pareja
+ * (mismo tipo y valor, tiempo dentro de la tolerancia) en una ventana fija
+ * de eventos dorados; los que salen de la ventana sin pareja y los del replay
+ * que no la encuentran cuentan como diferencias. Memoria constante: la
+ * ventana tiene WINDOW eventos como máximo.
+ */
+class TimelineDiff : public TimelineSink {
+public:
+  /**
+   * @param golden Traza dorada abierta para lectura.
+   * @param report Dónde listar las diferencias ("-" dorado, "+" replay).
+   * @param toleranceMs Desfase aceptado entre eventos equivalentes.
+   * @param maxReported Diferencias que se listan; el resto solo se cuenta.
+   */
+  TimelineDiff(FILE* golden, FILE* report, uint32_t toleranceMs, uint32_t maxReported);
+
+  void onEvent(const TimelineEvent& ev) override;
+
+  /// Consume lo que quede de la traza dorada; llamar al terminar el replay
+  void finish();
+
+  uint64_t getDifferences() const { return differences; }
+  uint64_t getMatched() const { return matched; }
+
+private:
+  static constexpr uint8_t WINDOW = 64;
+
+  bool readGolden(TimelineEvent& out);
+  void dropFront();
+  void reportDiff(char sign, const TimelineEvent& ev);
+
+  FILE* golden;
+  FILE* report;
+  uint32_t toleranceMs;
+  uint32_t maxReported;
+
+  TimelineEvent window[WINDOW];
+  uint8_t windowCount = 0;
+  bool goldenDone = false;
+  uint64_t differences = 0;
+  uint64_t matched = 0;
+  char line[128];
+};
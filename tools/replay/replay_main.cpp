@@ -0,0 +1,304 @@
+#include "ConfigStore.h"
+#include "FileStorageBackend.h"
+#include "ReplayEngine.h"
+#include "SensorLog.h"
+#include "ThresholdManager.h"
+#include "Timeline.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/*
+ * vortex_replay: reproduce capturas de sensores en el host.
+ *
+ *   vortex_replay run LOG [--out=traza.txt] [--golden=dorada.txt] [opciones]
+ *   vortex_replay convert LOG.txt LOG.bin [--step-ms=N]
+ *   vortex_replay diff DORADA.txt TRAZA.txt [--tolerance-ms=N]
+ *
+ * Opciones de run:
+ *   --config=ARCHIVO   Blob de ConfigStore (umbrales y calibración guardados)
+ *   --tps=MIN:MAX      Rango crudo del TPS (por defecto el de race_sim.py)
+ *   --map=MIN:MAX      Rango crudo del MAP
+ *   --set=CLAVE=VALOR  Sobrescribe un umbral (repetible)
+ *   --loop-ms=N        Periodo de loop() (20)
+ *   --step-ms=N        Separación de muestras de texto sin t_ms (20)
+ *   --max-gap-ms=N     Huecos más largos se saltan (1000)
+ *   --drift            Aplicar compensación de deriva
+ *   --tolerance-ms=N   Desfase aceptado contra la dorada (0)
+ *   --max-diffs=N      Diferencias listadas (20)
+ *
+ * Código de salida: 0 sin diferencias, 1 si la traza difiere de la dorada, 2 error.
+ */
+
+namespace {
+
+struct Options {
+  const char* outPath = nullptr;
+  const char* goldenPath = nullptr;
+  const char* configPath = nullptr;
+  uint32_t stepMs = 20;
+  uint32_t toleranceMs = 0;
+  uint32_t maxDiffs = 20;
+  bool tpsGiven = false;
+  bool mapGiven = false;
+  ReplayConfig replay;
+  std::vector<std::pair<std::string, float>> overrides;
+};
+
+const char* argValue(const char* arg, const char* key) {
+  size_t n = strlen(key);
+  return strncmp(arg, key, n) == 0 ? arg + n : nullptr;
+}
+
+bool parseRange(const char* text, uint16_t& lo, uint16_t& hi) {
+  unsigned a, b;
+  if (sscanf(text, "%u:%u", &a, &b) != 2 || a >= b || b > 4095) return false;
+  lo = static_cast<uint16_t>(a);
+  hi = static_cast<uint16_t>(b);
+  return true;
+}
+
+// Calibración de race_sim.py (TPS 0.5–2.25 V, MAP 3.05–3.26 V), la misma que loadDebugCalibration()
+void defaultCalibration(CalibrationData& c) {
+  c.tpsMin = static_cast<uint16_t>((0.5f / 3.3f) * 4095);
+  c.tpsMax = static_cast<uint16_t>((2.25f / 3.3f) * 4095);
+  c.mapMin = static_cast<uint16_t>((3.05f / 3.3f) * 4095);
+  c.mapMax = static_cast<uint16_t>((3.26f / 3.3f) * 4095);
+}
+
+bool parseOptions(int argc, char** argv, int first, Options& opt) {
+  defaultCalibration(opt.replay.calib);
+  for (int i = first; i < argc; ++i) {
+    const char* v;
+    if ((v = argValue(argv[i], "--out="))) opt.outPath = v;
+    else if ((v = argValue(argv[i], "--golden="))) opt.goldenPath = v;
+    else if ((v = argValue(argv[i], "--config="))) opt.configPath = v;
+    else if ((v = argValue(argv[i], "--loop-ms="))) opt.replay.loopMs = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--step-ms="))) opt.stepMs = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--max-gap-ms="))) opt.replay.maxGapMs = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--tolerance-ms="))) opt.toleranceMs = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--max-diffs="))) opt.maxDiffs = strtoul(v, nullptr, 10);
+    else if (strcmp(argv[i], "--drift") == 0) opt.replay.drift = true;
+    else if ((v = argValue(argv[i], "--tps="))) {
+      if (!parseRange(v, opt.replay.calib.tpsMin, opt.replay.calib.tpsMax)) {
+        fprintf(stderr, "Rango TPS inválido: %s\n", v);
+        return false;
+      }
+      opt.tpsGiven = true;
+    } else if ((v = argValue(argv[i], "--map="))) {
+      if (!parseRange(v, opt.replay.calib.mapMin, opt.replay.calib.mapMax)) {
+        fprintf(stderr, "Rango MAP inválido: %s\n", v);
+        return false;
+      }
+      opt.mapGiven = true;
+    } else if ((v = argValue(argv[i], "--set="))) {
+      const char* eq = strchr(v, '=');
+      if (!eq) {
+        fprintf(stderr, "Se esperaba --set=CLAVE=VALOR: %s\n", v);
+        return false;
+      }
+      opt.overrides.emplace_back(std::string(v, eq - v), strtof(eq + 1, nullptr));
+    } else {
+      fprintf(stderr, "Opción desconocida: %s\n", argv[i]);
+      return false;
+    }
+  }
+  return true;
+}
+
+// TimelineSink que reparte cada evento a la traza de salida y a la comparación
+class Fanout : public TimelineSink {
+public:
+  TimelineSink* a = nullptr;
+  TimelineSink* b = nullptr;
+  uint64_t events = 0;
+  void onEvent(const TimelineEvent& ev) override {
+    events++;
+    if (a) a->onEvent(ev);
+    if (b) b->onEvent(ev);
+  }
+};
+
+int cmdRun(const char* logPath, Options& opt) {
+  // Umbrales desde el blob indicado o, si no, los de fábrica en un archivo temporal
+  std::string storePath = opt.configPath
+    ? std::string(opt.configPath)
+    : "/tmp/vortex_replay_config_" + std::to_string(getpid()) + ".bin";
+  FileStorageBackend backend(storePath);
+  if (!opt.configPath) backend.erase();
+  ConfigStore& store = ConfigStore::getInstance();
+  if (!store.begin(&backend) && opt.configPath) {
+    fprintf(stderr, "No se pudo leer la configuración %s\n", opt.configPath);
+    return 2;
+  }
+
+  CalibrationData saved = store.getCalibration();
+  if (saved.valid) {
+    if (!opt.tpsGiven) { opt.replay.calib.tpsMin = saved.tpsMin; opt.replay.calib.tpsMax = saved.tpsMax; }
+    if (!opt.mapGiven) { opt.replay.calib.mapMin = saved.mapMin; opt.replay.calib.mapMax = saved.mapMax; }
+  }
+  opt.replay.eq = store.getEqualization();
+  CalibrationData& c = opt.replay.calib;
+  c.tpsMinRef = c.tpsMin; c.tpsMaxRef = c.tpsMax;
+  c.mapMinRef = c.mapMin; c.mapMaxRef = c.mapMax;
+  c.valid = 1;
+
+  ThresholdManager thresholds;
+  thresholds.begin();
+  for (const auto& kv : opt.overrides) {
+    if (!thresholds.setThreshold(kv.first, kv.second)) {
+      fprintf(stderr, "Umbral desconocido: %s\n", kv.first.c_str());
+      return 2;
+    }
+  }
+  const char* reason = "";
+  if (thresholds.applyEdits(&reason) == ThresholdManager::EditResult::INVALID) {
+    fprintf(stderr, "Umbrales incoherentes: %s\n", reason);
+    return 2;
+  }
+
+  SensorLogReader reader;
+  if (!reader.open(logPath, opt.stepMs)) {
+    fprintf(stderr, "No se pudo abrir el registro %s\n", logPath);
+    return 2;
+  }
+
+  FILE* out = nullptr;
+  if (opt.outPath) {
+    out = strcmp(opt.outPath, "-") == 0 ? stdout : fopen(opt.outPath, "w");
+    if (!out) {
+      fprintf(stderr, "No se pudo escribir %s\n", opt.outPath);
+      return 2;
+    }
+  }
+  FILE* golden = nullptr;
+  if (opt.goldenPath && !(golden = fopen(opt.goldenPath, "r"))) {
+    fprintf(stderr, "No se pudo abrir la traza dorada %s\n", opt.goldenPath);
+    return 2;
+  }
+
+  TimelineWriter writer(out);
+  TimelineDiff diff(golden, stdout, opt.toleranceMs, opt.maxDiffs);
+  Fanout fanout;
+  fanout.a = out ? &writer : nullptr;
+  fanout.b = golden ? &diff : nullptr;
+
+  auto t0 = std::chrono::steady_clock::now();
+  ReplayEngine engine(&thresholds, opt.replay, &fanout);
+  SensorSample s;
+  uint32_t firstMs = 0, lastMs = 0;
+  while (reader.next(s)) {
+    if (engine.getSamples() == 0) firstMs = s.tMs;
+    lastMs = s.tMs;
+    engine.feed(s);
+  }
+  engine.finish();
+  if (golden) diff.finish();
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  if (out && out != stdout) fclose(out);
+  if (golden) fclose(golden);
+
+  double logS = (lastMs - firstMs) / 1000.0;
+  fprintf(stderr,
+          "%s: %llu muestras (%s), %llu ciclos, %llu eventos, %.1f s de registro en %.3f s (x%.0f)\n",
+          logPath, (unsigned long long)engine.getSamples(), reader.isBinary() ? "binario" : "texto",
+          (unsigned long long)engine.getTicks(), (unsigned long long)fanout.events, logS, wallS,
+          wallS > 0 ? logS / wallS : 0.0);
+  if (reader.getSkipped() || reader.getTimeResets() || engine.getGaps()) {
+    fprintf(stderr, "  líneas descartadas %llu, reinicios de reloj %lu, huecos saltados %llu\n",
+            (unsigned long long)reader.getSkipped(), (unsigned long)reader.getTimeResets(),
+            (unsigned long long)engine.getGaps());
+  }
+  if (golden) {
+    fprintf(stderr, "  dorada: %llu coincidencias, %llu diferencias\n",
+            (unsigned long long)diff.getMatched(), (unsigned long long)diff.getDifferences());
+    return diff.getDifferences() ? 1 : 0;
+  }
+  return 0;
+}
+
+int cmdConvert(const char* inPath, const char* outPath, const Options& opt) {
+  SensorLogReader reader;
+  if (!reader.open(inPath, opt.stepMs)) {
+    fprintf(stderr, "No se pudo abrir el registro %s\n", inPath);
+    return 2;
+  }
+  SensorLogWriter writer;
+  if (!writer.open(outPath)) {
+    fprintf(stderr, "No se pudo escribir %s\n", outPath);
+    return 2;
+  }
+  SensorSample s;
+  uint64_t n = 0;
+  while (reader.next(s)) {
+    writer.write(s);
+    n++;
+  }
+  if (!writer.close()) {
+    fprintf(stderr, "Error de escritura en %s\n", outPath);
+    return 2;
+  }
+  fprintf(stderr, "%llu muestras → %s (%llu líneas descartadas)\n", (unsigned long long)n,
+          outPath, (unsigned long long)reader.getSkipped());
+  return 0;
+}
+
+int cmdDiff(const char* goldenPath, const char* tracePath, const Options& opt) {
+  FILE* golden = fopen(goldenPath, "r");
+  FILE* trace = fopen(tracePath, "r");
+  if (!golden || !trace) {
+    fprintf(stderr, "No se pudo abrir %s\n", golden ? tracePath : goldenPath);
+    if (golden) fclose(golden);
+    if (trace) fclose(trace);
+    return 2;
+  }
+  TimelineDiff diff(golden, stdout, opt.toleranceMs, opt.maxDiffs);
+  char line[128];
+  TimelineEvent ev;
+  while (fgets(line, sizeof(line), trace)) {
+    if (parseTimelineEvent(line, ev)) diff.onEvent(ev);
+  }
+  diff.finish();
+  fclose(golden);
+  fclose(trace);
+  fprintf(stderr, "%llu coincidencias, %llu diferencias\n",
+          (unsigned long long)diff.getMatched(), (unsigned long long)diff.getDifferences());
+  return diff.getDifferences() ? 1 : 0;
+}
+
+void usage() {
+  fprintf(stderr,
+          "Uso: vortex_replay run LOG [--out=TRAZA] [--golden=DORADA] [opciones]\n"
+          "     vortex_replay convert LOG.txt LOG.bin [--step-ms=N]\n"
+          "     vortex_replay diff DORADA TRAZA [--tolerance-ms=N]\n");
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 3) {
+    usage();
+    return 2;
+  }
+  const char* cmd = argv[1];
+  int first = strcmp(cmd, "run") == 0 ? 3 : 4;
+  if (argc < first) {
+    usage();
+    return 2;
+  }
+
+  Options opt;
+  if (!parseOptions(argc, argv, first, opt)) return 2;
+
+  if (strcmp(cmd, "run") == 0) return cmdRun(argv[2], opt);
+  if (strcmp(cmd, "convert") == 0) return cmdConvert(argv[2], argv[3], opt);
+  if (strcmp(cmd, "diff") == 0) return cmdDiff(argv[2], argv[3], opt);
+  usage();
+  return 2;
+}
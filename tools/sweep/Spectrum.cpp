@@ -0,0 +1,83 @@
+#include "Spectrum.h"
+#include <algorithm>
+#include <math.h>
+
+Spectrum::Spectrum(uint32_t log2Size) : n(size_t(1) << log2Size) {
+  window.resize(n);
+  // Blackman-Harris de 4 términos: lóbulos laterales a -92 dB, así la fuga
+  // de la fundamental no tapa espurios reales
+  for (size_t i = 0; i < n; ++i) {
+    double x = 2.0 * M_PI * i / n;
+    window[i] = float(0.35875 - 0.48829 * cos(x) + 0.14128 * cos(2.0 * x) - 0.01168 * cos(3.0 * x));
+  }
+  powerGain = 0.0;
+  for (float w : window) powerGain += double(w) * w;
+  powerGain /= n;
+
+  twiddle.resize(n / 2);
+  for (size_t i = 0; i < n / 2; ++i) twiddle[i] = std::polar(1.0, -2.0 * M_PI * i / n);
+
+  work.resize(n);
+  power.resize(n / 2 + 1);
+}
+
+void Spectrum::compute(const float* samples, double sampleRateHz) {
+  double mean = 0.0;
+  for (size_t i = 0; i < n; ++i) mean += samples[i];
+  mean /= n;
+  for (size_t i = 0; i < n; ++i) work[i] = (samples[i] - mean) * window[i];
+
+  fft();
+
+  // ×2 por doblar el lado negativo
+  const double scale = 2.0 / (double(n) * double(n) * powerGain);
+  for (size_t k = 0; k < power.size(); ++k) power[k] = std::norm(work[k]) * scale;
+  power[0] *= 0.5;
+  power[n / 2] *= 0.5;
+  binWidth = sampleRateHz / n;
+}
+
+size_t Spectrum::binOf(double hz) const {
+  double k = floor(hz / binWidth + 0.5);
+  if (k < 0.0) return 0;
+  return k >= power.size() ? power.size() - 1 : size_t(k);
+}
+
+double Spectrum::bandPower(double centerHz, size_t halfBins) const {
+  size_t c = binOf(centerHz);
+  size_t lo = c > halfBins ? c - halfBins : 0;
+  size_t hi = std::min(c + halfBins, power.size() - 1);
+  double sum = 0.0;
+  for (size_t k = lo; k <= hi; ++k) sum += power[k];
+  return sum;
+}
+
+double Spectrum::peakPower(double centerHz, size_t halfBins) const {
+  size_t c = binOf(centerHz);
+  size_t lo = c > halfBins ? c - halfBins : 0;
+  size_t hi = std::min(c + halfBins, power.size() - 1);
+  double peak = 0.0;
+  for (size_t k = lo; k <= hi; ++k) peak = std::max(peak, power[k]);
+  return peak;
+}
+
+// Cooley-Tukey iterativa en el sitio
+void Spectrum::fft() {
+  for (size_t i = 1, j = 0; i < n; ++i) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(work[i], work[j]);
+  }
+
+  for (size_t len = 2; len <= n; len <<= 1) {
+    size_t step = n / len;
+    for (size_t start = 0; start < n; start += len) {
+      for (size_t k = 0; k < len / 2; ++k) {
+        std::complex<double> t = work[start + k + len / 2] * twiddle[k * step];
+        work[start + k + len / 2] = work[start + k] - t;
+        work[start + k] += t;
+      }
+    }
+  }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <complex>
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @class Spectrum
+ * Espectro de potencia de un bloque de 2^n muestras: se quita la media, se
+ * aplica ventana de Blackman-Harris y una FFT radix-2.
+ *
+ * Las potencias se expresan como valor cuadrático medio de la señal (LSB²):
+ * una senoidal de amplitud A suma A²/2 sobre su lóbulo, sin importar la
+ * ventana ni el tamaño del bloque.
+ */
+class Spectrum {
+public:
+  explicit Spectrum(uint32_t log2Size);
+
+  size_t size() const { return n; }
+
+  /**
+   * @param samples n muestras.
+   * @param sampleRateHz Frecuencia de muestreo del bloque.
+   */
+  void compute(const float* samples, double sampleRateHz);
+
+  double binHz() const { return binWidth; }
+  size_t bins() const { return power.size(); }
+  double binPower(size_t k) const { return power[k]; }
+  size_t binOf(double hz) const;
+
+  /// Potencia sumada en [centro - halfBins, centro + halfBins]
+  double bandPower(double centerHz, size_t halfBins) const;
+  /// Bin de mayor potencia dentro de esa misma banda
+  double peakPower(double centerHz, size_t halfBins) const;
+
+private:
+  void fft();
+
+  size_t n;
+  double binWidth = 0.0;
+  double powerGain = 1.0;  ///< Media de w² de la ventana
+  std::vector<float> window;
+  std::vector<std::complex<double>> twiddle;
+  std::vector<std::complex<double>> work;
+  std::vector<double> power;  ///< Un lado, 0..n/2
+};
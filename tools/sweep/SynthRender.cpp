@@ -0,0 +1,157 @@
+#include "SynthRender.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+// El firmware solo trae la tabla de 16; otros tamaños se generan redondeando
+template <uint8_t N>
+static void fillTable(uint8_t (&table)[N]) {
+  if (N == SYNTH_TABLE_SIZE) {
+    memcpy(table, SYNTH_SINE_TABLE, N);
+    return;
+  }
+  for (uint8_t i = 0; i < N; ++i) {
+    table[i] = static_cast<uint8_t>(lround(128.0 + 127.0 * sin(2.0 * M_PI * i / N)));
+  }
+}
+
+template <uint8_t N>
+SynthRenderer<N>::SynthRenderer(const SynthParams& p)
+    : params(p),
+      periodUs(std::max<uint32_t>(1, synthTimerPeriodUs(p.freqHz, N))),
+      updateUs(std::max<uint32_t>(1, p.updateMs * 1000)),
+      nextIsrUs(periodUs),
+      nextUpdateUs(updateUs) {
+  params.level = std::min(std::max(p.level, 0.0f), 1.0f);
+  // Lo que hacen begin(), start() y setNoiseShaping()/setPhase() en AcousticInjector
+  fillTable(isr.table);
+  isr.shapeMask = p.noiseShaping ? 0xFF : 0;
+  isr.phaseOffset = synthPhaseFromDegrees(p.phaseDeg);
+}
+
+template <uint8_t N>
+uint8_t SynthRenderer<N>::tick() {
+  ++nowUs;
+  if (nowUs == nextUpdateUs) {
+    level = synthRampLevel(level, params.level, params.rampAlpha);
+    isr.levelInt = synthLevelInt(level);
+    isr.levelInt2 = isr.levelInt;
+    nextUpdateUs += updateUs;
+  }
+  if (nowUs == nextIsrUs) {
+    if (params.stereo) {
+      SynthFrame f = synthStereoStep(isr);
+      dac = f.dac1;
+      dac2 = f.dac2;
+    } else {
+      dac = synthIsrStep(isr);
+    }
+    nextIsrUs += periodUs;
+  }
+  return dac;
+}
+
+template class SynthRenderer<2>;
+template class SynthRenderer<4>;
+template class SynthRenderer<8>;
+template class SynthRenderer<16>;
+template class SynthRenderer<32>;
+template class SynthRenderer<64>;
+template class SynthRenderer<128>;
+
+bool synthRenderableTable(uint32_t size) {
+  return size >= 2 && size <= 128 && (size & (size - 1)) == 0;
+}
+
+// Solo la rampa, hasta que deja de moverse: nivel final y cuándo queda a 1 LSB
+static void rampSettle(const SynthParams& p, uint8_t& finalInt, uint32_t& settleMs) {
+  float target = std::min(std::max(p.level, 0.0f), 1.0f);
+  std::vector<uint8_t> steps;
+  float level = 0.0f;
+  for (int i = 0; i < 10000; ++i) {
+    level = synthRampLevel(level, target, p.rampAlpha);
+    steps.push_back(synthLevelInt(level));
+    if (steps.size() > 50 && steps[steps.size() - 50] == steps.back()) break;
+  }
+  finalInt = steps.back();
+  size_t first = steps.size() - 1;
+  while (first > 0 && abs(int(steps[first - 1]) - int(finalInt)) <= 1) --first;
+  settleMs = uint32_t(first + 1) * p.updateMs;
+}
+
+// Salta la rampa y llena samples con la salida del DAC; devuelve la alarma por muestra
+template <uint8_t N>
+static uint32_t renderSettled(const SynthParams& params, uint32_t startUs, std::vector<float>& samples) {
+  SynthRenderer<N> synth(params);
+  while (synth.getNowUs() < startUs) synth.tick();
+  for (float& s : samples) s = synth.tick();
+  return synth.getPeriodUs();
+}
+
+SynthMetrics analyzeSynth(const SynthParams& params, Spectrum& spectrum, std::vector<float>& samples,
+                          double bandHz) {
+  SynthMetrics m;
+  rampSettle(params, m.levelInt, m.settleMs);
+
+  samples.resize(spectrum.size());
+  const uint32_t startUs = m.settleMs * 1000;
+  switch (params.tableSize) {
+    case 2:   m.periodUs = renderSettled<2>(params, startUs, samples); break;
+    case 4:   m.periodUs = renderSettled<4>(params, startUs, samples); break;
+    case 8:   m.periodUs = renderSettled<8>(params, startUs, samples); break;
+    case 16:  m.periodUs = renderSettled<16>(params, startUs, samples); break;
+    case 32:  m.periodUs = renderSettled<32>(params, startUs, samples); break;
+    case 64:  m.periodUs = renderSettled<64>(params, startUs, samples); break;
+    case 128: m.periodUs = renderSettled<128>(params, startUs, samples); break;
+    default:  return m;  // synthRenderableTable() lo descarta antes
+  }
+  m.realHz = double(SYNTH_TIMER_HZ) / (double(m.periodUs) * params.tableSize);
+
+  spectrum.compute(samples.data(), SYNTH_TIMER_HZ);
+
+  // El lóbulo principal de Blackman-Harris ocupa ±4 bins; ±6 cubre el redondeo del centro
+  const size_t HALF = 6;
+  const double fullScale = 127.5 * 127.5 / 2.0;
+  const double nyquist = SYNTH_TIMER_HZ / 2.0;
+  const uint32_t n = params.tableSize;
+
+  double fund = spectrum.bandPower(m.realHz, HALF);
+  m.fundDbfs = 10.0 * log10(std::max(fund, 1e-20) / fullScale);
+
+  std::vector<bool> harmonic(spectrum.bins(), false);
+  double distortion = 0.0, image = 0.0;
+  // La salida es periódica en muestras enteras: todo, incluso lo que se
+  // repliega por encima de Nyquist, cae sobre múltiplos de realHz
+  for (uint32_t h = 1; h * m.realHz < nyquist + HALF * spectrum.binHz(); ++h) {
+    size_t c = spectrum.binOf(h * m.realHz);
+    for (size_t k = c > HALF ? c - HALF : 0; k <= c + HALF && k < harmonic.size(); ++k) harmonic[k] = true;
+    if (h >= 2 && h + 2 <= n) distortion += spectrum.bandPower(h * m.realHz, HALF);
+    if (h + 1 == n || h == n + 1) image = std::max(image, spectrum.bandPower(h * m.realHz, HALF));
+  }
+  m.thdPct = fund > 0.0 ? 100.0 * sqrt(distortion / fund) : 0.0;
+  m.imageDbc = 10.0 * log10(std::max(image, 1e-20) / std::max(fund, 1e-20));
+
+  // Sin la fundamental concentrada en un bin, el pico se compara bin contra bin
+  double fundPeak = spectrum.peakPower(m.realHz, HALF);
+  double spur = 0.0;
+  size_t spurBin = 0;
+  for (size_t k = HALF + 1; k < spectrum.bins(); ++k) {
+    if (!harmonic[k] && spectrum.binPower(k) > spur) {
+      spur = spectrum.binPower(k);
+      spurBin = k;
+    }
+  }
+  m.spurDbc = 10.0 * log10(std::max(spur, 1e-20) / std::max(fundPeak, 1e-20));
+  m.spurHz = spurBin * spectrum.binHz();
+
+  // En banda, sin la continua: SINAD cuenta todo, SNR solo lo que no es armónico
+  size_t bandBin = std::min(spectrum.binOf(bandHz), spectrum.bins() - 1);
+  double total = 0.0, noise = 0.0;
+  for (size_t k = HALF + 1; k <= bandBin; ++k) {
+    total += spectrum.binPower(k);
+    if (!harmonic[k]) noise += spectrum.binPower(k);
+  }
+  m.sinadDb = 10.0 * log10(std::max(fund, 1e-20) / std::max(total - fund, 1e-20));
+  m.snrDb = 10.0 * log10(std::max(fund, 1e-20) / std::max(noise, 1e-20));
+  return m;
+}
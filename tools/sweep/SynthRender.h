@@ -0,0 +1,90 @@
+#pragma once
+
+#include "Spectrum.h"
+#include "SynthKernel.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * @struct SynthParams
+ * Un punto del barrido: lo que hoy se ajusta a oído en AcousticInjector.
+ */
+struct SynthParams {
+  float    freqHz    = 5300.0f;           ///< Pedida a updateWaveFrequency()
+  float    level     = 1.0f;              ///< Objetivo de start()/setLevel(), 0–1
+  uint8_t  tableSize = SYNTH_TABLE_SIZE;  ///< Potencia de dos; 16 usa la tabla del firmware
+  float    rampAlpha = SYNTH_RAMP_ALPHA;
+  uint32_t updateMs  = 20;                ///< Cadencia de update() (loop de la FSM)
+  bool     noiseShaping = false;          ///< Realimentación del error (synthSampleShaped)
+  bool     stereo = false;                ///< Segundo canal con synthStereoStep()
+  float    phaseDeg = 90.0f;              ///< Desfase del segundo canal
+};
+
+/**
+ * @struct SynthMetrics
+ * Resultado de analizar la salida del DAC una vez asentada la rampa.
+ */
+struct SynthMetrics {
+  uint32_t periodUs = 0;      ///< Alarma del timer por muestra
+  double   realHz = 0.0;      ///< Frecuencia que sale de verdad
+  uint32_t settleMs = 0;      ///< Hasta que el nivel queda a 1 LSB de su valor final
+  uint8_t  levelInt = 0;      ///< Nivel final en la escala de la ISR
+  double   fundDbfs = 0.0;    ///< Fundamental respecto de un seno de fondo de escala
+  double   thdPct = 0.0;      ///< Armónicos 2..N-2 (forma de la tabla)
+  double   imageDbc = 0.0;    ///< Armónicos N-1 y N+1: imagen de la frecuencia de muestreo
+  double   spurDbc = 0.0;     ///< Mayor bin fuera de los armónicos
+  double   spurHz = 0.0;
+  double   sinadDb = 0.0;     ///< Fundamental frente a todo lo demás dentro de la banda
+  double   snrDb = 0.0;       ///< Igual, sin contar los armónicos
+};
+
+/**
+ * @class SynthRenderer
+ * Reproduce el inyector acústico tick a tick del timer (1 µs) con el estado
+ * y los pasos de la ISR del firmware (SynthIsrStateT, synthIsrStep() o
+ * synthStereoStep()): start() a nivel 0, la ISR cada synthTimerPeriodUs() µs
+ * y update() cada updateMs con synthRampLevel()/synthLevelInt().
+ *
+ * N es el tamaño de la tabla, una potencia de dos como exige la ISR; con
+ * N = SYNTH_TABLE_SIZE la tabla es SYNTH_SINE_TABLE.
+ *
+ * La salida es el valor retenido del DAC de 8 bits muestreado a
+ * SYNTH_TIMER_HZ, así las imágenes del retenedor aparecen en el espectro.
+ */
+template <uint8_t N>
+class SynthRenderer {
+public:
+  explicit SynthRenderer(const SynthParams& params);
+
+  /// Avanza un tick y devuelve el valor del DAC
+  uint8_t tick();
+
+  uint32_t getNowUs() const { return nowUs; }
+  uint8_t  getLevelInt() const { return isr.levelInt; }
+  uint32_t getPeriodUs() const { return periodUs; }
+  uint8_t  getDac2() const { return dac2; }  ///< Segundo canal con params.stereo
+
+private:
+  SynthParams params;
+  SynthIsrStateT<N> isr;
+  uint32_t periodUs;
+  uint32_t updateUs;
+  uint32_t nowUs = 0;
+  uint32_t nextIsrUs;
+  uint32_t nextUpdateUs;
+  float level = 0.0f;
+  uint8_t dac = 128;  ///< stop() deja el DAC a media escala
+  uint8_t dac2 = 128;
+};
+
+/// Tamaños de tabla que admite SynthRenderer (potencias de dos, 2–128)
+bool synthRenderableTable(uint32_t size);
+
+/**
+ * Renderiza y analiza un punto del barrido.
+ * @param spectrum Espectro reutilizable (uno por hilo); fija el tamaño del bloque.
+ * @param samples Búfer de trabajo reutilizable.
+ * @param bandHz Límite superior de la banda de SINAD/SNR.
+ */
+SynthMetrics analyzeSynth(const SynthParams& params, Spectrum& spectrum, std::vector<float>& samples,
+                          double bandHz);
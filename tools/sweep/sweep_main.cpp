@@ -0,0 +1,398 @@
+#include "AdditiveSynth.h"
+#include "DacCosine.h"
+#include "Spectrum.h"
+#include "SynthRender.h"
+#include "TuningProfile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/*
+ * vortex_sweep: barrido de parámetros de la síntesis acústica en el host.
+ *
+ *   vortex_sweep --freq=4200:6400:550 --level=0.25,0.5,1 --table=8,16,32
+ *
+ * Cada punto renderiza la salida del DAC con el código del firmware
+ * (SynthRenderer sobre el estado y los pasos de la ISR de SynthKernel.h), la analiza con una FFT y reporta
+ * potencia de la fundamental, THD, imágenes del muestreo, el mayor espurio
+ * y SINAD/SNR dentro de la banda.
+ * Los puntos se reparten entre todos los núcleos.
+ *
+ * Cada eje acepta una lista "a,b,c" o un rango "desde:hasta:paso".
+ *
+ * Opciones:
+ *   --freq=HZ        Frecuencia pedida (4200:6400:550)
+ *   --load=PCT       En lugar de --freq: carga MAP, con el mapa de fábrica
+ *   --level=L        Nivel 0–1 (0.25,0.5,1)
+ *   --table=N        Muestras por periodo, potencia de dos 2–128 (16)
+ *   --alpha=A        Suavizado de la rampa de nivel (0.9)
+ *   --update-ms=N    Cadencia de update() (20)
+ *   --shaping=0,1    Sin y con conformado de ruido (0)
+ *   --band=HZ        Límite de la banda de SINAD/SNR (20000)
+ *   --fft=N          Bloque de 2^N muestras a 1 MHz (17: 131 ms, 7.6 Hz por bin)
+ *   --threads=N      Hilos (todos los núcleos)
+ *   --csv=ARCHIVO    Además de la tabla, CSV para hojas de cálculo
+ *
+ * Con --coseno no se renderiza nada: se listan los registros del generador
+ * de coseno del DAC (DacCosine.h) para cada frecuencia y nivel, con la
+ * frecuencia y la escala que salen frente a las pedidas, y el error de la
+ * tabla por ISR al lado para comparar.
+ *
+ *   --coseno[=HZ]    RTC8M medido (8500000 nominal; "onda" lo muestra en la consola)
+ *   --cw-div=N       Divisor de RTC8M más alto permitido, 0–7 (0, como el firmware)
+ *
+ * Con --aditiva se verifica el motor aditivo (AdditiveSynth.h): se renderiza
+ * la mezcla a ADDITIVE_SAMPLE_HZ con los osciladores dados y se comprueba
+ * que cada uno sale a su frecuencia con la amplitud esperada tras el margen
+ * (±0.5 dB), sin recortes. Sale con 1 si algo no cuadra.
+ *
+ *   --aditiva[=HZ:NIVEL[:GRADOS],..]   Osciladores (5300:1,484:0.5)
+ */
+
+namespace {
+
+struct Options {
+  std::vector<float> freqs;
+  std::vector<float> loads;
+  std::vector<float> levels{0.25f, 0.5f, 1.0f};
+  std::vector<float> tables{float(SYNTH_TABLE_SIZE)};
+  std::vector<float> alphas{SYNTH_RAMP_ALPHA};
+  std::vector<float> updates{20.0f};
+  std::vector<float> shapings{0.0f};
+  double bandHz = 20000.0;
+  uint32_t fftLog2 = 17;
+  uint32_t threads = 0;
+  const char* csvPath = nullptr;
+  bool cosine = false;
+  float rtc8mHz = CW_RTC8M_NOMINAL_HZ;
+  uint8_t cwMaxDiv = 0;
+  bool additive = false;
+  std::vector<float> oscFreqs, oscLevels, oscPhases;
+};
+
+struct Point {
+  SynthParams params;
+  SynthMetrics metrics;
+};
+
+const char* argValue(const char* arg, const char* key) {
+  size_t n = strlen(key);
+  return strncmp(arg, key, n) == 0 ? arg + n : nullptr;
+}
+
+// "a,b,c" o "desde:hasta:paso"
+bool parseAxis(const char* text, std::vector<float>& out) {
+  out.clear();
+  float lo, hi, step;
+  if (strchr(text, ':')) {
+    if (sscanf(text, "%f:%f:%f", &lo, &hi, &step) != 3 || step <= 0.0f || hi < lo) return false;
+    for (int i = 0; lo + i * step <= hi + step * 1e-3f; ++i) out.push_back(lo + i * step);
+    return true;
+  }
+  const char* p = text;
+  while (*p) {
+    char* end;
+    float v = strtof(p, &end);
+    if (end == p) return false;
+    out.push_back(v);
+    p = *end == ',' ? end + 1 : end;
+    if (*end && *end != ',') return false;
+  }
+  return !out.empty();
+}
+
+// "hz:nivel[:grados],.."
+bool parseOscillators(const char* text, Options& opt) {
+  opt.oscFreqs.clear();
+  opt.oscLevels.clear();
+  opt.oscPhases.clear();
+  const char* p = text;
+  while (*p) {
+    float f, l, g = 0.0f;
+    int used = 0;
+    int n = sscanf(p, "%f:%f%n:%f%n", &f, &l, &used, &g, &used);
+    if (n < 2 || additiveIncrement(f) == 0 || l < 0.0f || l > 1.0f) return false;
+    opt.oscFreqs.push_back(f);
+    opt.oscLevels.push_back(l);
+    opt.oscPhases.push_back(g);
+    p += used;
+    if (*p == ',') ++p;
+    else if (*p) return false;
+  }
+  return !opt.oscFreqs.empty() && opt.oscFreqs.size() <= VORTEX_SYNTH_OSCILLATORS;
+}
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+  for (int i = 1; i < argc; ++i) {
+    const char* v;
+    std::vector<float>* axis = nullptr;
+    if ((v = argValue(argv[i], "--freq="))) axis = &opt.freqs;
+    else if ((v = argValue(argv[i], "--load="))) axis = &opt.loads;
+    else if ((v = argValue(argv[i], "--level="))) axis = &opt.levels;
+    else if ((v = argValue(argv[i], "--table="))) axis = &opt.tables;
+    else if ((v = argValue(argv[i], "--alpha="))) axis = &opt.alphas;
+    else if ((v = argValue(argv[i], "--update-ms="))) axis = &opt.updates;
+    else if ((v = argValue(argv[i], "--shaping="))) axis = &opt.shapings;
+    else if ((v = argValue(argv[i], "--band="))) opt.bandHz = strtod(v, nullptr);
+    else if ((v = argValue(argv[i], "--fft="))) opt.fftLog2 = std::min(22ul, std::max(10ul, strtoul(v, nullptr, 10)));
+    else if ((v = argValue(argv[i], "--threads="))) opt.threads = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--csv="))) opt.csvPath = v;
+    else if (strcmp(argv[i], "--coseno") == 0) opt.cosine = true;
+    else if ((v = argValue(argv[i], "--coseno="))) {
+      opt.cosine = true;
+      opt.rtc8mHz = strtof(v, nullptr);
+      if (opt.rtc8mHz < 1e6f || opt.rtc8mHz > 2e7f) {
+        fprintf(stderr, "RTC8M fuera de 1–20 MHz: %s\n", v);
+        return false;
+      }
+    }
+    else if ((v = argValue(argv[i], "--cw-div="))) opt.cwMaxDiv = std::min(7ul, strtoul(v, nullptr, 10));
+    else if (strcmp(argv[i], "--aditiva") == 0 || (v = argValue(argv[i], "--aditiva="))) {
+      opt.additive = true;
+      if (!parseOscillators(v ? v : "5300:1,484:0.5", opt)) {
+        fprintf(stderr, "Osciladores inválidos (HZ:NIVEL[:GRADOS],.., hasta %u): %s\n",
+                (unsigned)VORTEX_SYNTH_OSCILLATORS, argv[i]);
+        return false;
+      }
+    }
+    else {
+      fprintf(stderr, "Opción desconocida: %s\n", argv[i]);
+      return false;
+    }
+    if (axis && !parseAxis(v, *axis)) {
+      fprintf(stderr, "Eje inválido: %s\n", argv[i]);
+      return false;
+    }
+  }
+
+  for (float t : opt.tables) {
+    if (t != float(uint32_t(t)) || !synthRenderableTable(uint32_t(t))) {
+      fprintf(stderr, "La ISR solo admite tablas de 2, 4, 8, .. 128 muestras: %g\n", t);
+      return false;
+    }
+  }
+  for (float a : opt.alphas) {
+    if (a < 0.0f || a >= 1.0f) {
+      fprintf(stderr, "alpha fuera de [0, 1): %g\n", a);
+      return false;
+    }
+  }
+
+  // La carga pasa por el mismo mapeo que ActuatorManager con el perfil de fábrica
+  if (!opt.loads.empty()) {
+    opt.freqs.clear();
+    for (float load : opt.loads) {
+      opt.freqs.push_back(synthFrequencyForLoad(load, DEFAULT_FREQ_MIN_HZ, DEFAULT_FREQ_MAX_HZ));
+    }
+  } else if (opt.freqs.empty()) {
+    parseAxis("4200:6400:550", opt.freqs);
+  }
+  return true;
+}
+
+std::vector<Point> buildGrid(const Options& opt) {
+  std::vector<Point> grid;
+  for (float f : opt.freqs)
+    for (float l : opt.levels)
+      for (float t : opt.tables)
+        for (float a : opt.alphas)
+          for (float u : opt.updates)
+            for (float ns : opt.shapings) {
+              Point p;
+              p.params.freqHz = f;
+              p.params.level = l;
+              p.params.tableSize = static_cast<uint8_t>(t);
+              p.params.rampAlpha = a;
+              p.params.updateMs = static_cast<uint32_t>(std::max(1.0f, u));
+              p.params.noiseShaping = ns != 0.0f;
+              grid.push_back(p);
+            }
+  return grid;
+}
+
+void runAll(std::vector<Point>& grid, uint32_t fftLog2, double bandHz, uint32_t threads) {
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    Spectrum spectrum(fftLog2);
+    std::vector<float> samples;
+    for (size_t i = next++; i < grid.size(); i = next++) {
+      grid[i].metrics = analyzeSynth(grid[i].params, spectrum, samples, bandHz);
+    }
+  };
+  std::vector<std::thread> pool;
+  for (uint32_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+  worker();
+  for (std::thread& th : pool) th.join();
+}
+
+void writeTable(FILE* out, const std::vector<Point>& grid) {
+  fprintf(out, "%8s %5s %5s %5s %4s %2s | %6s %9s %7s %7s %8s %7s %8s %8s %9s %7s %7s\n",
+          "freq_hz", "nivel", "tabla", "alpha", "upd", "ns", "per_us", "real_hz", "err_hz",
+          "asent", "fund_dB", "thd_%", "img_dBc", "esp_dBc", "esp_hz", "sinad", "snr");
+  for (const Point& p : grid) {
+    const SynthParams& s = p.params;
+    const SynthMetrics& m = p.metrics;
+    fprintf(out, "%8.0f %5.2f %5u %5.2f %4u %2u | %6u %9.1f %+7.1f %5u ms %8.2f %7.2f %8.1f %8.1f %9.0f %7.1f %7.1f\n",
+            s.freqHz, s.level, (unsigned)s.tableSize, s.rampAlpha, (unsigned)s.updateMs, (unsigned)s.noiseShaping,
+            (unsigned)m.periodUs, m.realHz, m.realHz - s.freqHz, (unsigned)m.settleMs,
+            m.fundDbfs, m.thdPct, m.imageDbc, m.spurDbc, m.spurHz, m.sinadDb, m.snrDb);
+  }
+}
+
+void writeCsv(FILE* out, const std::vector<Point>& grid) {
+  fprintf(out, "freq_hz,level,table_size,ramp_alpha,update_ms,noise_shaping,period_us,real_hz,settle_ms,level_int,"
+               "fund_dbfs,thd_pct,image_dbc,spur_dbc,spur_hz,sinad_db,snr_db\n");
+  for (const Point& p : grid) {
+    const SynthParams& s = p.params;
+    const SynthMetrics& m = p.metrics;
+    fprintf(out, "%.1f,%.3f,%u,%.3f,%u,%u,%u,%.3f,%u,%u,%.3f,%.4f,%.2f,%.2f,%.1f,%.2f,%.2f\n",
+            s.freqHz, s.level, (unsigned)s.tableSize, s.rampAlpha, (unsigned)s.updateMs, (unsigned)s.noiseShaping,
+            (unsigned)m.periodUs, m.realHz, (unsigned)m.settleMs, (unsigned)m.levelInt,
+            m.fundDbfs, m.thdPct, m.imageDbc, m.spurDbc, m.spurHz, m.sinadDb, m.snrDb);
+  }
+}
+
+// Registros del generador de coseno; la tabla por ISR al lado como referencia
+void writeCosine(FILE* out, const Options& opt, bool csv) {
+  if (csv) {
+    fprintf(out, "freq_hz,level,fstep,clk_div,real_hz,err_hz,scale,amplitude,table_real_hz,table_err_hz\n");
+  } else {
+    fprintf(out, "RTC8M %.0f Hz, divisor hasta %u\n", opt.rtc8mHz, (unsigned)opt.cwMaxDiv);
+    fprintf(out, "%8s %5s | %6s %3s %9s %7s %6s %6s %7s | %9s %7s\n",
+            "freq_hz", "nivel", "fstep", "div", "real_hz", "err_hz", "escala", "amp", "amp_dB",
+            "tabla_hz", "err_hz");
+  }
+  for (float f : opt.freqs) {
+    CwToneSettings cw = cwToneForFrequency(f, opt.rtc8mHz, opt.cwMaxDiv);
+    uint32_t period = synthTimerPeriodUs(f, SYNTH_TABLE_SIZE);
+    double tableHz = double(SYNTH_TIMER_HZ) / (double(std::max<uint32_t>(1, period)) * SYNTH_TABLE_SIZE);
+    for (float l : opt.levels) {
+      uint8_t scale = cwScaleForLevel(l);
+      float amp = cwScaleAmplitude(scale);
+      int scaleOut = scale == CW_SCALE_OFF ? -1 : scale;
+      if (csv) {
+        fprintf(out, "%.1f,%.3f,%u,%u,%.3f,%.3f,%d,%.4f,%.3f,%.3f\n", f, l, (unsigned)cw.freqStep,
+                (unsigned)cw.clkDiv, cw.realHz, cw.errorHz, scaleOut, amp, tableHz, tableHz - f);
+        continue;
+      }
+      char ampDb[16] = "-inf";
+      if (amp > 0.0f && l > 0.0f) snprintf(ampDb, sizeof(ampDb), "%+7.1f", 20.0 * log10(amp / l));
+      fprintf(out, "%8.0f %5.2f | %6u %3u %9.1f %+7.1f %6s %6.3f %7s | %9.1f %+7.1f\n", f, l,
+              (unsigned)cw.freqStep, (unsigned)cw.clkDiv, cw.realHz, cw.errorHz,
+              scale == CW_SCALE_OFF ? "off" : (scale == 0 ? "1" : scale == 1 ? "1/2" : scale == 2 ? "1/4" : "1/8"),
+              amp, ampDb, tableHz, tableHz - f);
+    }
+  }
+}
+
+// Verificación espectral del motor aditivo con los osciladores del firmware
+int runAdditive(const Options& opt) {
+  AdditiveState<VORTEX_SYNTH_OSCILLATORS> s;
+  uint8_t levels[VORTEX_SYNTH_OSCILLATORS] = {};
+  additiveFillTable(s.table);
+  for (size_t i = 0; i < opt.oscFreqs.size(); ++i) {
+    levels[i] = synthLevelInt(opt.oscLevels[i]);
+    s.osc[i].increment = additiveIncrement(opt.oscFreqs[i]);
+    s.osc[i].level = levels[i];
+    s.osc[i].phase = additivePhase(opt.oscPhases[i]);
+  }
+  s.gain = additiveGain(levels, VORTEX_SYNTH_OSCILLATORS, 255);
+
+  // 2^16 muestras a 50 kHz: 1.3 s, 0.76 Hz por bin
+  Spectrum spectrum(16);
+  std::vector<float> samples(spectrum.size());
+  for (float& v : samples) v = additiveStep(s);
+  spectrum.compute(samples.data(), ADDITIVE_SAMPLE_HZ);
+
+  const size_t LOBE = 4;  // Medio lóbulo de Blackman-Harris
+  fprintf(stdout, "%u osciladores a %u Hz, ganancia %u/256, recortes %u\n", (unsigned)VORTEX_SYNTH_OSCILLATORS,
+          (unsigned)ADDITIVE_SAMPLE_HZ, (unsigned)s.gain, (unsigned)s.clipped);
+  fprintf(stdout, "%3s %9s %9s %5s %7s | %9s %9s %7s\n", "osc", "pedida_hz", "real_hz", "nivel", "grados",
+          "esperada", "medida", "err_dB");
+  bool ok = s.clipped == 0;
+  for (size_t i = 0; i < opt.oscFreqs.size(); ++i) {
+    double realHz = additiveFrequency(s.osc[i].increment);
+    double expected = 127.0 * levels[i] / 255.0 * s.gain / 256.0;
+    double measured = sqrt(2.0 * spectrum.bandPower(realHz, LOBE));
+    double errDb = expected > 0.0 && measured > 0.0 ? 20.0 * log10(measured / expected) : 0.0;
+    bool pass = expected < 1.0 || fabs(errDb) <= 0.5;
+    ok = ok && pass;
+    fprintf(stdout, "%3zu %9.1f %9.2f %5.2f %+7.1f | %9.2f %9.2f %+7.2f%s\n", i, opt.oscFreqs[i], realHz,
+            opt.oscLevels[i], opt.oscPhases[i], expected, measured, errDb, pass ? "" : "  ✗");
+  }
+
+  // Mayor espurio fuera de los lóbulos de los osciladores y de continua
+  double spurPower = 0.0, spurHz = 0.0, totalPower = 0.0;
+  for (size_t k = LOBE + 1; k < spectrum.bins(); ++k) {
+    double hz = k * spectrum.binHz();
+    bool inLobe = false;
+    for (size_t i = 0; i < opt.oscFreqs.size(); ++i) {
+      size_t c = spectrum.binOf(additiveFrequency(s.osc[i].increment));
+      if (k + LOBE >= c && k <= c + LOBE) inLobe = true;
+    }
+    if (!inLobe && spectrum.binPower(k) > spurPower) {
+      spurPower = spectrum.binPower(k);
+      spurHz = hz;
+    }
+    if (inLobe) totalPower += spectrum.binPower(k);
+  }
+  double spurDbc = spurPower > 0.0 && totalPower > 0.0 ? 10.0 * log10(spurPower / totalPower) : -200.0;
+  fprintf(stdout, "Espurio  %.1f dBc a %.0f Hz\n", spurDbc, spurHz);
+  fprintf(stdout, "%s\n", ok ? "OK" : "FALLO");
+  return ok ? 0 : 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseOptions(argc, argv, opt)) {
+    fprintf(stderr, "Uso: vortex_sweep [--freq=..|--load=..] [--level=..] [--table=..] [--alpha=..] [--update-ms=..] [--shaping=..] [--band=HZ] [--coseno[=HZ]] [--aditiva[=HZ:NIVEL[:GRADOS],..]]\n");
+    return 2;
+  }
+
+  if (opt.additive) return runAdditive(opt);
+
+  if (opt.cosine) {
+    writeCosine(stdout, opt, false);
+    if (opt.csvPath) {
+      FILE* csv = fopen(opt.csvPath, "w");
+      if (!csv) {
+        fprintf(stderr, "No se pudo escribir %s\n", opt.csvPath);
+        return 2;
+      }
+      writeCosine(csv, opt, true);
+      fclose(csv);
+    }
+    return 0;
+  }
+
+  std::vector<Point> grid = buildGrid(opt);
+  uint32_t threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+  threads = std::min<uint32_t>(threads, grid.size());
+
+  fprintf(stderr, "%zu puntos, bloque FFT de %u muestras, %u hilos\n", grid.size(), 1u << opt.fftLog2, threads);
+  auto t0 = std::chrono::steady_clock::now();
+  runAll(grid, opt.fftLog2, opt.bandHz, threads);
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  fprintf(stderr, "%.2f s\n", wallS);
+
+  writeTable(stdout, grid);
+
+  if (opt.csvPath) {
+    FILE* csv = fopen(opt.csvPath, "w");
+    if (!csv) {
+      fprintf(stderr, "No se pudo escribir %s\n", opt.csvPath);
+      return 2;
+    }
+    writeCsv(csv, grid);
+    fclose(csv);
+  }
+  return 0;
+}
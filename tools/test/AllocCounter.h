@@ -0,0 +1,19 @@
+#pragma once
+
+#include <stdint.h>
+
+/*
+ * Cuenta las reservas de memoria dinámica del ejecutable de pruebas: todo
+ * operator new y, con -Wl,--wrap (tools/test/CMakeLists.txt), las llamadas a
+ * malloc/calloc/realloc del código enlazado, incluido vortex_host. Lo que
+ * la libc reserve por dentro no se ve.
+ *
+ *   uint64_t before = test::allocationCount();
+ *   caminoCaliente();
+ *   EXPECT_EQ(test::allocationCount() - before, 0u);
+ */
+namespace test {
+
+uint64_t allocationCount();
+
+}  // namespace test
@@ -0,0 +1,96 @@
+#include "TestHarness.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+/*
+ * Runner de las pruebas.
+ *
+ *   vortex_tests [--filter=TEXTO] [--list]
+ *
+ * CTest lo lanza una vez por suite con --filter=Suite. (tools/test/CMakeLists.txt).
+ */
+namespace test {
+
+namespace {
+
+struct Registered {
+  std::string fullName;
+  Function fn;
+};
+
+std::vector<Registered>& registry() {
+  static std::vector<Registered> list;
+  return list;
+}
+
+constexpr unsigned MAX_REPORTED = 10;  // Un lazo que falla en cada vuelta no inunda la salida
+unsigned failures = 0;
+
+const char* argValue(const char* arg, const char* key) {
+  size_t n = strlen(key);
+  return strncmp(arg, key, n) == 0 ? arg + n : nullptr;
+}
+
+}  // namespace
+
+int registerTest(const char* suite, const char* name, Function fn) {
+  registry().push_back(Registered{std::string(suite) + "." + name, fn});
+  return static_cast<int>(registry().size());
+}
+
+void fail(const char* file, int line, const std::string& message) {
+  if (++failures <= MAX_REPORTED) {
+    const char* slash = strrchr(file, '/');
+    fprintf(stderr, "  %s:%d: %s\n", slash ? slash + 1 : file, line, message.c_str());
+  } else if (failures == MAX_REPORTED + 1) {
+    fprintf(stderr, "  (más fallos omitidos)\n");
+  }
+}
+
+}  // namespace test
+
+int main(int argc, char** argv) {
+  using namespace test;
+
+  const char* filter = nullptr;
+  bool list = false;
+  for (int i = 1; i < argc; ++i) {
+    const char* v;
+    if ((v = argValue(argv[i], "--filter="))) filter = v;
+    else if (strcmp(argv[i], "--list") == 0) list = true;
+    else {
+      fprintf(stderr, "Opción desconocida: %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  std::vector<Registered> selected;
+  for (const Registered& t : registry()) {
+    if (!filter || strstr(t.fullName.c_str(), filter)) selected.push_back(t);
+  }
+  std::sort(selected.begin(), selected.end(),
+            [](const Registered& a, const Registered& b) { return a.fullName < b.fullName; });
+
+  if (list) {
+    for (const Registered& t : selected) printf("%s\n", t.fullName.c_str());
+    return 0;
+  }
+  if (selected.empty()) {
+    fprintf(stderr, "Ninguna prueba coincide con '%s'\n", filter ? filter : "");
+    return 1;
+  }
+
+  unsigned failed = 0;
+  for (const Registered& t : selected) {
+    failures = 0;
+    t.fn();
+    printf("%-8s %s\n", failures ? "[FALLO]" : "[ OK ]", t.fullName.c_str());
+    fflush(stdout);
+    failed += failures != 0;
+  }
+  printf("\n%zu prueba(s), %u con fallos\n", selected.size(), failed);
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <math.h>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+/*
+ * Arnés mínimo de pruebas unitarias al estilo Google Test, sin dependencias
+ * externas, para el código portable del firmware:
+ *
+ *   TEST(Suite, Caso) {
+ *     EXPECT_EQ(algo(), 3);
+ *     ASSERT_TRUE(puntero);   // Si falla, el caso termina aquí
+ *   }
+ *
+ * EXPECT_* anota el fallo y sigue; ASSERT_* anota y sale del caso. El runner
+ * (TestHarness.cpp) ejecuta los casos cuyo "Suite.Caso" contiene --filter y
+ * termina con código 1 si alguno falla o si el filtro no encuentra ninguno.
+ */
+namespace test {
+
+typedef void (*Function)();
+
+int registerTest(const char* suite, const char* name, Function fn);
+
+/// Anota un fallo del caso en curso
+void fail(const char* file, int line, const std::string& message);
+
+/// Texto de un valor para el mensaje de fallo (uint8_t como número, enum como entero)
+template <typename T>
+std::string describe(const T& value) {
+  std::ostringstream os;
+  if constexpr (std::is_enum<T>::value) {
+    os << static_cast<long long>(value);
+  } else if constexpr (std::is_arithmetic<T>::value) {
+    os << +value;
+  } else {
+    os << value;
+  }
+  return os.str();
+}
+
+template <typename A, typename B>
+bool compare(const char* file, int line, bool ok, const char* expr, const A& a, const B& b) {
+  if (!ok) fail(file, line, std::string(expr) + " con " + describe(a) + " y " + describe(b));
+  return ok;
+}
+
+}  // namespace test
+
+#define TEST(suite, name)                                                                      \
+  static void test_##suite##_##name();                                                         \
+  static int test_registered_##suite##_##name = ::test::registerTest(#suite, #name, test_##suite##_##name); \
+  static void test_##suite##_##name()
+
+// Cada operando se evalúa una sola vez
+#define TEST_CMP_(a, op, b)                                                                   \
+  [&](const auto& lhs_, const auto& rhs_) {                                                  \
+    return ::test::compare(__FILE__, __LINE__, lhs_ op rhs_, #a " " #op " " #b, lhs_, rhs_); \
+  }((a), (b))
+
+#define EXPECT_TRUE(cond) \
+  ((cond) ? true : (::test::fail(__FILE__, __LINE__, "no se cumple: " #cond), false))
+#define EXPECT_FALSE(cond) EXPECT_TRUE(!(cond))
+#define EXPECT_EQ(a, b) TEST_CMP_(a, ==, b)
+#define EXPECT_NE(a, b) TEST_CMP_(a, !=, b)
+#define EXPECT_LT(a, b) TEST_CMP_(a, <, b)
+#define EXPECT_LE(a, b) TEST_CMP_(a, <=, b)
+#define EXPECT_GT(a, b) TEST_CMP_(a, >, b)
+#define EXPECT_GE(a, b) TEST_CMP_(a, >=, b)
+#define EXPECT_NEAR(a, b, tol)                                                                \
+  [&](double lhs_, double rhs_) {                                                             \
+    return ::test::compare(__FILE__, __LINE__, fabs(lhs_ - rhs_) <= (tol), #a " ≈ " #b " ± " #tol, lhs_, rhs_); \
+  }((a), (b))
+
+#define ASSERT_TRUE(cond) if (!EXPECT_TRUE(cond)) return
+#define ASSERT_FALSE(cond) if (!EXPECT_FALSE(cond)) return
+#define ASSERT_EQ(a, b) if (!EXPECT_EQ(a, b)) return
+#define ASSERT_LE(a, b) if (!EXPECT_LE(a, b)) return
+#define ASSERT_GE(a, b) if (!EXPECT_GE(a, b)) return
@@ -0,0 +1,84 @@
+// AcousticEq: tabla de ecualización desde las medidas del tweeter, su
+// interpolación y su paso a la tabla de carga
+#include "TestHarness.h"
+#include "AcousticEq.h"
+#include "SynthTuningTable.h"
+#include <math.h>
+
+namespace {
+
+const float Q = 1.0f / EQ_GAIN_UNITY;  // Resolución de la ganancia guardada
+
+// 5310 Hz se promedia con 5300: niveles -3, 1 y 3 dB, media 1/3
+AcousticEqBuilder threePoints() {
+  AcousticEqBuilder b;
+  b.addMeasurement(4200.0f, -3.0f);
+  b.addMeasurement(6400.0f, 3.0f);
+  b.addMeasurement(5300.0f, 0.0f);
+  b.addMeasurement(5310.0f, 2.0f);
+  return b;
+}
+
+}  // namespace
+
+TEST(AcousticEq, WithoutTableGainIsUnity) {
+  AcousticEqData eq;
+  EXPECT_EQ(eqGainAt(eq, 5000.0f), 1.0f);
+}
+
+TEST(AcousticEq, MeasurementsAreSortedAndMerged) {
+  AcousticEqBuilder b = threePoints();
+  EXPECT_EQ(b.size(), 3u);
+  EXPECT_EQ(b.frequencyAt(0), 4200.0f);
+  EXPECT_EQ(b.frequencyAt(1), 5300.0f);
+  EXPECT_NEAR(b.levelDbAt(1), 1.0f, 1e-6f);
+}
+
+TEST(AcousticEq, GainFlattensTowardsTheMean) {
+  AcousticEqData eq;
+  ASSERT_TRUE(threePoints().build(eq));
+  ASSERT_EQ(eq.count, 3);
+  const float mean = 1.0f / 3.0f;
+  const float expected[3] = {powf(10.0f, (mean + 3.0f) / 20.0f), powf(10.0f, (mean - 1.0f) / 20.0f),
+                             powf(10.0f, (mean - 3.0f) / 20.0f)};
+  for (uint8_t i = 0; i < 3; ++i) EXPECT_NEAR(eqGainAt(eq, eq.freqHz[i]), expected[i], Q);
+
+  // Lineal entre puntos; fuera del rango medido, el extremo
+  EXPECT_NEAR(eqGainAt(eq, 4750.0f), 0.5f * (eq.gain[0] + eq.gain[1]) * Q, 1e-6f);
+  EXPECT_EQ(eqGainAt(eq, 3000.0f), eq.gain[0] * Q);
+  EXPECT_EQ(eqGainAt(eq, 9000.0f), eq.gain[2] * Q);
+}
+
+TEST(AcousticEq, LoadTableTakesTheGainOfEachBin) {
+  AcousticEqData eq;
+  ASSERT_TRUE(threePoints().build(eq));
+  SynthTuningTable tuning;
+  tuning.applyEq(eq);
+  for (uint8_t bin = 0; bin < SYNTH_LOAD_BINS; ++bin) {
+    if (!EXPECT_EQ(tuning.gain(bin), eqGainAt(eq, tuning.frequencyHz(bin)))) break;
+  }
+  // Rehacer la tabla desde el mapa la deja sin ecualizar
+  tuning.build(ActuationMap());
+  EXPECT_EQ(tuning.gain(50), 1.0f);
+}
+
+TEST(AcousticEq, BuilderLimits) {
+  AcousticEqBuilder b;
+  for (uint8_t i = 0; i < EQ_MAX_POINTS; ++i) {
+    EXPECT_TRUE(b.addMeasurement(4200.0f + 200.0f * i, i == 5 ? -30.0f : 0.0f));
+  }
+  EXPECT_FALSE(b.addMeasurement(7000.0f, 0.0f));  // Ya hay EQ_MAX_POINTS
+  EXPECT_TRUE(b.addMeasurement(5205.0f, -30.0f));  // Lleno, pero se promedia con 5200
+  AcousticEqData eq;
+  ASSERT_TRUE(b.build(eq));
+  // Un agujero de 30 dB se corrige solo hasta EQ_GAIN_MAX
+  EXPECT_EQ(eq.gain[5], (uint16_t)(EQ_GAIN_MAX * EQ_GAIN_UNITY));
+
+  // Respuesta plana: nada que corregir
+  b.reset();
+  b.addMeasurement(4200.0f, 80.0f);
+  b.addMeasurement(6400.0f, 80.0f);
+  ASSERT_TRUE(b.build(eq));
+  EXPECT_EQ(eq.gain[0], EQ_GAIN_UNITY);
+  EXPECT_EQ(eq.gain[1], EQ_GAIN_UNITY);
+}
@@ -0,0 +1,87 @@
+// AdditiveSynth: mezcla de osciladores del modo aditivo, con el margen de
+// additiveGain() y cada oscilador a su frecuencia y amplitud
+#include "TestHarness.h"
+#include "AdditiveSynth.h"
+#include "Spectrum.h"
+#include <math.h>
+#include <vector>
+
+namespace {
+
+// Todos a nivel máximo y en fase durante un segundo: el peor pico posible
+template <uint8_t N>
+void expectNoClipInPhase() {
+  AdditiveState<N> s;
+  uint8_t levels[N];
+  additiveFillTable(s.table);
+  for (uint8_t i = 0; i < N; ++i) {
+    levels[i] = 255;
+    s.osc[i].level = 255;
+    s.osc[i].phase = additivePhase(90.0f);
+    s.osc[i].increment = additiveIncrement(HELMHOLTZ_HZ * (i + 1));
+  }
+  s.gain = additiveGain(levels, N, 255);
+  for (uint32_t i = 0; i < ADDITIVE_SAMPLE_HZ; ++i) additiveStep(s);
+  EXPECT_EQ(s.clipped, 0u);
+}
+
+}  // namespace
+
+TEST(AdditiveSynth, FullLevelInPhaseNeverClips) {
+  expectNoClipInPhase<1>();
+  expectNoClipInPhase<2>();
+  expectNoClipInPhase<4>();
+  expectNoClipInPhase<8>();
+  expectNoClipInPhase<16>();
+}
+
+TEST(AdditiveSynth, GainLeavesHeadroomOnlyWhenNeeded) {
+  uint8_t one[] = {255};
+  uint8_t quiet[] = {100, 100};
+  uint8_t two[] = {255, 255};
+  EXPECT_EQ(additiveGain(one, 1, 255), 256);
+  EXPECT_EQ(additiveGain(quiet, 2, 255), 256);  // La suma ya cabe
+  EXPECT_EQ(additiveGain(two, 2, 255), 128);
+  EXPECT_EQ(additiveGain(two, 2, 0), 0);
+  EXPECT_NEAR(additiveGain(one, 1, 128), 128.5, 1.0);
+}
+
+TEST(AdditiveSynth, IncrementAndPhase) {
+  for (float f : {HELMHOLTZ_HZ, 5300.0f, 24000.0f}) {
+    EXPECT_NEAR(additiveFrequency(additiveIncrement(f)), f, 1e-3);
+  }
+  EXPECT_EQ(additiveIncrement(0.0f), 0u);
+  EXPECT_EQ(additiveIncrement(-100.0f), 0u);
+  EXPECT_EQ(additiveIncrement(ADDITIVE_SAMPLE_HZ / 2.0f), 0u);  // Sin espacio bajo Nyquist
+  EXPECT_EQ(additivePhase(0.0f), 0u);
+  EXPECT_EQ(additivePhase(90.0f), 1u << 30);
+  EXPECT_EQ(additivePhase(-90.0f), 3u << 30);
+  EXPECT_EQ(additivePhase(450.0f), 1u << 30);
+}
+
+TEST(AdditiveSynth, OscillatorsComeOutAtTheirLevel) {
+  // La portadora y la resonancia de la cavidad a media amplitud, como begin()
+  const float freqs[] = {5300.0f, HELMHOLTZ_HZ};
+  const uint8_t levels[] = {255, 128};
+  AdditiveState<2> s;
+  additiveFillTable(s.table);
+  for (uint8_t i = 0; i < 2; ++i) {
+    s.osc[i].level = levels[i];
+    s.osc[i].increment = additiveIncrement(freqs[i]);
+  }
+  s.gain = additiveGain(levels, 2, 255);
+
+  // 2^16 muestras a 50 kHz: 0.76 Hz por bin
+  Spectrum spectrum(16);
+  std::vector<float> samples(spectrum.size());
+  for (float& v : samples) v = additiveStep(s);
+  spectrum.compute(samples.data(), ADDITIVE_SAMPLE_HZ);
+  EXPECT_EQ(s.clipped, 0u);
+
+  const size_t LOBE = 4;  // Medio lóbulo de Blackman-Harris
+  for (uint8_t i = 0; i < 2; ++i) {
+    double expected = 127.0 * levels[i] / 255.0 * s.gain / 256.0;
+    double measured = sqrt(2.0 * spectrum.bandPower(additiveFrequency(s.osc[i].increment), LOBE));
+    EXPECT_NEAR(20.0 * log10(measured / expected), 0.0, 0.5);
+  }
+}
@@ -0,0 +1,191 @@
+// BleProtocol: tramas de telemetría según el MTU, su decodificación en el
+// cliente y la validación de los comandos de la característica de control
+#include "TestHarness.h"
+#include "BleProtocol.h"
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+TelemetrySample sampleAt(uint32_t tMs, uint32_t i) {
+  TelemetrySample s;
+  s.tMs = tMs;
+  s.state = static_cast<uint8_t>(i % 9);
+  s.flags = static_cast<uint8_t>(i & 7);
+  s.tpsCenti = static_cast<int16_t>(i * 137 - 5000);
+  s.mapCenti = static_cast<int16_t>(-static_cast<int32_t>(i) * 311);
+  s.freqHz = static_cast<uint16_t>(4200 + i * 10);
+  s.level = static_cast<uint8_t>(i * 29);
+  s.profile = static_cast<uint8_t>(i % 4);
+  return s;
+}
+
+bool sameSample(const TelemetrySample& a, const TelemetrySample& b) {
+  return a.tMs == b.tMs && a.state == b.state && a.flags == b.flags && a.tpsCenti == b.tpsCenti &&
+         a.mapCenti == b.mapCenti && a.freqHz == b.freqHz && a.level == b.level && a.profile == b.profile;
+}
+
+bool decodes(const uint8_t* data, size_t len) {
+  ControlCommand cmd;
+  return decodeControl(data, len, cmd);
+}
+
+}  // namespace
+
+TEST(BleProtocol, CentiRoundsAndSaturates) {
+  EXPECT_EQ(telemetryCenti(12.34f), 1234);
+  EXPECT_EQ(telemetryCenti(-12.34f), -1234);
+  EXPECT_EQ(telemetryCenti(0.004f), 0);
+  EXPECT_EQ(telemetryCenti(0.006f), 1);
+  EXPECT_EQ(telemetryCenti(1e6f), 32767);
+  EXPECT_EQ(telemetryCenti(-1e6f), -32768);
+}
+
+TEST(BleProtocol, PayloadLimitIsClamped) {
+  TelemetryBatcher b;
+  EXPECT_EQ(b.getPayloadLimit(), BLE_MIN_PAYLOAD);
+  b.setPayloadLimit(3);
+  EXPECT_EQ(b.getPayloadLimit(), BLE_MIN_PAYLOAD);
+  b.setPayloadLimit(512);
+  EXPECT_EQ(b.getPayloadLimit(), BLE_MAX_PAYLOAD);
+}
+
+TEST(BleProtocol, FramesFillTheMtuAndRoundTrip) {
+  for (size_t payload : {BLE_MIN_PAYLOAD, size_t(23), size_t(100), size_t(182), BLE_MAX_PAYLOAD}) {
+    TelemetryBatcher b;
+    b.setPayloadLimit(payload);
+    std::vector<TelemetrySample> sent;
+    for (uint32_t i = 0; i < 64; ++i) {
+      TelemetrySample s = sampleAt(50000 + i * 20, i);
+      if (!b.fits(s)) break;
+      b.add(s);
+      sent.push_back(s);
+    }
+    // Tantas muestras como caben, ni una más
+    const size_t capacity = (payload - BLE_TELEMETRY_HEADER) / BLE_TELEMETRY_SAMPLE;
+    EXPECT_EQ(sent.size(), capacity);
+    EXPECT_LE(b.size(), payload);
+    EXPECT_EQ(b.size(), BLE_TELEMETRY_HEADER + capacity * BLE_TELEMETRY_SAMPLE);
+    EXPECT_EQ(b.firstMs(), 50000u);
+
+    TelemetryFrameInfo info;
+    TelemetrySample got[32];
+    ASSERT_EQ(decodeTelemetry(b.data(), b.size(), info, got, 32), sent.size());
+    EXPECT_EQ(info.seq, 0);
+    EXPECT_EQ(info.count, sent.size());
+    EXPECT_EQ(info.baseMs, 50000u);
+    for (size_t i = 0; i < sent.size(); ++i) {
+      if (!EXPECT_TRUE(sameSample(got[i], sent[i]))) break;
+    }
+  }
+}
+
+TEST(BleProtocol, DeltaTimeStaysWithin16Bits) {
+  TelemetryBatcher b;
+  b.setPayloadLimit(BLE_MAX_PAYLOAD);
+  EXPECT_TRUE(b.fits(sampleAt(1000, 0)));  // La primera siempre cabe
+  b.add(sampleAt(1000, 0));
+  EXPECT_TRUE(b.fits(sampleAt(1000 + 0xFFFF, 1)));
+  EXPECT_FALSE(b.fits(sampleAt(1000 + 0x10000, 1)));
+
+  // millis() dando la vuelta a mitad de trama
+  TelemetryBatcher w;
+  w.setPayloadLimit(BLE_MAX_PAYLOAD);
+  w.add(sampleAt(0xFFFFFF00u, 0));
+  ASSERT_TRUE(w.fits(sampleAt(0x100, 1)));
+  w.add(sampleAt(0x100, 1));
+  TelemetryFrameInfo info;
+  TelemetrySample got[2];
+  ASSERT_EQ(decodeTelemetry(w.data(), w.size(), info, got, 2), 2u);
+  EXPECT_EQ(got[1].tMs, 0x100u);
+}
+
+TEST(BleProtocol, ResetAdvancesSeq) {
+  TelemetryBatcher b;
+  TelemetryFrameInfo info;
+  TelemetrySample got[1];
+  for (uint32_t frame = 0; frame < 300; ++frame) {
+    b.add(sampleAt(frame * 1000, frame));
+    if (!EXPECT_EQ(decodeTelemetry(b.data(), b.size(), info, got, 1), 1u)) break;
+    // seq da la vuelta en 8 bits; cada trama empieza con su propia base
+    if (!EXPECT_EQ(info.seq, frame & 0xFF)) break;
+    if (!EXPECT_EQ(info.baseMs, frame * 1000)) break;
+    b.reset();
+    if (!EXPECT_EQ(b.count(), 0)) break;
+    if (!EXPECT_EQ(b.size(), BLE_TELEMETRY_HEADER)) break;
+  }
+}
+
+TEST(BleProtocol, DecodeTelemetryValidatesTheFrame) {
+  TelemetryBatcher b;
+  b.setPayloadLimit(BLE_MAX_PAYLOAD);
+  b.add(sampleAt(100, 0));
+  b.add(sampleAt(120, 1));
+  b.add(sampleAt(140, 2));
+  uint8_t frame[BLE_MAX_PAYLOAD + 1];
+  memcpy(frame, b.data(), b.size());
+  const size_t len = b.size();
+  TelemetryFrameInfo info;
+  TelemetrySample got[3];
+
+  EXPECT_EQ(decodeTelemetry(frame, BLE_TELEMETRY_HEADER - 1, info, got, 3), 0u);
+  // La longitud tiene que cuadrar con n
+  EXPECT_EQ(decodeTelemetry(frame, len - 1, info, got, 3), 0u);
+  EXPECT_EQ(decodeTelemetry(frame, len + 1, info, got, 3), 0u);
+  EXPECT_EQ(decodeTelemetry(frame, len - BLE_TELEMETRY_SAMPLE, info, got, 3), 0u);
+  // Solo se copian max muestras
+  EXPECT_EQ(decodeTelemetry(frame, len, info, got, 2), 2u);
+  EXPECT_EQ(info.count, 3);
+
+  frame[0] = 0x02;
+  EXPECT_EQ(decodeTelemetry(frame, len, info, got, 3), 0u);
+  frame[0] = BLE_FRAME_TELEMETRY;
+  frame[3] = BLE_PROTOCOL_VERSION + 1;
+  EXPECT_EQ(decodeTelemetry(frame, len, info, got, 3), 0u);
+  frame[3] = BLE_PROTOCOL_VERSION;
+  EXPECT_EQ(decodeTelemetry(frame, len, info, got, 3), 3u);
+}
+
+TEST(BleProtocol, ControlRoundTrip) {
+  ControlCommand cmds[5];
+  cmds[0].op = BleOp::SET_VALUE;
+  cmds[0].index = 7;
+  cmds[0].value = -12.5f;
+  cmds[1].op = BleOp::SELECT_PROFILE;
+  cmds[1].index = 3;
+  cmds[2].op = BleOp::SAVE;
+  cmds[3].op = BleOp::CALIBRATE;
+  cmds[4].op = BleOp::TELEMETRY_RATE;
+  cmds[4].intervalMs = 0xBEEF;
+  const size_t sizes[] = {6, 2, 1, 1, 3};
+
+  for (size_t i = 0; i < 5; ++i) {
+    uint8_t wire[BLE_MAX_CONTROL + 1];
+    ASSERT_EQ(encodeControl(cmds[i], wire), sizes[i]);
+    ControlCommand got;
+    ASSERT_TRUE(decodeControl(wire, sizes[i], got));
+    EXPECT_EQ(static_cast<uint8_t>(got.op), static_cast<uint8_t>(cmds[i].op));
+    EXPECT_EQ(got.index, cmds[i].index);
+    EXPECT_EQ(got.value, cmds[i].value);
+    EXPECT_EQ(got.intervalMs, cmds[i].intervalMs);
+
+    // Un byte de más o de menos no es el mismo comando
+    EXPECT_FALSE(decodes(wire, sizes[i] - 1));
+    wire[sizes[i]] = 0;
+    EXPECT_FALSE(decodes(wire, sizes[i] + 1));
+  }
+}
+
+TEST(BleProtocol, ControlRejectsUnknownOpsAndNaN) {
+  for (uint8_t op : {0x00, 0x06, 0x7F, 0xFF}) {
+    uint8_t wire[BLE_MAX_CONTROL] = {op};
+    for (size_t len = 1; len <= BLE_MAX_CONTROL; ++len) EXPECT_FALSE(decodes(wire, len));
+  }
+
+  ControlCommand cmd;
+  cmd.op = BleOp::SET_VALUE;
+  cmd.value = NAN;
+  uint8_t wire[BLE_MAX_CONTROL];
+  EXPECT_FALSE(decodes(wire, encodeControl(cmd, wire)));
+}
@@ -0,0 +1,215 @@
+// ByteRing frente a un sumidero lento o desconectado: nunca bloquea, no corta
+// mensajes, cuenta lo perdido y, con DROP_OLDEST, reanuda con lo reciente
+#include "TestHarness.h"
+#include "ByteRing.h"
+#include <atomic>
+#include <stdio.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+// Línea numerada de longitud variable con su propia comprobación
+std::string makeLine(uint32_t seq) {
+  char buf[48];
+  std::string pad(seq % 7, '.');
+  snprintf(buf, sizeof(buf), "L%06u%s#%02x\n", static_cast<unsigned>(seq), pad.c_str(), seq * 37u & 0xFFu);
+  return buf;
+}
+
+bool writeLine(ByteRing& ring, uint32_t seq) {
+  std::string line = makeLine(seq);
+  return ring.write(reinterpret_cast<const uint8_t*>(line.data()), line.size());
+}
+
+// Sumidero falso: acepta como mucho `rate` bytes por llamada, como drainOutput()
+struct SlowSink {
+  std::string received;
+
+  uint32_t drain(ByteRing& ring, uint32_t rate) {
+    uint8_t chunk[64];
+    uint32_t total = 0;
+    while (total < rate) {
+      uint32_t want = rate - total < sizeof(chunk) ? rate - total : sizeof(chunk);
+      uint32_t n = ring.read(chunk, want);
+      if (n == 0) break;
+      received.append(reinterpret_cast<const char*>(chunk), n);
+      total += n;
+    }
+    return total;
+  }
+};
+
+struct Parsed {
+  std::vector<uint32_t> seqs;
+  bool intact = true;  ///< Todas las líneas completas y bien formadas
+};
+
+Parsed parseLines(const std::string& text) {
+  Parsed p;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    size_t end = text.find('\n', pos);
+    if (end == std::string::npos) {
+      p.intact = false;
+      break;
+    }
+    unsigned seq = 0;
+    if (sscanf(text.c_str() + pos, "L%6u", &seq) != 1 || text.compare(pos, end + 1 - pos, makeLine(seq)) != 0) {
+      p.intact = false;
+    }
+    p.seqs.push_back(seq);
+    pos = end + 1;
+  }
+  return p;
+}
+
+bool strictlyIncreasing(const std::vector<uint32_t>& seqs) {
+  for (size_t i = 1; i < seqs.size(); ++i) {
+    if (seqs[i] <= seqs[i - 1]) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(ByteRing, DropNewestKeepsWholeMessagesInOrder) {
+  // El productor escribe una línea por ciclo; el sumidero drena 8 bytes por ciclo
+  static uint8_t storage[256];
+  ByteRing ring(storage, sizeof(storage), ByteRing::Policy::DROP_NEWEST);
+  SlowSink sink;
+  uint32_t offered = 0, refused = 0;
+  for (uint32_t seq = 0; seq < 2000; ++seq) {
+    offered += makeLine(seq).size();
+    if (!writeLine(ring, seq)) refused++;
+    sink.drain(ring, 8);
+  }
+  while (sink.drain(ring, 64) > 0) {}
+
+  Parsed p = parseLines(sink.received);
+  EXPECT_TRUE(p.intact);
+  EXPECT_TRUE(strictlyIncreasing(p.seqs));
+  EXPECT_EQ(p.seqs.front(), 0u);  // Lo pendiente nunca se tira
+  EXPECT_GT(refused, 500u);  // Llegan ~15 bytes por ciclo y salen 8
+
+  ByteRing::Stats st = ring.getStats();
+  EXPECT_EQ(st.overflows, refused);
+  EXPECT_EQ(st.written, sink.received.size());
+  EXPECT_EQ(st.written + st.dropped, offered);
+  EXPECT_LE(st.highWater, ring.capacity());
+}
+
+TEST(ByteRing, DropOldestResumesWithRecentOutput) {
+  // Cliente desconectado mientras la consola imprime: drainOutput() no
+  // entrega nada y solo tira lo antiguo; al reconectar sale lo más reciente
+  static uint8_t storage[256];
+  const uint32_t headroom = sizeof(storage) / 4;
+  ByteRing ring(storage, sizeof(storage), ByteRing::Policy::DROP_OLDEST);
+  SlowSink sink;
+  uint32_t offered = 0;
+  uint32_t seq = 0;
+  for (; seq < 500; ++seq) {
+    offered += makeLine(seq).size();
+    EXPECT_TRUE(writeLine(ring, seq));  // Siempre hay sitio para lo nuevo
+    ring.discardOldest(headroom);
+  }
+  EXPECT_GE(ring.size(), ring.capacity() - headroom - 20);
+
+  // El aviso de conexión se imprime antes de que el cliente se suscriba
+  uint32_t reconnect = seq;
+  offered += makeLine(seq).size();
+  EXPECT_TRUE(writeLine(ring, seq++));
+  ring.discardOldest(headroom);
+  for (; seq < reconnect + 300; ++seq) {
+    offered += makeLine(seq).size();
+    writeLine(ring, seq);
+    sink.drain(ring, 64);
+  }
+  while (sink.drain(ring, 64) > 0) {}
+
+  Parsed p = parseLines(sink.received);
+  EXPECT_TRUE(p.intact);
+  ASSERT_FALSE(p.seqs.empty());
+  // Sin huecos desde lo más antiguo que sobrevivió hasta lo último
+  for (size_t i = 0; i < p.seqs.size(); ++i) {
+    if (!EXPECT_EQ(p.seqs[i], p.seqs.front() + i)) break;
+  }
+  EXPECT_EQ(p.seqs.back(), seq - 1);
+  // Llegan el aviso y casi todo el buffer de lo impreso sin cliente
+  EXPECT_LT(p.seqs.front(), reconnect);
+  size_t away = 0;
+  for (uint32_t s = p.seqs.front(); s < reconnect; ++s) away += makeLine(s).size();
+  EXPECT_GE(away, (ring.capacity() - headroom) * 3 / 4);
+
+  ByteRing::Stats st = ring.getStats();
+  EXPECT_EQ(sink.received.size() + st.dropped, offered);
+  EXPECT_EQ(ring.size(), 0u);
+}
+
+TEST(ByteRing, DiscardOldestOnlyAppliesToDropOldest) {
+  static uint8_t storage[64];
+  ByteRing ring(storage, sizeof(storage), ByteRing::Policy::DROP_NEWEST);
+  uint32_t seq = 0;
+  while (writeLine(ring, seq)) seq++;
+  EXPECT_EQ(ring.discardOldest(sizeof(storage)), 0u);
+  SlowSink sink;
+  sink.drain(ring, 64);
+  EXPECT_EQ(parseLines(sink.received).seqs.front(), 0u);
+}
+
+TEST(ByteRing, OversizedMessageIsDroppedWhole) {
+  static uint8_t storage[64];
+  for (ByteRing::Policy policy : {ByteRing::Policy::DROP_NEWEST, ByteRing::Policy::DROP_OLDEST}) {
+    ByteRing ring(storage, sizeof(storage), policy);
+    std::string big(100, 'x');
+    EXPECT_FALSE(ring.write(reinterpret_cast<const uint8_t*>(big.data()), big.size()));
+    EXPECT_TRUE(writeLine(ring, 7));
+    SlowSink sink;
+    sink.drain(ring, 64);
+    EXPECT_EQ(sink.received, makeLine(7));
+    EXPECT_EQ(ring.getStats().dropped, 100u);
+  }
+}
+
+TEST(ByteRing, ConcurrentProducerAndSlowSink) {
+  // Dos hilos, como la tarea de consola y ConsoleDrain: el productor nunca
+  // espera y el consumidor nunca ve una línea rota, con cualquier política
+  static uint8_t storage[512];
+  for (ByteRing::Policy policy : {ByteRing::Policy::DROP_NEWEST, ByteRing::Policy::DROP_OLDEST}) {
+    ByteRing ring(storage, sizeof(storage), policy);
+    std::atomic<bool> done{false};
+    uint32_t offered = 0;
+
+    std::thread producer([&] {
+      for (uint32_t seq = 0; seq < 50000; ++seq) {
+        offered += makeLine(seq).size();
+        writeLine(ring, seq);
+        std::this_thread::yield();
+      }
+      done.store(true, std::memory_order_release);
+    });
+
+    // Con DROP_OLDEST el sumidero empieza cerrado y el consumidor solo recorta
+    SlowSink sink;
+    uint32_t round = 0;
+    while (!done.load(std::memory_order_acquire)) {
+      if (policy == ByteRing::Policy::DROP_OLDEST && round < 2000) {
+        ring.discardOldest(ring.capacity() / 4);
+        round++;
+      } else {
+        sink.drain(ring, 16 + round++ % 48);
+      }
+      std::this_thread::yield();
+    }
+    producer.join();
+    while (sink.drain(ring, 64) > 0) {}
+
+    Parsed p = parseLines(sink.received);
+    EXPECT_TRUE(p.intact);
+    EXPECT_TRUE(strictlyIncreasing(p.seqs));
+    EXPECT_GT(p.seqs.size(), 16u);
+    ByteRing::Stats st = ring.getStats();
+    EXPECT_EQ(sink.received.size() + st.dropped, offered);
+  }
+}
@@ -0,0 +1,185 @@
+// CalibrationEngine::evaluate() con trazas sintéticas: picos del ADC,
+// deriva durante la calibración y rangos que no se deben guardar
+#include "TestHarness.h"
+#include "CalibrationEngine.h"
+#include <math.h>
+
+namespace {
+
+constexpr uint32_t SAMPLES = 1000;  // 20 s a 50 Hz, como CALIB_DURATION_MS
+constexpr uint16_t TPS_LO = 420, TPS_HI = 3780;
+constexpr uint16_t MAP_LO = 900, MAP_HI = 3900;
+
+// Acelerador de tope a tope: 2 s abajo, 1 s de subida, 2 s arriba, 1 s de bajada
+float sweep(uint32_t i) {
+  uint32_t phase = i % 300;
+  if (phase < 100) return 0.0f;
+  if (phase < 150) return (phase - 100) / 50.0f;
+  if (phase < 250) return 1.0f;
+  return (300 - phase) / 50.0f;
+}
+
+struct Trace {
+  uint32_t seed = 1;
+  float noise = 2.0f;        ///< Cuentas, pico
+  float tpsDrift = 0.0f;     ///< Cuentas que se desplaza el TPS a lo largo de la traza
+  float mapDrift = 0.0f;
+
+  float jitter() {
+    seed = seed * 1664525u + 1013904223u;
+    return noise * ((seed >> 8) / 8388608.0f - 1.0f);
+  }
+  uint16_t clampAdc(float v) { return static_cast<uint16_t>(v < 0.0f ? 0.0f : (v > 4095.0f ? 4095.0f : v + 0.5f)); }
+
+  uint16_t tps(uint32_t i) {
+    return clampAdc(TPS_LO + (TPS_HI - TPS_LO) * sweep(i) + tpsDrift * i / SAMPLES + jitter());
+  }
+  // MAP sube con la carga: vacío al ralentí, atmosférica a fondo
+  uint16_t map(uint32_t i) {
+    return clampAdc(MAP_LO + (MAP_HI - MAP_LO) * sweep(i + 20) + mapDrift * i / SAMPLES + jitter());
+  }
+};
+
+CalibrationReport run(Trace trace, uint32_t spikeEvery = 0, uint16_t spikeValue = 4095, uint8_t spikeLength = 1) {
+  static CalibrationEngine engine;  // 4 KB de histogramas: fuera de la pila
+  engine.reset();
+  for (uint32_t i = 0; i < SAMPLES; ++i) {
+    uint16_t t = trace.tps(i), m = trace.map(i);
+    if (spikeEvery && i % spikeEvery < spikeLength) t = m = spikeValue;
+    engine.addSample(t, m);
+  }
+  return engine.evaluate();
+}
+
+}  // namespace
+
+TEST(CalibrationEngine, CleanSweepFindsTheStops) {
+  CalibrationReport r = run(Trace());
+  EXPECT_TRUE(r.accepted);
+  EXPECT_NEAR(r.tps.min, TPS_LO, 6);
+  EXPECT_NEAR(r.tps.max, TPS_HI, 6);
+  EXPECT_NEAR(r.map.min, MAP_LO, 6);
+  EXPECT_NEAR(r.map.max, MAP_HI, 6);
+  EXPECT_EQ(r.tps.spikeRate, 0.0f);
+  EXPECT_LT(r.tps.noise, 2.0f);
+  EXPECT_GT(r.quality, 0.9f);
+}
+
+TEST(CalibrationEngine, IsolatedSpikesDoNotWidenTheRange) {
+  // Un pico a fondo de escala cada 50 muestras (2 %) y otro a 0 en otra traza
+  CalibrationReport clean = run(Trace());
+  CalibrationReport high = run(Trace(), 50, 4095);
+  CalibrationReport low = run(Trace(), 50, 0);
+  for (const CalibrationReport* r : {&high, &low}) {
+    EXPECT_TRUE(r->accepted);
+    EXPECT_NEAR(r->tps.min, clean.tps.min, 2);
+    EXPECT_NEAR(r->tps.max, clean.tps.max, 2);
+    EXPECT_NEAR(r->map.min, clean.map.min, 2);
+    EXPECT_NEAR(r->map.max, clean.map.max, 2);
+    // Todos los picos se cuentan (en las rampas, alguna vecina también) y el
+    // ruido no los incluye
+    EXPECT_GE(r->tps.spikeRate, 0.02f);
+    EXPECT_LE(r->tps.spikeRate, 0.03f);
+    EXPECT_LT(r->tps.noise, 2.0f);
+  }
+}
+
+TEST(CalibrationEngine, ShortBurstsStayInTheTails) {
+  // Ráfagas de 2 muestras (la mediana de 3 no las quita) cada 10 s: quedan
+  // en la cola de MIN_TAIL_SAMPLES que se ignora
+  CalibrationReport clean = run(Trace());
+  CalibrationReport r = run(Trace(), 500, 4095, 2);
+  EXPECT_TRUE(r.accepted);
+  EXPECT_NEAR(r.tps.max, clean.tps.max, 4);
+  EXPECT_NEAR(r.map.max, clean.map.max, 4);
+}
+
+TEST(CalibrationEngine, FrequentSpikesAreRefused) {
+  // Un pico cada 8 muestras: el canal no es fiable aunque el rango salga bien
+  CalibrationReport r = run(Trace(), 8, 4095);
+  EXPECT_GT(r.tps.spikeRate, 0.1f);
+  EXPECT_EQ(r.tps.quality, 0.0f);
+  EXPECT_FALSE(r.accepted);
+}
+
+TEST(CalibrationEngine, DriftDuringCalibrationStaysInsideTheDriftBand) {
+  // El tope del TPS sube 40 cuentas y la atmosférica baja 30 durante los 20 s
+  Trace trace;
+  trace.tpsDrift = 40.0f;
+  trace.mapDrift = -30.0f;
+  CalibrationReport r = run(trace);
+  EXPECT_TRUE(r.accepted);
+  EXPECT_GE(r.tps.min, TPS_LO - 4);
+  EXPECT_LE(r.tps.min, TPS_LO + 40 + 4);
+  EXPECT_GE(r.tps.max, TPS_HI - 4);
+  EXPECT_LE(r.tps.max, TPS_HI + 40 + 4);
+  EXPECT_GE(r.map.max, MAP_HI - 30 - 4);
+  EXPECT_LE(r.map.max, MAP_HI + 4);
+  // La deriva ensancha cada extremo, no lo confunde con ruido
+  EXPECT_LT(r.tps.noise, 2.0f);
+  EXPECT_EQ(r.tps.spikeRate, 0.0f);
+}
+
+TEST(CalibrationEngine, DriftWithSpikesKeepsTheRobustRange) {
+  Trace trace;
+  trace.tpsDrift = 40.0f;
+  CalibrationReport drifted = run(trace);
+  CalibrationReport spiked = run(trace, 37, 4095);
+  EXPECT_TRUE(spiked.accepted);
+  EXPECT_NEAR(spiked.tps.min, drifted.tps.min, 2);
+  EXPECT_NEAR(spiked.tps.max, drifted.tps.max, 2);
+}
+
+TEST(CalibrationEngine, UntouchedThrottleIsDegenerate) {
+  static CalibrationEngine engine;
+  engine.reset();
+  Trace trace;
+  for (uint32_t i = 0; i < SAMPLES; ++i) engine.addSample(trace.tps(0), trace.map(i));
+  CalibrationReport r = engine.evaluate();
+  EXPECT_TRUE(r.tps.degenerate);
+  EXPECT_FALSE(r.map.degenerate);
+  EXPECT_FALSE(r.accepted);
+}
+
+TEST(CalibrationEngine, BriefTouchDoesNotSetTheStop) {
+  // Acelerador quieto salvo un toque de 3 muestras a fondo: ese extremo cae
+  // en la cola, el rango queda degenerado y no se guarda nada
+  static CalibrationEngine engine;
+  engine.reset();
+  Trace trace;
+  for (uint32_t i = 0; i < SAMPLES; ++i) {
+    uint16_t t = (i >= 500 && i < 503) ? TPS_HI : TPS_LO;
+    engine.addSample(t, trace.map(i));
+  }
+  CalibrationReport r = engine.evaluate();
+  EXPECT_LT(r.tps.max, TPS_LO + CalibrationEngine::MIN_SPAN);
+  EXPECT_TRUE(r.tps.degenerate);
+  EXPECT_FALSE(r.accepted);
+}
+
+TEST(CalibrationEngine, ShortDwellLowersConfidence) {
+  // Con 10 muestras a fondo el extremo cuenta, pero con la mitad del apoyo
+  // que pide la confianza (2 % de las muestras)
+  static CalibrationEngine engine;
+  engine.reset();
+  Trace trace;
+  for (uint32_t i = 0; i < SAMPLES; ++i) {
+    uint16_t t = (i >= 500 && i < 510) ? TPS_HI : TPS_LO;
+    engine.addSample(t, trace.map(i));
+  }
+  CalibrationReport r = engine.evaluate();
+  EXPECT_NEAR(r.tps.max, TPS_HI, 4);
+  EXPECT_LT(r.tps.quality, 0.55f);
+  EXPECT_GT(run(Trace()).tps.quality, 0.9f);
+}
+
+TEST(CalibrationEngine, TooFewSamplesLowerConfidence) {
+  static CalibrationEngine engine;
+  engine.reset();
+  Trace trace;
+  for (uint32_t i = 0; i < CalibrationEngine::MIN_SAMPLES / 4; ++i) engine.addSample(trace.tps(i * 6), trace.map(i * 6));
+  CalibrationReport r = engine.evaluate();
+  EXPECT_FALSE(r.tps.degenerate);
+  EXPECT_LE(r.tps.quality, 0.26f);
+  EXPECT_FALSE(r.accepted);
+}
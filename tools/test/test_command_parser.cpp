@@ -0,0 +1,198 @@
+// Consola: armado de líneas, separación en campos, números y despacho por la
+// tabla de comandos, todo sin memoria dinámica
+#include "TestHarness.h"
+#include "AllocCounter.h"
+#include "CommandParser.h"
+#include "CommandRegistry.h"
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+struct FakeConsole {
+  char last[16] = "";  // Copia: la línea se reutiliza tras despachar
+  long tps = -1, map = -1;
+  uint32_t hits = 0;
+
+  void feed(const CommandArgs& args) {
+    remember(args);
+    args.getInt("tps_raw", tps);
+    args.getInt("map_raw", map);
+  }
+  void other(const CommandArgs& args) { remember(args); }
+  void remember(const CommandArgs& args) {
+    hits++;
+    strncpy(last, args.name(), sizeof(last) - 1);
+  }
+};
+
+using FakeRegistry = CommandRegistry<FakeConsole>;
+
+const FakeRegistry::Command FAKE_COMMANDS[] = {
+  { "a", "", "Activar", &FakeConsole::other, false },
+  { "thr", "[CLAVE VALOR]", "Umbrales", &FakeConsole::other, false },
+  { "k", "", "Deriva", &FakeConsole::other, true },
+  { "tps_raw", "", nullptr, &FakeConsole::feed, false },
+};
+
+const FakeRegistry FAKE_REGISTRY(FAKE_COMMANDS);
+
+// Empuja el texto carácter a carácter y despacha cada línea completa
+uint32_t feedText(LineAssembler& line, FakeConsole& console, const char* text, bool dev = false) {
+  uint32_t dispatched = 0;
+  for (const char* p = text; *p; ++p) {
+    if (!line.push(*p)) continue;
+    CommandArgs args;
+    tokenizeCommand(line.data(), args);
+    if (FAKE_REGISTRY.dispatch(console, args, dev) == FakeRegistry::Result::OK) dispatched++;
+    line.reset();
+  }
+  return dispatched;
+}
+
+}  // namespace
+
+TEST(CommandParser, AssemblesLinesAndDropsCarriageReturns) {
+  LineAssembler line;
+  const char* text = "thr\r\n";
+  bool complete = false;
+  for (const char* p = text; *p; ++p) complete = line.push(*p);
+  EXPECT_TRUE(complete);
+  EXPECT_EQ(std::string(line.data()), std::string("thr"));
+  EXPECT_EQ(line.length(), 3u);
+}
+
+TEST(CommandParser, OverlongLineIsDroppedWhole) {
+  LineAssembler line;
+  FakeConsole console;
+  std::string longLine(LineAssembler::CAPACITY + 20, 'x');
+  longLine += "\n";
+  EXPECT_EQ(feedText(line, console, longLine.c_str()), 0u);
+  EXPECT_EQ(line.getOverflows(), 1u);
+  // La siguiente línea llega entera, sin restos de la anterior
+  EXPECT_EQ(feedText(line, console, "a\n"), 1u);
+  EXPECT_EQ(std::string(console.last), std::string("a"));
+
+  // Justo en el límite todavía cabe
+  std::string fits(LineAssembler::CAPACITY - 1, 'y');
+  bool complete = false;
+  for (char c : fits + "\n") complete = line.push(c);
+  EXPECT_TRUE(complete);
+  EXPECT_EQ(line.length(), LineAssembler::CAPACITY - 1);
+}
+
+TEST(CommandParser, SplitsKeyValueAndPositionalFields) {
+  char feed[] = "  tps_raw:1234,map_raw:3900  ";
+  CommandArgs args;
+  EXPECT_EQ(tokenizeCommand(feed, args), 2);
+  EXPECT_EQ(std::string(args.name()), std::string("tps_raw"));
+  EXPECT_EQ(std::string(args.find("map_raw")), std::string("3900"));
+  EXPECT_TRUE(args.find("tps") == nullptr);
+
+  char thr[] = "thr INJ_TPS_ON\t12.5";
+  EXPECT_EQ(tokenizeCommand(thr, args), 3);
+  EXPECT_EQ(std::string(args.arg(1)), std::string("INJ_TPS_ON"));
+  EXPECT_EQ(std::string(args.arg(2)), std::string("12.5"));
+  EXPECT_TRUE(args.arg(3) == nullptr);
+  EXPECT_TRUE(args.fields[1].value == nullptr);
+
+  // Solo el primer ':' separa: el resto es parte del valor
+  char twice[] = "x:1:2";
+  tokenizeCommand(twice, args);
+  EXPECT_EQ(std::string(args.find("x")), std::string("1:2"));
+}
+
+TEST(CommandParser, EmptyAndCrowdedLines) {
+  char blank[] = " \t ";
+  CommandArgs args;
+  EXPECT_EQ(tokenizeCommand(blank, args), 0);
+  EXPECT_EQ(std::string(args.name()), std::string(""));
+
+  char crowded[] = "a 1 2 3 4 5 6 7 8 9 10";
+  EXPECT_EQ(tokenizeCommand(crowded, args), CommandArgs::MAX_FIELDS);
+  EXPECT_EQ(std::string(args.arg(CommandArgs::MAX_FIELDS - 1)), std::string("7"));
+}
+
+TEST(CommandParser, ParsesNumbersWithoutStrtod) {
+  float f = 0.0f;
+  long n = 0;
+  EXPECT_TRUE(CommandArgs::toFloat("-12.5", f));
+  EXPECT_NEAR(f, -12.5, 1e-6);
+  EXPECT_TRUE(CommandArgs::toFloat("+.25", f));
+  EXPECT_NEAR(f, 0.25, 1e-6);
+  EXPECT_TRUE(CommandArgs::toFloat("7", f));
+  EXPECT_NEAR(f, 7.0, 1e-6);
+  for (const char* bad : {"", ".", "-", "1e3", "1.2.3", "12a", "nan"}) {
+    f = 99.0f;
+    EXPECT_FALSE(CommandArgs::toFloat(bad, f));
+    EXPECT_EQ(f, 99.0f);  // Un fallo no toca la salida
+  }
+  EXPECT_FALSE(CommandArgs::toFloat(nullptr, f));
+
+  EXPECT_TRUE(CommandArgs::toInt("-42", n));
+  EXPECT_EQ(n, -42);
+  EXPECT_FALSE(CommandArgs::toInt("4.2", n));
+  EXPECT_FALSE(CommandArgs::toInt("", n));
+  EXPECT_EQ(n, -42);
+}
+
+TEST(CommandParser, DispatchHonoursTheTable) {
+  FakeConsole console;
+  char line[32];
+  CommandArgs args;
+
+  strcpy(line, "k");
+  tokenizeCommand(line, args);
+  EXPECT_TRUE(FAKE_REGISTRY.dispatch(console, args, false) == FakeRegistry::Result::DEV_ONLY);
+  EXPECT_TRUE(FAKE_REGISTRY.dispatch(console, args, true) == FakeRegistry::Result::OK);
+
+  strcpy(line, "desconocido 1");
+  tokenizeCommand(line, args);
+  EXPECT_TRUE(FAKE_REGISTRY.dispatch(console, args, true) == FakeRegistry::Result::NOT_FOUND);
+
+  strcpy(line, "  ");
+  tokenizeCommand(line, args);
+  EXPECT_TRUE(FAKE_REGISTRY.dispatch(console, args, true) == FakeRegistry::Result::EMPTY);
+  EXPECT_EQ(console.hits, 1u);
+}
+
+TEST(CommandParser, SimulatorFeedAllocatesNothing) {
+  // Lo que manda el simulador a 50 Hz, más comandos y una línea demasiado
+  // larga: ni una reserva desde el primer carácter hasta el manejador
+  LineAssembler line;
+  FakeConsole console;
+  std::string overlong(LineAssembler::CAPACITY * 2, 'z');
+  overlong += "\n";
+
+  uint64_t before = test::allocationCount();
+  uint32_t dispatched = 0;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    dispatched += feedText(line, console, "tps_raw:1234,map_raw:3900\r\n");
+    dispatched += feedText(line, console, "thr INJ_TPS_ON 12.5\n", true);
+    dispatched += feedText(line, console, overlong.c_str());
+    float f;
+    CommandArgs::toFloat("-3.75", f);
+  }
+  uint64_t allocated = test::allocationCount() - before;
+
+  EXPECT_EQ(allocated, 0u);
+  EXPECT_EQ(dispatched, 2000u);
+  EXPECT_EQ(console.tps, 1234);
+  EXPECT_EQ(console.map, 3900);
+  EXPECT_EQ(line.getOverflows(), 1000u);
+}
+
+TEST(CommandParser, AllocationCounterSeesAllocations) {
+  // Control del propio contador: un std::string largo y un malloc de C sí reservan
+  uint64_t before = test::allocationCount();
+  std::string heap(200, 'h');
+  EXPECT_GE(test::allocationCount() - before, 1u);
+  EXPECT_EQ(heap.size(), 200u);
+
+  // Por un puntero volátil: el compilador puede quitar un malloc/free sin uso
+  void* (*volatile cMalloc)(size_t) = malloc;
+  before = test::allocationCount();
+  void* block = cMalloc(32);
+  EXPECT_EQ(test::allocationCount() - before, 1u);
+  free(block);
+}
@@ -0,0 +1,216 @@
+// ConfigStore: escrituras a flash por operación, contadas en FileStorageBackend
+#include "TestHarness.h"
+#include "ConfigStore.h"
+#include "FileStorageBackend.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+std::string storePath() {
+  return "/tmp/vortex_test_store_" + std::to_string(getpid()) + ".bin";
+}
+
+// Backend vacío y ConfigStore recién montado sobre él
+ConfigStore& freshStore(FileStorageBackend& backend) {
+  backend.erase();
+  ConfigStore& store = ConfigStore::getInstance();
+  store.begin(&backend);
+  backend.resetCounters();
+  return store;
+}
+
+CalibrationData sampleCalibration() {
+  CalibrationData c;
+  c.mapMin = c.mapMinRef = 900;
+  c.mapMax = c.mapMaxRef = 3900;
+  c.tpsMin = c.tpsMinRef = 420;
+  c.tpsMax = c.tpsMaxRef = 3780;
+  c.valid = 1;
+  return c;
+}
+
+// Blob con cabecera y CRC de una versión dada, como lo dejaría un firmware anterior
+void writeBlob(FileStorageBackend& backend, uint16_t version, const void* payload, uint16_t size) {
+  uint8_t buf[ConfigStore::MAX_BLOB_SIZE];
+  ConfigBlobHeader hdr;
+  hdr.magic = CONFIG_MAGIC;
+  hdr.version = version;
+  hdr.size = size;
+  hdr.crc = ConfigStore::crc32(static_cast<const uint8_t*>(payload), size);
+  memcpy(buf, &hdr, sizeof(hdr));
+  memcpy(buf + sizeof(hdr), payload, size);
+  backend.write(buf, sizeof(hdr) + size);
+}
+
+}  // namespace
+
+TEST(ConfigStore, BeginWithoutBlobOnlyReads) {
+  FileStorageBackend backend(storePath());
+  backend.erase();
+  EXPECT_FALSE(ConfigStore::getInstance().begin(&backend));
+  EXPECT_EQ(backend.getReadCount(), 1u);
+  EXPECT_EQ(backend.getWriteCount(), 0u);
+  EXPECT_FALSE(ConfigStore::getInstance().isDirty());
+}
+
+TEST(ConfigStore, SetterWritesOnceAfterQuietWindow) {
+  FileStorageBackend backend(storePath());
+  ConfigStore& store = freshStore(backend);
+
+  store.setCalibration(sampleCalibration());
+  EXPECT_EQ(backend.getWriteCount(), 0u);  // El setter solo toca RAM
+  EXPECT_TRUE(store.isDirty());
+
+  // El primer service() abre la ventana; dentro de ella no se escribe
+  EXPECT_FALSE(store.service(1000));
+  EXPECT_FALSE(store.service(1000 + ConfigStore::COALESCE_MS - 1));
+  EXPECT_EQ(backend.getWriteCount(), 0u);
+  EXPECT_TRUE(store.service(1000 + ConfigStore::COALESCE_MS));
+  EXPECT_EQ(backend.getWriteCount(), 1u);
+  EXPECT_EQ(backend.getBytesWritten(), sizeof(ConfigBlobHeader) + sizeof(ConfigData));
+
+  // Sin cambios nuevos no vuelve a escribir
+  EXPECT_FALSE(store.service(5000));
+  EXPECT_FALSE(store.flush());
+  EXPECT_EQ(backend.getWriteCount(), 1u);
+}
+
+TEST(ConfigStore, BurstOfSettersIsOneWrite) {
+  FileStorageBackend backend(storePath());
+  ConfigStore& store = freshStore(backend);
+
+  // Calibración, dos perfiles, perfil activo y ecualización, con service()
+  // corriendo entre medias: cada cambio reinicia la ventana
+  uint32_t commits = store.getCommitCount();
+  TuningProfile p;
+  strncpy(p.name, "pista", sizeof(p.name) - 1);
+  p.valid = 1;
+  uint32_t t = 0;
+  store.setCalibration(sampleCalibration());
+  store.service(t += 100);
+  store.setProfile(1, p);
+  store.service(t += 100);
+  p.revision = 2;
+  store.setProfile(1, p);
+  store.service(t += 100);
+  store.setActiveProfile(1);
+  store.service(t += 100);
+  AcousticEqData eq;
+  eq.count = 1;
+  eq.freqHz[0] = 5000;
+  eq.gain[0] = EQ_GAIN_UNITY;
+  store.setEqualization(eq);
+  for (uint32_t i = 0; i < 20; ++i) store.service(t += 100);
+
+  EXPECT_EQ(backend.getWriteCount(), 1u);
+  EXPECT_EQ(store.getCommitCount(), commits + 1);
+}
+
+TEST(ConfigStore, NoOpSettersDoNotWrite) {
+  FileStorageBackend backend(storePath());
+  ConfigStore& store = freshStore(backend);
+  store.setCalibration(sampleCalibration());
+  store.flush();
+  backend.resetCounters();
+
+  // Los mismos valores que ya hay: ni se marca sucio ni se escribe
+  store.setCalibration(sampleCalibration());
+  store.setActiveProfile(store.getActiveProfile());
+  store.setEqualization(store.getEqualization());
+  store.setActiveProfile(MAX_PROFILES);  // Fuera de rango: se ignora
+  EXPECT_FALSE(store.isDirty());
+  for (uint32_t t = 0; t < 5000; t += 100) store.service(t);
+  EXPECT_EQ(backend.getWriteCount(), 0u);
+}
+
+TEST(ConfigStore, ClearCalibrationIsOneWrite) {
+  FileStorageBackend backend(storePath());
+  ConfigStore& store = freshStore(backend);
+  store.setCalibration(sampleCalibration());
+  store.flush();
+  backend.resetCounters();
+
+  store.clearCalibration();
+  store.clearCalibration();
+  EXPECT_TRUE(store.flush());
+  EXPECT_EQ(backend.getWriteCount(), 1u);
+  EXPECT_EQ(store.getCalibration().valid, 0);
+}
+
+TEST(ConfigStore, ReloadsWhatItWrote) {
+  FileStorageBackend backend(storePath());
+  ConfigStore& store = freshStore(backend);
+  store.setCalibration(sampleCalibration());
+  store.setActiveProfile(2);
+  store.flush();
+
+  backend.resetCounters();
+  EXPECT_TRUE(store.begin(&backend));
+  EXPECT_EQ(backend.getWriteCount(), 0u);  // Blob vigente: arrancar no reescribe
+  EXPECT_FALSE(store.isDirty());
+  EXPECT_EQ(store.getCalibration().tpsMax, 3780);
+  EXPECT_EQ(store.getActiveProfile(), 2);
+}
+
+TEST(ConfigStore, MigratedBlobIsRewrittenOnce) {
+  FileStorageBackend backend(storePath());
+  backend.erase();
+  ConfigDataV3 v3{};
+  v3.calib = sampleCalibration();
+  v3.activeProfile = 1;
+  writeBlob(backend, 3, &v3, sizeof(v3));
+  backend.resetCounters();
+
+  ConfigStore& store = ConfigStore::getInstance();
+  EXPECT_TRUE(store.begin(&backend));
+  EXPECT_TRUE(store.isDirty());
+  EXPECT_EQ(store.getCalibration().mapMax, 3900);
+  for (uint32_t t = 0; t < 5000; t += 100) store.service(t);
+  EXPECT_EQ(backend.getWriteCount(), 1u);
+
+  // Ya en v4: un segundo arranque no migra ni escribe
+  backend.resetCounters();
+  EXPECT_TRUE(store.begin(&backend));
+  EXPECT_FALSE(store.isDirty());
+  EXPECT_EQ(backend.getWriteCount(), 0u);
+}
+
+TEST(ConfigStore, MigrationFromV3KeepsProfilesWithoutEq) {
+  ConfigDataV3 v3{};
+  v3.calib.mapMax = 4000;
+  v3.profiles[1].valid = 1;
+  v3.profiles[1].actuation.freqMaxHz = 7000.0f;
+  v3.activeProfile = 1;
+  ConfigData out;
+  ASSERT_TRUE(ConfigStore::migrate(3, reinterpret_cast<const uint8_t*>(&v3), sizeof(v3), out));
+  EXPECT_EQ(out.calib.mapMax, 4000);
+  EXPECT_TRUE(out.profiles[1].valid);
+  EXPECT_EQ(out.profiles[1].actuation.freqMaxHz, 7000.0f);
+  EXPECT_EQ(out.activeProfile, 1);
+  EXPECT_EQ(out.eq.count, 0);
+  // Un v4 con el tamaño de un v3 no se acepta
+  EXPECT_FALSE(ConfigStore::migrate(4, reinterpret_cast<const uint8_t*>(&v3), sizeof(v3), out));
+}
+
+TEST(ConfigStore, CorruptBlobIsIgnored) {
+  FileStorageBackend backend(storePath());
+  ConfigStore& store = freshStore(backend);
+  store.setCalibration(sampleCalibration());
+  store.flush();
+
+  // Un bit cambiado en el payload: el CRC no cuadra y se arranca de fábrica
+  uint8_t buf[ConfigStore::MAX_BLOB_SIZE];
+  size_t len = backend.read(buf, sizeof(buf));
+  ASSERT_GE(len, sizeof(ConfigBlobHeader) + 1);
+  buf[sizeof(ConfigBlobHeader)] ^= 0x01;
+  backend.write(buf, len);
+  backend.resetCounters();
+
+  EXPECT_FALSE(store.begin(&backend));
+  EXPECT_EQ(store.getCalibration().valid, 0);
+  EXPECT_EQ(backend.getWriteCount(), 0u);
+  backend.erase();
+}
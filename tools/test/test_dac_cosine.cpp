@@ -0,0 +1,109 @@
+// DacCosine: registros del generador de coseno y lo que sale con ellos,
+// frente a la tabla por ISR en la banda del inyector
+#include "TestHarness.h"
+#include "DacCosine.h"
+#include "SynthKernel.h"
+#include "TuningProfile.h"
+#include <math.h>
+
+namespace {
+
+struct ToneRow {
+  float    requestHz;
+  uint16_t freqStep;
+  float    realHz;
+  float    tableHz;  ///< Lo que da hoy la tabla de 16 con el periodo en µs enteros
+};
+
+// RTC8M nominal y CK8M_DIV_SEL sin tocar, como el firmware
+const ToneRow TONES[] = {
+  {4200.0f, 32, 4150.4f, 4464.3f},
+  {4750.0f, 37, 4798.9f, 4807.7f},
+  {5300.0f, 41, 5317.7f, 5681.8f},
+  {5850.0f, 45, 5836.5f, 6250.0f},
+  {6400.0f, 49, 6355.3f, 6944.4f},
+};
+
+struct ScaleRow {
+  float   level;
+  uint8_t scale;
+};
+
+const ScaleRow SCALES[] = {
+  {1.0f, 0},   {0.71f, 0},  {0.70f, 1},  {0.5f, 1},    {0.36f, 1},
+  {0.35f, 2},  {0.25f, 2},  {0.18f, 2},  {0.17f, 3},   {0.125f, 3},
+  {0.0625f, 3}, {0.062f, CW_SCALE_OFF}, {0.0f, CW_SCALE_OFF}, {-1.0f, CW_SCALE_OFF},
+};
+
+}  // namespace
+
+TEST(DacCosine, AchievableFrequencies) {
+  const float stepHz = cwToneFrequency(1, 0, CW_RTC8M_NOMINAL_HZ);
+  EXPECT_NEAR(stepHz, 129.70, 0.01);
+  for (const ToneRow& row : TONES) {
+    CwToneSettings cw = cwToneForFrequency(row.requestHz, CW_RTC8M_NOMINAL_HZ, 0);
+    EXPECT_EQ(cw.freqStep, row.freqStep);
+    EXPECT_EQ(cw.clkDiv, 0);
+    EXPECT_NEAR(cw.realHz, row.realHz, 0.05);
+    EXPECT_NEAR(cw.errorHz, cw.realHz - row.requestHz, 1e-3);
+
+    uint32_t period = synthTimerPeriodUs(row.requestHz, SYNTH_TABLE_SIZE);
+    EXPECT_NEAR(1e6 / (period * double(SYNTH_TABLE_SIZE)), row.tableHz, 0.05);
+  }
+}
+
+TEST(DacCosine, WithinHalfAStepAcrossTheBand) {
+  // En toda la banda del perfil de fábrica y con RTC8M de chips lentos o
+  // rápidos, el error no pasa de medio paso; el peor caso, muy por debajo del de la tabla
+  for (float rtc8m : {8.0e6f, CW_RTC8M_NOMINAL_HZ, 9.0e6f}) {
+    float halfStep = cwToneFrequency(1, 0, rtc8m) / 2.0f;
+    for (float f = DEFAULT_FREQ_MIN_HZ; f <= DEFAULT_FREQ_MAX_HZ; f += 10.0f) {
+      CwToneSettings cw = cwToneForFrequency(f, rtc8m, 0);
+      if (!EXPECT_LE(fabsf(cw.errorHz), halfStep + 0.01f)) break;
+    }
+  }
+  float worstCw = 0.0f, worstTable = 0.0f;
+  for (float f = DEFAULT_FREQ_MIN_HZ; f <= DEFAULT_FREQ_MAX_HZ; f += 10.0f) {
+    worstCw = fmaxf(worstCw, fabsf(cwToneForFrequency(f, CW_RTC8M_NOMINAL_HZ, 0).errorHz));
+    uint32_t period = synthTimerPeriodUs(f, SYNTH_TABLE_SIZE);
+    worstTable = fmaxf(worstTable, fabsf(SYNTH_TIMER_HZ / (period * float(SYNTH_TABLE_SIZE)) - f));
+  }
+  EXPECT_LE(worstCw, 65.0f);
+  EXPECT_GT(worstTable, 500.0f);
+}
+
+TEST(DacCosine, DividerOnlyWhenItHelps) {
+  // Con divisor permitido el error no empeora, y a igualdad gana el menor
+  for (float f = 1000.0f; f <= 20000.0f; f += 37.0f) {
+    CwToneSettings fixed = cwToneForFrequency(f, CW_RTC8M_NOMINAL_HZ, 0);
+    CwToneSettings free = cwToneForFrequency(f, CW_RTC8M_NOMINAL_HZ, CW_MAX_CLK_DIV);
+    if (!EXPECT_LE(fabsf(free.errorHz), fabsf(fixed.errorHz))) break;
+    EXPECT_NEAR(free.realHz, cwToneFrequency(free.freqStep, free.clkDiv, CW_RTC8M_NOMINAL_HZ), 1e-3);
+  }
+  // 2·stepHz sale exacto con el divisor 0
+  float exact = 2.0f * cwToneFrequency(1, 0, CW_RTC8M_NOMINAL_HZ);
+  EXPECT_EQ(cwToneForFrequency(exact, CW_RTC8M_NOMINAL_HZ, CW_MAX_CLK_DIV).clkDiv, 0);
+  // Un divisor fuera de los 3 bits se limita
+  EXPECT_LE(cwToneForFrequency(10.0f, CW_RTC8M_NOMINAL_HZ, 200).clkDiv, CW_MAX_CLK_DIV);
+}
+
+TEST(DacCosine, StepIsClamped) {
+  EXPECT_EQ(cwToneForFrequency(1.0f, CW_RTC8M_NOMINAL_HZ, 0).freqStep, 1);
+  EXPECT_EQ(cwToneForFrequency(1e9f, CW_RTC8M_NOMINAL_HZ, 0).freqStep, 65535);
+}
+
+TEST(DacCosine, ScaleForLevel) {
+  for (const ScaleRow& row : SCALES) {
+    if (!EXPECT_EQ(cwScaleForLevel(row.level), row.scale)) break;
+  }
+  EXPECT_EQ(cwScaleAmplitude(0), 1.0f);
+  EXPECT_EQ(cwScaleAmplitude(3), 0.125f);
+  EXPECT_EQ(cwScaleAmplitude(CW_SCALE_OFF), 0.0f);
+
+  // Desde 1/8 / √2 la escala queda a menos de 3 dB del nivel; por debajo,
+  // hasta el corte en 1/16, la de 1/8 sobra como mucho 6 dB
+  for (float level = 0.0625f; level <= 1.0f; level += 0.001f) {
+    float db = 20.0f * log10f(cwScaleAmplitude(cwScaleForLevel(level)) / level);
+    if (!EXPECT_LE(fabsf(db), level >= 0.0884f ? 3.02f : 6.03f)) break;
+  }
+}
@@ -0,0 +1,159 @@
+// DashboardModel: bytes por minuto frente al repintado completo de antes
+// (línea entera cada 300 ms) y lo que queda en el terminal tras los deltas
+#include "TestHarness.h"
+#include "DashboardModel.h"
+#include <stdlib.h>
+#include <string>
+
+namespace {
+
+constexpr uint32_t MINUTE_MS = 60000;
+constexpr uint32_t TICK_MS = 100;         // Periodo del HUD en ConsoleUI
+constexpr uint32_t OLD_PERIOD_MS = 300;   // imprimirDashboard() anterior
+constexpr float COUNT_V = 3.3f / 4095.0f;
+
+// Terminal mínimo: una línea con CR, CSI 2K y CSI n G
+struct Terminal {
+  std::string line;
+  size_t col = 0;
+
+  void feed(const char* data, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+      char c = data[i];
+      if (c == '\r') {
+        col = 0;
+      } else if (c == '\x1b' && i + 1 < len && data[i + 1] == '[') {
+        size_t j = i + 2;
+        unsigned n = 0;
+        while (j < len && data[j] >= '0' && data[j] <= '9') n = n * 10 + (data[j++] - '0');
+        if (j < len && data[j] == 'K' && n == 2) line.clear();
+        if (j < len && data[j] == 'G') col = n ? n - 1 : 0;
+        i = j;
+      } else {
+        if (line.size() <= col) line.resize(col + 1, ' ');
+        line[col++] = c;
+      }
+    }
+  }
+};
+
+struct Scenario {
+  bool transient;
+  uint32_t seed = 5;
+
+  int noise() {  // ±1 cuenta de ADC
+    seed = seed * 1664525u + 1013904223u;
+    return static_cast<int>(seed >> 30) % 3 - 1;
+  }
+
+  DashboardSnapshot at(uint32_t t) {
+    DashboardSnapshot s;
+    s.state = transient ? "ACTIVE" : "IDLE";
+    s.elapsedS = t / 1000;
+    s.tpsMinV = 0.50f; s.tpsMaxV = 4.20f;
+    s.mapMinV = 0.90f; s.mapMaxV = 3.10f;
+    s.boost = false; s.beam = false;
+    if (!transient) {
+      s.tpsV = 0.61f + noise() * COUNT_V;
+      s.mapV = 1.10f + noise() * COUNT_V;
+      s.dac = 128; s.level = 0.0f; s.freq = 0.0f;
+    } else {
+      // Rampas de acelerador de 6 s de ida y vuelta; el MAP y el actuador las siguen
+      float phase = (t % 6000) / 3000.0f;
+      float x = phase < 1.0f ? phase : 2.0f - phase;
+      s.tpsV = 0.50f + 3.70f * x + noise() * COUNT_V;
+      s.mapV = 0.90f + 2.20f * x + noise() * COUNT_V;
+      s.dac = static_cast<uint8_t>(128 + 100 * x);
+      s.level = x;
+      s.freq = 200.0f + 800.0f * x;
+      s.boost = x > 0.8f;
+    }
+    return s;
+  }
+};
+
+struct Traffic {
+  size_t before = 0;  ///< Línea completa cada OLD_PERIOD_MS
+  size_t after = 0;   ///< DashboardModel cada TICK_MS
+  Terminal screen;
+  DashboardSnapshot last;
+};
+
+Traffic runMinute(bool transient) {
+  Traffic tr;
+  Scenario sc{transient};
+  DashboardModel hud, full;
+  char out[DashboardModel::LINE_CAPACITY];
+  for (uint32_t t = 0; t < MINUTE_MS; t += TICK_MS) {
+    DashboardSnapshot s = sc.at(t);
+    size_t n = hud.render(s, t, out, sizeof(out));
+    tr.after += n;
+    tr.screen.feed(out, n);
+    if (t % OLD_PERIOD_MS == 0) {
+      full.invalidate();
+      tr.before += full.render(s, t, out, sizeof(out));
+    }
+    tr.last = s;
+  }
+  // Un segundo quieto con el último valor: vencen todos los intervalos
+  for (uint32_t t = MINUTE_MS; t <= MINUTE_MS + 1000; t += TICK_MS) {
+    size_t n = hud.render(tr.last, t, out, sizeof(out));
+    tr.screen.feed(out, n);
+  }
+  return tr;
+}
+
+std::string fullLine(const DashboardSnapshot& s) {
+  DashboardModel hud;
+  char out[DashboardModel::LINE_CAPACITY];
+  Terminal screen;
+  screen.feed(out, hud.render(s, 0, out, sizeof(out)));
+  return screen.line;
+}
+
+}  // namespace
+
+TEST(DashboardModel, SteadyStateSendsAlmostNothing) {
+  Traffic tr = runMinute(false);
+  // Antes: ~115 bytes cada 300 ms; ahora solo el contador de segundos y el
+  // ruido que cambia el segundo decimal
+  EXPECT_GT(tr.before, 20000u);
+  EXPECT_LE(tr.after, 1500u);
+  EXPECT_LE(tr.after * 15, tr.before);
+  EXPECT_EQ(tr.screen.line, fullLine(tr.last));
+}
+
+TEST(DashboardModel, TransientSendsLessThanFullRepaints) {
+  Traffic tr = runMinute(true);
+  // Con todo moviéndose los límites por campo siguen ahorrando
+  EXPECT_GT(tr.after, 5000u);
+  EXPECT_LE(tr.after * 10, tr.before * 8);
+  EXPECT_EQ(tr.screen.line, fullLine(tr.last));
+}
+
+TEST(DashboardModel, InvalidateRepaintsTheWholeLine) {
+  Scenario sc{false};
+  DashboardModel hud;
+  char out[DashboardModel::LINE_CAPACITY];
+  DashboardSnapshot s = sc.at(0);
+  size_t first = hud.render(s, 0, out, sizeof(out));
+  EXPECT_EQ(hud.render(s, 100, out, sizeof(out)), 0u);
+
+  // Otra salida movió el cursor: el siguiente render vuelve a ser completo
+  hud.invalidate();
+  EXPECT_EQ(hud.render(s, 200, out, sizeof(out)), first);
+  EXPECT_EQ(hud.getFullRenders(), 2u);
+  EXPECT_LE(first, DashboardModel::LINE_CAPACITY);
+}
+
+TEST(DashboardModel, FieldsKeepTheirColumns) {
+  // Un valor más largo que su ancho se recorta: el resto de la línea no se mueve
+  Scenario sc{false};
+  DashboardSnapshot s = sc.at(0);
+  std::string normal = fullLine(s);
+  s.state = "CALIBRANDO_LARGO";
+  s.elapsedS = 1234567;
+  std::string wide = fullLine(s);
+  EXPECT_EQ(wide.size(), normal.size());
+  EXPECT_EQ(wide.substr(wide.find("TPS=")), normal.substr(normal.find("TPS=")));
+}
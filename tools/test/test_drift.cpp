@@ -0,0 +1,197 @@
+// DriftCompensator con horas de conducción simulada: topes del TPS que se
+// desplazan, presión atmosférica que cambia con el tiempo, ruido y picos.
+// El lazo imita CalibrationManager::trackDrift() a 100 Hz.
+#include "TestHarness.h"
+#include "DriftCompensator.h"
+#include <math.h>
+#include <stdlib.h>
+
+namespace {
+
+constexpr uint32_t STEP_MS = 10;
+constexpr uint32_t HOUR_MS = 3600u * 1000u;
+
+constexpr uint16_t TPS_LO = 420, TPS_HI = 3780;
+constexpr uint16_t MAP_LO = 900, MAP_HI = 3900;
+
+CalibrationData manualCalibration() {
+  CalibrationData c;
+  c.tpsMin = c.tpsMinRef = TPS_LO;
+  c.tpsMax = c.tpsMaxRef = TPS_HI;
+  c.mapMin = c.mapMinRef = MAP_LO;
+  c.mapMax = c.mapMaxRef = MAP_HI;
+  c.valid = 1;
+  return c;
+}
+
+// Deriva lineal de los tres extremos con referencia física a lo largo de la prueba
+struct Drift {
+  float tpsMin = 0.0f, tpsMax = 0.0f, mapMax = 0.0f;  ///< Cuentas al final
+};
+
+struct DriveSim {
+  uint32_t durationMs;
+  Drift drift;
+  uint32_t seed = 99;
+
+  float progress(uint32_t t) const { return static_cast<float>(t) / durationMs; }
+  float trueTpsMin(uint32_t t) const { return TPS_LO + drift.tpsMin * progress(t); }
+  float trueTpsMax(uint32_t t) const { return TPS_HI + drift.tpsMax * progress(t); }
+  float trueMapMax(uint32_t t) const { return MAP_HI + drift.mapMax * progress(t); }
+
+  float noise(float amplitude) {
+    seed = seed * 1664525u + 1013904223u;
+    return amplitude * ((seed >> 8) / 8388608.0f - 1.0f);
+  }
+  static uint16_t adc(float v) { return static_cast<uint16_t>(v < 0.0f ? 0.0f : (v > 4095.0f ? 4095.0f : v + 0.5f)); }
+
+  /**
+   * Ciclo de 60 s: 20 s de ralentí, 25 s de crucero, 5 s a fondo y 10 s de
+   * retención. Cada 30 min, 3 min con el motor parado (MAP atmosférica).
+   * Un pico de un solo ciclo cada ~10 s en cada canal.
+   */
+  void sample(uint32_t t, uint16_t& tps, uint16_t& map) {
+    uint32_t inCycle = t % 60000;
+    bool engineOff = t % (30 * 60000) < 3 * 60000;
+    float tpsV, mapV;
+    if (engineOff) {
+      tpsV = trueTpsMin(t);
+      mapV = trueMapMax(t);
+    } else if (inCycle < 20000) {
+      tpsV = trueTpsMin(t);
+      mapV = 1250.0f + 40.0f * sinf(t * 0.001f);
+    } else if (inCycle < 45000) {
+      tpsV = 1400.0f + 150.0f * sinf(t * 0.0003f);
+      mapV = 2600.0f + 200.0f * sinf(t * 0.0005f);
+    } else if (inCycle < 50000) {
+      tpsV = trueTpsMax(t);
+      mapV = trueMapMax(t) - 5.0f;  // A fondo el colector queda un poco por debajo de la atmosférica
+    } else {
+      tpsV = trueTpsMin(t);
+      mapV = 1000.0f;
+    }
+    tps = adc(tpsV + noise(3.0f));
+    map = adc(mapV + noise(3.0f));
+    if (t % 9970 == 0) tps = 4095;
+    if (t % 10030 == 0) map = 0;
+  }
+};
+
+struct DriftRun {
+  float maxError[3] = {0.0f, 0.0f, 0.0f};  ///< |estimación − verdad| desde la primera hora
+  float finalError[3] = {0.0f, 0.0f, 0.0f};
+  uint32_t persists = 0;
+  uint32_t maxPersistsPerHour = 0;
+  CalibrationData stored;                  ///< Lo último entregado a ConfigStore
+  CalibrationData live;                    ///< Lo que usan los sensores
+};
+
+DriftRun runDrive(DriveSim sim) {
+  DriftRun run;
+  DriftCompensator drift;
+  run.stored = run.live = manualCalibration();
+  drift.begin(run.stored);
+
+  uint32_t hourPersists = 0;
+  for (uint32_t t = 0; t < sim.durationMs; t += STEP_MS) {
+    uint16_t tps, map;
+    sim.sample(t, tps, map);
+    if (drift.update(tps, map, t)) {
+      drift.apply(run.live);
+      if (drift.shouldPersist()) {
+        run.stored = run.live;
+        drift.markPersisted();
+        run.persists++;
+        hourPersists++;
+      }
+    }
+    if (t % HOUR_MS == HOUR_MS - STEP_MS) {
+      if (hourPersists > run.maxPersistsPerHour) run.maxPersistsPerHour = hourPersists;
+      hourPersists = 0;
+    }
+
+    float err[3] = {fabsf(run.live.tpsMin - sim.trueTpsMin(t)), fabsf(run.live.tpsMax - sim.trueTpsMax(t)),
+                    fabsf(run.live.mapMax - sim.trueMapMax(t))};
+    for (int i = 0; i < 3; ++i) {
+      if (t >= HOUR_MS && err[i] > run.maxError[i]) run.maxError[i] = err[i];
+      run.finalError[i] = err[i];
+    }
+  }
+  return run;
+}
+
+}  // namespace
+
+TEST(DriftCompensator, StableSensorsNeverPersist) {
+  // Cuatro horas sin deriva: el ruido, los picos, el crucero y el ralentí con
+  // carga no mueven ningún extremo lo bastante para escribir en flash
+  DriftRun run = runDrive(DriveSim{4 * HOUR_MS, Drift()});
+  EXPECT_EQ(run.persists, 0u);
+  EXPECT_LE(run.finalError[0], 2.0f);
+  EXPECT_LE(run.finalError[1], 2.0f);
+  // A fondo el MAP queda 5 cuentas por debajo de la atmosférica y esas
+  // mesetas entran (INWARD_CAPTURE): sesgo acotado, por debajo de PERSIST_DELTA
+  EXPECT_LE(run.finalError[2], EndpointTracker::INWARD_CAPTURE);
+  EXPECT_EQ(run.live.mapMin, MAP_LO);  // El vacío máximo no se adapta
+}
+
+TEST(DriftCompensator, FollowsSlowTpsAndBarometricDrift) {
+  // Cuatro horas: los topes del TPS suben 40 cuentas (alimentación del
+  // potenciómetro) y la atmosférica baja 30 (frente de bajas presiones)
+  Drift drift;
+  drift.tpsMin = 40.0f;
+  drift.tpsMax = 40.0f;
+  drift.mapMax = -30.0f;
+  DriftRun run = runDrive(DriveSim{4 * HOUR_MS, drift});
+
+  // Convergencia: siempre a pocas cuentas de la verdad, al final casi encima
+  EXPECT_LE(run.maxError[0], 4.0f);
+  EXPECT_LE(run.maxError[1], 4.0f);
+  EXPECT_LE(run.maxError[2], 6.0f);  // La atmosférica solo se ve con el motor parado o a fondo
+  for (int i = 0; i < 3; ++i) EXPECT_LE(run.finalError[i], 3.0f);
+
+  // Persistencia: una escritura por cada PERSIST_DELTA del extremo que más
+  // deriva (los demás van en el mismo blob), nunca una por meseta
+  EXPECT_GE(run.persists, 40u / DriftCompensator::PERSIST_DELTA - 1);
+  EXPECT_LE(run.persists, (40u + 40u + 30u) / DriftCompensator::PERSIST_DELTA);
+  EXPECT_LE(run.maxPersistsPerHour, 8u);
+
+  // Lo guardado va como mucho PERSIST_DELTA por detrás de lo que se usa
+  EXPECT_LT(abs(run.live.tpsMin - run.stored.tpsMin), DriftCompensator::PERSIST_DELTA);
+  EXPECT_LT(abs(run.live.mapMax - run.stored.mapMax), DriftCompensator::PERSIST_DELTA);
+  EXPECT_EQ(run.stored.tpsMinRef, TPS_LO);  // La referencia manual no se toca
+}
+
+TEST(DriftCompensator, DriftBeyondTheGuardBandIsClamped) {
+  // El tope inferior se va 200 cuentas en dos horas: la estimación no sale
+  // de la banda de guarda y las mesetas de fuera se rechazan
+  Drift drift;
+  drift.tpsMin = 200.0f;
+  uint16_t guard = DriftCompensator::guardFor(TPS_LO, TPS_HI);
+  DriftRun run = runDrive(DriveSim{2 * HOUR_MS, drift});
+  EXPECT_LE(run.live.tpsMin, TPS_LO + guard);
+  EXPECT_GE(run.live.tpsMin, TPS_LO + guard - EndpointTracker::PLATEAU_BAND);
+  EXPECT_LE(run.stored.tpsMin, TPS_LO + guard);
+  EXPECT_LE(run.finalError[1], 2.0f);  // El otro tope sigue en su sitio
+}
+
+TEST(DriftCompensator, PlateausInsideTheRangeAreNotStops) {
+  // Un ralentí con carga 30 cuentas por encima del tope durante horas no es
+  // deriva: el extremo no se mueve hacia dentro más que INWARD_CAPTURE
+  EndpointTracker tracker;
+  tracker.reset(EndpointTracker::Side::LOWER, TPS_LO, TPS_LO, 80);
+  for (uint32_t t = 0; t < HOUR_MS; t += STEP_MS) tracker.update(TPS_LO + 30, t);
+  EXPECT_EQ(tracker.getValue(), TPS_LO);
+  EXPECT_GT(tracker.getStatus().rejected, 1000u);
+  EXPECT_EQ(tracker.getStatus().observations, 0u);
+}
+
+TEST(DriftCompensator, InvalidCalibrationStaysInactive) {
+  CalibrationData calib = manualCalibration();
+  calib.valid = 0;
+  DriftCompensator drift;
+  drift.begin(calib);
+  EXPECT_FALSE(drift.isActive());
+  EXPECT_FALSE(drift.update(TPS_LO + 50, MAP_HI, 0));
+  EXPECT_FALSE(drift.shouldPersist());
+}
@@ -0,0 +1,117 @@
+// GoertzelDetector: detector del micrófono de retorno con tonos sintéticos
+// cuantizados a 12 bits, con continua y ruido gaussiano
+#include "TestHarness.h"
+#include "GoertzelDetector.h"
+#include <math.h>
+
+namespace {
+
+const float FS = 38871.0f;  // Muestreo medido, no redondo
+
+struct SyntheticMic {
+  double sampleHz, freqHz, amplitude, offset, noise;
+  double phase = 0.3;
+  uint32_t seed = 2463534242u;
+
+  double uniform() {
+    seed ^= seed << 13;
+    seed ^= seed >> 17;
+    seed ^= seed << 5;
+    return (seed + 1.0) / 4294967297.0;
+  }
+  // Lectura del ADC: tono + continua + ruido, redondeada y recortada a 12 bits
+  float next() {
+    double gauss = sqrt(-2.0 * log(uniform())) * cos(2.0 * M_PI * uniform());
+    double x = offset + amplitude * sin(phase) + noise * gauss;
+    phase += 2.0 * M_PI * freqHz / sampleHz;
+    x = floor(x + 0.5);
+    return static_cast<float>(x < 0.0 ? 0.0 : (x > 4095.0 ? 4095.0 : x));
+  }
+};
+
+// Ventanas enteras hasta juntar 'windows' resultados; devuelve la media
+GoertzelResult run(GoertzelDetector& det, SyntheticMic& mic, uint32_t windows) {
+  GoertzelResult mean;
+  double amp = 0.0, snr = 0.0, rms = 0.0;
+  uint32_t got = 0;
+  for (uint32_t guard = 0; got < windows && guard <= (windows + 2) * GOERTZEL_MAX_SAMPLES; ++guard) {
+    if (!det.push(mic.next())) continue;
+    amp += det.result().amplitude;
+    snr += det.result().snrDb;
+    rms += det.result().rms;
+    got++;
+  }
+  EXPECT_EQ(got, windows);  // Cada ventana se cierra
+  mean.amplitude = static_cast<float>(amp / windows);
+  mean.snrDb = static_cast<float>(snr / windows);
+  mean.rms = static_cast<float>(rms / windows);
+  mean.mean = det.result().mean;
+  return mean;
+}
+
+}  // namespace
+
+TEST(GoertzelDetector, RejectsImpossibleTuning) {
+  GoertzelDetector det;
+  EXPECT_FALSE(det.tune(20000.0f, 40000.0f, 400));
+  EXPECT_FALSE(det.tune(5000.0f, 0.0f, 400));
+  EXPECT_FALSE(det.tune(5000.0f, 40000.0f, 4));
+}
+
+TEST(GoertzelDetector, CleanToneAcrossTheBand) {
+  // Sin ruido, amplitud al 1 % con ventanas de periodos enteros
+  for (float f = 4200.0f; f <= 6400.0f; f += 137.0f) {
+    GoertzelDetector det;
+    ASSERT_TRUE(det.tune(f, FS, 400));
+    double period = FS / f;
+    double cycles = det.windowLength() / period;
+    EXPECT_LE(fabs(cycles - floor(cycles + 0.5)) * period, 0.5 + 1e-3);
+    SyntheticMic mic{FS, f, 300.0, 1900.0, 0.0};
+    GoertzelResult r = run(det, mic, 4);
+    EXPECT_NEAR(r.amplitude, 300.0f, 3.0f);
+    EXPECT_GE(r.snrDb, 30.0f);
+    EXPECT_NEAR(r.mean, 1900.0f, 1.0f);
+  }
+}
+
+TEST(GoertzelDetector, NoisyTone) {
+  // SNR teórica 10·log10(A²/2/σ²) = 9 dB: amplitud al 5 %
+  GoertzelDetector det;
+  det.tune(5000.0f, FS, 400);
+  SyntheticMic noisy{FS, 5000.0, 200.0, 2048.0, 50.0};
+  GoertzelResult r = run(det, noisy, 200);
+  EXPECT_NEAR(r.amplitude, 200.0f, 10.0f);
+  EXPECT_NEAR(r.snrDb, 9.03f, 1.0f);
+  EXPECT_NEAR(r.rms, sqrtf(200.0f * 200.0f / 2.0f + 50.0f * 50.0f), 3.0f);
+}
+
+TEST(GoertzelDetector, SilenceAndNeighbours) {
+  GoertzelDetector det;
+  det.tune(5000.0f, FS, 400);
+  // Tweeter muerto: solo ruido, muy por debajo del umbral de 6 dB del monitor
+  SyntheticMic silent{FS, 5000.0, 0.0, 2048.0, 50.0};
+  EXPECT_LE(run(det, silent, 50).snrDb, -10.0f);
+  // Selectividad: un tono 600 Hz fuera queda 20 dB por debajo
+  SyntheticMic detuned{FS, 5600.0, 200.0, 2048.0, 0.0};
+  EXPECT_LE(run(det, detuned, 20).amplitude, 20.0f);
+}
+
+TEST(GoertzelDetector, ClippedInputStaysBounded) {
+  GoertzelDetector det;
+  det.tune(5000.0f, FS, 400);
+  SyntheticMic hot{FS, 5000.0, 3000.0, 2048.0, 0.0};
+  GoertzelResult r = run(det, hot, 10);
+  EXPECT_GE(r.amplitude, 1800.0f);
+  EXPECT_LE(r.amplitude, 2600.0f);
+}
+
+TEST(GoertzelDetector, FirstWindowOnlyMeasuresDc) {
+  GoertzelDetector det;
+  det.tune(5000.0f, FS, 400);
+  SyntheticMic mic{FS, 5000.0, 200.0, 2048.0, 0.0};
+  uint32_t early = 0;
+  for (uint16_t i = 0; i < det.windowLength(); ++i) {
+    if (det.push(mic.next())) early++;
+  }
+  EXPECT_EQ(early, 0u);
+}
@@ -0,0 +1,273 @@
+// vortex_replay: lectura de registros de texto y binarios, la comparación
+// con la traza dorada y un ciclo corto reproducido contra la que está en data/
+#include "TestHarness.h"
+#include "ConfigStore.h"
+#include "FileStorageBackend.h"
+#include "ReplayEngine.h"
+#include "SensorLog.h"
+#include "ThresholdManager.h"
+#include "Timeline.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+const char* const SHORT_LOG = VORTEX_TEST_DATA "/replay_short.txt";
+const char* const SHORT_GOLDEN = VORTEX_TEST_DATA "/replay_short.golden";
+
+std::string tempPath(const char* name) {
+  return "/tmp/vortex_test_replay_" + std::to_string(getpid()) + "_" + name;
+}
+
+std::string readFile(const char* path) {
+  std::string text;
+  FILE* f = fopen(path, "rb");
+  if (!f) return text;
+  char buf[4096];
+  size_t n;
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) text.append(buf, n);
+  fclose(f);
+  return text;
+}
+
+void writeFile(const std::string& path, const std::string& text) {
+  FILE* f = fopen(path.c_str(), "wb");
+  fwrite(text.data(), 1, text.size(), f);
+  fclose(f);
+}
+
+std::vector<SensorSample> readAll(SensorLogReader& reader) {
+  std::vector<SensorSample> samples;
+  SensorSample s;
+  while (reader.next(s)) samples.push_back(s);
+  return samples;
+}
+
+struct Collect : public TimelineSink {
+  std::vector<TimelineEvent> events;
+  void onEvent(const TimelineEvent& ev) override { events.push_back(ev); }
+};
+
+// Lo que hace "vortex_replay run" sin --config: umbrales de fábrica y la
+// calibración de race_sim.py
+std::vector<TimelineEvent> replayLog(const char* path) {
+  static FileStorageBackend backend(tempPath("config.bin"));
+  backend.erase();
+  ConfigStore::getInstance().begin(&backend);
+  ThresholdManager thresholds;
+  thresholds.begin();
+
+  ReplayConfig config;
+  CalibrationData& c = config.calib;
+  c.tpsMin = c.tpsMinRef = static_cast<uint16_t>((0.5f / 3.3f) * 4095);
+  c.tpsMax = c.tpsMaxRef = static_cast<uint16_t>((2.25f / 3.3f) * 4095);
+  c.mapMin = c.mapMinRef = static_cast<uint16_t>((3.05f / 3.3f) * 4095);
+  c.mapMax = c.mapMaxRef = static_cast<uint16_t>((3.26f / 3.3f) * 4095);
+  c.valid = 1;
+
+  Collect sink;
+  ReplayEngine engine(&thresholds, config, &sink);
+  SensorLogReader reader;
+  if (!reader.open(path, 20)) return sink.events;
+  SensorSample s;
+  while (reader.next(s)) engine.feed(s);
+  engine.finish();
+  return sink.events;
+}
+
+struct DiffOutcome {
+  uint64_t differences;
+  uint64_t matched;
+  std::string report;
+};
+
+DiffOutcome diffAgainst(std::string golden, const std::vector<TimelineEvent>& trace, uint32_t toleranceMs,
+                        uint32_t maxReported = 100) {
+  FILE* g = fmemopen(&golden[0], golden.size(), "r");
+  char* text = nullptr;
+  size_t size = 0;
+  FILE* report = open_memstream(&text, &size);
+  TimelineDiff diff(g, report, toleranceMs, maxReported);
+  for (const TimelineEvent& ev : trace) diff.onEvent(ev);
+  diff.finish();
+  fclose(g);
+  fclose(report);
+  DiffOutcome out{diff.getDifferences(), diff.getMatched(), std::string(text, size)};
+  free(text);
+  return out;
+}
+
+TimelineEvent event(uint32_t tMs, TimelineKind kind, int32_t value) {
+  TimelineEvent ev;
+  ev.tMs = tMs;
+  ev.kind = kind;
+  ev.value = value;
+  return ev;
+}
+
+}  // namespace
+
+TEST(Replay, TextLogSkipsWhatIsNotASample) {
+  std::string log =
+    "# captura de prueba\n"
+    "\n"
+    "t_ms:1000,tps_raw:700,map_raw:3800\n"
+    "HUD | TPS 12% | MAP 40%\n"
+    "tps_raw:710,map_raw:3801\n"            // Sin t_ms: stepMs después
+    "t_ms:1040,tps_raw:4096,map_raw:3800\n"  // Fuera del ADC
+    "t_ms:1040,tps_raw:720,map_raw:-1\n"
+    "t_ms:1060,tps_raw:730,map_raw:3802," + std::string(300, 'x') + "\n"
+    "t_ms:1080,tps_raw:740,map_raw:3803\r\n";
+  std::string path = tempPath("text.txt");
+  writeFile(path, log);
+
+  SensorLogReader reader;
+  ASSERT_TRUE(reader.open(path.c_str(), 20));
+  EXPECT_FALSE(reader.isBinary());
+  std::vector<SensorSample> s = readAll(reader);
+  ASSERT_EQ(s.size(), 3u);
+  EXPECT_EQ(s[0].tMs, 1000u);
+  EXPECT_EQ(s[0].tpsRaw, 700);
+  EXPECT_EQ(s[0].mapRaw, 3800);
+  EXPECT_EQ(s[1].tMs, 1020u);
+  EXPECT_EQ(s[1].tpsRaw, 710);
+  EXPECT_EQ(s[2].tMs, 1080u);
+  EXPECT_EQ(s[2].mapRaw, 3803);
+  // El HUD, los dos fuera de rango y la línea demasiado larga; no los comentarios
+  EXPECT_EQ(reader.getSkipped(), 4u);
+  EXPECT_EQ(reader.getTimeResets(), 0u);
+  unlink(path.c_str());
+}
+
+TEST(Replay, TimeResetKeepsTheClockMonotonic) {
+  // El ESP32 se reinicia a mitad de captura: el tiempo vuelve a empezar
+  std::string log =
+    "t_ms:1000,tps_raw:700,map_raw:3800\n"
+    "t_ms:1020,tps_raw:700,map_raw:3800\n"
+    "t_ms:5,tps_raw:710,map_raw:3801\n"
+    "t_ms:25,tps_raw:720,map_raw:3802\n"
+    "tps_raw:730,map_raw:3803\n"
+    "t_ms:0,tps_raw:740,map_raw:3804\n";
+  std::string path = tempPath("reset.txt");
+  writeFile(path, log);
+
+  SensorLogReader reader;
+  ASSERT_TRUE(reader.open(path.c_str(), 20));
+  std::vector<SensorSample> s = readAll(reader);
+  ASSERT_EQ(s.size(), 6u);
+  // Tras cada reinicio, un paso después de la última muestra y desde ahí con el desfase
+  const uint32_t expected[] = {1000, 1020, 1040, 1060, 1080, 1100};
+  for (size_t i = 0; i < s.size(); ++i) {
+    if (!EXPECT_EQ(s[i].tMs, expected[i])) break;
+  }
+  EXPECT_EQ(reader.getTimeResets(), 2u);
+  unlink(path.c_str());
+}
+
+TEST(Replay, BinaryLogRoundTrip) {
+  std::string path = tempPath("log.bin");
+  const SensorSample written[] = {{0, 0, 4095}, {20, 1234, 3800}, {40, 4095, 0}, {10, 5, 6}};
+  SensorLogWriter writer;
+  ASSERT_TRUE(writer.open(path.c_str()));
+  for (const SensorSample& s : written) writer.write(s);
+  ASSERT_TRUE(writer.close());
+
+  SensorLogReader reader;
+  ASSERT_TRUE(reader.open(path.c_str(), 20));
+  EXPECT_TRUE(reader.isBinary());
+  std::vector<SensorSample> s = readAll(reader);
+  ASSERT_EQ(s.size(), 4u);
+  for (size_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(s[i].tMs, written[i].tMs);
+    EXPECT_EQ(s[i].tpsRaw, written[i].tpsRaw);
+    EXPECT_EQ(s[i].mapRaw, written[i].mapRaw);
+  }
+  // También en binario un tiempo que retrocede es un reinicio
+  EXPECT_EQ(s[3].tMs, 60u);
+  EXPECT_EQ(reader.getTimeResets(), 1u);
+
+  // Otra versión o tamaño de registro no se lee
+  std::string bin = readFile(path.c_str());
+  bin[4] = 2;
+  writeFile(path, bin);
+  EXPECT_FALSE(reader.open(path.c_str(), 20));
+  unlink(path.c_str());
+}
+
+TEST(Replay, ShortCycleMatchesTheGoldenTrace) {
+  std::vector<TimelineEvent> trace = replayLog(SHORT_LOG);
+  std::string golden = readFile(SHORT_GOLDEN);
+  ASSERT_FALSE(golden.empty());
+  ASSERT_GE(trace.size(), 10u);
+
+  DiffOutcome d = diffAgainst(golden, trace, 0);
+  EXPECT_EQ(d.differences, 0u);
+  EXPECT_EQ(d.matched, trace.size());
+  EXPECT_EQ(d.report, "");
+
+  // El ciclo pasa por inyección y vortex, no se queda en IDLE
+  bool injected = false, vortex = false;
+  for (const TimelineEvent& ev : trace) {
+    if (ev.kind != TimelineKind::STATE) continue;
+    injected |= ev.value == static_cast<int32_t>(SystemState::INYECCION_ACUSTICA);
+    vortex |= ev.value == static_cast<int32_t>(SystemState::VORTEX);
+  }
+  EXPECT_TRUE(injected);
+  EXPECT_TRUE(vortex);
+}
+
+TEST(Replay, ShortCycleReportsADeliberateMismatch) {
+  std::vector<TimelineEvent> trace = replayLog(SHORT_LOG);
+  std::string golden = readFile(SHORT_GOLDEN);
+  size_t pos = golden.find("\n4740 level 26\n");
+  ASSERT_TRUE(pos != std::string::npos);
+  golden.replace(pos, 15, "\n4740 level 27\n");
+
+  DiffOutcome d = diffAgainst(golden, trace, 0);
+  EXPECT_EQ(d.differences, 2u);
+  EXPECT_EQ(d.matched, trace.size() - 1);
+  EXPECT_EQ(d.report, "+ 4740 level 26\n- 4740 level 27\n");
+}
+
+TEST(Replay, DiffToleranceWindow) {
+  const std::vector<TimelineEvent> trace = {event(105, TimelineKind::STATE, 3)};
+  EXPECT_EQ(diffAgainst("100 state IDLE\n", trace, 5).differences, 0u);
+  EXPECT_EQ(diffAgainst("110 state IDLE\n", trace, 5).differences, 0u);
+  DiffOutcome late = diffAgainst("100 state IDLE\n", trace, 4);
+  EXPECT_EQ(late.differences, 2u);
+  EXPECT_EQ(late.report, "- 100 state IDLE\n+ 105 state IDLE\n");
+  // Mismo tiempo pero otro tipo o valor no empareja
+  EXPECT_EQ(diffAgainst("105 vortex 3\n", trace, 5).differences, 2u);
+  EXPECT_EQ(diffAgainst("105 state VORTEX\n", trace, 5).differences, 2u);
+}
+
+TEST(Replay, DiffWindowIsBounded) {
+  // 70 dorados en el mismo ms; el replay empieza por el último, que aún no
+  // está en la ventana de 64 y no encuentra pareja
+  std::string golden;
+  std::vector<TimelineEvent> trace;
+  for (int32_t v = 0; v < 70; ++v) golden += "10 level " + std::to_string(v) + "\n";
+  trace.push_back(event(10, TimelineKind::LEVEL, 69));
+  for (int32_t v = 0; v < 69; ++v) trace.push_back(event(10, TimelineKind::LEVEL, v));
+
+  DiffOutcome d = diffAgainst(golden, trace, 0);
+  EXPECT_EQ(d.matched, 69u);
+  EXPECT_EQ(d.differences, 2u);
+  EXPECT_EQ(d.report, "+ 10 level 69\n- 10 level 69\n");
+}
+
+TEST(Replay, FinishReportsTrailingGoldenEvents) {
+  const std::vector<TimelineEvent> trace = {event(0, TimelineKind::STATE, 3)};
+  std::string golden = "0 state IDLE\n# fin\n\n20 acoustic 1\n40 level 36\n60 freq 5120\n";
+  DiffOutcome d = diffAgainst(golden, trace, 0);
+  EXPECT_EQ(d.matched, 1u);
+  EXPECT_EQ(d.differences, 3u);
+  EXPECT_EQ(d.report, "- 20 acoustic 1\n- 40 level 36\n- 60 freq 5120\n");
+  // Se listan solo maxReported, pero se cuentan todas
+  DiffOutcome capped = diffAgainst(golden, trace, 0, 1);
+  EXPECT_EQ(capped.differences, 3u);
+  EXPECT_EQ(capped.report, "- 20 acoustic 1\n");
+}
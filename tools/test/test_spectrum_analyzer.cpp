@@ -0,0 +1,115 @@
+// FixedFft y SpectrumAnalyzer: FFT Q15 contra la DFT en doble precisión de
+// la misma entrada (÷ n, como la salida Q15) y espectro promediado con los
+// tonos que interesan en el conducto
+#include "TestHarness.h"
+#include "FixedFft.h"
+#include "SpectrumAnalyzer.h"
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+
+namespace {
+
+const float FS = 38871.0f;
+
+void expectMatchesReference(uint16_t n) {
+  std::vector<int16_t> re(n), im(n);
+  std::vector<double> cosTable(n), sinTable(n);
+  for (uint16_t i = 0; i < n; ++i) {
+    cosTable[i] = cos(2.0 * M_PI * i / n);
+    sinTable[i] = sin(2.0 * M_PI * i / n);
+  }
+  // Ruido blanco a media escala: ejercita todos los giros
+  uint32_t seed = 12345u + n;
+  for (uint16_t i = 0; i < n; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    re[i] = static_cast<int16_t>(static_cast<int32_t>(seed >> 16) - 32768) / 2;
+    im[i] = 0;
+  }
+  std::vector<int16_t> x(re);
+  ASSERT_TRUE(fftQ15(re.data(), im.data(), n));
+
+  double signal = 0.0, error = 0.0;
+  for (uint16_t k = 0; k < n; ++k) {
+    double xr = 0.0, xi = 0.0;
+    for (uint16_t i = 0; i < n; ++i) {
+      uint16_t m = static_cast<uint16_t>((static_cast<uint32_t>(k) * i) % n);
+      xr += x[i] * cosTable[m];
+      xi -= x[i] * sinTable[m];
+    }
+    xr /= n;
+    xi /= n;
+    signal += xr * xr + xi * xi;
+    error += (re[k] - xr) * (re[k] - xr) + (im[k] - xi) * (im[k] - xi);
+  }
+  EXPECT_GE(10.0 * log10(signal / error), 40.0);  // SQNR (dB)
+  EXPECT_LE(sqrt(error / n), 1.5);                // Error RMS (LSB)
+}
+
+}  // namespace
+
+TEST(SpectrumAnalyzer, ValidSizes) {
+  EXPECT_FALSE(fftValidSize(128));
+  EXPECT_FALSE(fftValidSize(4096));
+  EXPECT_FALSE(fftValidSize(768));
+  EXPECT_TRUE(fftValidSize(512));
+}
+
+TEST(SpectrumAnalyzer, FftMatchesTheReference) {
+  for (uint16_t n = FFT_MIN_SIZE; n && n <= FFT_MAX_SIZE; n <<= 1) expectMatchesReference(n);
+}
+
+TEST(SpectrumAnalyzer, CenteredToneLevelAndSpurs) {
+  // Un seno centrado en un bin a -6 dBFS: nivel exacto y espurios lejos
+  for (uint16_t n = FFT_MIN_SIZE; n && n <= FFT_MAX_SIZE; n <<= 1) {
+    SpectrumAnalyzer sa;
+    ASSERT_TRUE(sa.configure(n, FS, 4));
+    uint16_t bin = static_cast<uint16_t>(lroundf(5000.0f / sa.binHz()));
+    double f = bin * sa.binHz();
+    for (uint32_t block = 0; block < 4; ++block) {
+      for (uint16_t i = 0; i < n; ++i) {
+        double t = (block * n + i) / static_cast<double>(FS);
+        sa.input()[i] = static_cast<int16_t>(lround(0.5 * sin(2.0 * M_PI * f * t) * 32767.0 + 1200.0));
+      }
+      // Publica solo al completar los promedios
+      EXPECT_EQ(sa.process(), block == 3);
+    }
+    EXPECT_NEAR(sa.binDb(bin), -6.02f, 0.05f);
+    float worstSpur = -200.0f;
+    for (uint16_t k = 1; k <= n / 2; ++k) {
+      if (abs(k - bin) > 2) worstSpur = fmaxf(worstSpur, sa.binDb(k));
+    }
+    EXPECT_LE(worstSpur, -60.0f);
+  }
+}
+
+TEST(SpectrumAnalyzer, DuctTonesInTheSummary) {
+  // Helmholtz, portadora y silbido del turbo sobre ruido: cada tono aparece
+  // en su banda del resumen y entre ellos queda el ruido
+  SpectrumAnalyzer sa;
+  ASSERT_TRUE(sa.configure(2048, FS, 8));
+  uint32_t seed = 7;
+  const double tones[3][2] = {{484.0, 0.1}, {5000.0, 0.5}, {12400.0, 0.03}};
+  for (uint32_t block = 0; block < 8; ++block) {
+    for (uint16_t i = 0; i < 2048; ++i) {
+      double t = (block * 2048 + i) / static_cast<double>(FS);
+      double v = 0.0;
+      for (const auto& tone : tones) v += tone[1] * sin(2.0 * M_PI * tone[0] * t);
+      seed = seed * 1664525u + 1013904223u;
+      v += 0.001 * ((seed >> 8) / 16777216.0 - 0.5);
+      sa.input()[i] = static_cast<int16_t>(lround(v * 32767.0));
+    }
+    sa.process();
+  }
+  uint8_t bands[SPECTRUM_MAX_BANDS];
+  ASSERT_EQ(sa.encode(bands, SPECTRUM_MAX_BANDS), SPECTRUM_MAX_BANDS);
+  float bandHz = sa.binHz() * 1024 / SPECTRUM_MAX_BANDS;
+  for (const auto& tone : tones) {
+    float db = -bands[static_cast<uint8_t>(tone[0] / bandHz)] * SPECTRUM_DB_STEP;
+    float expected = 20.0f * log10f(static_cast<float>(tone[1]));
+    // Sin centrar en un bin, Hann pierde hasta 1.42 dB
+    EXPECT_LE(db, expected + 0.1f);
+    EXPECT_GE(db, expected - 1.6f);
+  }
+  EXPECT_LE(-bands[static_cast<uint8_t>(8000.0 / bandHz)] * SPECTRUM_DB_STEP, -70.0f);
+}
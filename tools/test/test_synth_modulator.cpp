@@ -0,0 +1,157 @@
+// SynthModulator: ráfagas, AM y chirps con la aritmética de la ISR; tiempos,
+// profundidad, barridos y que la envolvente nunca salte
+#include "TestHarness.h"
+#include "AdditiveSynth.h"
+#include "SynthKernel.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+namespace {
+
+const float TABLE_HZ = float(SYNTH_TIMER_HZ) / 12.0f;  // Periodo de 12 µs: ~5.2 kHz
+
+struct Envelope {
+  uint32_t minEnv = SYNTH_MOD_UNITY;
+  uint32_t maxEnv = 0;
+  uint32_t on = 0;     ///< Muestras por encima de la mitad
+  uint32_t jumps = 0;  ///< Pasos mayores que slew o por encima de 1
+  uint32_t last = 0;
+};
+
+Envelope render(SynthModState& m, uint32_t samples) {
+  Envelope e;
+  uint32_t prev = m.env;
+  for (uint32_t i = 0; i < samples; ++i) {
+    uint32_t env = synthModStep(m);
+    int32_t d = (int32_t)env - (int32_t)prev;
+    if (d > (int32_t)m.slew || -d > (int32_t)m.slew || env > SYNTH_MOD_UNITY) e.jumps++;
+    prev = env;
+    e.minEnv = std::min(e.minEnv, env);
+    e.maxEnv = std::max(e.maxEnv, env);
+    if (env >= SYNTH_MOD_UNITY / 2) e.on++;
+  }
+  e.last = prev;
+  return e;
+}
+
+SynthIsrState firmwareState() {
+  SynthIsrState s;
+  memcpy(s.table, SYNTH_SINE_TABLE, sizeof(s.table));
+  s.levelInt = 200;
+  return s;
+}
+
+}  // namespace
+
+TEST(SynthModulator, NoneLeavesTheIsrUntouched) {
+  SynthIsrState plain = firmwareState(), mod = firmwareState();
+  synthModConfigure(mod.mod, AcousticModulation(), TABLE_HZ);
+  uint32_t differs = 0;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    if (synthIsrStep(plain) != synthIsrStep(mod)) differs++;
+  }
+  EXPECT_EQ(differs, 0u);
+}
+
+TEST(SynthModulator, BurstDutyCycle) {
+  // Ráfagas 2/3 ms: tras el primer ciclo (que arranca ya encendido), cada
+  // uno pasa 2 ms por encima de la mitad
+  AcousticModulation cfg;
+  cfg.mode = ModulationMode::BURST;
+  cfg.burstOnMs = 2;
+  cfg.burstOffMs = 3;
+  SynthModState m;
+  synthModConfigure(m, cfg, TABLE_HZ);
+  synthModRestart(m);
+  render(m, m.burstPeriod);
+  Envelope e = render(m, 4 * m.burstPeriod);
+  EXPECT_EQ(e.jumps, 0u);
+  EXPECT_EQ(e.minEnv, 0u);
+  EXPECT_EQ(e.maxEnv, SYNTH_MOD_UNITY);
+  EXPECT_GE(e.on + 8, 4 * m.burstOn);
+  EXPECT_LE(e.on, 4 * m.burstOn + 8);
+}
+
+TEST(SynthModulator, AdditiveIsSilentInTheBurstGap) {
+  AcousticModulation cfg;
+  cfg.mode = ModulationMode::BURST;
+  cfg.burstOnMs = 2;
+  cfg.burstOffMs = 3;
+  AdditiveState<2> add;
+  uint8_t levels[2] = {255, 128};
+  additiveFillTable(add.table);
+  add.osc[0].level = 255;
+  add.osc[0].increment = additiveIncrement(5300.0f);
+  add.osc[1].level = 128;
+  add.osc[1].increment = additiveIncrement(HELMHOLTZ_HZ);
+  add.gain = additiveGain(levels, 2, 255);
+  synthModConfigure(add.mod, cfg, ADDITIVE_SAMPLE_HZ);
+  synthModRestart(add.mod);
+  // Con la ráfaga apagada (tras la rampa de bajada) el DAC queda en media escala
+  uint32_t sounding = 0;
+  for (uint32_t i = 0; i < add.mod.burstPeriod; ++i) {
+    uint8_t out = additiveStep(add);
+    if (i > add.mod.burstOn + ADDITIVE_SAMPLE_HZ / 1000 && out != 128) sounding++;
+  }
+  EXPECT_EQ(sounding, 0u);
+}
+
+TEST(SynthModulator, AmDepth) {
+  // 20 Hz, profundidad 0.5: un periodo entero entre 0.5 y 1
+  AcousticModulation cfg;
+  cfg.mode = ModulationMode::AM;
+  cfg.amRateHz = 20.0f;
+  cfg.amDepth = 0.5f;
+  SynthModState m;
+  synthModConfigure(m, cfg, TABLE_HZ);
+  synthModRestart(m);
+  Envelope e = render(m, uint32_t(TABLE_HZ / 20.0f));
+  EXPECT_EQ(e.jumps, 0u);
+  EXPECT_GE(e.maxEnv, SYNTH_MOD_UNITY * 99 / 100);
+  EXPECT_GE(e.minEnv, SYNTH_MOD_UNITY * 49 / 100);
+  EXPECT_LE(e.minEnv, SYNTH_MOD_UNITY * 51 / 100);
+}
+
+TEST(SynthModulator, ModeChangesNeverJump) {
+  // Cambios de modo en marcha, en mitad de flancos y valles
+  const ModulationMode sequence[] = {ModulationMode::BURST, ModulationMode::NONE, ModulationMode::AM,
+                                     ModulationMode::BURST, ModulationMode::AM, ModulationMode::NONE};
+  AcousticModulation cfg;
+  cfg.burstOnMs = 2;
+  SynthModState m;
+  for (ModulationMode mode : sequence) {
+    cfg.mode = mode;
+    cfg.burstOnMs = cfg.burstOnMs == 2 ? 7 : 2;
+    synthModConfigure(m, cfg, TABLE_HZ);
+    EXPECT_EQ(render(m, 1237).jumps, 0u);
+  }
+  // Y con NONE vuelve a 1 en una rampa
+  Envelope e = render(m, uint32_t(TABLE_HZ / 1000.0f) + 2);
+  EXPECT_EQ(e.jumps, 0u);
+  EXPECT_EQ(e.last, SYNTH_MOD_UNITY);
+}
+
+TEST(SynthModulator, ChirpsSweepEndToEnd) {
+  // De 4.2 a 6.4 kHz en 20 ms: extremos y punto medio (aritmético o geométrico)
+  AcousticModulation cfg;
+  cfg.chirpStartHz = 4200.0f;
+  cfg.chirpEndHz = 6400.0f;
+  cfg.chirpMs = 20;
+  for (ModulationMode mode : {ModulationMode::CHIRP_LINEAR, ModulationMode::CHIRP_EXP}) {
+    cfg.mode = mode;
+    SynthModState c;
+    volatile uint32_t inc = additiveIncrement(5300.0f);
+    synthModConfigure(c, cfg, ADDITIVE_SAMPLE_HZ);
+    float mid = mode == ModulationMode::CHIRP_EXP ? sqrtf(4200.0f * 6400.0f) : 5300.0f;
+    for (uint32_t round = 0; round < 2; ++round) {
+      synthModChirp(c, inc);
+      EXPECT_NEAR(additiveFrequency(inc), 4200.0f, 0.5f);
+      for (uint32_t i = 1; i < c.chirpSamples; ++i) {
+        synthModChirp(c, inc);
+        if (i == c.chirpSamples / 2) EXPECT_NEAR(additiveFrequency(inc) / mid, 1.0f, 1e-3f);
+      }
+      EXPECT_NEAR(additiveFrequency(inc) / 6400.0f, 1.0f, 1e-3f);
+    }
+  }
+}
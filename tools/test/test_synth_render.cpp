@@ -0,0 +1,114 @@
+// vortex_sweep: el render sale de los pasos de la ISR del firmware y el
+// análisis ve lo que cabe esperar de una tabla retenida por el DAC
+#include "TestHarness.h"
+#include "Spectrum.h"
+#include "SynthRender.h"
+#include <math.h>
+#include <string.h>
+#include <vector>
+
+namespace {
+
+SynthParams firmwarePoint() {
+  SynthParams p;
+  p.freqHz = 5300.0f;
+  p.level = 0.8f;
+  p.updateMs = 1;
+  p.noiseShaping = true;
+  return p;
+}
+
+}  // namespace
+
+TEST(SynthRender, StepsTheFirmwareIsr) {
+  // Una ISR aparte, alimentada con el nivel que deja update(): mismas muestras
+  SynthParams p = firmwarePoint();
+  SynthRenderer<SYNTH_TABLE_SIZE> synth(p);
+  SynthIsrState isr;
+  memcpy(isr.table, SYNTH_SINE_TABLE, sizeof(isr.table));
+  isr.shapeMask = 0xFF;
+  const uint32_t period = synth.getPeriodUs();
+  EXPECT_EQ(period, synthTimerPeriodUs(p.freqHz, SYNTH_TABLE_SIZE));
+
+  uint8_t expected = 128;
+  uint32_t mismatches = 0;
+  for (uint32_t t = 1; t <= 200000; ++t) {
+    uint8_t out = synth.tick();
+    if (t % period == 0) {
+      isr.levelInt = synth.getLevelInt();
+      expected = synthIsrStep(isr);
+    }
+    if (out != expected) mismatches++;
+  }
+  EXPECT_EQ(mismatches, 0u);
+  // La rampa en coma flotante se queda a 1 LSB del objetivo, como en el firmware
+  EXPECT_NEAR(synth.getLevelInt(), synthLevelInt(p.level), 1);
+}
+
+TEST(SynthRender, StereoStepsBothChannels) {
+  SynthParams p = firmwarePoint();
+  p.stereo = true;
+  p.phaseDeg = 90.0f;
+  SynthRenderer<SYNTH_TABLE_SIZE> stereo(p);
+  p.stereo = false;
+  SynthRenderer<SYNTH_TABLE_SIZE> mono(p);
+
+  SynthIsrState isr;
+  memcpy(isr.table, SYNTH_SINE_TABLE, sizeof(isr.table));
+  isr.shapeMask = 0xFF;
+  isr.phaseOffset = synthPhaseFromDegrees(90.0f);
+  const uint32_t period = stereo.getPeriodUs();
+
+  uint8_t expected2 = 128;
+  uint32_t firstDiffers = 0, secondDiffers = 0;
+  for (uint32_t t = 1; t <= 200000; ++t) {
+    uint8_t out = stereo.tick();
+    if (out != mono.tick()) firstDiffers++;
+    if (t % period == 0) {
+      isr.levelInt = stereo.getLevelInt();
+      isr.levelInt2 = isr.levelInt;
+      expected2 = synthStereoStep(isr).dac2;
+    }
+    if (stereo.getDac2() != expected2) secondDiffers++;
+  }
+  // El primer canal no cambia por tener un segundo
+  EXPECT_EQ(firstDiffers, 0u);
+  EXPECT_EQ(secondDiffers, 0u);
+}
+
+TEST(SynthRender, OnlyTablesTheIsrCanMask) {
+  for (uint32_t n : {2u, 4u, 8u, 16u, 32u, 64u, 128u}) EXPECT_TRUE(synthRenderableTable(n));
+  for (uint32_t n : {0u, 1u, 3u, 12u, 24u, 100u, 255u, 256u}) EXPECT_FALSE(synthRenderableTable(n));
+}
+
+TEST(SynthRender, FirmwareTableAnalysis) {
+  Spectrum spectrum(15);
+  std::vector<float> samples;
+  SynthParams p = firmwarePoint();
+  p.noiseShaping = false;
+  p.level = 1.0f;
+  SynthMetrics m = analyzeSynth(p, spectrum, samples, 20000.0);
+
+  EXPECT_EQ(m.periodUs, synthTimerPeriodUs(p.freqHz, SYNTH_TABLE_SIZE));
+  EXPECT_NEAR(m.realHz, 1e6 / (m.periodUs * 16.0), 1e-9);
+  EXPECT_NEAR(m.realHz, p.freqHz, p.freqHz * 0.1);
+  EXPECT_NEAR(m.levelInt, synthLevelInt(1.0f), 1);
+  // Casi un seno de fondo de escala; la forma de la tabla apenas distorsiona
+  EXPECT_NEAR(m.fundDbfs, 0.0, 1.0);
+  EXPECT_LT(m.thdPct, 2.0);
+  EXPECT_LT(m.imageDbc, -20.0);
+}
+
+TEST(SynthRender, LargerTablesPushTheImageDown) {
+  // El retenedor deja la imagen a unos 20·log10(N) dB de la fundamental
+  Spectrum spectrum(15);
+  std::vector<float> samples;
+  SynthParams p = firmwarePoint();
+  p.freqHz = 2000.0f;
+  p.noiseShaping = false;
+  p.tableSize = 8;
+  SynthMetrics small = analyzeSynth(p, spectrum, samples, 20000.0);
+  p.tableSize = 32;
+  SynthMetrics large = analyzeSynth(p, spectrum, samples, 20000.0);
+  EXPECT_LT(large.imageDbc, small.imageDbc - 9.0);
+}
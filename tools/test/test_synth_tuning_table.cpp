@@ -0,0 +1,53 @@
+// SynthTuningTable: la tabla de carga da lo mismo que el cálculo en float
+// y nunca invierte el sentido del mapa
+#include "TestHarness.h"
+#include "SynthTuningTable.h"
+#include <math.h>
+
+namespace {
+
+// Subir la carga nunca mueve la frecuencia en contra del mapa
+void expectMonotonic(const ActuationMap& map) {
+  SynthTuningTable table;
+  table.build(map);
+  bool rising = map.freqMaxHz >= map.freqMinHz;
+  uint8_t prevBin = 0;
+  for (int centi = 0; centi <= 10000; ++centi) {
+    uint8_t bin = SynthTuningTable::binForLoad(centi / 100.0f);
+    if (!EXPECT_GE(bin, prevBin)) return;
+    if (bin != prevBin) {
+      uint32_t a = table.periodUs(prevBin), b = table.periodUs(bin);
+      if (!(rising ? EXPECT_LE(b, a) : EXPECT_GE(b, a))) return;
+    }
+    prevBin = bin;
+  }
+}
+
+}  // namespace
+
+TEST(SynthTuningTable, BinsCoverTheLoadRange) {
+  EXPECT_EQ(SynthTuningTable::binForLoad(-5.0f), 0);
+  EXPECT_EQ(SynthTuningTable::binForLoad(NAN), 0);
+  EXPECT_EQ(SynthTuningTable::binForLoad(0.49f), 0);
+  EXPECT_EQ(SynthTuningTable::binForLoad(0.5f), 1);
+  EXPECT_EQ(SynthTuningTable::binForLoad(42.4f), 42);
+  EXPECT_EQ(SynthTuningTable::binForLoad(100.0f), SYNTH_LOAD_BINS - 1);
+  EXPECT_EQ(SynthTuningTable::binForLoad(250.0f), SYNTH_LOAD_BINS - 1);
+}
+
+TEST(SynthTuningTable, MatchesTheFloatPathAtEachBin) {
+  ActuationMap map;
+  SynthTuningTable table;
+  table.build(map);
+  for (uint8_t bin = 0; bin < SYNTH_LOAD_BINS; ++bin) {
+    float freq = synthFrequencyForLoad(bin, map.freqMinHz, map.freqMaxHz);
+    if (!EXPECT_EQ(table.periodUs(bin), synthTimerPeriodUs(freq, SYNTH_TABLE_SIZE))) break;
+    EXPECT_NEAR(table.realFrequencyHz(bin), 1e6 / (table.periodUs(bin) * double(SYNTH_TABLE_SIZE)), 0.01);
+  }
+}
+
+TEST(SynthTuningTable, PeriodFollowsTheMapDirection) {
+  expectMonotonic(ActuationMap());
+  expectMonotonic(ActuationMap{6400.0f, 4200.0f});
+  expectMonotonic(ActuationMap{1000.0f, 20000.0f});
+}
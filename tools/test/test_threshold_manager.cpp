@@ -0,0 +1,277 @@
+// ThresholdManager: ediciones en borrador que se publican de una vez, sus
+// invariantes y el cambio de perfil con la StateMachine real en marcha
+#include "TestHarness.h"
+#include "ConfigStore.h"
+#include "DebugManager.h"
+#include "FileStorageBackend.h"
+#include "StateMachine.h"
+#include "ThresholdManager.h"
+#include <atomic>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+
+namespace {
+
+// Actuadores de mentira: recuerdan el mapa que fijó la FSM
+class NullActuators : public ActuatorControl {
+public:
+  void update() override {}
+  void startVortex() override {}
+  void stopVortex() override {}
+  void startAcoustic(float) override { acoustic = true; }
+  void stopAcoustic() override { acoustic = false; }
+  void setAcousticParameters(float, float, const AcousticModulation&) override {}
+  bool isAcousticOn() const override { return acoustic; }
+  void setActuationMap(const ActuationMap& m) override { map = m; }
+
+  bool acoustic = false;
+  ActuationMap map;
+};
+
+// ConfigStore vacío sobre un archivo temporal, para cada prueba
+FileStorageBackend& freshStore() {
+  static FileStorageBackend backend("/tmp/vortex_test_thresholds_" + std::to_string(getpid()) + ".bin");
+  backend.erase();
+  ConfigStore::getInstance().begin(&backend);
+  return backend;
+}
+
+// Juego coherente identificado por sig: cada campo se deriva de él, así una
+// mezcla de dos juegos se detecta comparando cualquier campo con MAP_WAKEUP
+TuningProfile signedProfile(float sig) {
+  TuningProfile p = ThresholdManager::factoryProfile();
+  Thresholds& t = p.thresholds;
+  t.MAP_WAKEUP_PERCENT = sig;
+  t.INJ_TPS_ON = 10.0f + sig;
+  t.INJ_TPS_OFF = 8.0f + sig;
+  t.INJ_MAP_ON = 40.0f + sig;
+  t.INJ_MAP_OFF = 30.0f + sig;
+  t.VORTEX_TPS_ON = 45.0f + sig;
+  t.VORTEX_MAP_ON = 75.0f + sig;
+  t.VORTEX_TPS_OFF = 30.0f + sig;
+  p.actuation.freqMinHz = 4000.0f + 10.0f * sig;
+  p.actuation.freqMaxHz = 6000.0f + 10.0f * sig;
+  return p;
+}
+
+bool isSigned(const TuningProfile& p) {
+  TuningProfile want = signedProfile(p.thresholds.MAP_WAKEUP_PERCENT);
+  return memcmp(&p.thresholds, &want.thresholds, sizeof(Thresholds)) == 0 &&
+         p.actuation.freqMinHz == want.actuation.freqMinHz && p.actuation.freqMaxHz == want.actuation.freqMaxHz;
+}
+
+// Lo que hace la consola con una línea "thr CLAVE VALOR" por clave; entre
+// líneas el loop de control sigue corriendo
+void stageAll(ThresholdManager& m, const TuningProfile& p) {
+  const Thresholds& t = p.thresholds;
+  const std::pair<const char*, float> lines[] = {
+    {"MAP_WAKEUP_PERCENT", t.MAP_WAKEUP_PERCENT}, {"INJ_TPS_ON", t.INJ_TPS_ON},
+    {"INJ_MAP_ON", t.INJ_MAP_ON},                 {"INJ_TPS_OFF", t.INJ_TPS_OFF},
+    {"INJ_MAP_OFF", t.INJ_MAP_OFF},               {"VORTEX_TPS_ON", t.VORTEX_TPS_ON},
+    {"VORTEX_MAP_ON", t.VORTEX_MAP_ON},           {"VORTEX_TPS_OFF", t.VORTEX_TPS_OFF},
+    {"FREQ_MIN_HZ", p.actuation.freqMinHz},       {"FREQ_MAX_HZ", p.actuation.freqMaxHz},
+  };
+  for (const auto& line : lines) {
+    m.setThreshold(line.first, line.second);
+    std::this_thread::yield();
+  }
+}
+
+bool isSafe(SystemState s) {
+  return s == SystemState::OFF || s == SystemState::SIN_CALIBRAR || s == SystemState::CALIBRATION ||
+         s == SystemState::IDLE;
+}
+
+}  // namespace
+
+TEST(ThresholdManager, EditsAreStagedUntilApplied) {
+  freshStore();
+  ThresholdManager m;
+  m.begin();
+  m.applyPending();
+
+  EXPECT_TRUE(m.setThreshold("INJ_TPS_ON", 20.0f));
+  EXPECT_TRUE(m.setThreshold("INJ_TPS_OFF", 15.0f));
+  EXPECT_FALSE(m.setThreshold("NO_EXISTE", 1.0f));
+  // Nada llega al loop ni al perfil mientras se edita
+  EXPECT_FALSE(m.applyPending());
+  EXPECT_EQ(m.active().thresholds.INJ_TPS_ON, 10.0f);
+  EXPECT_EQ(m.getThresholds().INJ_TPS_OFF, 8.0f);
+  EXPECT_EQ(m.getEditIndex(), 0);
+
+  TuningProfile draft;
+  ASSERT_TRUE(m.getEdits(draft));
+  EXPECT_EQ(draft.thresholds.INJ_TPS_ON, 20.0f);
+
+  EXPECT_TRUE(m.applyEdits() == ThresholdManager::EditResult::OK);
+  EXPECT_TRUE(m.applyPending());  // Una sola publicación con las dos claves
+  EXPECT_FALSE(m.applyPending());
+  EXPECT_EQ(m.active().thresholds.INJ_TPS_ON, 20.0f);
+  EXPECT_EQ(m.active().thresholds.INJ_TPS_OFF, 15.0f);
+  EXPECT_EQ(m.getEditIndex(), -1);
+  EXPECT_TRUE(m.applyEdits() == ThresholdManager::EditResult::NO_EDITS);
+}
+
+TEST(ThresholdManager, IncoherentEditsAreRefused) {
+  freshStore();
+  ThresholdManager m;
+  m.begin();
+  m.applyPending();
+
+  // OFF por encima de ON: la FSM nunca apagaría la inyección
+  m.setThreshold("INJ_TPS_OFF", 12.0f);
+  const char* reason = nullptr;
+  EXPECT_TRUE(m.applyEdits(&reason) == ThresholdManager::EditResult::INVALID);
+  EXPECT_TRUE(reason != nullptr);
+  EXPECT_FALSE(m.applyPending());
+  EXPECT_EQ(m.getThresholds().INJ_TPS_OFF, 8.0f);
+
+  // El borrador sigue abierto: completar la edición la hace válida
+  m.setThreshold("INJ_TPS_ON", 14.0f);
+  EXPECT_TRUE(m.applyEdits() == ThresholdManager::EditResult::OK);
+  EXPECT_TRUE(m.applyPending());
+
+  // Los demás invariantes de makeValid() en tools/tune
+  const TuningProfile base = signedProfile(5.0f);
+  EXPECT_TRUE(ThresholdManager::checkProfile(base) == nullptr);
+  TuningProfile p = base;
+  p.thresholds.INJ_MAP_OFF = p.thresholds.INJ_MAP_ON - 0.5f;
+  EXPECT_TRUE(ThresholdManager::checkProfile(p) != nullptr);
+  p = base;
+  p.thresholds.VORTEX_TPS_OFF = p.thresholds.VORTEX_TPS_ON;
+  EXPECT_TRUE(ThresholdManager::checkProfile(p) != nullptr);
+  p = base;
+  p.thresholds.VORTEX_TPS_ON = p.thresholds.INJ_TPS_ON;
+  EXPECT_TRUE(ThresholdManager::checkProfile(p) != nullptr);
+  p = base;
+  p.thresholds.VORTEX_MAP_ON = 120.0f;
+  EXPECT_TRUE(ThresholdManager::checkProfile(p) != nullptr);
+  p = base;
+  p.actuation.freqMaxHz = p.actuation.freqMinHz - 1.0f;
+  EXPECT_TRUE(ThresholdManager::checkProfile(p) != nullptr);
+  EXPECT_TRUE(ThresholdManager::checkProfile(ThresholdManager::factoryProfile()) == nullptr);
+}
+
+TEST(ThresholdManager, SaveAppliesAndPersistsOnlyCoherentEdits) {
+  freshStore();
+  ThresholdManager m;
+  m.begin();
+  ConfigStore& store = ConfigStore::getInstance();
+  TuningProfile stored;
+  ASSERT_TRUE(store.getProfile(0, stored));
+  uint16_t revision = stored.revision;
+
+  m.setThreshold("VORTEX_TPS_OFF", 60.0f);  // Por encima de VORTEX_TPS_ON
+  EXPECT_TRUE(m.save() == ThresholdManager::EditResult::INVALID);
+  store.getProfile(0, stored);
+  EXPECT_EQ(stored.revision, revision);
+  EXPECT_EQ(stored.thresholds.VORTEX_TPS_OFF, 30.0f);
+
+  m.discardEdits();
+  m.setThreshold("VORTEX_TPS_OFF", 35.0f);
+  EXPECT_TRUE(m.save() == ThresholdManager::EditResult::OK);
+  store.getProfile(0, stored);
+  EXPECT_EQ(stored.revision, revision + 1);
+  EXPECT_EQ(stored.thresholds.VORTEX_TPS_OFF, 35.0f);
+}
+
+TEST(ThresholdManager, NewProfileIsEditedWithoutTouchingTheActiveOne) {
+  freshStore();
+  ThresholdManager m;
+  m.begin();
+  m.applyPending();
+
+  int pista = m.createAndEdit("pista");
+  ASSERT_GE(pista, 1);
+  stageAll(m, signedProfile(6.0f));
+  EXPECT_TRUE(m.save() == ThresholdManager::EditResult::OK);
+  EXPECT_FALSE(m.applyPending());  // Se editó "pista", el loop sigue con "base"
+  EXPECT_EQ(m.getSelectedIndex(), 0);
+  TuningProfile p;
+  ASSERT_TRUE(m.getProfile(static_cast<uint8_t>(pista), p));
+  EXPECT_TRUE(isSigned(p));
+  EXPECT_EQ(std::string(p.name), std::string("pista"));
+
+  // Reimportar con el mismo nombre edita el existente
+  EXPECT_EQ(m.createAndEdit("pista"), pista);
+  stageAll(m, signedProfile(7.0f));
+  EXPECT_TRUE(m.applyEdits() == ThresholdManager::EditResult::OK);
+  m.getProfile(static_cast<uint8_t>(pista), p);
+  EXPECT_EQ(p.thresholds.MAP_WAKEUP_PERCENT, 7.0f);
+
+  // Sin ranuras libres las ediciones no caen en otro perfil
+  EXPECT_GE(m.createProfile("a"), 0);
+  EXPECT_GE(m.createProfile("b"), 0);
+  EXPECT_EQ(m.createAndEdit("lleno"), -1);
+  EXPECT_EQ(m.getEditIndex(), ThresholdManager::NO_SLOT);
+  m.setThreshold("INJ_TPS_ON", 30.0f);
+  EXPECT_TRUE(m.save() == ThresholdManager::EditResult::NO_SLOT);
+  EXPECT_EQ(m.getThresholds().INJ_TPS_ON, 10.0f);
+  EXPECT_FALSE(m.applyPending());
+}
+
+TEST(ThresholdManager, SwitchingUnderARunningControlLoop) {
+  // El loop corre la StateMachine real con cargas que recorren todos los
+  // estados; la consola, en otro hilo, alterna perfiles y reescribe uno de
+  // ellos clave a clave. Cada perfil que ve el loop debe ser un juego entero
+  // y coherente, y solo puede cambiar en un estado sin actuadores.
+  freshStore();
+  ThresholdManager m;
+  m.begin();
+  stageAll(m, signedProfile(5.0f));
+  ASSERT_TRUE(m.applyEdits() == ThresholdManager::EditResult::OK);
+  int pista = m.createAndEdit("pista");
+  ASSERT_GE(pista, 1);
+  stageAll(m, signedProfile(6.0f));
+  ASSERT_TRUE(m.applyEdits() == ThresholdManager::EditResult::OK);
+
+  NullActuators actuators;
+  DebugManager debug;
+  StateMachine fsm;
+  fsm.begin(true, &actuators, &m);
+
+  std::atomic<bool> done{false};
+  std::thread console([&]() {
+    for (uint32_t i = 0; i < 4000; ++i) {
+      m.selectProfile(i % 2 ? static_cast<uint8_t>(pista) : 0);
+      m.editProfile(static_cast<uint8_t>(pista));
+      stageAll(m, signedProfile(i % 3 ? 6.0f : 7.0f));
+      m.applyEdits();
+      std::this_thread::yield();
+    }
+    done.store(true, std::memory_order_release);
+  });
+
+  uint32_t step = 0, changes = 0, mixed = 0, unsafe = 0, mapMismatch = 0;
+  float lastSig = m.active().thresholds.MAP_WAKEUP_PERCENT;
+  bool finished = false;
+  while (!finished) {
+    finished = done.load(std::memory_order_acquire);  // Una vuelta más tras el último cambio
+    for (uint32_t i = 0; i < 50; ++i) {
+      uint32_t phase = step++ % 400;
+      float load = phase < 200 ? phase * 0.5f : (400 - phase) * 0.5f;
+      SystemState before = fsm.getState();
+      fsm.update(load, load, false, false, true, debug);
+      fsm.handleActions();
+
+      const TuningProfile& p = m.active();
+      if (!isSigned(p)) mixed++;
+      if (p.actuation.freqMaxHz != actuators.map.freqMaxHz) mapMismatch++;
+      if (p.thresholds.MAP_WAKEUP_PERCENT != lastSig) {
+        changes++;
+        if (!isSafe(before)) unsafe++;
+        lastSig = p.thresholds.MAP_WAKEUP_PERCENT;
+      }
+    }
+    std::this_thread::yield();
+  }
+  console.join();
+
+  EXPECT_EQ(mixed, 0u);
+  EXPECT_EQ(unsafe, 0u);
+  EXPECT_EQ(mapMismatch, 0u);
+  EXPECT_GT(changes, 10u);
+}
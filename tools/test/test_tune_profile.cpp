@@ -0,0 +1,191 @@
+// vortex_tune: los perfiles que emite se importan por consola en un paso y
+// cumplen los invariantes que la consola exige al aplicarlos
+#include "TestHarness.h"
+#include "CommandParser.h"
+#include "ConfigStore.h"
+#include "FileStorageBackend.h"
+#include "ThresholdManager.h"
+#include "TuneProfile.h"
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <unistd.h>
+
+namespace {
+
+void freshStore() {
+  static FileStorageBackend backend("/tmp/vortex_test_tune_" + std::to_string(getpid()) + ".bin");
+  backend.erase();
+  ConfigStore::getInstance().begin(&backend);
+}
+
+std::string exportBlock(const char* name, const Thresholds& t) {
+  char* text = nullptr;
+  size_t size = 0;
+  FILE* out = open_memstream(&text, &size);
+  writeProfileBlock(out, name, t);
+  fclose(out);
+  std::string block(text, size);
+  free(text);
+  return block;
+}
+
+// Lo que hacen ConsoleUI::cmdPerfil y cmdUmbrales con cada línea del bloque
+struct Import {
+  ThresholdManager& m;
+  uint32_t lines = 0;
+  uint32_t publications = 0;     ///< Perfiles adoptados por el loop durante el bloque
+  uint32_t beforeSave = 0;       ///< ...antes de llegar a "thr save"
+  bool rejected = false;         ///< Alguna línea que la consola habría rechazado
+  ThresholdManager::EditResult saved = ThresholdManager::EditResult::NO_EDITS;
+
+  void line(char* text) {
+    CommandArgs args;
+    if (tokenizeCommand(text, args) == 0 || args.name()[0] == '#') return;
+    lines++;
+    const char* a1 = args.arg(1);
+    float value;
+    if (strcmp(args.name(), "perfil") == 0 && a1 && strcmp(a1, "nuevo") == 0) {
+      if (m.createAndEdit(args.arg(2)) < 0) rejected = true;
+    } else if (strcmp(args.name(), "perfil") == 0 && a1) {
+      int index = m.findProfile(a1);
+      if (index < 0 || !m.selectProfile(static_cast<uint8_t>(index))) rejected = true;
+    } else if (strcmp(args.name(), "thr") == 0 && a1 && strcmp(a1, "save") == 0) {
+      beforeSave = publications;
+      saved = m.save();
+    } else if (strcmp(args.name(), "thr") == 0 && args.arg(2) && CommandArgs::toFloat(args.arg(2), value)) {
+      if (!m.setThreshold(a1, value)) rejected = true;
+    } else {
+      rejected = true;
+    }
+    // El loop de control corre entre línea y línea
+    if (m.applyPending()) publications++;
+  }
+
+  void text(const std::string& block) {
+    size_t pos = 0;
+    while (pos < block.size()) {
+      size_t end = block.find('\n', pos);
+      std::string one = block.substr(pos, end - pos);
+      line(&one[0]);
+      pos = end == std::string::npos ? block.size() : end + 1;
+    }
+  }
+};
+
+Thresholds tuned(uint32_t seed) {
+  std::mt19937 rng(seed);
+  Thresholds t{};
+  for (size_t i = 0; i < TUNE_PARAM_COUNT; ++i) {
+    const ParamSpec& p = TUNE_PARAMS[i];
+    t.*p.field = std::uniform_real_distribution<float>(p.lo, p.hi)(rng);
+  }
+  makeValid(t);
+  return t;
+}
+
+bool sameThresholds(const Thresholds& a, const Thresholds& b) {
+  for (size_t i = 0; i < TUNE_PARAM_COUNT; ++i) {
+    if (a.*TUNE_PARAMS[i].field != b.*TUNE_PARAMS[i].field) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+TEST(TuneProfile, MakeValidPassesTheConsoleChecks) {
+  // Cualquier punto de la búsqueda, también los extremos del rango, es importable
+  TuningProfile p = ThresholdManager::factoryProfile();
+  for (uint32_t seed = 0; seed < 5000; ++seed) {
+    p.thresholds = tuned(seed);
+    const char* reason = ThresholdManager::checkProfile(p);
+    if (reason) {
+      EXPECT_TRUE(reason == nullptr);
+      break;
+    }
+  }
+  for (float edge : {-1000.0f, 1000.0f}) {
+    for (size_t i = 0; i < TUNE_PARAM_COUNT; ++i) p.thresholds.*TUNE_PARAMS[i].field = edge;
+    makeValid(p.thresholds);
+    EXPECT_TRUE(ThresholdManager::checkProfile(p) == nullptr);
+  }
+}
+
+TEST(TuneProfile, BlockImportsWithoutIntermediatePublication) {
+  freshStore();
+  ThresholdManager m;
+  m.begin();
+  m.applyPending();
+
+  Thresholds t = tuned(7);
+  std::string block = exportBlock("tune1", t);
+  EXPECT_EQ(block.find("perfil nuevo tune1\n"), 0u);
+
+  Import imp{m};
+  imp.text(block);
+  EXPECT_FALSE(imp.rejected);
+  EXPECT_EQ(imp.lines, TUNE_PARAM_COUNT + 2);  // perfil nuevo, las claves y thr save
+  EXPECT_TRUE(imp.saved == ThresholdManager::EditResult::OK);
+  EXPECT_EQ(imp.publications, 0u);  // Perfil nuevo: el loop sigue con el suyo
+
+  int index = m.findProfile("tune1");
+  ASSERT_GE(index, 1);
+  TuningProfile p;
+  m.getProfile(static_cast<uint8_t>(index), p);
+  EXPECT_TRUE(sameThresholds(p.thresholds, t));
+  TuningProfile stored;
+  EXPECT_TRUE(ConfigStore::getInstance().getProfile(static_cast<uint8_t>(index), stored));
+  EXPECT_TRUE(sameThresholds(stored.thresholds, t));
+
+  // Pasar a él es un único cambio con el juego completo
+  Import use{m};
+  char select[] = "perfil tune1";
+  use.line(select);
+  EXPECT_EQ(use.publications, 1u);
+  EXPECT_TRUE(sameThresholds(m.active().thresholds, t));
+}
+
+TEST(TuneProfile, ReimportOverTheActiveProfilePublishesOnce) {
+  freshStore();
+  ThresholdManager m;
+  m.begin();
+  Import first{m};
+  first.text(exportBlock("tune1", tuned(1)));
+  char select[] = "perfil tune1";
+  first.line(select);
+  m.applyPending();
+
+  // Otro resultado con el mismo nombre mientras ese perfil está en uso
+  Thresholds t = tuned(2);
+  Import again{m};
+  again.text(exportBlock("tune1", t));
+  EXPECT_FALSE(again.rejected);
+  EXPECT_EQ(again.beforeSave, 0u);
+  EXPECT_EQ(again.publications, 1u);
+  EXPECT_TRUE(sameThresholds(m.active().thresholds, t));
+}
+
+TEST(TuneProfile, BlockWithoutAFreeSlotChangesNothing) {
+  freshStore();
+  ThresholdManager m;
+  m.begin();
+  m.applyPending();
+  m.createProfile("a");
+  m.createProfile("b");
+  m.createProfile("c");
+  Thresholds before = m.getThresholds();
+
+  Import imp{m};
+  imp.text(exportBlock("tune1", tuned(3)));
+  EXPECT_TRUE(imp.rejected);
+  EXPECT_TRUE(imp.saved == ThresholdManager::EditResult::NO_SLOT);
+  EXPECT_EQ(imp.publications, 0u);
+  EXPECT_TRUE(sameThresholds(m.getThresholds(), before));
+  TuningProfile p;
+  for (uint8_t i = 1; i < MAX_PROFILES; ++i) {
+    ASSERT_TRUE(m.getProfile(i, p));
+    EXPECT_TRUE(sameThresholds(p.thresholds, before));
+  }
+}
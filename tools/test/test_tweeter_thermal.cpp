@@ -0,0 +1,107 @@
+// TweeterThermal: modelo RC de primer orden que limita el nivel del tweeter,
+// simulado con el paso del lazo (20 ms con jitter) y comparado con el RC en
+// doble precisión
+#include "TestHarness.h"
+#include "TweeterThermal.h"
+#include <algorithm>
+#include <math.h>
+
+namespace {
+
+const ThermalParams P;
+
+// A nivel 1 desde frío hasta que empieza a limitar; devuelve los ms
+uint32_t heatUntilLimiting(TweeterThermal& th, uint32_t& t) {
+  uint32_t ms = 0;
+  th.apply(t, 1.0f);
+  while (!th.isLimiting() && ms <= 60000) {
+    t += 20;
+    ms += 20;
+    // Todo recorte se marca
+    if (th.apply(t, 1.0f) < 1.0f && !EXPECT_TRUE(th.isLimiting())) break;
+  }
+  return ms;
+}
+
+}  // namespace
+
+TEST(TweeterThermal, KneeArrivesOnTime) {
+  // En frío deja nivel 1 hasta la rodilla: tau·ln(R / (R - K)) a potencia 1
+  TweeterThermal th;
+  uint32_t t = 0xFFFF0000u;  // millis() da la vuelta a mitad de la prueba
+  uint32_t ms = heatUntilLimiting(th, t);
+  ASSERT_TRUE(th.isLimiting());
+  EXPECT_NEAR(ms / 1000.0, P.tauS * log(P.riseFullC / (P.riseFullC - P.kneeC)), 0.05);
+}
+
+TEST(TweeterThermal, FullPowerSettlesAtTheCeiling) {
+  TweeterThermal th;
+  uint32_t t = 0;
+  heatUntilLimiting(th, t);
+  // A fondo sin parar: se acerca al techo sin pasarlo y queda en el nivel continuo
+  float peak = 0.0f;
+  for (uint32_t i = 0; i < 60000; ++i) {
+    th.apply(t += 20, 1.0f);
+    peak = std::max(peak, th.getRise());
+  }
+  EXPECT_LE(peak, P.ceilingC + 0.01f);
+  EXPECT_GE(th.getRise(), P.ceilingC - 0.5f);
+  EXPECT_NEAR(th.maxLevel(), th.continuousLevel(), 0.005f);
+
+  // Parado enfría con la misma constante, integrada en una sola llamada
+  float hot = th.getRise();
+  th.off(t);
+  th.apply(t += (uint32_t)(2000.0 * P.tauS), 0.0f);
+  EXPECT_NEAR(th.getRise(), hot * exp(-2.0), 0.01);
+}
+
+TEST(TweeterThermal, BurstsCountTheirDutyCycle) {
+  // Ráfagas a nivel 1 con la mitad de ciclo: potencia media 0.5, nunca limita
+  AcousticModulation burst;
+  burst.mode = ModulationMode::BURST;
+  TweeterThermal pulsed;
+  uint32_t limited = 0;
+  for (uint32_t i = 0; i < 100000; ++i) {
+    if (pulsed.apply(i * 20, 1.0f, modulationDuty(burst)) < 1.0f) limited++;
+  }
+  EXPECT_EQ(limited, 0u);
+  EXPECT_NEAR(pulsed.getRise(), 0.5f * P.riseFullC, 0.1f);
+
+  burst.burstOnMs = 0;
+  burst.burstOffMs = 0;
+  EXPECT_EQ(modulationDuty(burst), 1.0f);  // Sin periodo: encendido siempre
+}
+
+TEST(TweeterThermal, LongDriveTracksTheExactRc) {
+  // 2 h con jitter y un nivel que sube y baja; referencia en doble con la
+  // potencia que de verdad salió en cada tramo
+  TweeterThermal drive;
+  AcousticModulation am;
+  am.mode = ModulationMode::AM;
+  double ref = 0.0, refPower = 0.0, maxErr = 0.0;
+  float peak = 0.0f;
+  uint32_t seed = 12345, limited = 0, raised = 0, t = 0;
+  drive.apply(t, 0.0f);
+  for (uint32_t i = 0; i < 360000; ++i) {
+    seed = seed * 1664525u + 1013904223u;
+    uint32_t dt = 15 + (seed >> 24) % 11;
+    t += dt;
+    double decay = exp(-(dt / 1000.0) / P.tauS);
+    ref = P.riseFullC * refPower + (ref - P.riseFullC * refPower) * decay;
+
+    float level = 0.6f + 0.4f * sinf(i * 1e-4f);
+    bool modulated = (i / 30000) % 2;
+    float duty = modulated ? modulationDuty(am) : 1.0f;
+    float out = drive.apply(t, level, duty);
+    if (out > level) raised++;
+    if (drive.isLimiting()) limited++;
+    refPower = (double)out * out * duty;
+
+    maxErr = std::max(maxErr, fabs(drive.getRise() - ref));
+    peak = std::max(peak, drive.getRise());
+  }
+  EXPECT_EQ(raised, 0u);  // Solo baja el nivel, nunca lo sube
+  EXPECT_GT(limited, 0u);
+  EXPECT_LE(peak, P.ceilingC + 0.01f);
+  EXPECT_LE(maxErr, 0.05);
+}
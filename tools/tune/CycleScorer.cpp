@@ -0,0 +1,87 @@
+#include "CycleScorer.h"
+#include "StateMachine.h"
+
+void CycleScore::add(const CycleScore& o) {
+  tipIns += o.tipIns;
+  misses += o.misses;
+  latencySumMs += o.latencySumMs;
+  toggles += o.toggles;
+  activeMs += o.activeMs;
+  totalMs += o.totalMs;
+}
+
+void CycleScorer::onSample(uint32_t tMs, float tpsPct) {
+  if (!started) {
+    started = true;
+    startMs = tMs;
+  }
+
+  if (pending && tMs - tipInMs > missWindowMs) {
+    pending = false;
+    score.misses++;
+    score.latencySumMs += missWindowMs;
+  }
+
+  if (tpsPct < tipInPct - REARM_PCT) {
+    armed = true;
+  } else if (armed && tpsPct >= tipInPct) {
+    armed = false;
+    score.tipIns++;
+    if (acousticOn) {
+      // Ya estaba inyectando: latencia cero
+    } else if (!pending) {
+      pending = true;
+      tipInMs = tMs;
+    } else {
+      // Aceleración nueva con la anterior aún sin respuesta: la anterior ya falló
+      score.misses++;
+      score.latencySumMs += missWindowMs;
+      tipInMs = tMs;
+    }
+  }
+}
+
+void CycleScorer::onEvent(const TimelineEvent& ev) {
+  switch (ev.kind) {
+    case TimelineKind::ACOUSTIC:
+      score.toggles++;
+      acousticOn = ev.value != 0;
+      if (acousticOn && pending) {
+        pending = false;
+        score.latencySumMs += ev.tMs > tipInMs ? ev.tMs - tipInMs : 0;
+      }
+      break;
+
+    case TimelineKind::VORTEX:
+      score.toggles++;
+      break;
+
+    case TimelineKind::STATE: {
+      bool nowActive = ev.value == static_cast<int32_t>(SystemState::INYECCION_ACUSTICA) ||
+                       ev.value == static_cast<int32_t>(SystemState::VORTEX);
+      if (nowActive && !active) {
+        activeSinceMs = ev.tMs;
+      } else if (!nowActive && active) {
+        score.activeMs += ev.tMs - activeSinceMs;
+      }
+      active = nowActive;
+      break;
+    }
+
+    default:
+      break;
+  }
+}
+
+void CycleScorer::finish(uint32_t endMs) {
+  if (active) {
+    score.activeMs += endMs - activeSinceMs;
+    active = false;
+  }
+  if (pending) {
+    pending = false;
+    score.misses++;
+    score.latencySumMs += missWindowMs;
+  }
+  score.totalMs = started ? endMs - startMs : 0;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Timeline.h"
+#include <stdint.h>
+
+/**
+ * @struct CycleScore
+ * Lo que se mide de un ciclo de manejo; se puede sumar entre ciclos.
+ */
+struct CycleScore {
+  uint32_t tipIns = 0;          ///< Aceleraciones detectadas en la entrada
+  uint32_t misses = 0;          ///< Sin inyección dentro de la ventana
+  uint64_t latencySumMs = 0;    ///< Suma de latencias (los fallos cuentan la ventana completa)
+  uint32_t toggles = 0;         ///< Conmutaciones de relé (acústico y vortex)
+  uint64_t activeMs = 0;        ///< Tiempo en INYECCION_ACUSTICA o VORTEX
+  uint64_t totalMs = 0;
+
+  void add(const CycleScore& o);
+  float meanLatencyMs() const { return tipIns ? float(latencySumMs) / tipIns : 0.0f; }
+  float togglesPerMin() const { return totalMs ? toggles * 60000.0f / totalMs : 0.0f; }
+  float activePct() const { return totalMs ? activeMs * 100.0f / totalMs : 0.0f; }
+};
+
+/**
+ * @struct CostWeights
+ * Peso de cada término del coste (menor es mejor).
+ */
+struct CostWeights {
+  float latency = 1.0f;   ///< Por ms de latencia media tras una aceleración
+  float toggles = 20.0f;  ///< Por conmutación de relé por minuto
+  float active = 5.0f;    ///< Por punto porcentual de tiempo en estados activos
+
+  float cost(const CycleScore& s) const {
+    return latency * s.meanLatencyMs() + toggles * s.togglesPerMin() + active * s.activePct();
+  }
+};
+
+/**
+ * @class CycleScorer
+ * Puntúa la línea de tiempo del replay contra la entrada que la produjo.
+ *
+ * Una aceleración ("tip-in") es el TPS, en % de calibración como lo ve la
+ * FSM, cruzando tipInPct hacia arriba después de haber bajado de
+ * tipInPct - REARM_PCT. Su latencia es el tiempo hasta el siguiente
+ * "acoustic 1"; si no llega en missWindowMs cuenta como fallo.
+ *
+ * Llamar onSample() después de ReplayEngine::feed() con la misma muestra:
+ * así los eventos que ya llegaron son todos anteriores a ella.
+ */
+class CycleScorer : public TimelineSink {
+public:
+  static constexpr float REARM_PCT = 5.0f;
+
+  CycleScorer(float tipInPct, uint32_t missWindowMs) : tipInPct(tipInPct), missWindowMs(missWindowMs) {}
+
+  void onSample(uint32_t tMs, float tpsPct);
+  void onEvent(const TimelineEvent& ev) override;
+
+  /// Cierra el ciclo en endMs (tiempo activo y aceleración pendiente)
+  void finish(uint32_t endMs);
+
+  const CycleScore& getScore() const { return score; }
+
+private:
+  float tipInPct;
+  uint32_t missWindowMs;
+
+  CycleScore score;
+  bool armed = false;
+  bool pending = false;
+  uint32_t tipInMs = 0;
+  bool acousticOn = false;
+  bool active = false;
+  uint32_t activeSinceMs = 0;
+  bool started = false;
+  uint32_t startMs = 0;
+};
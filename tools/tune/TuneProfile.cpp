@@ -0,0 +1,35 @@
+#include "TuneProfile.h"
+#include "ThresholdManager.h"
+#include <algorithm>
+#include <math.h>
+
+const ParamSpec TUNE_PARAMS[TUNE_PARAM_COUNT] = {
+  {"MAP_WAKEUP_PERCENT", &Thresholds::MAP_WAKEUP_PERCENT, 0.0f, 20.0f},
+  {"INJ_TPS_ON",         &Thresholds::INJ_TPS_ON,         2.0f, 40.0f},
+  {"INJ_MAP_ON",         &Thresholds::INJ_MAP_ON,         5.0f, 80.0f},
+  {"INJ_TPS_OFF",        &Thresholds::INJ_TPS_OFF,        1.0f, 35.0f},
+  {"INJ_MAP_OFF",        &Thresholds::INJ_MAP_OFF,        0.0f, 70.0f},
+  {"VORTEX_TPS_ON",      &Thresholds::VORTEX_TPS_ON,     20.0f, 95.0f},
+  {"VORTEX_MAP_ON",      &Thresholds::VORTEX_MAP_ON,     30.0f, 98.0f},
+  {"VORTEX_TPS_OFF",     &Thresholds::VORTEX_TPS_OFF,    10.0f, 85.0f},
+};
+static_assert(sizeof(Thresholds) == TUNE_PARAM_COUNT * sizeof(float), "Umbral nuevo sin rango de búsqueda");
+
+void makeValid(Thresholds& t) {
+  constexpr float HYSTERESIS = ThresholdManager::MIN_HYSTERESIS;
+  for (const ParamSpec& p : TUNE_PARAMS) {
+    float v = std::min(std::max(t.*p.field, p.lo), p.hi);
+    t.*p.field = roundf(v / TUNE_QUANTUM) * TUNE_QUANTUM;
+  }
+  t.INJ_TPS_OFF = std::min(t.INJ_TPS_OFF, t.INJ_TPS_ON - HYSTERESIS);
+  t.INJ_MAP_OFF = std::min(t.INJ_MAP_OFF, t.INJ_MAP_ON - HYSTERESIS);
+  t.VORTEX_TPS_ON = std::max(t.VORTEX_TPS_ON, t.INJ_TPS_ON + HYSTERESIS);
+  t.VORTEX_TPS_OFF = std::min(t.VORTEX_TPS_OFF, t.VORTEX_TPS_ON - HYSTERESIS);
+}
+
+void writeProfileBlock(FILE* out, const char* name, const Thresholds& t) {
+  fprintf(out, "perfil nuevo %s\n", name);
+  for (const ParamSpec& p : TUNE_PARAMS) fprintf(out, "thr %s %.1f\n", p.name, t.*p.field);
+  fprintf(out, "thr save\n");
+  fprintf(out, "# \"perfil %s\" para usarlo\n\n", name);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Thresholds.h"
+#include <stddef.h>
+#include <stdio.h>
+
+/**
+ * @struct ParamSpec
+ * Un umbral que optimiza vortex_tune: clave de consola, campo y rango de
+ * búsqueda (en %).
+ */
+struct ParamSpec {
+  const char* name;
+  float Thresholds::* field;
+  float lo;
+  float hi;
+};
+
+constexpr size_t TUNE_PARAM_COUNT = 8;  ///< Todos los campos de Thresholds
+extern const ParamSpec TUNE_PARAMS[TUNE_PARAM_COUNT];
+
+constexpr float TUNE_QUANTUM = 0.5f;  ///< Resolución de los umbrales emitidos
+
+/**
+ * Deja un juego dentro de rango, cuantizado y con la histéresis que exige
+ * ThresholdManager::checkProfile(), para que la consola lo acepte al importarlo.
+ */
+void makeValid(Thresholds& t);
+
+/**
+ * Escribe un perfil como bloque importable por la consola: "perfil nuevo
+ * NOMBRE" abre el borrador, cada "thr CLAVE VALOR" se acumula en él y un
+ * único "thr save" lo valida, lo aplica y lo guarda. Nada llega al loop de
+ * control a mitad del bloque.
+ * @param name Nombre del perfil (hasta PROFILE_NAME_LEN - 1 caracteres).
+ */
+void writeProfileBlock(FILE* out, const char* name, const Thresholds& t);
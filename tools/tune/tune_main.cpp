@@ -0,0 +1,283 @@
+#include "CycleScorer.h"
+#include "ReplayEngine.h"
+#include "SensorLog.h"
+#include "SensorMath.h"
+#include "ThresholdManager.h"
+#include "TuneProfile.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <math.h>
+#include <random>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+/*
+ * vortex_tune: busca umbrales de la FSM sobre un corpus de ciclos de manejo.
+ *
+ *   vortex_tune [opciones] CICLO... > perfiles.txt
+ *
+ * Cada ciclo es un registro de vortex_replay (texto o binario): capturas con
+ * "rec" o ciclos simulados con lib/simulation/drive_cycles.py. Cada juego de
+ * umbrales se evalúa reproduciendo todo el corpus con la StateMachine real y
+ * se puntúa con CostWeights; la búsqueda es evolutiva (población aleatoria y
+ * luego perturbaciones cada vez menores de los mejores) y evalúa en paralelo
+ * en todos los núcleos.
+ *
+ * La salida son los mejores perfiles como bloques "perfil nuevo NOMBRE", líneas
+ * "thr CLAVE VALOR" y un solo "thr save" (writeProfileBlock()), listos para
+ * pegar en la consola del ESP32: cada bloque se aplica de una vez.
+ *
+ * Opciones:
+ *   --generations=N  --population=N  --top=N  --threads=N  --seed=N
+ *   --tip-in=PCT     TPS que define una aceleración (30)
+ *   --miss-ms=N      Ventana para considerar fallida una aceleración (2000)
+ *   --w-latency=W --w-toggles=W --w-active=W   Pesos del coste
+ *   --tps=MIN:MAX --map=MIN:MAX --loop-ms=N --step-ms=N   Como en vortex_replay
+ *   --out=ARCHIVO    Perfiles (por defecto stdout)
+ */
+
+namespace {
+
+struct Candidate {
+  Thresholds t;
+  CycleScore score;
+  float cost = 0.0f;
+};
+
+struct Options {
+  std::vector<const char*> cycles;
+  const char* outPath = nullptr;
+  uint32_t generations = 10;
+  uint32_t population = 48;
+  uint32_t top = 5;
+  uint32_t threads = 0;
+  uint32_t seed = 1;
+  uint32_t stepMs = 20;
+  float tipInPct = 30.0f;
+  uint32_t missMs = 2000;
+  CostWeights weights;
+  ReplayConfig replay;
+};
+
+const char* argValue(const char* arg, const char* key) {
+  size_t n = strlen(key);
+  return strncmp(arg, key, n) == 0 ? arg + n : nullptr;
+}
+
+bool parseRange(const char* text, uint16_t& lo, uint16_t& hi) {
+  unsigned a, b;
+  if (sscanf(text, "%u:%u", &a, &b) != 2 || a >= b || b > 4095) return false;
+  lo = static_cast<uint16_t>(a);
+  hi = static_cast<uint16_t>(b);
+  return true;
+}
+
+bool parseOptions(int argc, char** argv, Options& opt) {
+  // Calibración de race_sim.py, igual que vortex_replay
+  CalibrationData& c = opt.replay.calib;
+  c.tpsMin = static_cast<uint16_t>((0.5f / 3.3f) * 4095);
+  c.tpsMax = static_cast<uint16_t>((2.25f / 3.3f) * 4095);
+  c.mapMin = static_cast<uint16_t>((3.05f / 3.3f) * 4095);
+  c.mapMax = static_cast<uint16_t>((3.26f / 3.3f) * 4095);
+
+  for (int i = 1; i < argc; ++i) {
+    const char* v;
+    if (argv[i][0] != '-') opt.cycles.push_back(argv[i]);
+    else if ((v = argValue(argv[i], "--out="))) opt.outPath = v;
+    else if ((v = argValue(argv[i], "--generations="))) opt.generations = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--population="))) opt.population = std::max(2ul, strtoul(v, nullptr, 10));
+    else if ((v = argValue(argv[i], "--top="))) opt.top = std::max(1ul, strtoul(v, nullptr, 10));
+    else if ((v = argValue(argv[i], "--threads="))) opt.threads = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--seed="))) opt.seed = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--step-ms="))) opt.stepMs = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--loop-ms="))) opt.replay.loopMs = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--tip-in="))) opt.tipInPct = strtof(v, nullptr);
+    else if ((v = argValue(argv[i], "--miss-ms="))) opt.missMs = strtoul(v, nullptr, 10);
+    else if ((v = argValue(argv[i], "--w-latency="))) opt.weights.latency = strtof(v, nullptr);
+    else if ((v = argValue(argv[i], "--w-toggles="))) opt.weights.toggles = strtof(v, nullptr);
+    else if ((v = argValue(argv[i], "--w-active="))) opt.weights.active = strtof(v, nullptr);
+    else if ((v = argValue(argv[i], "--tps="))) {
+      if (!parseRange(v, c.tpsMin, c.tpsMax)) {
+        fprintf(stderr, "Rango TPS inválido: %s\n", v);
+        return false;
+      }
+    } else if ((v = argValue(argv[i], "--map="))) {
+      if (!parseRange(v, c.mapMin, c.mapMax)) {
+        fprintf(stderr, "Rango MAP inválido: %s\n", v);
+        return false;
+      }
+    } else {
+      fprintf(stderr, "Opción desconocida: %s\n", argv[i]);
+      return false;
+    }
+  }
+  c.valid = 1;
+  return !opt.cycles.empty();
+}
+
+// El corpus se carga una vez (8 bytes por muestra) y lo comparten todos los hilos
+bool loadCorpus(const Options& opt, std::vector<std::vector<SensorSample>>& corpus, double& totalS) {
+  totalS = 0.0;
+  for (const char* path : opt.cycles) {
+    SensorLogReader reader;
+    if (!reader.open(path, opt.stepMs)) {
+      fprintf(stderr, "No se pudo abrir el ciclo %s\n", path);
+      return false;
+    }
+    std::vector<SensorSample> samples;
+    SensorSample s;
+    while (reader.next(s)) samples.push_back(s);
+    if (samples.empty()) {
+      fprintf(stderr, "Ciclo sin muestras: %s\n", path);
+      return false;
+    }
+    totalS += (samples.back().tMs - samples.front().tMs) / 1000.0;
+    corpus.push_back(std::move(samples));
+  }
+  return true;
+}
+
+void evaluate(Candidate& cand, const std::vector<std::vector<SensorSample>>& corpus, const Options& opt) {
+  ThresholdManager thresholds;
+  for (const ParamSpec& p : TUNE_PARAMS) thresholds.setThreshold(p.name, cand.t.*p.field);
+  if (thresholds.applyEdits() != ThresholdManager::EditResult::OK) {
+    cand.cost = INFINITY;  // makeValid() no debería dejar pasar ninguno
+    return;
+  }
+
+  const CalibrationData& c = opt.replay.calib;
+  CycleScore total;
+  for (const std::vector<SensorSample>& cycle : corpus) {
+    CycleScorer scorer(opt.tipInPct, opt.missMs);
+    ReplayEngine engine(&thresholds, opt.replay, &scorer);
+    for (const SensorSample& s : cycle) {
+      engine.feed(s);
+      scorer.onSample(s.tMs, rawToPercent(s.tpsRaw, c.tpsMin, c.tpsMax));
+    }
+    engine.finish();
+    scorer.finish(cycle.back().tMs);
+    total.add(scorer.getScore());
+  }
+  cand.score = total;
+  cand.cost = opt.weights.cost(total);
+}
+
+void evaluateAll(std::vector<Candidate>& batch, const std::vector<std::vector<SensorSample>>& corpus,
+                 const Options& opt, uint32_t threads) {
+  std::atomic<size_t> next{0};
+  auto worker = [&]() {
+    for (size_t i = next++; i < batch.size(); i = next++) evaluate(batch[i], corpus, opt);
+  };
+  std::vector<std::thread> pool;
+  for (uint32_t i = 1; i < threads; ++i) pool.emplace_back(worker);
+  worker();
+  for (std::thread& th : pool) th.join();
+}
+
+bool sameThresholds(const Thresholds& a, const Thresholds& b) {
+  for (const ParamSpec& p : TUNE_PARAMS) {
+    if (a.*p.field != b.*p.field) return false;
+  }
+  return true;
+}
+
+void writeProfile(FILE* out, size_t rank, const Candidate& c, const char* label) {
+  fprintf(out, "# perfil %zu%s: coste %.1f (latencia media %.0f ms, %u/%u fallos, %.2f conmutaciones/min, %.1f%% activo)\n",
+          rank, label, c.cost, c.score.meanLatencyMs(), (unsigned)c.score.misses,
+          (unsigned)c.score.tipIns, c.score.togglesPerMin(), c.score.activePct());
+  char name[PROFILE_NAME_LEN];
+  if (rank) snprintf(name, sizeof(name), "tune%u", static_cast<unsigned>(rank % 1000));
+  else snprintf(name, sizeof(name), "fabrica");
+  writeProfileBlock(out, name, c.t);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options opt;
+  if (!parseOptions(argc, argv, opt)) {
+    fprintf(stderr, "Uso: vortex_tune [opciones] CICLO...\n");
+    return 2;
+  }
+
+  std::vector<std::vector<SensorSample>> corpus;
+  double corpusS;
+  if (!loadCorpus(opt, corpus, corpusS)) return 2;
+
+  uint32_t threads = opt.threads ? opt.threads : std::max(1u, std::thread::hardware_concurrency());
+
+  // Parte de los umbrales de fábrica
+  Candidate defaults;
+  defaults.t = ThresholdManager::factoryProfile().thresholds;
+
+  std::mt19937 rng(opt.seed);
+  std::vector<Candidate> batch;
+  batch.push_back(defaults);
+  for (uint32_t i = 1; i < opt.population; ++i) {
+    Candidate c;
+    for (const ParamSpec& p : TUNE_PARAMS) {
+      c.t.*p.field = std::uniform_real_distribution<float>(p.lo, p.hi)(rng);
+    }
+    makeValid(c.t);
+    batch.push_back(c);
+  }
+
+  fprintf(stderr, "%zu ciclos, %.1f min de manejo, %u hilos\n", corpus.size(), corpusS / 60.0, threads);
+  auto t0 = std::chrono::steady_clock::now();
+
+  std::vector<Candidate> elite;
+  const size_t eliteSize = std::max<size_t>(opt.top, opt.population / 4);
+  float scale = 0.15f;  // Desviación de las perturbaciones, en fracción del rango
+  uint64_t evaluations = 0;
+
+  for (uint32_t gen = 0; gen <= opt.generations; ++gen) {
+    evaluateAll(batch, corpus, opt, threads);
+    evaluations += batch.size();
+    if (gen == 0) defaults = batch[0];
+
+    for (const Candidate& c : batch) {
+      bool dup = std::any_of(elite.begin(), elite.end(),
+                             [&](const Candidate& e) { return sameThresholds(e.t, c.t); });
+      if (!dup) elite.push_back(c);
+    }
+    std::sort(elite.begin(), elite.end(),
+              [](const Candidate& a, const Candidate& b) { return a.cost < b.cost; });
+    if (elite.size() > eliteSize) elite.resize(eliteSize);
+    fprintf(stderr, "  generación %u: mejor coste %.1f\n", gen, elite.front().cost);
+
+    if (gen == opt.generations) break;
+
+    // Siguiente población: perturbaciones de los mejores, más finas en cada generación
+    batch.clear();
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    for (uint32_t i = 0; i < opt.population; ++i) {
+      Candidate c;
+      c.t = elite[i % elite.size()].t;
+      for (const ParamSpec& p : TUNE_PARAMS) c.t.*p.field += noise(rng) * scale * (p.hi - p.lo);
+      makeValid(c.t);
+      batch.push_back(c);
+    }
+    scale *= 0.75f;
+  }
+
+  double wallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  fprintf(stderr, "%llu evaluaciones en %.2f s\n", (unsigned long long)evaluations, wallS);
+
+  FILE* out = opt.outPath ? fopen(opt.outPath, "w") : stdout;
+  if (!out) {
+    fprintf(stderr, "No se pudo escribir %s\n", opt.outPath);
+    return 2;
+  }
+  fprintf(out, "# vortex_tune: %zu ciclos, %.1f min, %llu evaluaciones, pesos latencia=%.2f conmutaciones=%.2f activo=%.2f\n",
+          corpus.size(), corpusS / 60.0, (unsigned long long)evaluations,
+          opt.weights.latency, opt.weights.toggles, opt.weights.active);
+  fprintf(out, "# Para importar un perfil, enviar su bloque por la consola (USB o Bluetooth).\n\n");
+  for (size_t i = 0; i < elite.size() && i < opt.top; ++i) writeProfile(out, i + 1, elite[i], "");
+  writeProfile(out, 0, defaults, " (umbrales de fábrica, referencia)");
+  if (out != stdout) fclose(out);
+  return 0;
+}